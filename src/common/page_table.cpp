@@ -2,10 +2,58 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#ifdef ARCHITECTURE_x86_64
+#include <emmintrin.h>
+#endif
+
+#include "common/bit_util.h"
 #include "common/page_table.h"
 
 namespace Common {
 
+namespace {
+
+/// Runs of entries spanning more than this many bytes bypass the cache when filled
+constexpr std::size_t STREAMING_FILL_THRESHOLD = 1ULL << 20;
+
+template <typename T>
+void FillEntries(T* entries, std::size_t count, T value) {
+    static_assert(sizeof(T) == sizeof(u64));
+#ifdef ARCHITECTURE_x86_64
+    if (count != 0 && (reinterpret_cast<std::uintptr_t>(entries) & 15) != 0) {
+        *entries++ = value;
+        --count;
+    }
+    u64 raw_value;
+    std::memcpy(&raw_value, &value, sizeof(raw_value));
+    const __m128i pair = _mm_set1_epi64x(static_cast<long long>(raw_value));
+    auto* pairs = reinterpret_cast<__m128i*>(entries);
+    const std::size_t num_pairs = count / 2;
+    if (num_pairs * sizeof(__m128i) >= STREAMING_FILL_THRESHOLD) {
+        // Mapping gigabytes writes megabytes of entries, keep them from evicting the working set
+        for (std::size_t i = 0; i < num_pairs; ++i) {
+            _mm_stream_si128(pairs + i, pair);
+        }
+        _mm_sfence();
+    } else {
+        for (std::size_t i = 0; i < num_pairs; ++i) {
+            _mm_store_si128(pairs + i, pair);
+        }
+    }
+    if (count % 2 != 0) {
+        entries[count - 1] = value;
+    }
+#else
+    std::fill_n(entries, count, value);
+#endif
+}
+
+} // Anonymous namespace
+
 PageTable::PageTable() = default;
 
 PageTable::~PageTable() = default;
@@ -19,7 +67,42 @@ void PageTable::Resize(std::size_t address_space_width_in_bits, std::size_t page
 
     if (has_attribute) {
         attributes.resize(num_page_table_entries);
+        translated_code.resize(num_page_table_entries);
     }
 }
 
+void FillPageRun(PageTable& page_table, std::size_t first, std::size_t num_pages, u8* pointer,
+                 u64 backing_addr, PageType type) {
+    FillEntries(page_table.pointers.data() + first, num_pages, pointer);
+    FillEntries(page_table.backing_addr.data() + first, num_pages, backing_addr);
+    std::memset(page_table.attributes.data() + first, static_cast<int>(type), num_pages);
+}
+
+std::size_t FindByteRunEnd(const u8* values, std::size_t first, std::size_t last) {
+    const u8 value = values[first];
+    std::size_t index = first + 1;
+#ifdef ARCHITECTURE_x86_64
+    // Compare 16 values at a time, block operations commonly span hundreds of pages
+    const __m128i expected = _mm_set1_epi8(static_cast<char>(value));
+    for (; index + 16 <= last; index += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + index));
+        const auto equal = static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, expected)));
+        if (equal != 0xFFFF) {
+            return index + CountTrailingZeroes32(~equal);
+        }
+    }
+#endif
+    for (; index < last; ++index) {
+        if (values[index] != value) {
+            return index;
+        }
+    }
+    return last;
+}
+
+std::size_t FindPageTypeRunEnd(const PageType* attributes, std::size_t first, std::size_t last) {
+    static_assert(sizeof(PageType) == sizeof(u8));
+    return FindByteRunEnd(reinterpret_cast<const u8*>(attributes), first, last);
+}
+
 } // namespace Common
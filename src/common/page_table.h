@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <set>
+#include <tuple>
 #include <vector>
 
 #include <boost/icl/interval_map.hpp>
@@ -22,7 +24,8 @@ enum class PageType : u8 {
     /// Page is mapped to regular memory, but also needs to check for rasterizer cache flushing and
     /// invalidation
     RasterizerCachedMemory,
-    /// Page is mapped to a I/O region. Writing and reading to this page is handled by functions.
+    /// Page is mapped to regular memory with debug hooks, or to a I/O region. Writing and reading
+    /// to this page is handled by the functions of the special regions first.
     Special,
     /// Page is allocated for use.
     Allocated,
@@ -71,6 +74,53 @@ struct PageTable {
     VirtualBuffer<u64> backing_addr;
 
     VirtualBuffer<PageType> attributes;
+
+    /**
+     * Nonzero for pages the CPU translated instructions from. Code translated from a page must be
+     * invalidated when the page is remapped. Entries are only accessed through std::atomic_ref.
+     */
+    VirtualBuffer<u8> translated_code;
+
+    /// Memory hooks of the address space, mapped memory they cover is of type `Special`
+    boost::icl::interval_map<u64, std::set<SpecialRegion>> special_regions;
 };
 
+/**
+ * Maps a run of pages in a single pass. Page table entries are offsets from the virtual address
+ * of their page, so a run backed by contiguous memory is described by a single pointer and
+ * backing address shared by all of its pages, like a huge page.
+ *
+ * @param page_table   Page table to update.
+ * @param first        Index of the first page of the run.
+ * @param num_pages    Number of pages in the run.
+ * @param pointer      Host pointer of the run minus its virtual address, or null.
+ * @param backing_addr Backing address of the run minus its virtual address, or zero.
+ * @param type         Page type of the run.
+ */
+void FillPageRun(PageTable& page_table, std::size_t first, std::size_t num_pages, u8* pointer,
+                 u64 backing_addr, PageType type);
+
+/**
+ * Finds the end of the run of bytes with the same value as the first one.
+ *
+ * @param values Values to scan.
+ * @param first  Index of the first value of the run.
+ * @param last   Index past the last value to scan, must be greater than `first`.
+ *
+ * @returns Index of the first value in (first, last) different from the first one, or `last`.
+ */
+[[nodiscard]] std::size_t FindByteRunEnd(const u8* values, std::size_t first, std::size_t last);
+
+/**
+ * Finds the end of the run of pages with the same type as the first one.
+ *
+ * @param attributes Page types of the page table.
+ * @param first      Index of the first page of the run.
+ * @param last       Index past the last page to scan, must be greater than `first`.
+ *
+ * @returns Index of the first page in (first, last) with a different type, or `last`.
+ */
+[[nodiscard]] std::size_t FindPageTypeRunEnd(const PageType* attributes, std::size_t first,
+                                             std::size_t last);
+
 } // namespace Common
@@ -0,0 +1,224 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <thread>
+
+#ifdef __linux__
+#include <cerrno>
+#include <ctime>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
+#if _MSC_VER
+#include <intrin.h>
+#if _M_AMD64
+#define __x86_64__ 1
+#endif
+#if _M_ARM64
+#define __aarch64__ 1
+#endif
+#else
+#if __x86_64__
+#include <xmmintrin.h>
+#endif
+#endif
+
+#include "common/common_types.h"
+#include "common/logging/log.h"
+#include "common/precision_waiter.h"
+
+namespace Common {
+
+namespace {
+
+using namespace std::chrono_literals;
+
+/// Initial estimate of how late the host wakes up from sleeps
+constexpr std::chrono::nanoseconds InitialOversleep = 200us;
+/// Bounds of the busy-wait tail
+constexpr std::chrono::nanoseconds MinSpinMargin = 10us;
+constexpr std::chrono::nanoseconds MaxSpinMargin = 2ms;
+
+void ThreadPause() {
+#if __x86_64__
+    _mm_pause();
+#elif __aarch64__ && _MSC_VER
+    __yield();
+#elif __aarch64__
+    asm("yield");
+#endif
+}
+
+#ifdef __linux__
+timespec ToTimespec(PrecisionWaiter::Clock::time_point time_point) {
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        time_point.time_since_epoch())
+                        .count();
+    timespec result{};
+    result.tv_sec = static_cast<time_t>(ns / 1'000'000'000);
+    result.tv_nsec = static_cast<long>(ns % 1'000'000'000);
+    return result;
+}
+#endif
+
+} // Anonymous namespace
+
+PrecisionWaiter::PrecisionWaiter() : oversleep_mean{InitialOversleep} {
+#ifdef __linux__
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    bool is_valid = epoll_fd != -1 && timer_fd != -1 && event_fd != -1;
+    for (const int fd : {timer_fd, event_fd}) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        is_valid = is_valid && epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) == 0;
+    }
+    if (!is_valid) {
+        LOG_WARNING(Common, "timerfd waits are unavailable, using condition variables instead");
+        for (int* const fd : {&epoll_fd, &timer_fd, &event_fd}) {
+            if (*fd != -1) {
+                close(*fd);
+                *fd = -1;
+            }
+        }
+    }
+#endif
+}
+
+PrecisionWaiter::~PrecisionWaiter() {
+#ifdef __linux__
+    for (const int fd : {epoll_fd, timer_fd, event_fd}) {
+        if (fd != -1) {
+            close(fd);
+        }
+    }
+#endif
+}
+
+void PrecisionWaiter::Set() {
+    if (is_set.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+#ifdef __linux__
+    if (event_fd != -1) {
+        const u64 value = 1;
+        [[maybe_unused]] const ssize_t result = write(event_fd, &value, sizeof(value));
+        return;
+    }
+#endif
+    std::lock_guard lock{mutex};
+    condvar.notify_one();
+}
+
+void PrecisionWaiter::Wait() {
+#ifdef __linux__
+    if (epoll_fd != -1) {
+        while (!ConsumeSet()) {
+            std::array<epoll_event, 2> events;
+            const int count = epoll_wait(epoll_fd, events.data(), 2, -1);
+            for (int i = 0; i < count; ++i) {
+                u64 value;
+                [[maybe_unused]] const ssize_t result =
+                    read(events[i].data.fd, &value, sizeof(value));
+            }
+        }
+        return;
+    }
+#endif
+    std::unique_lock lock{mutex};
+    condvar.wait(lock, [this] { return is_set.load(std::memory_order_acquire); });
+    ConsumeSet();
+}
+
+bool PrecisionWaiter::WaitUntil(Clock::time_point deadline) {
+    const auto sleep_deadline = deadline - SpinMargin();
+    if (sleep_deadline > Clock::now()) {
+        if (SleepInterruptible(sleep_deadline)) {
+            return ConsumeSet();
+        }
+        TrackOversleep(sleep_deadline);
+    }
+    return Spin(deadline, true);
+}
+
+void PrecisionWaiter::SleepUntil(Clock::time_point deadline) {
+    const auto sleep_deadline = deadline - SpinMargin();
+    if (sleep_deadline > Clock::now()) {
+#ifdef __linux__
+        const timespec time = ToTimespec(sleep_deadline);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &time, nullptr) == EINTR) {
+        }
+#else
+        std::this_thread::sleep_until(sleep_deadline);
+#endif
+        TrackOversleep(sleep_deadline);
+    }
+    Spin(deadline, false);
+}
+
+std::chrono::nanoseconds PrecisionWaiter::SpinMargin() const {
+    return std::clamp<std::chrono::nanoseconds>(oversleep_mean + 4 * oversleep_deviation,
+                                                MinSpinMargin, MaxSpinMargin);
+}
+
+bool PrecisionWaiter::SleepInterruptible(Clock::time_point deadline) {
+#ifdef __linux__
+    if (epoll_fd != -1) {
+        itimerspec spec{};
+        spec.it_value = ToTimespec(deadline);
+        timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &spec, nullptr);
+        while (!is_set.load(std::memory_order_acquire)) {
+            std::array<epoll_event, 2> events;
+            const int count = epoll_wait(epoll_fd, events.data(), 2, -1);
+            bool has_expired = false;
+            for (int i = 0; i < count; ++i) {
+                u64 value;
+                [[maybe_unused]] const ssize_t result =
+                    read(events[i].data.fd, &value, sizeof(value));
+                has_expired |= events[i].data.fd == timer_fd;
+            }
+            if (has_expired) {
+                break;
+            }
+        }
+        return is_set.load(std::memory_order_acquire);
+    }
+#endif
+    std::unique_lock lock{mutex};
+    return condvar.wait_until(lock, deadline,
+                              [this] { return is_set.load(std::memory_order_acquire); });
+}
+
+bool PrecisionWaiter::Spin(Clock::time_point deadline, bool interruptible) {
+    while (Clock::now() < deadline) {
+        if (interruptible && is_set.load(std::memory_order_relaxed)) {
+            return ConsumeSet();
+        }
+        ThreadPause();
+    }
+    return interruptible && ConsumeSet();
+}
+
+void PrecisionWaiter::TrackOversleep(Clock::time_point sleep_deadline) {
+    const Clock::duration oversleep = Clock::now() - sleep_deadline;
+    const Clock::duration error = oversleep - oversleep_mean;
+    oversleep_mean += error / 8;
+    oversleep_deviation += ((error < Clock::duration::zero() ? -error : error) -
+                            oversleep_deviation) /
+                           4;
+}
+
+bool PrecisionWaiter::ConsumeSet() {
+    return is_set.exchange(false, std::memory_order_acq_rel);
+}
+
+} // namespace Common
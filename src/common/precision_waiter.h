@@ -0,0 +1,87 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace Common {
+
+/**
+ * Event that waits for absolute deadlines with microsecond accuracy.
+ *
+ * Host timers commonly wake threads up tens to hundreds of microseconds late. The waiter sleeps
+ * until shortly before the deadline and busy-waits the remaining time. The length of the busy-wait
+ * tail follows how late the host timer has been waking the waiter up.
+ *
+ * On Linux, interruptible waits sleep on a timerfd armed with an absolute deadline and an eventfd
+ * signalled by Set, both polled with epoll. Other hosts, or hosts where those aren't available,
+ * sleep on a condition variable.
+ *
+ * Like Common::Event, a single thread is expected to wait at a time.
+ */
+class PrecisionWaiter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    PrecisionWaiter();
+    ~PrecisionWaiter();
+
+    PrecisionWaiter(const PrecisionWaiter&) = delete;
+    PrecisionWaiter& operator=(const PrecisionWaiter&) = delete;
+
+    /// Wakes up the waiting thread, or makes the next wait return immediately
+    void Set();
+
+    /// Waits until the waiter is set
+    void Wait();
+
+    /// Waits until the deadline or until the waiter is set, returns true when it was set
+    bool WaitUntil(Clock::time_point deadline);
+
+    /// Waits for the given duration or until the waiter is set, returns true when it was set
+    bool WaitFor(std::chrono::nanoseconds duration) {
+        return WaitUntil(Clock::now() + duration);
+    }
+
+    /**
+     * Sleeps until the deadline, ignoring Set. This is cheaper than WaitUntil, it uses a single
+     * clock_nanosleep with an absolute deadline on POSIX hosts.
+     */
+    void SleepUntil(Clock::time_point deadline);
+
+    /// Returns the current length of the busy-wait tail
+    [[nodiscard]] std::chrono::nanoseconds SpinMargin() const;
+
+private:
+    /// Sleeps on the host timer until the deadline, returns true when the waiter was set
+    bool SleepInterruptible(Clock::time_point deadline);
+
+    /// Busy-waits until the deadline, returns true when the waiter was set
+    bool Spin(Clock::time_point deadline, bool interruptible);
+
+    /// Updates the oversleep estimate with how late a sleep ended
+    void TrackOversleep(Clock::time_point sleep_deadline);
+
+    /// Consumes the set state, returns true when the waiter was set
+    bool ConsumeSet();
+
+    std::atomic_bool is_set{false};
+
+    std::mutex mutex;
+    std::condition_variable condvar;
+
+    int epoll_fd = -1;
+    int timer_fd = -1;
+    int event_fd = -1;
+
+    /// Running mean and mean deviation of how late the host wakes up from sleeps
+    Clock::duration oversleep_mean;
+    Clock::duration oversleep_deviation{};
+};
+
+} // namespace Common
@@ -0,0 +1,56 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Common {
+
+/**
+ * A fixed size pool of worker threads executing queued work items in FIFO order.
+ *
+ * Work is expected to be queued and waited on from a single owner thread, which blocks in
+ * WaitForRequests() until every item queued so far has finished running.
+ */
+class ThreadWorker final {
+public:
+    explicit ThreadWorker(std::size_t num_workers, const std::string& name);
+    ~ThreadWorker();
+
+    ThreadWorker(const ThreadWorker&) = delete;
+    ThreadWorker& operator=(const ThreadWorker&) = delete;
+
+    /// Queues a work item to be executed by any of the workers
+    void QueueWork(std::function<void()> work);
+
+    /// Blocks until all queued work items have been executed
+    void WaitForRequests();
+
+    /// Returns the number of worker threads in the pool
+    std::size_t NumWorkers() const {
+        return threads.size();
+    }
+
+private:
+    void WorkerLoop(std::string thread_name);
+
+    std::vector<std::thread> threads;
+    std::queue<std::function<void()>> requests;
+    std::mutex queue_mutex;
+    std::condition_variable request_condition;
+    std::condition_variable wait_condition;
+    std::size_t work_scheduled{};
+    std::size_t work_done{};
+    bool stop{};
+};
+
+} // namespace Common
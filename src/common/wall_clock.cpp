@@ -67,15 +67,28 @@ std::unique_ptr<WallClock> CreateBestMatchingClock(u32 emulated_cpu_frequency,
                                                    u32 emulated_clock_frequency) {
     const auto& caps = GetCPUCaps();
     u64 rtsc_frequency = 0;
+    bool verify_frequency = false;
     if (caps.invariant_tsc) {
-        rtsc_frequency = EstimateRDTSCFrequency();
+        // Measuring the TSC frequency takes seconds. Prefer the frequency calibrated on a previous
+        // boot, then the frequency enumerated by CPUID, and verify them in the background.
+        const std::string path = GetRDTSCCalibrationPath();
+        const std::string key = GetRDTSCCalibrationKey();
+        rtsc_frequency = LoadRDTSCCalibration(path, key);
+        if (rtsc_frequency == 0) {
+            rtsc_frequency = caps.tsc_frequency;
+        }
+        verify_frequency = rtsc_frequency != 0;
+        if (rtsc_frequency == 0) {
+            rtsc_frequency = EstimateRDTSCFrequency();
+            SaveRDTSCCalibration(path, key, rtsc_frequency);
+        }
     }
     if (rtsc_frequency == 0) {
         return std::make_unique<StandardWallClock>(emulated_cpu_frequency,
                                                    emulated_clock_frequency);
     } else {
         return std::make_unique<X64::NativeClock>(emulated_cpu_frequency, emulated_clock_frequency,
-                                                  rtsc_frequency);
+                                                  rtsc_frequency, verify_frequency);
     }
 }
 
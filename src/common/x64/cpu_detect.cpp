@@ -71,9 +71,6 @@ static CPUCaps Detect() {
     else
         caps.manufacturer = Manufacturer::Unknown;
 
-    u32 family = {};
-    u32 model = {};
-
     __cpuid(cpu_id, 0x80000000);
 
     u32 max_ex_fn = cpu_id[0];
@@ -84,13 +81,14 @@ static CPUCaps Detect() {
     // Detect family and other miscellaneous features
     if (max_std_fn >= 1) {
         __cpuid(cpu_id, 0x00000001);
-        family = (cpu_id[0] >> 8) & 0xf;
-        model = (cpu_id[0] >> 4) & 0xf;
-        if (family == 0xf) {
-            family += (cpu_id[0] >> 20) & 0xff;
+        caps.family = (cpu_id[0] >> 8) & 0xf;
+        caps.model = (cpu_id[0] >> 4) & 0xf;
+        caps.stepping = cpu_id[0] & 0xf;
+        if (caps.family == 0xf) {
+            caps.family += (cpu_id[0] >> 20) & 0xff;
         }
-        if (family >= 6) {
-            model += ((cpu_id[0] >> 16) & 0xf) << 4;
+        if (caps.family >= 6) {
+            caps.model += ((cpu_id[0] >> 16) & 0xf) << 4;
         }
 
         if ((cpu_id[3] >> 25) & 1)
@@ -117,6 +115,8 @@ static CPUCaps Detect() {
                 caps.avx = true;
                 if ((cpu_id[2] >> 12) & 1)
                     caps.fma = true;
+                if ((cpu_id[2] >> 29) & 1)
+                    caps.f16c = true;
             }
         }
 
@@ -161,6 +161,17 @@ static CPUCaps Detect() {
         }
     }
 
+    if (max_std_fn >= 0x15) {
+        // TSC frequency is the crystal clock frequency times the TSC to crystal ratio
+        __cpuid(cpu_id, 0x15);
+        const u32 denominator = static_cast<u32>(cpu_id[0]);
+        const u32 numerator = static_cast<u32>(cpu_id[1]);
+        const u32 crystal_frequency = static_cast<u32>(cpu_id[2]);
+        if (denominator != 0 && numerator != 0 && crystal_frequency != 0) {
+            caps.tsc_frequency = static_cast<u64>(crystal_frequency) * numerator / denominator;
+        }
+    }
+
     if (max_std_fn >= 0x16) {
         __cpuid(cpu_id, 0x16);
         caps.base_frequency = cpu_id[0];
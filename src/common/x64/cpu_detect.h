@@ -31,12 +31,18 @@ struct CPUCaps {
     bool bmi1;
     bool bmi2;
     bool fma;
+    bool f16c;
     bool fma4;
     bool aes;
     bool invariant_tsc;
     u32 base_frequency;
     u32 max_frequency;
     u32 bus_frequency;
+    /// TSC frequency in Hz as enumerated by CPUID leaf 0x15, 0 when not enumerated
+    u64 tsc_frequency;
+    u32 family;
+    u32 model;
+    u32 stepping;
 };
 
 /**
@@ -3,74 +3,195 @@
 // Refer to the license.txt file included.
 
 #include <chrono>
-#include <mutex>
+#include <cstdlib>
 #include <thread>
 
+#ifdef __linux__
+#include <fstream>
+#endif
+
 #ifdef _MSC_VER
 #include <intrin.h>
 #else
 #include <x86intrin.h>
 #endif
 
+#include <fmt/format.h>
+
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/string_util.h"
 #include "common/uint128.h"
+#include "common/x64/cpu_detect.h"
 #include "common/x64/native_clock.h"
 
 namespace Common {
 
-u64 EstimateRDTSCFrequency() {
-    const auto milli_10 = std::chrono::milliseconds{10};
-    // get current time
+namespace {
+
+constexpr std::chrono::milliseconds CalibrationDuration{3000};
+
+/// Relative difference, in parts per million, above which a verified frequency is stored
+constexpr u64 CalibrationTolerancePPM = 200;
+
+/**
+ * Measures the TSC frequency over the given duration.
+ * Returns 0 when stop_event is set before the measurement completes.
+ */
+u64 MeasureRDTSCFrequency(std::chrono::milliseconds duration, Event* stop_event) {
     _mm_mfence();
-    const u64 tscStart = __rdtsc();
-    const auto startTime = std::chrono::high_resolution_clock::now();
-    // wait roughly 3 seconds
-    while (true) {
-        auto milli = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::high_resolution_clock::now() - startTime);
-        if (milli.count() >= 3000)
-            break;
-        std::this_thread::sleep_for(milli_10);
+    const u64 tsc_start = __rdtsc();
+    const auto start_time = std::chrono::steady_clock::now();
+    if (stop_event) {
+        if (stop_event->WaitFor(duration)) {
+            return 0;
+        }
+    } else {
+        std::this_thread::sleep_for(duration);
     }
-    const auto endTime = std::chrono::high_resolution_clock::now();
+    const auto end_time = std::chrono::steady_clock::now();
     _mm_mfence();
-    const u64 tscEnd = __rdtsc();
+    const u64 tsc_end = __rdtsc();
     // calculate difference
     const u64 timer_diff =
-        std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count();
-    const u64 tsc_diff = tscEnd - tscStart;
-    const u64 tsc_freq = MultiplyAndDivide64(tsc_diff, 1000000000ULL, timer_diff);
-    return tsc_freq;
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count();
+    const u64 tsc_diff = tsc_end - tsc_start;
+    return MultiplyAndDivide64(tsc_diff, 1000000000ULL, timer_diff);
+}
+
+/// Returns the microcode revision of the host CPU, or an empty string when it's unknown
+std::string GetMicrocodeRevision() {
+#ifdef __linux__
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.rfind("microcode", 0) == 0) {
+            const std::size_t separator = line.find(':');
+            if (separator != std::string::npos) {
+                return StripSpaces(line.substr(separator + 1));
+            }
+        }
+    }
+#endif
+    return {};
+}
+
+} // Anonymous namespace
+
+u64 EstimateRDTSCFrequency() {
+    return MeasureRDTSCFrequency(CalibrationDuration, nullptr);
+}
+
+std::string GetRDTSCCalibrationPath() {
+    return FS::GetUserPath(FS::UserPath::CacheDir) + "rdtsc_calibration.txt";
+}
+
+std::string GetRDTSCCalibrationKey() {
+    const auto& caps = GetCPUCaps();
+    return fmt::format("{} {:X}-{:X}-{:X} {}", StripSpaces(caps.cpu_string), caps.family,
+                       caps.model, caps.stepping, GetMicrocodeRevision());
+}
+
+u64 LoadRDTSCCalibration(const std::string& path, const std::string& key) {
+    std::string contents;
+    if (FS::ReadFileToString(true, path, contents) == 0) {
+        return 0;
+    }
+    // The first line holds the key the frequency on the second line was calibrated for
+    const std::size_t separator = contents.find('\n');
+    if (separator == std::string::npos || contents.substr(0, separator) != key) {
+        return 0;
+    }
+    return std::strtoull(contents.c_str() + separator + 1, nullptr, 10);
+}
+
+void SaveRDTSCCalibration(const std::string& path, const std::string& key, u64 frequency) {
+    const std::string contents = fmt::format("{}\n{}\n", key, frequency);
+    if (FS::WriteStringToFile(true, path, contents) != contents.size()) {
+        LOG_WARNING(Common, "Failed to write the TSC calibration to {}", path);
+    }
 }
 
 namespace X64 {
 NativeClock::NativeClock(u64 emulated_cpu_frequency, u64 emulated_clock_frequency,
-                         u64 rtsc_frequency)
+                         u64 rtsc_frequency, bool verify_frequency)
     : WallClock(emulated_cpu_frequency, emulated_clock_frequency, true), rtsc_frequency{
                                                                              rtsc_frequency} {
     _mm_mfence();
-    last_measure = __rdtsc();
-    accumulated_ticks = 0U;
+    base_measure.store(__rdtsc(), std::memory_order_relaxed);
+    if (verify_frequency) {
+        verify_thread = std::thread([this] { VerifyFrequency(); });
+    }
+}
+
+NativeClock::~NativeClock() {
+    if (verify_thread.joinable()) {
+        stop_verify.Set();
+        verify_thread.join();
+    }
 }
 
 u64 NativeClock::GetRTSC() {
-    std::scoped_lock scope{rtsc_serialize};
-    _mm_mfence();
-    const u64 current_measure = __rdtsc();
-    u64 diff = current_measure - last_measure;
-    diff = diff & ~static_cast<u64>(static_cast<s64>(diff) >> 63); // max(diff, 0)
-    if (current_measure > last_measure) {
-        last_measure = current_measure;
+    for (;;) {
+        const u32 sequence = pause_sequence.load(std::memory_order_acquire);
+        const u32 phase = sequence % NUM_PAUSE_PHASES;
+        if (phase == Pausing) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (phase != Running) {
+            return paused_measure.load(std::memory_order_relaxed) & inaccuracy_mask;
+        }
+        // The TSC is invariant and synchronized between cores, so reads only have to be ordered
+        // with the loads of this thread
+        const u64 base = base_measure.load(std::memory_order_relaxed);
+        _mm_lfence();
+        const u64 rtsc_value = __rdtsc() - base;
+        _mm_lfence();
+        // A read racing with a pause is only valid when it was measured before the pause began,
+        // otherwise it could be later than the time the clock stops at
+        if (pause_sequence.load(std::memory_order_seq_cst) == sequence) {
+            /// The clock cannot be more precise than the guest timer, remove the lower bits
+            return rtsc_value & inaccuracy_mask;
+        }
     }
-    accumulated_ticks += diff;
-    /// The clock cannot be more precise than the guest timer, remove the lower bits
-    return accumulated_ticks & inaccuracy_mask;
 }
 
 void NativeClock::Pause(bool is_paused) {
-    if (!is_paused) {
+    const u32 phase = pause_sequence.load(std::memory_order_relaxed) % NUM_PAUSE_PHASES;
+    if (is_paused && phase == Running) {
+        pause_sequence.fetch_add(1, std::memory_order_seq_cst);
         _mm_mfence();
-        last_measure = __rdtsc();
+        const u64 current_measure = __rdtsc();
+        paused_measure.store(current_measure - base_measure.load(std::memory_order_relaxed),
+                             std::memory_order_relaxed);
+        pause_sequence.fetch_add(1, std::memory_order_release);
+    } else if (!is_paused && phase == Paused) {
+        // Count from the time the clock stopped at, so reads made while paused stay in the past
+        _mm_lfence();
+        const u64 current_measure = __rdtsc();
+        base_measure.store(current_measure - paused_measure.load(std::memory_order_relaxed),
+                           std::memory_order_relaxed);
+        pause_sequence.fetch_add(NUM_PAUSE_PHASES - Paused, std::memory_order_release);
+    }
+}
+
+void NativeClock::VerifyFrequency() {
+    Common::SetCurrentThreadName("yuzu:TSCCalibration");
+    Common::SetCurrentThreadPriority(Common::ThreadPriority::Low);
+
+    const u64 measured = MeasureRDTSCFrequency(CalibrationDuration, &stop_verify);
+    if (measured == 0) {
+        return;
+    }
+    const u64 difference =
+        measured > rtsc_frequency ? measured - rtsc_frequency : rtsc_frequency - measured;
+    if (MultiplyAndDivide64(difference, 1'000'000, rtsc_frequency) <= CalibrationTolerancePPM) {
+        return;
     }
+    LOG_WARNING(Common, "TSC frequency {} Hz differs from the calibrated {} Hz, updating the cache",
+                measured, rtsc_frequency);
+    SaveRDTSCCalibration(GetRDTSCCalibrationPath(), GetRDTSCCalibrationKey(), measured);
 }
 
 std::chrono::nanoseconds NativeClock::GetTimeNS() {
@@ -4,9 +4,11 @@
 
 #pragma once
 
-#include <optional>
+#include <atomic>
+#include <string>
+#include <thread>
 
-#include "common/spin_lock.h"
+#include "common/thread.h"
 #include "common/wall_clock.h"
 
 namespace Common {
@@ -14,7 +16,14 @@ namespace Common {
 namespace X64 {
 class NativeClock : public WallClock {
 public:
-    NativeClock(u64 emulated_cpu_frequency, u64 emulated_clock_frequency, u64 rtsc_frequency);
+    /**
+     * @param rtsc_frequency   Frequency of the host TSC, which must be invariant
+     * @param verify_frequency Measures the TSC frequency again on a background thread, updating
+     *                         the calibration cache when it differs from rtsc_frequency
+     */
+    NativeClock(u64 emulated_cpu_frequency, u64 emulated_clock_frequency, u64 rtsc_frequency,
+                bool verify_frequency = false);
+    ~NativeClock() override;
 
     std::chrono::nanoseconds GetTimeNS() override;
 
@@ -31,18 +40,49 @@ public:
 private:
     u64 GetRTSC();
 
+    void VerifyFrequency();
+
     /// value used to reduce the native clocks accuracy as some apss rely on
     /// undefined behavior where the level of accuracy in the clock shouldn't
     /// be higher.
     static constexpr u64 inaccuracy_mask = ~(0x400 - 1);
 
-    SpinLock rtsc_serialize{};
-    u64 last_measure{};
-    u64 accumulated_ticks{};
+    /// Phases of the clock, pause_sequence moves through them in order
+    enum PausePhase : u32 {
+        Running = 0, ///< Reads measure the TSC
+        Pausing = 1, ///< The time the clock stops at is being measured, reads retry
+        Paused = 2,  ///< Reads return paused_measure
+    };
+    /// Period of the phases in pause_sequence, a power of two so the sequence can wrap around
+    static constexpr u32 NUM_PAUSE_PHASES = 4;
+
+    /// TSC value the clock counts from, moved forward by the time spent paused. With an invariant
+    /// TSC, reads only have to subtract it and don't have to be serialized.
+    std::atomic<u64> base_measure{};
+    /// Ticks the clock stopped at, reads made while paused return it so time never goes backwards
+    std::atomic<u64> paused_measure{};
+    /// Incremented on every phase change, its value modulo NUM_PAUSE_PHASES is a PausePhase
+    std::atomic<u32> pause_sequence{};
     u64 rtsc_frequency;
+
+    std::thread verify_thread;
+    Common::Event stop_verify;
 };
 } // namespace X64
 
+/// Measures the TSC frequency against the host's steady clock, this takes about three seconds
 u64 EstimateRDTSCFrequency();
 
+/// Returns the path of the TSC calibration cache in the user directory
+std::string GetRDTSCCalibrationPath();
+
+/// Returns a key identifying the host CPU model and microcode a calibration is valid for
+std::string GetRDTSCCalibrationKey();
+
+/// Loads the TSC frequency stored for the given key, returns 0 when there is none
+u64 LoadRDTSCCalibration(const std::string& path, const std::string& key);
+
+/// Stores the TSC frequency calibrated for the given key
+void SaveRDTSCCalibration(const std::string& path, const std::string& key, u64 frequency);
+
 } // namespace Common
@@ -67,6 +67,9 @@ public:
     /// Clear all instruction cache
     virtual void ClearInstructionCache() = 0;
 
+    /// Clear the instruction cache of code translated from the given address range
+    virtual void InvalidateCacheRange(VAddr addr, std::size_t size) = 0;
+
     /// Notifies CPU emulation that the current page table has changed.
     ///
     /// @param new_page_table                 The new page table.
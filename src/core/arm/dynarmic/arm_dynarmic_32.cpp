@@ -37,6 +37,9 @@ public:
     u64 MemoryRead64(u32 vaddr) override {
         return parent.system.Memory().Read64(vaddr);
     }
+    u32 MemoryReadCode(u32 vaddr) override {
+        return parent.system.Memory().ReadCode32(vaddr);
+    }
 
     void MemoryWrite8(u32 vaddr, u8 value) override {
         parent.system.Memory().Write8(vaddr, value);
@@ -281,6 +284,13 @@ void ARM_Dynarmic_32::ClearInstructionCache() {
     jit->ClearCache();
 }
 
+void ARM_Dynarmic_32::InvalidateCacheRange(VAddr addr, std::size_t size) {
+    if (!jit) {
+        return;
+    }
+    jit->InvalidateCacheRange(static_cast<u32>(addr), size);
+}
+
 void ARM_Dynarmic_32::ClearExclusiveState() {
     jit->ClearExclusiveState();
 }
@@ -42,6 +42,9 @@ public:
     u64 MemoryRead64(u64 vaddr) override {
         return parent.system.Memory().Read64(vaddr);
     }
+    u32 MemoryReadCode(u64 vaddr) override {
+        return parent.system.Memory().ReadCode32(vaddr);
+    }
     Vector MemoryRead128(u64 vaddr) override {
         auto& memory = parent.system.Memory();
         return {memory.Read64(vaddr), memory.Read64(vaddr + 8)};
@@ -342,6 +345,13 @@ void ARM_Dynarmic_64::ClearInstructionCache() {
     jit->ClearCache();
 }
 
+void ARM_Dynarmic_64::InvalidateCacheRange(VAddr addr, std::size_t size) {
+    if (!jit) {
+        return;
+    }
+    jit->InvalidateCacheRange(addr, size);
+}
+
 void ARM_Dynarmic_64::ClearExclusiveState() {
     jit->ClearExclusiveState();
 }
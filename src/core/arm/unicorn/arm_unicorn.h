@@ -43,6 +43,7 @@ public:
     void Run() override;
     void Step() override;
     void ClearInstructionCache() override;
+    void InvalidateCacheRange(VAddr, std::size_t) override {}
     void PageTableChanged(Common::PageTable&, std::size_t) override {}
     void RecordBreak(GDBStub::BreakpointAddress bkpt);
 
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
 #include <memory>
 #include <utility>
@@ -220,8 +221,13 @@ struct System::Impl {
         }
 
         telemetry_session->AddInitialInfo(*app_loader);
-        auto main_process =
-            Kernel::Process::Create(system, "main", Kernel::Process::ProcessType::Userland);
+        const std::size_t handle_table_capacity =
+            std::clamp<std::size_t>(Settings::values.handle_table_capacity,
+                                    Kernel::HandleTable::MAX_COUNT,
+                                    Kernel::HandleTable::MAX_CAPACITY);
+        auto main_process = Kernel::Process::Create(system, "main",
+                                                    Kernel::Process::ProcessType::Userland,
+                                                    handle_table_capacity);
         const auto [load_result, load_parameters] = app_loader->Load(*main_process);
         if (load_result != Loader::ResultStatus::Success) {
             LOG_CRITICAL(Core, "Failed to load ROM (Error {})!", static_cast<int>(load_result));
@@ -238,6 +244,9 @@ struct System::Impl {
             cheat_engine->Initialize();
         }
 
+        // Initialize memory freezer
+        memory_freezer = std::make_unique<Tools::Freezer>(core_timing, memory);
+
         // All threads are started, begin main process execution, now that we're in the clear.
         main_process->Run(load_parameters->main_thread_priority,
                           load_parameters->main_thread_stack_size);
@@ -294,6 +303,7 @@ struct System::Impl {
         Service::Shutdown();
         service_manager.reset();
         cheat_engine.reset();
+        memory_freezer.reset();
         telemetry_session.reset();
         device_memory.reset();
 
@@ -438,6 +448,10 @@ void System::InvalidateCpuInstructionCaches() {
     impl->kernel.InvalidateAllInstructionCaches();
 }
 
+void System::InvalidateCpuInstructionCacheRange(VAddr addr, std::size_t size) {
+    impl->kernel.InvalidateInstructionCacheRange(addr, size);
+}
+
 System::ResultStatus System::Load(Frontend::EmuWindow& emu_window, const std::string& filepath) {
     return impl->Load(*this, emu_window, filepath);
 }
@@ -519,6 +533,10 @@ Kernel::Process* System::CurrentProcess() {
 }
 
 Core::DeviceMemory& System::DeviceMemory() {
+    // Memory can be mapped before boot, like in the tests, Init replaces it with a fresh one
+    if (!impl->device_memory) {
+        impl->device_memory = std::make_unique<Core::DeviceMemory>();
+    }
     return *impl->device_memory;
 }
 
@@ -718,6 +736,14 @@ const Service::LM::Manager& System::GetLogManager() const {
     return impl->lm_manager;
 }
 
+Tools::Freezer& System::GetMemoryFreezer() {
+    return *impl->memory_freezer;
+}
+
+const Tools::Freezer& System::GetMemoryFreezer() const {
+    return *impl->memory_freezer;
+}
+
 void System::SetExitLock(bool locked) {
     impl->exit_lock = locked;
 }
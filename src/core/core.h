@@ -76,6 +76,10 @@ class DebugContext;
 class GPU;
 } // namespace Tegra
 
+namespace Tools {
+class Freezer;
+}
+
 namespace VideoCore {
 class RendererBase;
 } // namespace VideoCore
@@ -161,6 +165,13 @@ public:
      */
     void InvalidateCpuInstructionCaches();
 
+    /**
+     * Invalidate the code translated from an address range from the CPU instruction caches
+     * @param addr Start of the address range.
+     * @param size Size of the address range in bytes.
+     */
+    void InvalidateCpuInstructionCacheRange(VAddr addr, std::size_t size);
+
     /// Shutdown the emulated system.
     void Shutdown();
 
@@ -262,7 +273,7 @@ public:
     /// Gets the global scheduler
     const Kernel::GlobalScheduler& GlobalScheduler() const;
 
-    /// Gets the manager for the guest device memory
+    /// Gets the manager for the guest device memory, creating it if the system isn't initialized
     Core::DeviceMemory& DeviceMemory();
 
     /// Gets the manager for the guest device memory
@@ -361,6 +372,12 @@ public:
 
     const Service::LM::Manager& GetLogManager() const;
 
+    /// Gets the memory freezer of the running application
+    Tools::Freezer& GetMemoryFreezer();
+
+    /// Gets the memory freezer of the running application
+    const Tools::Freezer& GetMemoryFreezer() const;
+
     void SetExitLock(bool locked);
 
     bool GetExitLock() const;
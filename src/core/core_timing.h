@@ -15,6 +15,7 @@
 #include <vector>
 
 #include "common/common_types.h"
+#include "common/precision_waiter.h"
 #include "common/spin_lock.h"
 #include "common/thread.h"
 #include "common/wall_clock.h"
@@ -148,7 +149,7 @@ private:
     u64 event_fifo_id = 0;
 
     std::shared_ptr<EventType> ev_lost;
-    Common::Event event{};
+    Common::PrecisionWaiter event;
     Common::Event pause_event{};
     Common::SpinLock basic_lock{};
     Common::SpinLock advance_lock{};
@@ -2,8 +2,6 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
-#include <algorithm>
-#include <vector>
 
 #include "common/assert.h"
 #include "common/common_types.h"
@@ -21,22 +19,31 @@
 
 namespace Kernel {
 
-// Wake up num_to_wake (or all) threads in a vector.
-void AddressArbiter::WakeThreads(const std::vector<std::shared_ptr<Thread>>& waiting_threads,
-                                 s32 num_to_wake) {
+namespace {
+/// Number of table slots an arbiter starts with, must be a power of two.
+constexpr std::size_t INITIAL_WAIT_QUEUE_SLOTS = 16;
+
+std::size_t HashAddress(VAddr address, std::size_t mask) {
+    // Arbitration addresses are 32-bit aligned, drop the bits that never change.
+    return static_cast<std::size_t>(((address >> 2) * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+}
+} // Anonymous namespace
+
+// Wake up num_to_wake (or all) threads waiting on an address.
+void AddressArbiter::WakeThreads(VAddr address, s32 num_to_wake) {
     // Only process up to 'target' threads, unless 'target' is <= 0, in which case process
     // them all.
-    std::size_t last = waiting_threads.size();
-    if (num_to_wake > 0) {
-        last = std::min(last, static_cast<std::size_t>(num_to_wake));
-    }
+    for (s32 woken = 0; num_to_wake <= 0 || woken < num_to_wake; ++woken) {
+        Thread* const thread = wait_queues.Front(address);
+        if (thread == nullptr) {
+            break;
+        }
 
-    // Signal the waiting threads.
-    for (std::size_t i = 0; i < last; i++) {
-        waiting_threads[i]->SetSynchronizationResults(nullptr, RESULT_SUCCESS);
-        RemoveThread(waiting_threads[i]);
-        waiting_threads[i]->WaitForArbitration(false);
-        waiting_threads[i]->ResumeFromWait();
+        // Signal the waiting thread.
+        thread->SetSynchronizationResults(nullptr, RESULT_SUCCESS);
+        RemoveThread(thread);
+        thread->WaitForArbitration(false);
+        thread->ResumeFromWait();
     }
 }
 
@@ -59,9 +66,7 @@ ResultCode AddressArbiter::SignalToAddress(VAddr address, SignalType type, s32 v
 
 ResultCode AddressArbiter::SignalToAddressOnly(VAddr address, s32 num_to_wake) {
     SchedulerLock lock(system.Kernel());
-    const std::vector<std::shared_ptr<Thread>> waiting_threads =
-        GetThreadsWaitingOnAddress(address);
-    WakeThreads(waiting_threads, num_to_wake);
+    WakeThreads(address, num_to_wake);
     return RESULT_SUCCESS;
 }
 
@@ -100,9 +105,8 @@ ResultCode AddressArbiter::ModifyByWaitingCountAndSignalToAddressIfEqual(VAddr a
         return ERR_INVALID_ADDRESS_STATE;
     }
 
-    // Get threads waiting on the address.
-    const std::vector<std::shared_ptr<Thread>> waiting_threads =
-        GetThreadsWaitingOnAddress(address);
+    // Get the number of threads waiting on the address.
+    const std::size_t waiting_count = GetWaitingThreadCount(address);
 
     const std::size_t current_core = system.CurrentCoreIndex();
     auto& monitor = system.Monitor();
@@ -115,15 +119,15 @@ ResultCode AddressArbiter::ModifyByWaitingCountAndSignalToAddressIfEqual(VAddr a
         }
         // Determine the modified value depending on the waiting count.
         if (num_to_wake <= 0) {
-            if (waiting_threads.empty()) {
+            if (waiting_count == 0) {
                 updated_value = value + 1;
             } else {
                 updated_value = value - 1;
             }
         } else {
-            if (waiting_threads.empty()) {
+            if (waiting_count == 0) {
                 updated_value = value + 1;
-            } else if (waiting_threads.size() <= static_cast<u32>(num_to_wake)) {
+            } else if (waiting_count <= static_cast<u32>(num_to_wake)) {
                 updated_value = value - 1;
             } else {
                 updated_value = value;
@@ -131,7 +135,7 @@ ResultCode AddressArbiter::ModifyByWaitingCountAndSignalToAddressIfEqual(VAddr a
         }
     } while (!monitor.ExclusiveWrite32(current_core, address, updated_value));
 
-    WakeThreads(waiting_threads, num_to_wake);
+    WakeThreads(address, num_to_wake);
     return RESULT_SUCCESS;
 }
 
@@ -199,7 +203,7 @@ ResultCode AddressArbiter::WaitForAddressIfLessThan(VAddr address, s32 value, s6
         }
 
         current_thread->SetArbiterWaitAddress(address);
-        InsertThread(SharedFrom(current_thread));
+        InsertThread(current_thread);
         current_thread->SetStatus(ThreadStatus::WaitArb);
         current_thread->WaitForArbitration(true);
     }
@@ -212,7 +216,7 @@ ResultCode AddressArbiter::WaitForAddressIfLessThan(VAddr address, s32 value, s6
     {
         SchedulerLock lock(kernel);
         if (current_thread->IsWaitingForArbitration()) {
-            RemoveThread(SharedFrom(current_thread));
+            RemoveThread(current_thread);
             current_thread->WaitForArbitration(false);
         }
     }
@@ -254,7 +258,7 @@ ResultCode AddressArbiter::WaitForAddressIfEqual(VAddr address, s32 value, s64 t
 
         current_thread->SetSynchronizationResults(nullptr, RESULT_TIMEOUT);
         current_thread->SetArbiterWaitAddress(address);
-        InsertThread(SharedFrom(current_thread));
+        InsertThread(current_thread);
         current_thread->SetStatus(ThreadStatus::WaitArb);
         current_thread->WaitForArbitration(true);
     }
@@ -267,7 +271,7 @@ ResultCode AddressArbiter::WaitForAddressIfEqual(VAddr address, s32 value, s64 t
     {
         SchedulerLock lock(kernel);
         if (current_thread->IsWaitingForArbitration()) {
-            RemoveThread(SharedFrom(current_thread));
+            RemoveThread(current_thread);
             current_thread->WaitForArbitration(false);
         }
     }
@@ -275,48 +279,154 @@ ResultCode AddressArbiter::WaitForAddressIfEqual(VAddr address, s32 value, s64 t
     return current_thread->GetSignalingResult();
 }
 
-void AddressArbiter::HandleWakeupThread(std::shared_ptr<Thread> thread) {
-    ASSERT(thread->GetStatus() == ThreadStatus::WaitArb);
+void AddressArbiter::HandleWakeupThread(Thread* thread) {
     RemoveThread(thread);
     thread->SetArbiterWaitAddress(0);
 }
 
-void AddressArbiter::InsertThread(std::shared_ptr<Thread> thread) {
-    const VAddr arb_addr = thread->GetArbiterWaitAddress();
-    std::list<std::shared_ptr<Thread>>& thread_list = arb_threads[arb_addr];
+void AddressArbiter::InsertThread(Thread* thread) {
+    wait_queues.Insert(thread);
+}
+
+void AddressArbiter::RemoveThread(Thread* thread) {
+    wait_queues.Remove(thread);
+}
+
+std::size_t AddressArbiter::GetWaitingThreadCount(VAddr address) const {
+    return wait_queues.Count(address);
+}
+
+ArbiterWaitQueues::ArbiterWaitQueues() : table(INITIAL_WAIT_QUEUE_SLOTS) {}
+ArbiterWaitQueues::~ArbiterWaitQueues() = default;
 
-    const auto iter =
-        std::find_if(thread_list.cbegin(), thread_list.cend(), [&thread](const auto& entry) {
-            return entry->GetPriority() >= thread->GetPriority();
-        });
+void ArbiterWaitQueues::Insert(Thread* thread) {
+    WaitQueue& queue = FindOrInsertQueue(thread->GetArbiterWaitAddress());
 
-    if (iter == thread_list.cend()) {
-        thread_list.push_back(std::move(thread));
+    Thread* previous = nullptr;
+    Thread* next = queue.head;
+    while (next != nullptr && next->GetPriority() < thread->GetPriority()) {
+        previous = next;
+        next = next->GetArbiterWaitNext();
+    }
+
+    thread->SetArbiterWaitPrevious(previous);
+    thread->SetArbiterWaitNext(next);
+    if (previous != nullptr) {
+        previous->SetArbiterWaitNext(thread);
     } else {
-        thread_list.insert(iter, std::move(thread));
+        queue.head = thread;
+    }
+    if (next != nullptr) {
+        next->SetArbiterWaitPrevious(thread);
     }
+    ++queue.size;
 }
 
-void AddressArbiter::RemoveThread(std::shared_ptr<Thread> thread) {
-    const VAddr arb_addr = thread->GetArbiterWaitAddress();
-    std::list<std::shared_ptr<Thread>>& thread_list = arb_threads[arb_addr];
+void ArbiterWaitQueues::Remove(Thread* thread) {
+    const std::size_t slot = FindQueue(thread->GetArbiterWaitAddress());
+    if (slot == table.size()) {
+        return;
+    }
+    WaitQueue& queue = table[slot];
 
-    const auto iter = std::find_if(thread_list.cbegin(), thread_list.cend(),
-                                   [&thread](const auto& entry) { return thread == entry; });
+    Thread* const previous = thread->GetArbiterWaitPrevious();
+    Thread* const next = thread->GetArbiterWaitNext();
+    if (previous == nullptr && queue.head != thread) {
+        // The thread is not in the queue
+        return;
+    }
 
-    if (iter != thread_list.cend()) {
-        thread_list.erase(iter);
+    if (previous != nullptr) {
+        previous->SetArbiterWaitNext(next);
+    } else {
+        queue.head = next;
     }
+    if (next != nullptr) {
+        next->SetArbiterWaitPrevious(previous);
+    }
+    thread->SetArbiterWaitPrevious(nullptr);
+    thread->SetArbiterWaitNext(nullptr);
+
+    if (--queue.size == 0) {
+        EraseQueue(slot);
+    }
+}
+
+Thread* ArbiterWaitQueues::Front(VAddr address) const {
+    const std::size_t slot = FindQueue(address);
+    return slot == table.size() ? nullptr : table[slot].head;
 }
 
-std::vector<std::shared_ptr<Thread>> AddressArbiter::GetThreadsWaitingOnAddress(
-    VAddr address) const {
-    const auto iter = arb_threads.find(address);
-    if (iter == arb_threads.cend()) {
-        return {};
+std::size_t ArbiterWaitQueues::Count(VAddr address) const {
+    const std::size_t slot = FindQueue(address);
+    return slot == table.size() ? 0 : table[slot].size;
+}
+
+std::size_t ArbiterWaitQueues::FindQueue(VAddr address) const {
+    // Unused slots are told apart by their size rather than their address, as any address
+    // including zero may be waited on
+    const std::size_t mask = table.size() - 1;
+    for (std::size_t slot = HashAddress(address, mask);; slot = (slot + 1) & mask) {
+        const WaitQueue& queue = table[slot];
+        if (queue.size == 0) {
+            return table.size();
+        }
+        if (queue.address == address) {
+            return slot;
+        }
     }
+}
 
-    const std::list<std::shared_ptr<Thread>>& thread_list = iter->second;
-    return {thread_list.cbegin(), thread_list.cend()};
+ArbiterWaitQueues::WaitQueue& ArbiterWaitQueues::FindOrInsertQueue(VAddr address) {
+    // Keep the table at most half full, so probe sequences stay short
+    if ((num_queues + 1) * 2 > table.size()) {
+        Rehash(table.size() * 2);
+    }
+
+    const std::size_t mask = table.size() - 1;
+    for (std::size_t slot = HashAddress(address, mask);; slot = (slot + 1) & mask) {
+        WaitQueue& queue = table[slot];
+        if (queue.size == 0) {
+            queue.address = address;
+            ++num_queues;
+            return queue;
+        }
+        if (queue.address == address) {
+            return queue;
+        }
+    }
 }
+
+void ArbiterWaitQueues::EraseQueue(std::size_t slot) {
+    // Shift back the following entries of the probe sequence instead of leaving a tombstone
+    const std::size_t mask = table.size() - 1;
+    std::size_t hole = slot;
+    for (std::size_t next = (hole + 1) & mask; table[next].size != 0; next = (next + 1) & mask) {
+        const std::size_t ideal = HashAddress(table[next].address, mask);
+        if (((next - ideal) & mask) >= ((next - hole) & mask)) {
+            table[hole] = table[next];
+            hole = next;
+        }
+    }
+    table[hole] = {};
+    --num_queues;
+}
+
+void ArbiterWaitQueues::Rehash(std::size_t new_size) {
+    std::vector<WaitQueue> old_table(new_size);
+    old_table.swap(table);
+
+    const std::size_t mask = new_size - 1;
+    for (const WaitQueue& queue : old_table) {
+        if (queue.size == 0) {
+            continue;
+        }
+        std::size_t slot = HashAddress(queue.address, mask);
+        while (table[slot].size != 0) {
+            slot = (slot + 1) & mask;
+        }
+        table[slot] = queue;
+    }
+}
+
 } // namespace Kernel
@@ -4,9 +4,7 @@
 
 #pragma once
 
-#include <list>
-#include <memory>
-#include <unordered_map>
+#include <cstddef>
 #include <vector>
 
 #include "common/common_types.h"
@@ -21,6 +19,54 @@ namespace Kernel {
 
 class Thread;
 
+/**
+ * Priority ordered queues of the threads waiting on each arbitration address. Threads are linked
+ * through their own arbiter wait links, and the queue heads live in an open addressing table keyed
+ * by address, so queueing and waking threads doesn't allocate unless the table grows.
+ */
+class ArbiterWaitQueues {
+public:
+    ArbiterWaitQueues();
+    ~ArbiterWaitQueues();
+
+    ArbiterWaitQueues(ArbiterWaitQueues&&) = default;
+    ArbiterWaitQueues& operator=(ArbiterWaitQueues&&) = default;
+
+    /// Queues a thread on its arbiter wait address, ahead of the threads with the same priority
+    void Insert(Thread* thread);
+
+    /// Removes a thread from the queue of its arbiter wait address, if it is queued
+    void Remove(Thread* thread);
+
+    /// Returns the thread with the highest priority waiting on an address, or null
+    Thread* Front(VAddr address) const;
+
+    /// Returns the number of threads waiting on an address
+    std::size_t Count(VAddr address) const;
+
+private:
+    struct WaitQueue {
+        VAddr address = 0;
+        Thread* head = nullptr;
+        std::size_t size = 0; ///< Number of threads in the queue, zero for unused table slots.
+    };
+
+    /// Finds the table slot of an address, returns the table size when no thread waits on it.
+    std::size_t FindQueue(VAddr address) const;
+
+    /// Finds the queue of an address, creating an empty one if it does not exist.
+    WaitQueue& FindOrInsertQueue(VAddr address);
+
+    /// Removes an empty queue from the table.
+    void EraseQueue(std::size_t slot);
+
+    /// Resizes the table, new_size must be a power of two.
+    void Rehash(std::size_t new_size);
+
+    std::vector<WaitQueue> table;
+    std::size_t num_queues = 0;
+};
+
 class AddressArbiter {
 public:
     enum class ArbitrationType {
@@ -51,7 +97,7 @@ public:
     ResultCode WaitForAddress(VAddr address, ArbitrationType type, s32 value, s64 timeout_ns);
 
     /// Removes a thread from the container and resets its address arbiter adress to 0
-    void HandleWakeupThread(std::shared_ptr<Thread> thread);
+    void HandleWakeupThread(Thread* thread);
 
 private:
     /// Signals an address being waited on.
@@ -73,20 +119,20 @@ private:
     /// Waits on an address if the value passed is equal to the argument value.
     ResultCode WaitForAddressIfEqual(VAddr address, s32 value, s64 timeout);
 
-    /// Wake up num_to_wake (or all) threads in a vector.
-    void WakeThreads(const std::vector<std::shared_ptr<Thread>>& waiting_threads, s32 num_to_wake);
+    /// Wake up num_to_wake (or all) threads waiting on an address.
+    void WakeThreads(VAddr address, s32 num_to_wake);
 
     /// Insert a thread into the address arbiter container
-    void InsertThread(std::shared_ptr<Thread> thread);
+    void InsertThread(Thread* thread);
 
     /// Removes a thread from the address arbiter container
-    void RemoveThread(std::shared_ptr<Thread> thread);
+    void RemoveThread(Thread* thread);
 
-    // Gets the threads waiting on an address.
-    std::vector<std::shared_ptr<Thread>> GetThreadsWaitingOnAddress(VAddr address) const;
+    /// Gets the number of threads waiting on an address.
+    std::size_t GetWaitingThreadCount(VAddr address) const;
 
-    /// List of threads waiting for a address arbiter
-    std::unordered_map<VAddr, std::list<std::shared_ptr<Thread>>> arb_threads;
+    /// Threads waiting for the address arbiter to be signaled
+    ArbiterWaitQueues wait_queues;
 
     Core::System& system;
 };
@@ -5,6 +5,7 @@
 #include "core/hle/kernel/client_session.h"
 #include "core/hle/kernel/errors.h"
 #include "core/hle/kernel/hle_ipc.h"
+#include "core/hle/kernel/object_slab.h"
 #include "core/hle/kernel/server_session.h"
 #include "core/hle/kernel/session.h"
 #include "core/hle/kernel/thread.h"
@@ -39,7 +40,8 @@ bool ClientSession::IsSignaled() const {
 ResultVal<std::shared_ptr<ClientSession>> ClientSession::Create(KernelCore& kernel,
                                                                 std::shared_ptr<Session> parent,
                                                                 std::string name) {
-    std::shared_ptr<ClientSession> client_session{std::make_shared<ClientSession>(kernel)};
+    std::shared_ptr<ClientSession> client_session{
+        MakeSlabObject<ClientSession, SessionSlabCount>(kernel)};
 
     client_session->name = std::move(name);
     client_session->parent = std::move(parent);
@@ -7,6 +7,7 @@
 #include <memory>
 #include <string>
 
+#include "core/hle/kernel/resource_limit.h"
 #include "core/hle/kernel/synchronization_object.h"
 #include "core/hle/result.h"
 
@@ -50,6 +51,11 @@ public:
 
     bool IsSignaled() const override;
 
+    /// Holds the session count reserved for the session until the client end is destroyed
+    void SetResourceReservation(ResourceReservation reservation) {
+        resource_reservation = std::move(reservation);
+    }
+
 private:
     static ResultVal<std::shared_ptr<ClientSession>> Create(KernelCore& kernel,
                                                             std::shared_ptr<Session> parent,
@@ -58,6 +64,8 @@ private:
     /// The parent session, which links to the server endpoint.
     std::shared_ptr<Session> parent;
 
+    ResourceReservation resource_reservation;
+
     /// Name of the client session (optional)
     std::string name;
 };
@@ -15,8 +15,8 @@
 
 namespace Kernel {
 namespace {
-constexpr u16 GetSlot(Handle handle) {
-    return static_cast<u16>(handle >> 15);
+constexpr u32 GetSlot(Handle handle) {
+    return handle >> 15;
 }
 
 constexpr u16 GetGeneration(Handle handle) {
@@ -24,15 +24,19 @@ constexpr u16 GetGeneration(Handle handle) {
 }
 } // Anonymous namespace
 
-HandleTable::HandleTable(KernelCore& kernel) : kernel{kernel} {
+HandleTable::HandleTable(KernelCore& kernel, std::size_t capacity)
+    : objects(capacity), generations(capacity), table_size{static_cast<u32>(capacity)},
+      kernel{kernel} {
+    ASSERT(capacity > 0 && capacity <= MAX_CAPACITY);
     Clear();
 }
 
 HandleTable::~HandleTable() = default;
 
 ResultCode HandleTable::SetSize(s32 handle_table_size) {
-    if (static_cast<u32>(handle_table_size) > MAX_COUNT) {
-        LOG_ERROR(Kernel, "Handle table size {} is greater than {}", handle_table_size, MAX_COUNT);
+    if (static_cast<u32>(handle_table_size) > GetCapacity()) {
+        LOG_ERROR(Kernel, "Handle table size {} is greater than {}", handle_table_size,
+                  GetCapacity());
         return ERR_OUT_OF_MEMORY;
     }
 
@@ -41,7 +45,7 @@ ResultCode HandleTable::SetSize(s32 handle_table_size) {
     // value in that case, since we assume this by default unless this function
     // is called.
     if (handle_table_size > 0) {
-        table_size = static_cast<u16>(handle_table_size);
+        table_size = static_cast<u32>(handle_table_size);
     }
 
     return RESULT_SUCCESS;
@@ -50,7 +54,7 @@ ResultCode HandleTable::SetSize(s32 handle_table_size) {
 ResultVal<Handle> HandleTable::Create(std::shared_ptr<Object> obj) {
     DEBUG_ASSERT(obj != nullptr);
 
-    const u16 slot = next_free_slot;
+    const u32 slot = next_free_slot;
     if (slot >= table_size) {
         LOG_ERROR(Kernel, "Unable to allocate Handle, too many slots in use.");
         return ERR_HANDLE_TABLE_FULL;
@@ -87,7 +91,7 @@ ResultCode HandleTable::Close(Handle handle) {
         return ERR_INVALID_HANDLE;
     }
 
-    const u16 slot = GetSlot(handle);
+    const u32 slot = GetSlot(handle);
 
     objects[slot] = nullptr;
 
@@ -117,7 +121,7 @@ std::shared_ptr<Object> HandleTable::GetGeneric(Handle handle) const {
 }
 
 void HandleTable::Clear() {
-    for (u16 i = 0; i < table_size; ++i) {
+    for (u32 i = 0; i < table_size; ++i) {
         generations[i] = i + 1;
         objects[i] = nullptr;
     }
@@ -4,9 +4,9 @@
 
 #pragma once
 
-#include <array>
 #include <cstddef>
 #include <memory>
+#include <vector>
 
 #include "common/common_types.h"
 #include "core/hle/kernel/object.h"
@@ -50,7 +50,18 @@ public:
     /// This is the maximum limit of handles allowed per process in Horizon
     static constexpr std::size_t MAX_COUNT = 1024;
 
-    explicit HandleTable(KernelCore& kernel);
+    /// Largest capacity addressable by the slot index bits of a handle
+    static constexpr std::size_t MAX_CAPACITY = std::size_t{1} << 17;
+
+    /**
+     * Creates a handle table.
+     *
+     * @param kernel   The kernel instance this handle table operates under.
+     * @param capacity Number of slots backing the table. Horizon limits processes to
+     *                 MAX_COUNT handles, but larger tables may be created for homebrew stress
+     *                 tests and kernel-global tables, up to MAX_CAPACITY.
+     */
+    explicit HandleTable(KernelCore& kernel, std::size_t capacity = MAX_COUNT);
     ~HandleTable();
 
     /**
@@ -63,10 +74,15 @@ public:
      *          If initialization was not successful, then ERR_OUT_OF_MEMORY
      *          will be returned.
      *
-     * @pre handle_table_size must be within the range [0, 1024]
+     * @pre handle_table_size must be within the range [0, capacity]
      */
     ResultCode SetSize(s32 handle_table_size);
 
+    /// Gets the number of slots backing this handle table.
+    std::size_t GetCapacity() const {
+        return objects.size();
+    }
+
     /**
      * Allocates a handle for the given object.
      * @return The created Handle or one of the following errors:
@@ -113,20 +129,20 @@ public:
 
 private:
     /// Stores the Object referenced by the handle or null if the slot is empty.
-    std::array<std::shared_ptr<Object>, MAX_COUNT> objects;
+    std::vector<std::shared_ptr<Object>> objects;
 
     /**
      * The value of `next_generation` when the handle was created, used to check for validity. For
      * empty slots, contains the index of the next free slot in the list.
      */
-    std::array<u16, MAX_COUNT> generations;
+    std::vector<u32> generations;
 
     /**
      * The limited size of the handle table. This can be specified by process
      * capabilities in order to restrict the overall number of handles that
      * can be created in a process instance
      */
-    u16 table_size = static_cast<u16>(MAX_COUNT);
+    u32 table_size;
 
     /**
      * Global counter of the number of created handles. Stored in `generations` when a handle is
@@ -135,7 +151,7 @@ private:
     u16 next_generation = 1;
 
     /// Head of the free slots linked list.
-    u16 next_free_slot = 0;
+    u32 next_free_slot = 0;
 
     /// Underlying kernel instance that this handle table operates under.
     KernelCore& kernel;
@@ -48,10 +48,14 @@ MICROPROFILE_DEFINE(Kernel_SVC, "Kernel", "SVC", MP_RGB(70, 200, 70));
 
 namespace Kernel {
 
+/// The global handle table holds every thread in the system, so it is not bound by the
+/// per-process handle limit.
+constexpr std::size_t GLOBAL_HANDLE_TABLE_CAPACITY = 0x4000;
+
 struct KernelCore::Impl {
     explicit Impl(Core::System& system, KernelCore& kernel)
         : global_scheduler{kernel}, synchronization{system}, time_manager{system},
-          global_handle_table{kernel}, system{system} {}
+          global_handle_table{kernel, GLOBAL_HANDLE_TABLE_CAPACITY}, system{system} {}
 
     void SetMulticore(bool is_multicore) {
         this->is_multicore = is_multicore;
@@ -255,7 +259,8 @@ struct KernelCore::Impl {
         constexpr PAddr time_addr{layout.System().StartAddress() + hid_size + font_size + irs_size};
 
         // Initialize memory manager
-        memory_manager = std::make_unique<Memory::MemoryManager>();
+        memory_manager = std::make_unique<Memory::MemoryManager>(
+            [this] { return GetCurrentHostThreadID(); });
         memory_manager->InitializeManager(Memory::MemoryManager::Pool::Application,
                                           layout.Application().StartAddress(),
                                           layout.Application().EndAddress());
@@ -485,6 +490,16 @@ void KernelCore::InvalidateAllInstructionCaches() {
     }
 }
 
+void KernelCore::InvalidateInstructionCacheRange(VAddr addr, std::size_t size) {
+    auto& threads = GlobalScheduler().GetThreadList();
+    for (auto& thread : threads) {
+        if (!thread->IsHLEThread()) {
+            auto& arm_interface = thread->ArmInterface();
+            arm_interface.InvalidateCacheRange(addr, size);
+        }
+    }
+}
+
 void KernelCore::PrepareReschedule(std::size_t id) {
     // TODO: Reimplement, this
 }
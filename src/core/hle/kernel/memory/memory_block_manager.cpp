@@ -10,20 +10,18 @@ namespace Kernel::Memory {
 MemoryBlockManager::MemoryBlockManager(VAddr start_addr, VAddr end_addr)
     : start_addr{start_addr}, end_addr{end_addr} {
     const u64 num_pages{(end_addr - start_addr) / PageSize};
-    memory_block_tree.emplace_back(start_addr, num_pages, MemoryState::Free, MemoryPermission::None,
-                                   MemoryAttribute::None);
+    const MemoryBlock block{start_addr, num_pages, MemoryState::Free, MemoryPermission::None,
+                            MemoryAttribute::None};
+    memory_block_tree.emplace(block.GetLastAddress(), block);
 }
 
 MemoryBlockManager::iterator MemoryBlockManager::FindIterator(VAddr addr) {
-    auto node{memory_block_tree.begin()};
-    while (node != end()) {
-        const VAddr end_addr{node->GetNumPages() * PageSize + node->GetAddress()};
-        if (node->GetAddress() <= addr && end_addr - 1 >= addr) {
-            return node;
-        }
-        node = std::next(node);
+    // The first block ending at or after the address is the only one that can contain it
+    const auto node{memory_block_tree.lower_bound(addr)};
+    if (node == memory_block_tree.end() || node->second.GetAddress() > addr) {
+        return end();
     }
-    return end();
+    return iterator{node};
 }
 
 VAddr MemoryBlockManager::FindFreeArea(VAddr region_start, std::size_t region_num_pages,
@@ -35,7 +33,7 @@ VAddr MemoryBlockManager::FindFreeArea(VAddr region_start, std::size_t region_nu
 
     const VAddr region_end{region_start + region_num_pages * PageSize};
     const VAddr region_last{region_end - 1};
-    for (auto it{FindIterator(region_start)}; it != memory_block_tree.cend(); it++) {
+    for (auto it{FindIterator(region_start)}; it != end(); it++) {
         const auto info{it->GetMemoryInfo()};
         if (region_last < info.GetAddress()) {
             break;
@@ -67,113 +65,28 @@ void MemoryBlockManager::Update(VAddr addr, std::size_t num_pages, MemoryState p
                                 MemoryPermission prev_perm, MemoryAttribute prev_attribute,
                                 MemoryState state, MemoryPermission perm,
                                 MemoryAttribute attribute) {
-    const VAddr end_addr{addr + num_pages * PageSize};
-    iterator node{memory_block_tree.begin()};
-
     prev_attribute |= MemoryAttribute::IpcAndDeviceMapped;
 
-    while (node != memory_block_tree.end()) {
-        MemoryBlock* block{&(*node)};
-        iterator next_node{std::next(node)};
-        const VAddr cur_addr{block->GetAddress()};
-        const VAddr cur_end_addr{block->GetNumPages() * PageSize + cur_addr};
-
-        if (addr < cur_end_addr && cur_addr < end_addr) {
-            if (!block->HasProperties(prev_state, prev_perm, prev_attribute)) {
-                node = next_node;
-                continue;
-            }
-
-            iterator new_node{node};
-            if (addr > cur_addr) {
-                memory_block_tree.insert(node, block->Split(addr));
-            }
-
-            if (end_addr < cur_end_addr) {
-                new_node = memory_block_tree.insert(node, block->Split(end_addr));
-            }
-
-            new_node->Update(state, perm, attribute);
-
-            MergeAdjacent(new_node, next_node);
-        }
-
-        if (cur_end_addr - 1 >= end_addr - 1) {
-            break;
-        }
-
-        node = next_node;
-    }
+    UpdateRange(
+        addr, num_pages,
+        [&](const MemoryBlock& block) {
+            return block.HasProperties(prev_state, prev_perm, prev_attribute);
+        },
+        [&](iterator block) { block->Update(state, perm, attribute); });
 }
 
 void MemoryBlockManager::Update(VAddr addr, std::size_t num_pages, MemoryState state,
                                 MemoryPermission perm, MemoryAttribute attribute) {
-    const VAddr end_addr{addr + num_pages * PageSize};
-    iterator node{memory_block_tree.begin()};
-
-    while (node != memory_block_tree.end()) {
-        MemoryBlock* block{&(*node)};
-        iterator next_node{std::next(node)};
-        const VAddr cur_addr{block->GetAddress()};
-        const VAddr cur_end_addr{block->GetNumPages() * PageSize + cur_addr};
-
-        if (addr < cur_end_addr && cur_addr < end_addr) {
-            iterator new_node{node};
-
-            if (addr > cur_addr) {
-                memory_block_tree.insert(node, block->Split(addr));
-            }
-
-            if (end_addr < cur_end_addr) {
-                new_node = memory_block_tree.insert(node, block->Split(end_addr));
-            }
-
-            new_node->Update(state, perm, attribute);
-
-            MergeAdjacent(new_node, next_node);
-        }
-
-        if (cur_end_addr - 1 >= end_addr - 1) {
-            break;
-        }
-
-        node = next_node;
-    }
+    UpdateRange(
+        addr, num_pages, [](const MemoryBlock&) { return true; },
+        [&](iterator block) { block->Update(state, perm, attribute); });
 }
 
 void MemoryBlockManager::UpdateLock(VAddr addr, std::size_t num_pages, LockFunc&& lock_func,
                                     MemoryPermission perm) {
-    const VAddr end_addr{addr + num_pages * PageSize};
-    iterator node{memory_block_tree.begin()};
-
-    while (node != memory_block_tree.end()) {
-        MemoryBlock* block{&(*node)};
-        iterator next_node{std::next(node)};
-        const VAddr cur_addr{block->GetAddress()};
-        const VAddr cur_end_addr{block->GetNumPages() * PageSize + cur_addr};
-
-        if (addr < cur_end_addr && cur_addr < end_addr) {
-            iterator new_node{node};
-
-            if (addr > cur_addr) {
-                memory_block_tree.insert(node, block->Split(addr));
-            }
-
-            if (end_addr < cur_end_addr) {
-                new_node = memory_block_tree.insert(node, block->Split(end_addr));
-            }
-
-            lock_func(new_node, perm);
-
-            MergeAdjacent(new_node, next_node);
-        }
-
-        if (cur_end_addr - 1 >= end_addr - 1) {
-            break;
-        }
-
-        node = next_node;
-    }
+    UpdateRange(
+        addr, num_pages, [](const MemoryBlock&) { return true; },
+        [&](iterator block) { lock_func(block, perm); });
 }
 
 void MemoryBlockManager::IterateForRange(VAddr start, VAddr end, IterateFunc&& func) {
@@ -186,37 +99,59 @@ void MemoryBlockManager::IterateForRange(VAddr start, VAddr end, IterateFunc&& f
     } while (info.addr + info.size - 1 < end - 1 && it != cend());
 }
 
-void MemoryBlockManager::MergeAdjacent(iterator it, iterator& next_it) {
-    MemoryBlock* block{&(*it)};
+template <typename Filter, typename Func>
+void MemoryBlockManager::UpdateRange(VAddr addr, std::size_t num_pages, Filter&& filter,
+                                     Func&& func) {
+    const VAddr update_end_addr{addr + num_pages * PageSize};
 
-    auto EraseIt = [&](const iterator it_to_erase) {
-        if (next_it == it_to_erase) {
-            next_it = std::next(next_it);
+    // Every block overlapping the range is visited once, merging waits until all were updated
+    for (iterator node{FindIterator(addr)};
+         node != end() && node->GetAddress() < update_end_addr; ++node) {
+        if (!filter(*node)) {
+            continue;
         }
-        memory_block_tree.erase(it_to_erase);
-    };
-
-    if (it != memory_block_tree.begin()) {
-        MemoryBlock* prev{&(*std::prev(it))};
 
-        if (block->HasSameProperties(*prev)) {
-            const iterator prev_it{std::prev(it)};
-
-            prev->Add(block->GetNumPages());
-            EraseIt(it);
+        if (addr > node->GetAddress()) {
+            InsertBlock(node, node->Split(addr));
+        }
 
-            it = prev_it;
-            block = prev;
+        if (update_end_addr < node->GetEndAddress()) {
+            func(InsertBlock(node, node->Split(update_end_addr)));
+            break;
         }
+
+        func(node);
     }
 
-    if (it != cend()) {
-        const MemoryBlock* const next{&(*std::next(it))};
+    MergeAdjacent(addr, update_end_addr);
+}
+
+MemoryBlockManager::iterator MemoryBlockManager::InsertBlock(iterator hint,
+                                                             const MemoryBlock& block) {
+    return iterator{memory_block_tree.emplace_hint(hint.Base(), block.GetLastAddress(), block)};
+}
+
+void MemoryBlockManager::MergeAdjacent(VAddr addr, VAddr end_addr) {
+    iterator it{FindIterator(addr)};
+    if (it == end()) {
+        return;
+    }
+    if (it != begin()) {
+        --it;
+    }
 
-        if (block->HasSameProperties(*next)) {
-            block->Add(next->GetNumPages());
-            EraseIt(std::next(it));
+    // Merged blocks are absorbed by the block after them, whose last address doesn't change
+    for (iterator next_it{std::next(it)}; next_it != end(); next_it = std::next(it)) {
+        const VAddr next_addr{next_it->GetAddress()};
+        if (it->HasSameProperties(*next_it)) {
+            next_it->addr = it->GetAddress();
+            next_it->num_pages += it->GetNumPages();
+            memory_block_tree.erase(it.Base());
+        }
+        if (next_addr >= end_addr) {
+            break;
         }
+        it = next_it;
     }
 }
 
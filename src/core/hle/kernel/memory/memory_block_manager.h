@@ -4,8 +4,11 @@
 
 #pragma once
 
+#include <cstddef>
 #include <functional>
-#include <list>
+#include <iterator>
+#include <map>
+#include <type_traits>
 
 #include "common/common_types.h"
 #include "core/hle/kernel/memory/memory_block.h"
@@ -14,21 +17,92 @@ namespace Kernel::Memory {
 
 class MemoryBlockManager final {
 public:
-    using MemoryBlockTree = std::list<MemoryBlock>;
-    using iterator = MemoryBlockTree::iterator;
-    using const_iterator = MemoryBlockTree::const_iterator;
+    /**
+     * Blocks keyed by their last address. Splitting a block and merging a block into the one after
+     * it keep the last address of the surviving block, so blocks are updated in place.
+     */
+    using MemoryBlockTree = std::map<VAddr, MemoryBlock>;
+
+    /// Iterator over the blocks of the tree in address order, dereferencing to the block
+    template <typename TreeIterator>
+    class BlockIterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = MemoryBlock;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<
+            std::is_same_v<TreeIterator, MemoryBlockTree::const_iterator>, const MemoryBlock&,
+            MemoryBlock&>;
+        using pointer = std::remove_reference_t<reference>*;
+
+        BlockIterator() = default;
+        explicit BlockIterator(TreeIterator it) : it{it} {}
+
+        /// Allows converting iterators to const_iterators
+        template <typename OtherIterator>
+        BlockIterator(const BlockIterator<OtherIterator>& other) : it{other.Base()} {}
+
+        reference operator*() const {
+            return it->second;
+        }
+        pointer operator->() const {
+            return &it->second;
+        }
+
+        BlockIterator& operator++() {
+            ++it;
+            return *this;
+        }
+        BlockIterator operator++(int) {
+            return BlockIterator{it++};
+        }
+        BlockIterator& operator--() {
+            --it;
+            return *this;
+        }
+        BlockIterator operator--(int) {
+            return BlockIterator{it--};
+        }
+
+        bool operator==(const BlockIterator& other) const {
+            return it == other.it;
+        }
+        bool operator!=(const BlockIterator& other) const {
+            return it != other.it;
+        }
+
+        TreeIterator Base() const {
+            return it;
+        }
+
+    private:
+        TreeIterator it{};
+    };
+
+    using iterator = BlockIterator<MemoryBlockTree::iterator>;
+    using const_iterator = BlockIterator<MemoryBlockTree::const_iterator>;
 
 public:
     MemoryBlockManager(VAddr start_addr, VAddr end_addr);
 
+    iterator begin() {
+        return iterator{memory_block_tree.begin()};
+    }
+    const_iterator begin() const {
+        return const_iterator{memory_block_tree.begin()};
+    }
     iterator end() {
-        return memory_block_tree.end();
+        return iterator{memory_block_tree.end()};
     }
     const_iterator end() const {
-        return memory_block_tree.end();
+        return const_iterator{memory_block_tree.end()};
     }
     const_iterator cend() const {
-        return memory_block_tree.cend();
+        return const_iterator{memory_block_tree.cend()};
+    }
+
+    std::size_t GetNumBlocks() const {
+        return memory_block_tree.size();
     }
 
     iterator FindIterator(VAddr addr);
@@ -55,7 +129,13 @@ public:
     }
 
 private:
-    void MergeAdjacent(iterator it, iterator& next_it);
+    /// Applies `func` to the blocks overlapping a range that pass `filter`, splitting them at the
+    /// bounds of the range and merging the results with their neighbours
+    template <typename Filter, typename Func>
+    void UpdateRange(VAddr addr, std::size_t num_pages, Filter&& filter, Func&& func);
+
+    iterator InsertBlock(iterator hint, const MemoryBlock& block);
+    void MergeAdjacent(VAddr addr, VAddr end_addr);
 
     const VAddr start_addr;
     const VAddr end_addr;
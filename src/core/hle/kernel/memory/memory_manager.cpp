@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <utility>
 
 #include "common/alignment.h"
 #include "common/assert.h"
@@ -41,11 +42,145 @@ std::size_t MemoryManager::Impl::Initialize(Pool new_pool, u64 start_address, u6
     return total_metadata_size;
 }
 
+MemoryManager::MemoryManager(CoreIndexGetter get_core_index)
+    : get_core_index{std::move(get_core_index)} {}
+
 void MemoryManager::InitializeManager(Pool pool, u64 start_address, u64 end_address) {
     ASSERT(pool < Pool::Count);
     managers[static_cast<std::size_t>(pool)].Initialize(pool, start_address, end_address);
 }
 
+MemoryManager::Statistics MemoryManager::GetStatistics(Pool pool) const {
+    const PoolStatistics& stats{statistics[static_cast<std::size_t>(pool)]};
+    return {
+        .cached_allocations = stats.cached_allocations.load(std::memory_order_relaxed),
+        .heap_allocations = stats.heap_allocations.load(std::memory_order_relaxed),
+        .cached_frees = stats.cached_frees.load(std::memory_order_relaxed),
+        .heap_frees = stats.heap_frees.load(std::memory_order_relaxed),
+        .refills = stats.refills.load(std::memory_order_relaxed),
+        .flushes = stats.flushes.load(std::memory_order_relaxed),
+        .drains = stats.drains.load(std::memory_order_relaxed),
+    };
+}
+
+MemoryManager::CoreCache& MemoryManager::GetCoreCache(std::size_t pool_index) {
+    const std::size_t core_index{get_core_index ? get_core_index()
+                                                : Core::Hardware::NUM_CPU_CORES};
+    return core_caches[pool_index][std::min<std::size_t>(core_index,
+                                                         Core::Hardware::NUM_CPU_CORES)];
+}
+
+VAddr MemoryManager::AllocateBlock(std::size_t pool_index, CoreCache& cache, s32 index) {
+    Impl& chosen_manager{managers[pool_index]};
+    PoolStatistics& stats{statistics[pool_index]};
+
+    // Small blocks come from the magazine of the current core, without walking the heap bitmaps
+    if (index >= 0 && index < static_cast<s32>(NumCachedBlockSizes)) {
+        std::lock_guard cache_lock{cache.lock};
+        Magazine& magazine{cache.magazines[index]};
+        if (magazine.count == 0) {
+            // Refill half of the magazine in a single visit to the heap
+            const std::size_t batch_size{MagazineCapacities[index] / 2};
+            {
+                std::lock_guard lock{pool_locks[pool_index]};
+                while (magazine.count < batch_size) {
+                    const VAddr block{chosen_manager.AllocateBlock(index)};
+                    if (!block) {
+                        break;
+                    }
+                    magazine.blocks[magazine.count++] = block;
+                }
+            }
+            if (magazine.count != 0) {
+                // Hand out the lowest addresses first, keeping consecutive allocations contiguous
+                std::reverse(magazine.blocks.begin(), magazine.blocks.begin() + magazine.count);
+                stats.refills.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        if (magazine.count != 0) {
+            stats.cached_allocations.fetch_add(1, std::memory_order_relaxed);
+            return magazine.blocks[--magazine.count];
+        }
+    }
+
+    {
+        std::lock_guard lock{pool_locks[pool_index]};
+        if (const VAddr block{chosen_manager.AllocateBlock(index)}; block) {
+            stats.heap_allocations.fetch_add(1, std::memory_order_relaxed);
+            return block;
+        }
+    }
+
+    // Blocks cached by the magazines are still free memory, return them to the heap and retry
+    DrainMagazines(pool_index);
+
+    std::lock_guard lock{pool_locks[pool_index]};
+    const VAddr block{chosen_manager.AllocateBlock(index)};
+    if (block) {
+        stats.heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    return block;
+}
+
+void MemoryManager::FreeBlocks(std::size_t pool_index, CoreCache& cache, VAddr addr,
+                               std::size_t num_pages) {
+    // Ranges up to a 64 KiB block are cached, larger ones go straight back to the heap
+    constexpr std::size_t large_block_pages{PageHeap::GetBlockNumPages(1)};
+    if (num_pages <= large_block_pages) {
+        std::lock_guard cache_lock{cache.lock};
+        if (num_pages == large_block_pages &&
+            Common::IsAligned(addr, PageHeap::GetBlockSize(1))) {
+            FreeToMagazine(pool_index, cache, addr, 1);
+            return;
+        }
+        for (std::size_t page = 0; page < num_pages; page++) {
+            FreeToMagazine(pool_index, cache, addr + page * PageSize, 0);
+        }
+        return;
+    }
+
+    std::lock_guard lock{pool_locks[pool_index]};
+    managers[pool_index].Free(addr, num_pages);
+    statistics[pool_index].heap_frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MemoryManager::FreeToMagazine(std::size_t pool_index, CoreCache& cache, VAddr block,
+                                   s32 index) {
+    PoolStatistics& stats{statistics[pool_index]};
+    Magazine& magazine{cache.magazines[index]};
+    if (magazine.count == MagazineCapacities[index]) {
+        // Flush the oldest half of the magazine in a single visit to the heap
+        const std::size_t batch_size{MagazineCapacities[index] / 2};
+        {
+            std::lock_guard lock{pool_locks[pool_index]};
+            for (std::size_t i = 0; i < batch_size; i++) {
+                managers[pool_index].Free(magazine.blocks[i], PageHeap::GetBlockNumPages(index));
+            }
+        }
+        std::move(magazine.blocks.begin() + batch_size,
+                  magazine.blocks.begin() + magazine.count, magazine.blocks.begin());
+        magazine.count -= batch_size;
+        stats.flushes.fetch_add(1, std::memory_order_relaxed);
+    }
+    magazine.blocks[magazine.count++] = block;
+    stats.cached_frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MemoryManager::DrainMagazines(std::size_t pool_index) {
+    for (CoreCache& cache : core_caches[pool_index]) {
+        std::lock_guard cache_lock{cache.lock};
+        std::lock_guard lock{pool_locks[pool_index]};
+        for (std::size_t index = 0; index < NumCachedBlockSizes; index++) {
+            Magazine& magazine{cache.magazines[index]};
+            for (std::size_t i = 0; i < magazine.count; i++) {
+                managers[pool_index].Free(magazine.blocks[i], PageHeap::GetBlockNumPages(index));
+            }
+            magazine.count = 0;
+        }
+    }
+    statistics[pool_index].drains.fetch_add(1, std::memory_order_relaxed);
+}
+
 VAddr MemoryManager::AllocateContinuous(std::size_t num_pages, std::size_t align_pages, Pool pool,
                                         Direction dir) {
     // Early return if we're allocating no pages
@@ -53,17 +188,14 @@ VAddr MemoryManager::AllocateContinuous(std::size_t num_pages, std::size_t align
         return {};
     }
 
-    // Lock the pool that we're allocating from
-    const auto pool_index{static_cast<std::size_t>(pool)};
-    std::lock_guard lock{pool_locks[pool_index]};
-
     // Choose a heap based on our page size request
+    const auto pool_index{static_cast<std::size_t>(pool)};
     const s32 heap_index{PageHeap::GetAlignedBlockIndex(num_pages, align_pages)};
 
     // Loop, trying to iterate from each block
     // TODO (bunnei): Support multiple managers
-    Impl& chosen_manager{managers[pool_index]};
-    VAddr allocated_block{chosen_manager.AllocateBlock(heap_index)};
+    CoreCache& cache{GetCoreCache(pool_index)};
+    VAddr allocated_block{AllocateBlock(pool_index, cache, heap_index)};
 
     // If we failed to allocate, quit now
     if (!allocated_block) {
@@ -73,7 +205,8 @@ VAddr MemoryManager::AllocateContinuous(std::size_t num_pages, std::size_t align
     // If we allocated more than we need, free some
     const auto allocated_pages{PageHeap::GetBlockNumPages(heap_index)};
     if (allocated_pages > num_pages) {
-        chosen_manager.Free(allocated_block + num_pages * PageSize, allocated_pages - num_pages);
+        FreeBlocks(pool_index, cache, allocated_block + num_pages * PageSize,
+                   allocated_pages - num_pages);
     }
 
     return allocated_block;
@@ -88,11 +221,8 @@ ResultCode MemoryManager::Allocate(PageLinkedList& page_list, std::size_t num_pa
         return RESULT_SUCCESS;
     }
 
-    // Lock the pool that we're allocating from
-    const auto pool_index{static_cast<std::size_t>(pool)};
-    std::lock_guard lock{pool_locks[pool_index]};
-
     // Choose a heap based on our page size request
+    const auto pool_index{static_cast<std::size_t>(pool)};
     const s32 heap_index{PageHeap::GetBlockIndex(num_pages)};
     if (heap_index < 0) {
         return ERR_OUT_OF_MEMORY;
@@ -100,13 +230,14 @@ ResultCode MemoryManager::Allocate(PageLinkedList& page_list, std::size_t num_pa
 
     // TODO (bunnei): Support multiple managers
     Impl& chosen_manager{managers[pool_index]};
+    CoreCache& cache{GetCoreCache(pool_index)};
 
     // Ensure that we don't leave anything un-freed
     auto group_guard = detail::ScopeExit([&] {
         for (const auto& it : page_list.Nodes()) {
             const auto min_num_pages{std::min<size_t>(
                 it.GetNumPages(), (chosen_manager.GetEndAddress() - it.GetAddress()) / PageSize)};
-            chosen_manager.Free(it.GetAddress(), min_num_pages);
+            FreeBlocks(pool_index, cache, it.GetAddress(), min_num_pages);
         }
     });
 
@@ -116,7 +247,7 @@ ResultCode MemoryManager::Allocate(PageLinkedList& page_list, std::size_t num_pa
 
         while (num_pages >= pages_per_alloc) {
             // Allocate a block
-            VAddr allocated_block{chosen_manager.AllocateBlock(index)};
+            VAddr allocated_block{AllocateBlock(pool_index, cache, index)};
             if (!allocated_block) {
                 break;
             }
@@ -124,7 +255,7 @@ ResultCode MemoryManager::Allocate(PageLinkedList& page_list, std::size_t num_pa
             // Safely add it to our group
             {
                 auto block_guard = detail::ScopeExit(
-                    [&] { chosen_manager.Free(allocated_block, pages_per_alloc); });
+                    [&] { FreeBlocks(pool_index, cache, allocated_block, pages_per_alloc); });
 
                 if (const ResultCode result{page_list.AddBlock(allocated_block, pages_per_alloc)};
                     result.IsError()) {
@@ -155,18 +286,16 @@ ResultCode MemoryManager::Free(PageLinkedList& page_list, std::size_t num_pages,
         return RESULT_SUCCESS;
     }
 
-    // Lock the pool that we're freeing from
-    const auto pool_index{static_cast<std::size_t>(pool)};
-    std::lock_guard lock{pool_locks[pool_index]};
-
     // TODO (bunnei): Support multiple managers
+    const auto pool_index{static_cast<std::size_t>(pool)};
     Impl& chosen_manager{managers[pool_index]};
+    CoreCache& cache{GetCoreCache(pool_index)};
 
     // Free all of the pages
     for (const auto& it : page_list.Nodes()) {
         const auto min_num_pages{std::min<size_t>(
             it.GetNumPages(), (chosen_manager.GetEndAddress() - it.GetAddress()) / PageSize)};
-        chosen_manager.Free(it.GetAddress(), min_num_pages);
+        FreeBlocks(pool_index, cache, it.GetAddress(), min_num_pages);
     }
 
     return RESULT_SUCCESS;
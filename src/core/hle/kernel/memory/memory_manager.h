@@ -5,9 +5,13 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <functional>
 #include <mutex>
 
 #include "common/common_types.h"
+#include "common/spin_lock.h"
+#include "core/hardware_properties.h"
 #include "core/hle/kernel/memory/page_heap.h"
 #include "core/hle/result.h"
 
@@ -37,12 +41,29 @@ public:
         Mask = (0xF << Shift),
     };
 
+    /// Allocation counters of a pool
+    struct Statistics {
+        u64 cached_allocations{}; ///< Small blocks allocated from a magazine
+        u64 heap_allocations{};   ///< Blocks allocated from the page heap
+        u64 cached_frees{};       ///< Small blocks freed to a magazine
+        u64 heap_frees{};         ///< Ranges freed to the page heap
+        u64 refills{};            ///< Batches of blocks moved from the page heap to a magazine
+        u64 flushes{};            ///< Batches of blocks moved from a magazine to the page heap
+        u64 drains{};             ///< Times the magazines were emptied to satisfy an allocation
+    };
+
+    /// Returns the index of the CPU core of the calling thread, or an invalid index outside of them
+    using CoreIndexGetter = std::function<u32()>;
+
     MemoryManager() = default;
+    explicit MemoryManager(CoreIndexGetter get_core_index);
 
     constexpr std::size_t GetSize(Pool pool) const {
         return managers[static_cast<std::size_t>(pool)].GetSize();
     }
 
+    Statistics GetStatistics(Pool pool) const;
+
     void InitializeManager(Pool pool, u64 start_address, u64 end_address);
     VAddr AllocateContinuous(std::size_t num_pages, std::size_t align_pages, Pool pool,
                              Direction dir = Direction::FromFront);
@@ -88,9 +109,46 @@ private:
         }
     };
 
+    static constexpr std::size_t NumPools{static_cast<std::size_t>(Pool::Count)};
+
+    /// Block sizes cached by the magazines, 4 KiB and 64 KiB
+    static constexpr std::size_t NumCachedBlockSizes{2};
+    static constexpr std::array<std::size_t, NumCachedBlockSizes> MagazineCapacities{128, 16};
+
+    /// Stack of free blocks of a single size, refilled and flushed by half its capacity
+    struct Magazine {
+        std::array<VAddr, MagazineCapacities[0]> blocks{};
+        std::size_t count{};
+    };
+
+    /// Magazines of a CPU core, the last ones are shared by threads outside of the cores
+    struct alignas(64) CoreCache {
+        Common::SpinLock lock;
+        std::array<Magazine, NumCachedBlockSizes> magazines;
+    };
+
+    struct PoolStatistics {
+        std::atomic<u64> cached_allocations{};
+        std::atomic<u64> heap_allocations{};
+        std::atomic<u64> cached_frees{};
+        std::atomic<u64> heap_frees{};
+        std::atomic<u64> refills{};
+        std::atomic<u64> flushes{};
+        std::atomic<u64> drains{};
+    };
+
+    CoreCache& GetCoreCache(std::size_t pool_index);
+    VAddr AllocateBlock(std::size_t pool_index, CoreCache& cache, s32 index);
+    void FreeBlocks(std::size_t pool_index, CoreCache& cache, VAddr addr, std::size_t num_pages);
+    void FreeToMagazine(std::size_t pool_index, CoreCache& cache, VAddr block, s32 index);
+    void DrainMagazines(std::size_t pool_index);
+
 private:
-    std::array<std::mutex, static_cast<std::size_t>(Pool::Count)> pool_locks;
+    std::array<std::mutex, NumPools> pool_locks;
     std::array<Impl, MaxManagerCount> managers;
+    std::array<std::array<CoreCache, Core::Hardware::NUM_CPU_CORES + 1>, NumPools> core_caches;
+    std::array<PoolStatistics, NumPools> statistics;
+    CoreIndexGetter get_core_index;
 };
 
 } // namespace Kernel::Memory
@@ -0,0 +1,190 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+
+#include "common/common_types.h"
+#include "common/spin_lock.h"
+#include "core/hle/kernel/memory/slab_heap.h"
+
+namespace Kernel {
+
+/// Number of objects of each type Horizon reserves slab memory for
+constexpr std::size_t ThreadSlabCount{800};
+constexpr std::size_t EventSlabCount{700};
+constexpr std::size_t SessionSlabCount{933};
+constexpr std::size_t SharedMemorySlabCount{80};
+
+namespace impl {
+
+/**
+ * Fixed number of slots for objects of one type, created on first use. Slabs are never destroyed,
+ * as objects may be released after the kernel that created them, even by the destructors of other
+ * statics like the system instance. When every slot is in use, objects are allocated from the
+ * global heap instead.
+ *
+ * Each host thread caches a few free slots, so objects created and destroyed by the same thread
+ * don't touch the shared free list.
+ */
+template <typename T, std::size_t Count>
+class ObjectSlab final : NonCopyable {
+public:
+    static ObjectSlab& Get() {
+        static ObjectSlab& slab = *new ObjectSlab;
+        return slab;
+    }
+
+    void* Allocate() {
+        Magazine& magazine{GetMagazine()};
+        if (magazine.count == 0) {
+            Refill(magazine);
+        }
+        if (magazine.count != 0) {
+            return magazine.slots[--magazine.count];
+        }
+        overflow_count.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(sizeof(T), std::align_val_t{alignof(T)});
+    }
+
+    void Free(void* obj) {
+        if (!Contains(obj)) {
+            ::operator delete(obj, std::align_val_t{alignof(T)});
+            return;
+        }
+        Magazine& magazine{GetMagazine()};
+        if (magazine.count == MagazineSize) {
+            Flush(magazine, MagazineSize / 2);
+        }
+        magazine.slots[magazine.count++] = obj;
+    }
+
+    bool Contains(const void* obj) const {
+        return heap.Contains(reinterpret_cast<uintptr_t>(obj));
+    }
+
+    /// Number of objects that didn't fit in the slab
+    std::size_t GetOverflowCount() const {
+        return overflow_count.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr std::size_t MagazineSize = 16;
+
+    struct Slot {
+        alignas(T) u8 data[sizeof(T)];
+    };
+
+    /// Free slots cached by a host thread, returned to the slab when the thread exits
+    struct Magazine {
+        explicit Magazine(ObjectSlab& slab) : slab{slab} {}
+        ~Magazine() {
+            slab.Flush(*this, count);
+        }
+
+        ObjectSlab& slab;
+        std::array<void*, MagazineSize> slots{};
+        std::size_t count{};
+    };
+
+    ObjectSlab() : storage{std::make_unique<Slot[]>(Count)} {
+        heap.InitializeImpl(sizeof(Slot), storage.get(), sizeof(Slot) * Count);
+    }
+
+    Magazine& GetMagazine() {
+        static thread_local Magazine magazine{*this};
+        return magazine;
+    }
+
+    void Refill(Magazine& magazine) {
+        std::scoped_lock lock{guard};
+        while (magazine.count < MagazineSize / 2) {
+            void* const obj{heap.AllocateImpl()};
+            if (obj == nullptr) {
+                break;
+            }
+            magazine.slots[magazine.count++] = obj;
+        }
+    }
+
+    void Flush(Magazine& magazine, std::size_t num_slots) {
+        std::scoped_lock lock{guard};
+        for (std::size_t i = 0; i < num_slots; ++i) {
+            heap.FreeImpl(magazine.slots[--magazine.count]);
+        }
+    }
+
+    // The free list of the slab heap is exposed to ABA when popped concurrently
+    Common::SpinLock guard;
+    Memory::SlabHeapBase heap;
+    std::unique_ptr<Slot[]> storage;
+    std::atomic<std::size_t> overflow_count{};
+};
+
+} // namespace impl
+
+/**
+ * Allocator of the slab of a kernel object type. Used through std::allocate_shared, it places the
+ * object and its reference counts in a single slab slot.
+ */
+template <typename T, std::size_t Count>
+class SlabAllocator {
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = SlabAllocator<U, Count>;
+    };
+
+    SlabAllocator() = default;
+
+    template <typename U>
+    SlabAllocator(const SlabAllocator<U, Count>&) {}
+
+    T* allocate(std::size_t n) {
+        if (n != 1) {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+        }
+        return static_cast<T*>(impl::ObjectSlab<T, Count>::Get().Allocate());
+    }
+
+    void deallocate(T* obj, std::size_t n) {
+        if (n != 1) {
+            ::operator delete(obj, std::align_val_t{alignof(T)});
+            return;
+        }
+        impl::ObjectSlab<T, Count>::Get().Free(obj);
+    }
+
+    template <typename U>
+    bool operator==(const SlabAllocator<U, Count>&) const {
+        return true;
+    }
+    template <typename U>
+    bool operator!=(const SlabAllocator<U, Count>&) const {
+        return false;
+    }
+};
+
+/**
+ * Creates a kernel object in the slab of its type
+ * @tparam T Type of the object
+ * @tparam Count Number of objects of the type the slab holds
+ * @param args Arguments passed to the constructor of the object
+ * @return A shared pointer to the newly created object
+ */
+template <typename T, std::size_t Count, typename... Args>
+std::shared_ptr<T> MakeSlabObject(Args&&... args) {
+    return std::allocate_shared<T>(SlabAllocator<T, Count>{}, std::forward<Args>(args)...);
+}
+
+} // namespace Kernel
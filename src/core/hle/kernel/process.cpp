@@ -111,10 +111,11 @@ private:
     std::bitset<num_slot_entries> is_slot_used;
 };
 
-std::shared_ptr<Process> Process::Create(Core::System& system, std::string name, ProcessType type) {
+std::shared_ptr<Process> Process::Create(Core::System& system, std::string name, ProcessType type,
+                                         std::size_t handle_table_capacity) {
     auto& kernel = system.Kernel();
 
-    std::shared_ptr<Process> process = std::make_shared<Process>(system);
+    std::shared_ptr<Process> process = std::make_shared<Process>(system, handle_table_capacity);
     process->name = std::move(name);
     process->resource_limit = ResourceLimit::Create(kernel);
     process->status = ProcessStatus::Created;
@@ -405,10 +406,11 @@ void Process::LoadModule(CodeSet code_set, VAddr base_addr) {
     ReprotectSegment(code_set.DataSegment(), Memory::MemoryPermission::ReadAndWrite);
 }
 
-Process::Process(Core::System& system)
+Process::Process(Core::System& system, std::size_t handle_table_capacity)
     : SynchronizationObject{system.Kernel()}, page_table{std::make_unique<Memory::PageTable>(
                                                   system)},
-      handle_table{system.Kernel()}, address_arbiter{system}, mutex{system}, system{system} {}
+      handle_table{system.Kernel(), handle_table_capacity}, address_arbiter{system}, mutex{system},
+      system{system} {}
 
 Process::~Process() = default;
 
@@ -65,7 +65,7 @@ enum class ProcessStatus {
 
 class Process final : public SynchronizationObject {
 public:
-    explicit Process(Core::System& system);
+    explicit Process(Core::System& system, std::size_t handle_table_capacity);
     ~Process() override;
 
     enum : u64 {
@@ -88,8 +88,14 @@ public:
 
     static constexpr std::size_t RANDOM_ENTROPY_SIZE = 4;
 
-    static std::shared_ptr<Process> Create(Core::System& system, std::string name,
-                                           ProcessType type);
+    /**
+     * Creates a process.
+     * @param handle_table_capacity Number of handles the process may hold. Horizon limits it to
+     *                              HandleTable::MAX_COUNT, homebrew stress tests may use more.
+     */
+    static std::shared_ptr<Process> Create(
+        Core::System& system, std::string name, ProcessType type,
+        std::size_t handle_table_capacity = HandleTable::MAX_COUNT);
 
     std::string GetTypeName() const override {
         return "Process";
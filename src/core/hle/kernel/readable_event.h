@@ -18,6 +18,7 @@ class ReadableEvent final : public SynchronizationObject {
     friend class WritableEvent;
 
 public:
+    explicit ReadableEvent(KernelCore& kernel);
     ~ReadableEvent() override;
 
     std::string GetTypeName() const override {
@@ -49,8 +50,6 @@ public:
     void Signal() override;
 
 private:
-    explicit ReadableEvent(KernelCore& kernel);
-
     std::string name; ///< Name of event (optional)
 };
 
@@ -70,4 +70,36 @@ ResultCode ResourceLimit::SetLimitValue(ResourceType resource, s64 value) {
         return ERR_INVALID_STATE;
     }
 }
+
+ResourceReservation::ResourceReservation(std::shared_ptr<ResourceLimit> limit_,
+                                         ResourceType resource)
+    : resource{resource} {
+    if (limit_->Reserve(resource, 1)) {
+        limit = std::move(limit_);
+    }
+}
+
+ResourceReservation::~ResourceReservation() {
+    Release();
+}
+
+ResourceReservation::ResourceReservation(ResourceReservation&& other) noexcept
+    : limit{std::move(other.limit)}, resource{other.resource} {}
+
+ResourceReservation& ResourceReservation::operator=(ResourceReservation&& other) noexcept {
+    if (this != &other) {
+        Release();
+        limit = std::move(other.limit);
+        resource = other.resource;
+    }
+    return *this;
+}
+
+void ResourceReservation::Release() {
+    if (limit) {
+        limit->Release(resource, 1);
+        limit.reset();
+    }
+}
+
 } // namespace Kernel
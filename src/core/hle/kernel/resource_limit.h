@@ -101,4 +101,32 @@ private:
     ResourceArray available{};
 };
 
+/**
+ * One unit of a resource reserved from a limit on behalf of an object. The unit is released back
+ * to the limit when the reservation is destroyed, along with the object holding it.
+ */
+class ResourceReservation final {
+public:
+    ResourceReservation() = default;
+    ResourceReservation(std::shared_ptr<ResourceLimit> limit, ResourceType resource);
+    ~ResourceReservation();
+
+    ResourceReservation(const ResourceReservation&) = delete;
+    ResourceReservation& operator=(const ResourceReservation&) = delete;
+
+    ResourceReservation(ResourceReservation&& other) noexcept;
+    ResourceReservation& operator=(ResourceReservation&& other) noexcept;
+
+    /// Whether the limit had room for the resource
+    bool Succeeded() const {
+        return limit != nullptr;
+    }
+
+private:
+    void Release();
+
+    std::shared_ptr<ResourceLimit> limit;
+    ResourceType resource{};
+};
+
 } // namespace Kernel
@@ -16,6 +16,7 @@
 #include "core/hle/kernel/handle_table.h"
 #include "core/hle/kernel/hle_ipc.h"
 #include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/object_slab.h"
 #include "core/hle/kernel/process.h"
 #include "core/hle/kernel/scheduler.h"
 #include "core/hle/kernel/server_session.h"
@@ -31,7 +32,7 @@ ServerSession::~ServerSession() = default;
 ResultVal<std::shared_ptr<ServerSession>> ServerSession::Create(KernelCore& kernel,
                                                                 std::shared_ptr<Session> parent,
                                                                 std::string name) {
-    std::shared_ptr<ServerSession> session{std::make_shared<ServerSession>(kernel)};
+    std::shared_ptr<ServerSession> session{MakeSlabObject<ServerSession, SessionSlabCount>(kernel)};
 
     session->request_event =
         Core::Timing::CreateEvent(name, [session](std::uintptr_t, std::chrono::nanoseconds) {
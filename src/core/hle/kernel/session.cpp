@@ -4,6 +4,7 @@
 
 #include "common/assert.h"
 #include "core/hle/kernel/client_session.h"
+#include "core/hle/kernel/object_slab.h"
 #include "core/hle/kernel/server_session.h"
 #include "core/hle/kernel/session.h"
 
@@ -13,7 +14,7 @@ Session::Session(KernelCore& kernel) : SynchronizationObject{kernel} {}
 Session::~Session() = default;
 
 Session::SessionPair Session::Create(KernelCore& kernel, std::string name) {
-    auto session{std::make_shared<Session>(kernel)};
+    auto session{MakeSlabObject<Session, SessionSlabCount>(kernel)};
     auto client_session{Kernel::ClientSession::Create(kernel, session, name + "_Client").Unwrap()};
     auto server_session{Kernel::ServerSession::Create(kernel, session, name + "_Server").Unwrap()};
 
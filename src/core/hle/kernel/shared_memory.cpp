@@ -6,6 +6,7 @@
 #include "core/core.h"
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/memory/page_table.h"
+#include "core/hle/kernel/object_slab.h"
 #include "core/hle/kernel/shared_memory.h"
 
 namespace Kernel {
@@ -22,7 +23,7 @@ std::shared_ptr<SharedMemory> SharedMemory::Create(
     std::string name) {
 
     std::shared_ptr<SharedMemory> shared_memory{
-        std::make_shared<SharedMemory>(kernel, device_memory)};
+        MakeSlabObject<SharedMemory, SharedMemorySlabCount>(kernel, device_memory)};
 
     shared_memory->owner_process = owner_process;
     shared_memory->page_list = std::move(page_list);
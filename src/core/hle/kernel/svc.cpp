@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
 #include <cinttypes>
 #include <iterator>
 #include <mutex>
@@ -311,12 +312,18 @@ static ResultCode ConnectToNamedPort(Core::System& system, Handle* out_handle,
         return ERR_NOT_FOUND;
     }
 
-    ASSERT(kernel.CurrentProcess()->GetResourceLimit()->Reserve(ResourceType::Sessions, 1));
+    ResourceReservation reservation{kernel.CurrentProcess()->GetResourceLimit(),
+                                    ResourceType::Sessions};
+    if (!reservation.Succeeded()) {
+        LOG_ERROR(Kernel_SVC, "Session count exceeds the resource limit");
+        return ERR_RESOURCE_LIMIT_EXCEEDED;
+    }
 
     auto client_port = it->second;
 
     std::shared_ptr<ClientSession> client_session;
     CASCADE_RESULT(client_session, client_port->Connect());
+    client_session->SetResourceReservation(std::move(reservation));
 
     // Return the client session
     auto& handle_table = kernel.CurrentProcess()->GetHandleTable();
@@ -450,7 +457,7 @@ static ResultCode WaitSynchronization(Core::System& system, Handle* index, VAddr
         return ERR_INVALID_POINTER;
     }
 
-    static constexpr u64 MaxHandles = 0x40;
+    static constexpr u64 MaxHandles = MAX_SYNCHRONIZATION_OBJECTS;
 
     if (handle_count > MaxHandles) {
         LOG_ERROR(Kernel_SVC, "Handle count specified is too large, expected {} but got {}",
@@ -459,19 +466,21 @@ static ResultCode WaitSynchronization(Core::System& system, Handle* index, VAddr
     }
 
     auto& kernel = system.Kernel();
-    Thread::ThreadSynchronizationObjects objects(handle_count);
     const auto& handle_table = kernel.CurrentProcess()->GetHandleTable();
 
+    std::array<Handle, MaxHandles> handles;
+    memory.ReadBlock(handles_address, handles.data(), handle_count * sizeof(Handle));
+
+    Thread::ThreadSynchronizationObjects objects;
     for (u64 i = 0; i < handle_count; ++i) {
-        const Handle handle = memory.Read32(handles_address + i * sizeof(Handle));
-        const auto object = handle_table.Get<SynchronizationObject>(handle);
+        auto object = handle_table.Get<SynchronizationObject>(handles[i]);
 
         if (object == nullptr) {
             LOG_ERROR(Kernel_SVC, "Object is a nullptr");
             return ERR_INVALID_HANDLE;
         }
 
-        objects[i] = object;
+        objects.push_back(std::move(object));
     }
     auto& synchronization = kernel.Synchronization();
     const auto [result, handle_result] = synchronization.WaitFor(objects, nano_seconds);
@@ -1181,7 +1190,7 @@ static ResultCode SetThreadPriority(Core::System& system, Handle handle, u32 pri
 
     const auto* const current_process = system.Kernel().CurrentProcess();
 
-    std::shared_ptr<Thread> thread = current_process->GetHandleTable().Get<Thread>(handle);
+    const std::shared_ptr<Thread> thread = current_process->GetHandleTable().Get<Thread>(handle);
     if (!thread) {
         LOG_ERROR(Kernel_SVC, "Thread handle does not exist, handle=0x{:08X}", handle);
         return ERR_INVALID_HANDLE;
@@ -1526,14 +1535,17 @@ static ResultCode CreateThread(Core::System& system, Handle* out_handle, VAddr e
         return ERR_INVALID_THREAD_PRIORITY;
     }
 
-    auto& kernel = system.Kernel();
-
-    ASSERT(kernel.CurrentProcess()->GetResourceLimit()->Reserve(ResourceType::Threads, 1));
+    ResourceReservation reservation{current_process->GetResourceLimit(), ResourceType::Threads};
+    if (!reservation.Succeeded()) {
+        LOG_ERROR(Kernel_SVC, "Thread count exceeds the resource limit");
+        return ERR_RESOURCE_LIMIT_EXCEEDED;
+    }
 
     ThreadType type = THREADTYPE_USER;
     CASCADE_RESULT(std::shared_ptr<Thread> thread,
                    Thread::Create(system, type, "", entry_point, priority, arg, processor_id,
                                   stack_top, current_process));
+    thread->SetResourceReservation(std::move(reservation));
 
     const auto new_thread_handle = current_process->GetHandleTable().Create(thread);
     if (new_thread_handle.Failed()) {
@@ -2084,8 +2096,16 @@ static ResultCode CreateEvent(Core::System& system, Handle* write_handle, Handle
     LOG_DEBUG(Kernel_SVC, "called");
 
     auto& kernel = system.Kernel();
+    ResourceReservation reservation{kernel.CurrentProcess()->GetResourceLimit(),
+                                    ResourceType::Events};
+    if (!reservation.Succeeded()) {
+        LOG_ERROR(Kernel_SVC, "Event count exceeds the resource limit");
+        return ERR_RESOURCE_LIMIT_EXCEEDED;
+    }
+
     const auto [readable_event, writable_event] =
         WritableEvent::CreateEventPair(kernel, "CreateEvent");
+    writable_event->SetResourceReservation(std::move(reservation));
 
     HandleTable& handle_table = kernel.CurrentProcess()->GetHandleTable();
 
@@ -34,8 +34,8 @@ void Synchronization::SignalObject(SynchronizationObject& obj) const {
     }
 }
 
-std::pair<ResultCode, Handle> Synchronization::WaitFor(
-    std::vector<std::shared_ptr<SynchronizationObject>>& sync_objects, s64 nano_seconds) {
+std::pair<ResultCode, Handle> Synchronization::WaitFor(SynchronizationObjects& sync_objects,
+                                                       s64 nano_seconds) {
     auto& kernel = system.Kernel();
     auto* const thread = system.CurrentScheduler().GetCurrentThread();
     Handle event_handle = InvalidHandle;
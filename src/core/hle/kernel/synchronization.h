@@ -4,11 +4,10 @@
 
 #pragma once
 
-#include <memory>
 #include <utility>
-#include <vector>
 
 #include "core/hle/kernel/object.h"
+#include "core/hle/kernel/synchronization_object.h"
 #include "core/hle/result.h"
 
 namespace Core {
@@ -17,8 +16,6 @@ class System;
 
 namespace Kernel {
 
-class SynchronizationObject;
-
 /**
  * The 'Synchronization' class is an interface for handling synchronization methods
  * used by Synchronization objects and synchronization SVCs. This centralizes processing of
@@ -35,8 +32,7 @@ public:
     /// it returns Success and the handle index of the signaled sync object. In
     /// case not, the current thread will be locked and wait for nano_seconds or
     /// for a synchronization object to signal.
-    std::pair<ResultCode, Handle> WaitFor(
-        std::vector<std::shared_ptr<SynchronizationObject>>& sync_objects, s64 nano_seconds);
+    std::pair<ResultCode, Handle> WaitFor(SynchronizationObjects& sync_objects, s64 nano_seconds);
 
 private:
     Core::System& system;
@@ -4,17 +4,29 @@
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <vector>
 
+#include <boost/container/static_vector.hpp>
+
 #include "core/hle/kernel/object.h"
 
 namespace Kernel {
 
 class KernelCore;
 class Synchronization;
+class SynchronizationObject;
 class Thread;
 
+/// Maximum number of objects a thread can wait on with a single WaitSynchronization call
+constexpr std::size_t MAX_SYNCHRONIZATION_OBJECTS = 64;
+
+/// Objects a thread waits on, stored inline so that waiting never allocates
+using SynchronizationObjects =
+    boost::container::static_vector<std::shared_ptr<SynchronizationObject>,
+                                    MAX_SYNCHRONIZATION_OBJECTS>;
+
 /// Class that represents a Kernel object that a thread can be waiting on
 class SynchronizationObject : public Object {
 public:
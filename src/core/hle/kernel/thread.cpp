@@ -21,6 +21,7 @@
 #include "core/hle/kernel/handle_table.h"
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/object.h"
+#include "core/hle/kernel/object_slab.h"
 #include "core/hle/kernel/process.h"
 #include "core/hle/kernel/scheduler.h"
 #include "core/hle/kernel/thread.h"
@@ -58,6 +59,11 @@ void Thread::Stop() {
         kernel.GlobalHandleTable().Close(global_handle);
 
         if (owner_process) {
+            // Don't leave a dangling entry behind in the arbiter's intrusive wait queues.
+            if (waiting_for_arbitration) {
+                owner_process->GetAddressArbiter().HandleWakeupThread(this);
+                waiting_for_arbitration = false;
+            }
             owner_process->UnregisterThread(this);
 
             // Mark the TLS slot in the thread's page as free.
@@ -187,7 +193,7 @@ ResultVal<std::shared_ptr<Thread>> Thread::Create(Core::System& system, ThreadTy
         }
     }
 
-    std::shared_ptr<Thread> thread = std::make_shared<Thread>(kernel);
+    std::shared_ptr<Thread> thread = MakeSlabObject<Thread, ThreadSlabCount>(kernel);
 
     thread->thread_id = kernel.CreateNewThreadID();
     thread->status = ThreadStatus::Dormant;
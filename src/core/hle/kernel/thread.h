@@ -13,6 +13,7 @@
 #include "common/spin_lock.h"
 #include "core/arm/arm_interface.h"
 #include "core/hle/kernel/object.h"
+#include "core/hle/kernel/resource_limit.h"
 #include "core/hle/kernel/synchronization_object.h"
 #include "core/hle/result.h"
 
@@ -126,7 +127,7 @@ public:
     using ThreadContext32 = Core::ARM_Interface::ThreadContext32;
     using ThreadContext64 = Core::ARM_Interface::ThreadContext64;
 
-    using ThreadSynchronizationObjects = std::vector<std::shared_ptr<SynchronizationObject>>;
+    using ThreadSynchronizationObjects = SynchronizationObjects;
 
     using HLECallback = std::function<bool(std::shared_ptr<Thread> thread)>;
 
@@ -440,6 +441,22 @@ public:
         arb_wait_address = address;
     }
 
+    Thread* GetArbiterWaitPrevious() const {
+        return arb_wait_previous;
+    }
+
+    void SetArbiterWaitPrevious(Thread* thread) {
+        arb_wait_previous = thread;
+    }
+
+    Thread* GetArbiterWaitNext() const {
+        return arb_wait_next;
+    }
+
+    void SetArbiterWaitNext(Thread* thread) {
+        arb_wait_next = thread;
+    }
+
     bool HasHLECallback() const {
         return hle_callback != nullptr;
     }
@@ -569,6 +586,11 @@ public:
         is_phantom_mode = phantom;
     }
 
+    /// Holds the thread count reserved for the thread until it is destroyed
+    void SetResourceReservation(ResourceReservation reservation) {
+        resource_reservation = std::move(reservation);
+    }
+
     bool HasExited() const {
         return has_exited;
     }
@@ -644,6 +666,10 @@ private:
     VAddr arb_wait_address{0};
     bool waiting_for_arbitration{};
 
+    /// Links of the priority ordered queue of threads waiting on the same arbiter address.
+    Thread* arb_wait_previous{};
+    Thread* arb_wait_next{};
+
     /// Handle used as userdata to reference this object when inserting into the CoreTiming queue.
     Handle global_handle = 0;
 
@@ -675,6 +701,8 @@ private:
 
     bool was_running = false;
 
+    ResourceReservation resource_reservation;
+
     std::string name;
 };
 
@@ -6,6 +6,7 @@
 #include "common/assert.h"
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/object.h"
+#include "core/hle/kernel/object_slab.h"
 #include "core/hle/kernel/readable_event.h"
 #include "core/hle/kernel/thread.h"
 #include "core/hle/kernel/writable_event.h"
@@ -16,8 +17,8 @@ WritableEvent::WritableEvent(KernelCore& kernel) : Object{kernel} {}
 WritableEvent::~WritableEvent() = default;
 
 EventPair WritableEvent::CreateEventPair(KernelCore& kernel, std::string name) {
-    std::shared_ptr<WritableEvent> writable_event(new WritableEvent(kernel));
-    std::shared_ptr<ReadableEvent> readable_event(new ReadableEvent(kernel));
+    auto writable_event{MakeSlabObject<WritableEvent, EventSlabCount>(kernel)};
+    auto readable_event{MakeSlabObject<ReadableEvent, EventSlabCount>(kernel)};
 
     writable_event->name = name + ":Writable";
     writable_event->readable = readable_event;
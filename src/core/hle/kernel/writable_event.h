@@ -7,6 +7,7 @@
 #include <memory>
 
 #include "core/hle/kernel/object.h"
+#include "core/hle/kernel/resource_limit.h"
 
 namespace Kernel {
 
@@ -21,6 +22,7 @@ struct EventPair {
 
 class WritableEvent final : public Object {
 public:
+    explicit WritableEvent(KernelCore& kernel);
     ~WritableEvent() override;
 
     /**
@@ -48,11 +50,16 @@ public:
     void Clear();
     bool IsSignaled() const;
 
-private:
-    explicit WritableEvent(KernelCore& kernel);
+    /// Holds the event count reserved for the event pair until the writable end is destroyed
+    void SetResourceReservation(ResourceReservation reservation) {
+        resource_reservation = std::move(reservation);
+    }
 
+private:
     std::shared_ptr<ReadableEvent> readable;
 
+    ResourceReservation resource_reservation;
+
     std::string name; ///< Name of event (optional)
 };
 
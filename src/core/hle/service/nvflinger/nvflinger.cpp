@@ -8,6 +8,7 @@
 #include "common/assert.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
+#include "common/precision_waiter.h"
 #include "common/scope_exit.h"
 #include "common/thread.h"
 #include "core/core.h"
@@ -80,7 +81,7 @@ NVFlinger::NVFlinger(Core::System& system) : system(system) {
 
     if (system.IsMulticore()) {
         is_running = true;
-        wait_event = std::make_unique<Common::Event>();
+        wait_event = std::make_unique<Common::PrecisionWaiter>();
         vsync_thread = std::make_unique<std::thread>(VSyncThread, std::ref(*this));
     } else {
         system.CoreTiming().ScheduleEvent(frame_ns, composition_event);
@@ -264,6 +265,7 @@ void NVFlinger::Compose() {
                      buffer->get().transform, buffer->get().crop_rect);
 
         swap_interval = buffer->get().swap_interval;
+        system.FrameLimiter().SetVSyncPeriod(std::chrono::nanoseconds{GetNextTicks()});
         buffer_queue.ReleaseBuffer(buffer->get().slot);
     }
 }
@@ -17,7 +17,7 @@
 #include "core/hle/kernel/object.h"
 
 namespace Common {
-class Event;
+class PrecisionWaiter;
 } // namespace Common
 
 namespace Core::Timing {
@@ -128,7 +128,7 @@ private:
     Core::System& system;
 
     std::unique_ptr<std::thread> vsync_thread;
-    std::unique_ptr<Common::Event> wait_event;
+    std::unique_ptr<Common::PrecisionWaiter> wait_event;
     std::atomic<bool> is_running{};
 };
 
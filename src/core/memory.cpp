@@ -3,9 +3,12 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <mutex>
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "common/assert.h"
 #include "common/atomic_ops.h"
@@ -28,10 +31,16 @@ namespace Core::Memory {
 // from outside classes. This also allows modification to the internals of the memory
 // subsystem without needing to rebuild all files that make use of the memory interface.
 struct Memory::Impl {
+    using HookInterval = boost::icl::discrete_interval<u64>;
+
     explicit Impl(Core::System& system_) : system{system_} {}
 
     void SetCurrentPageTable(Kernel::Process& process, u32 core_id) {
-        current_page_table = &process.PageTable().PageTableImpl();
+        Common::PageTable* const page_table = &process.PageTable().PageTableImpl();
+        if (current_page_table != page_table) {
+            current_page_table = page_table;
+            page_table_generation.fetch_add(1, std::memory_order_release);
+        }
 
         const std::size_t address_space_width = process.PageTable().GetAddressSpaceWidth();
 
@@ -57,12 +66,170 @@ struct Memory::Impl {
 
     void AddDebugHook(Common::PageTable& page_table, VAddr base, u64 size,
                       Common::MemoryHookPointer hook) {
-        UNIMPLEMENTED();
+        std::lock_guard lock{debug_hooks_mutex};
+        page_table.special_regions.add(
+            {HookInterval::right_open(base, base + size),
+             {{Common::SpecialRegion::Type::DebugHook, std::move(hook)}}});
+        UpdateHookedPages(page_table, base, size);
     }
 
     void RemoveDebugHook(Common::PageTable& page_table, VAddr base, u64 size,
                          Common::MemoryHookPointer hook) {
-        UNIMPLEMENTED();
+        std::lock_guard lock{debug_hooks_mutex};
+        page_table.special_regions.subtract(
+            {HookInterval::right_open(base, base + size),
+             {{Common::SpecialRegion::Type::DebugHook, std::move(hook)}}});
+        UpdateHookedPages(page_table, base, size);
+    }
+
+    void AddDebugHook(VAddr base, u64 size, Common::MemoryHookPointer hook) {
+        AddDebugHook(system.CurrentProcess()->PageTable().PageTableImpl(), base, size,
+                     std::move(hook));
+    }
+
+    void RemoveDebugHook(VAddr base, u64 size, Common::MemoryHookPointer hook) {
+        // The hooks go away with the page table of the process
+        Kernel::Process* const process = system.CurrentProcess();
+        if (process == nullptr) {
+            return;
+        }
+        RemoveDebugHook(process->PageTable().PageTableImpl(), base, size, std::move(hook));
+    }
+
+    static bool HasDebugHooks(const Common::PageTable& page_table, VAddr page_addr) {
+        const auto range = page_table.special_regions.equal_range(
+            HookInterval::right_open(page_addr, page_addr + PAGE_SIZE));
+        return range.first != range.second;
+    }
+
+    /**
+     * Switches the mapped pages of a range to the special type while they have debug hooks, which
+     * takes them off the fast paths, and back to plain memory once their hooks are removed. Pages
+     * cached by the rasterizer are left alone, they switch when they are uncached.
+     * The debug hooks lock must be held.
+     */
+    void UpdateHookedPages(Common::PageTable& page_table, VAddr base, u64 size) {
+        bool changed = false;
+        const VAddr end = base + size;
+        for (VAddr page_addr = base & ~PAGE_MASK; page_addr < end; page_addr += PAGE_SIZE) {
+            const std::size_t page = page_addr >> PAGE_BITS;
+            Common::PageType& page_type = page_table.attributes[page];
+            const bool hooked = HasDebugHooks(page_table, page_addr);
+            if (page_type == Common::PageType::Memory && hooked) {
+                page_type = Common::PageType::Special;
+                page_table.pointers[page] = nullptr;
+            } else if (page_type == Common::PageType::Special && !hooked) {
+                page_table.pointers[page] =
+                    system.DeviceMemory().GetPointer(page_table.backing_addr[page] + page_addr) -
+                    page_addr;
+                page_type = Common::PageType::Memory;
+            } else {
+                continue;
+            }
+            changed = true;
+        }
+        if (changed) {
+            page_table_generation.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    /**
+     * Calls the debug hooks covering vaddr until one of them handles the access.
+     *
+     * @returns Whether a hook handled the access.
+     */
+    template <typename Func>
+    bool CallDebugHooks(const Common::PageTable& page_table, VAddr vaddr, Func&& func) {
+        std::lock_guard lock{debug_hooks_mutex};
+        const auto it = page_table.special_regions.find(vaddr);
+        if (it == page_table.special_regions.end()) {
+            return false;
+        }
+        for (const Common::SpecialRegion& region : it->second) {
+            if (region.type == Common::SpecialRegion::Type::DebugHook && func(*region.handler)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template <typename T>
+    std::optional<T> ReadFromDebugHooks(VAddr vaddr) {
+        std::optional<T> result;
+        CallDebugHooks(*current_page_table, vaddr, [&](Common::MemoryHook& hook) {
+            if constexpr (sizeof(T) == sizeof(u8)) {
+                result = hook.Read8(vaddr);
+            } else if constexpr (sizeof(T) == sizeof(u16)) {
+                result = hook.Read16(vaddr);
+            } else if constexpr (sizeof(T) == sizeof(u32)) {
+                result = hook.Read32(vaddr);
+            } else if constexpr (sizeof(T) == sizeof(u64)) {
+                result = hook.Read64(vaddr);
+            } else {
+                T value;
+                if (hook.ReadBlock(vaddr, &value, sizeof(T))) {
+                    result = value;
+                }
+            }
+            return result.has_value();
+        });
+        return result;
+    }
+
+    template <typename T>
+    bool WriteToDebugHooks(VAddr vaddr, const T data) {
+        return CallDebugHooks(*current_page_table, vaddr, [&](Common::MemoryHook& hook) {
+            if constexpr (sizeof(T) == sizeof(u8)) {
+                return hook.Write8(vaddr, static_cast<u8>(data));
+            } else if constexpr (sizeof(T) == sizeof(u16)) {
+                return hook.Write16(vaddr, static_cast<u16>(data));
+            } else if constexpr (sizeof(T) == sizeof(u32)) {
+                return hook.Write32(vaddr, static_cast<u32>(data));
+            } else if constexpr (sizeof(T) == sizeof(u64)) {
+                return hook.Write64(vaddr, static_cast<u64>(data));
+            } else {
+                return hook.WriteBlock(vaddr, &data, sizeof(T));
+            }
+        });
+    }
+
+    /**
+     * Compares the value reads see at vaddr, which the debug hooks may provide, against expected
+     * and writes data through the hooks when they match. No other hooked access can happen in
+     * between.
+     *
+     * @returns Whether data was written.
+     */
+    template <typename T>
+    bool WriteExclusiveToDebugHooks(VAddr vaddr, const T data, const T expected) {
+        std::lock_guard lock{debug_hooks_mutex};
+        u8* const backing = GetPointerFromRasterizerCachedMemory(vaddr);
+        std::optional<T> current = ReadFromDebugHooks<T>(vaddr);
+        if (!current) {
+            current.emplace();
+            std::memcpy(&*current, backing, sizeof(T));
+        }
+        if (std::memcmp(&*current, &expected, sizeof(T)) != 0) {
+            return false;
+        }
+        if (!WriteToDebugHooks(vaddr, data)) {
+            std::memcpy(backing, &data, sizeof(T));
+        }
+        return true;
+    }
+
+    bool ReadBlockFromDebugHooks(const Common::PageTable& page_table, VAddr vaddr, void* dest,
+                                 std::size_t size) {
+        return CallDebugHooks(page_table, vaddr, [&](Common::MemoryHook& hook) {
+            return hook.ReadBlock(vaddr, dest, size);
+        });
+    }
+
+    bool WriteBlockToDebugHooks(const Common::PageTable& page_table, VAddr vaddr, const void* src,
+                                std::size_t size) {
+        return CallDebugHooks(page_table, vaddr, [&](Common::MemoryHook& hook) {
+            return hook.WriteBlock(vaddr, src, size);
+        });
     }
 
     bool IsValidVirtualAddress(const Kernel::Process& process, const VAddr vaddr) const {
@@ -77,11 +244,9 @@ struct Memory::Impl {
             return true;
         }
 
-        if (page_table.attributes[vaddr >> PAGE_BITS] != Common::PageType::Special) {
-            return false;
-        }
-
-        return false;
+        // Special pages are only backed by memory when they are hooked memory pages
+        return page_table.attributes[vaddr >> PAGE_BITS] == Common::PageType::Special &&
+               page_table.backing_addr[vaddr >> PAGE_BITS] != 0;
     }
 
     bool IsValidVirtualAddress(VAddr vaddr) const {
@@ -104,14 +269,24 @@ struct Memory::Impl {
             return page_pointer + vaddr;
         }
 
-        if (current_page_table->attributes[vaddr >> PAGE_BITS] ==
-            Common::PageType::RasterizerCachedMemory) {
+        const Common::PageType type = current_page_table->attributes[vaddr >> PAGE_BITS];
+        if (type == Common::PageType::RasterizerCachedMemory ||
+            type == Common::PageType::Special) {
             return GetPointerFromRasterizerCachedMemory(vaddr);
         }
 
         return {};
     }
 
+    u8* GetUncachedPointer(const VAddr vaddr) const {
+        u8* const page_pointer{current_page_table->pointers[vaddr >> PAGE_BITS]};
+        return page_pointer ? page_pointer + vaddr : nullptr;
+    }
+
+    u64 GetPageTableGeneration() const {
+        return page_table_generation.load(std::memory_order_acquire);
+    }
+
     u8 Read8(const VAddr addr) {
         return Read<u8>(addr);
     }
@@ -136,6 +311,14 @@ struct Memory::Impl {
         }
     }
 
+    u32 ReadCode32(const VAddr addr) {
+        // Remapping the page must invalidate the code translated from it. Cores read code while
+        // other threads remap pages, the flags are only accessed atomically.
+        std::atomic_ref{current_page_table->translated_code[addr >> PAGE_BITS]}.store(
+            1, std::memory_order_relaxed);
+        return Read32(addr);
+    }
+
     u64 Read64(const VAddr addr) {
         if ((addr & 7) == 0) {
             return Read<u64_le>(addr);
@@ -208,95 +391,135 @@ struct Memory::Impl {
         return string;
     }
 
-    void ReadBlock(const Kernel::Process& process, const VAddr src_addr, void* dest_buffer,
-                   const std::size_t size) {
+    /**
+     * Walks the pages of [addr, addr + size) in runs of pages of the same type.
+     *
+     * Each rasterizer cached run is reported once to on_cached_run before its memory is accessed,
+     * so it's flushed or invalidated with a single call. The memory of mapped runs is then passed
+     * to on_memory in host contiguous chunks, and unmapped runs are reported to on_unmapped.
+     * Special pages are passed one at a time to on_special, which returns whether debug hooks
+     * handled the access, otherwise their memory goes to on_memory as well.
+     * All callbacks receive the offset of the chunk within the block.
+     */
+    template <typename OnUnmapped, typename OnCachedRun, typename OnSpecial, typename OnMemory>
+    void WalkBlock(const Kernel::Process& process, const VAddr addr, const std::size_t size,
+                   OnUnmapped&& on_unmapped, OnCachedRun&& on_cached_run, OnSpecial&& on_special,
+                   OnMemory&& on_memory) {
         const auto& page_table = process.PageTable().PageTableImpl();
-
-        std::size_t remaining_size = size;
-        std::size_t page_index = src_addr >> PAGE_BITS;
-        std::size_t page_offset = src_addr & PAGE_MASK;
-
-        while (remaining_size > 0) {
-            const std::size_t copy_amount =
-                std::min(static_cast<std::size_t>(PAGE_SIZE) - page_offset, remaining_size);
-            const auto current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
-
-            switch (page_table.attributes[page_index]) {
-            case Common::PageType::Unmapped: {
-                LOG_ERROR(HW_Memory,
-                          "Unmapped ReadBlock @ 0x{:016X} (start address = 0x{:016X}, size = {})",
-                          current_vaddr, src_addr, size);
-                std::memset(dest_buffer, 0, copy_amount);
+        const VAddr end_addr = addr + size;
+        const std::size_t end_page = size == 0 ? 0 : ((end_addr - 1) >> PAGE_BITS) + 1;
+
+        VAddr run_addr = addr;
+        while (run_addr < end_addr) {
+            const std::size_t first_page = run_addr >> PAGE_BITS;
+            const std::size_t run_end_page =
+                Common::FindPageTypeRunEnd(page_table.attributes.data(), first_page, end_page);
+            const VAddr run_end = std::min<VAddr>(run_end_page << PAGE_BITS, end_addr);
+            const std::size_t offset = run_addr - addr;
+
+            switch (page_table.attributes[first_page]) {
+            case Common::PageType::Unmapped:
+                on_unmapped(run_addr, offset, run_end - run_addr);
                 break;
-            }
-            case Common::PageType::Memory: {
-                DEBUG_ASSERT(page_table.pointers[page_index]);
-
-                const u8* const src_ptr =
-                    page_table.pointers[page_index] + page_offset + (page_index << PAGE_BITS);
-                std::memcpy(dest_buffer, src_ptr, copy_amount);
+            case Common::PageType::Memory:
+                ForEachHostChunk(page_table.pointers, run_addr, run_end,
+                                 [&](VAddr chunk_addr, u8* page_pointer, std::size_t amount) {
+                                     on_memory(page_pointer + chunk_addr, chunk_addr - addr,
+                                               amount);
+                                 });
                 break;
-            }
-            case Common::PageType::RasterizerCachedMemory: {
-                const u8* const host_ptr{GetPointerFromRasterizerCachedMemory(current_vaddr)};
-                system.GPU().FlushRegion(current_vaddr, copy_amount);
-                std::memcpy(dest_buffer, host_ptr, copy_amount);
+            case Common::PageType::RasterizerCachedMemory:
+                on_cached_run(run_addr, run_end - run_addr);
+                ForEachHostChunk(page_table.backing_addr, run_addr, run_end,
+                                 [&](VAddr chunk_addr, PAddr backing, std::size_t amount) {
+                                     u8* const host_ptr =
+                                         system.DeviceMemory().GetPointer(backing + chunk_addr);
+                                     on_memory(host_ptr, chunk_addr - addr, amount);
+                                 });
+                break;
+            case Common::PageType::Special:
+                for (VAddr page_addr = run_addr; page_addr < run_end;) {
+                    const VAddr page_end =
+                        std::min<VAddr>((page_addr & ~PAGE_MASK) + PAGE_SIZE, run_end);
+                    const std::size_t amount = page_end - page_addr;
+                    if (!on_special(page_table, page_addr, page_addr - addr, amount)) {
+                        u8* const host_ptr = system.DeviceMemory().GetPointer(
+                            page_table.backing_addr[page_addr >> PAGE_BITS] + page_addr);
+                        on_memory(host_ptr, page_addr - addr, amount);
+                    }
+                    page_addr = page_end;
+                }
                 break;
-            }
             default:
                 UNREACHABLE();
             }
+            run_addr = run_end;
+        }
+    }
 
-            page_index++;
-            page_offset = 0;
-            dest_buffer = static_cast<u8*>(dest_buffer) + copy_amount;
-            remaining_size -= copy_amount;
+    /**
+     * Splits [run_addr, run_end) in chunks of consecutive pages with the same page table entry,
+     * which are contiguous in host memory as entries are stored relative to the page address.
+     */
+    template <typename Entry, typename Func>
+    static void ForEachHostChunk(const Common::VirtualBuffer<Entry>& entries, VAddr run_addr,
+                                 VAddr run_end, Func&& func) {
+        while (run_addr < run_end) {
+            const Entry entry = entries[run_addr >> PAGE_BITS];
+            VAddr chunk_end = (run_addr & ~PAGE_MASK) + PAGE_SIZE;
+            while (chunk_end < run_end && entries[chunk_end >> PAGE_BITS] == entry) {
+                chunk_end += PAGE_SIZE;
+            }
+            chunk_end = std::min(chunk_end, run_end);
+            func(run_addr, entry, chunk_end - run_addr);
+            run_addr = chunk_end;
         }
     }
 
+    void ReadBlock(const Kernel::Process& process, const VAddr src_addr, void* dest_buffer,
+                   const std::size_t size) {
+        block_stats.block_operations.fetch_add(1, std::memory_order_relaxed);
+        u8* const dest = static_cast<u8*>(dest_buffer);
+        WalkBlock(
+            process, src_addr, size,
+            [&](VAddr current_vaddr, std::size_t offset, std::size_t amount) {
+                LOG_ERROR(HW_Memory,
+                          "Unmapped ReadBlock @ 0x{:016X} (start address = 0x{:016X}, size = {})",
+                          current_vaddr, src_addr, size);
+                std::memset(dest + offset, 0, amount);
+            },
+            [&](VAddr run_addr, std::size_t run_size) {
+                block_stats.flush_calls.fetch_add(1, std::memory_order_relaxed);
+                system.GPU().FlushRegion(run_addr, run_size);
+            },
+            [&](const Common::PageTable& page_table, VAddr vaddr, std::size_t offset,
+                std::size_t amount) {
+                return ReadBlockFromDebugHooks(page_table, vaddr, dest + offset, amount);
+            },
+            [&](const u8* src_ptr, std::size_t offset, std::size_t amount) {
+                std::memcpy(dest + offset, src_ptr, amount);
+            });
+    }
+
     void ReadBlockUnsafe(const Kernel::Process& process, const VAddr src_addr, void* dest_buffer,
                          const std::size_t size) {
-        const auto& page_table = process.PageTable().PageTableImpl();
-
-        std::size_t remaining_size = size;
-        std::size_t page_index = src_addr >> PAGE_BITS;
-        std::size_t page_offset = src_addr & PAGE_MASK;
-
-        while (remaining_size > 0) {
-            const std::size_t copy_amount =
-                std::min(static_cast<std::size_t>(PAGE_SIZE) - page_offset, remaining_size);
-            const auto current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
-
-            switch (page_table.attributes[page_index]) {
-            case Common::PageType::Unmapped: {
+        u8* const dest = static_cast<u8*>(dest_buffer);
+        WalkBlock(
+            process, src_addr, size,
+            [&](VAddr current_vaddr, std::size_t offset, std::size_t amount) {
                 LOG_ERROR(HW_Memory,
                           "Unmapped ReadBlock @ 0x{:016X} (start address = 0x{:016X}, size = {})",
                           current_vaddr, src_addr, size);
-                std::memset(dest_buffer, 0, copy_amount);
-                break;
-            }
-            case Common::PageType::Memory: {
-                DEBUG_ASSERT(page_table.pointers[page_index]);
-
-                const u8* const src_ptr =
-                    page_table.pointers[page_index] + page_offset + (page_index << PAGE_BITS);
-                std::memcpy(dest_buffer, src_ptr, copy_amount);
-                break;
-            }
-            case Common::PageType::RasterizerCachedMemory: {
-                const u8* const host_ptr{GetPointerFromRasterizerCachedMemory(current_vaddr)};
-                std::memcpy(dest_buffer, host_ptr, copy_amount);
-                break;
-            }
-            default:
-                UNREACHABLE();
-            }
-
-            page_index++;
-            page_offset = 0;
-            dest_buffer = static_cast<u8*>(dest_buffer) + copy_amount;
-            remaining_size -= copy_amount;
-        }
+                std::memset(dest + offset, 0, amount);
+            },
+            [](VAddr, std::size_t) {},
+            [&](const Common::PageTable& page_table, VAddr vaddr, std::size_t offset,
+                std::size_t amount) {
+                return ReadBlockFromDebugHooks(page_table, vaddr, dest + offset, amount);
+            },
+            [&](const u8* src_ptr, std::size_t offset, std::size_t amount) {
+                std::memcpy(dest + offset, src_ptr, amount);
+            });
     }
 
     void ReadBlock(const VAddr src_addr, void* dest_buffer, const std::size_t size) {
@@ -309,89 +532,46 @@ struct Memory::Impl {
 
     void WriteBlock(const Kernel::Process& process, const VAddr dest_addr, const void* src_buffer,
                     const std::size_t size) {
-        const auto& page_table = process.PageTable().PageTableImpl();
-        std::size_t remaining_size = size;
-        std::size_t page_index = dest_addr >> PAGE_BITS;
-        std::size_t page_offset = dest_addr & PAGE_MASK;
-
-        while (remaining_size > 0) {
-            const std::size_t copy_amount =
-                std::min(static_cast<std::size_t>(PAGE_SIZE) - page_offset, remaining_size);
-            const auto current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
-
-            switch (page_table.attributes[page_index]) {
-            case Common::PageType::Unmapped: {
+        block_stats.block_operations.fetch_add(1, std::memory_order_relaxed);
+        const u8* const src = static_cast<const u8*>(src_buffer);
+        WalkBlock(
+            process, dest_addr, size,
+            [&](VAddr current_vaddr, std::size_t, std::size_t) {
                 LOG_ERROR(HW_Memory,
                           "Unmapped WriteBlock @ 0x{:016X} (start address = 0x{:016X}, size = {})",
                           current_vaddr, dest_addr, size);
-                break;
-            }
-            case Common::PageType::Memory: {
-                DEBUG_ASSERT(page_table.pointers[page_index]);
-
-                u8* const dest_ptr =
-                    page_table.pointers[page_index] + page_offset + (page_index << PAGE_BITS);
-                std::memcpy(dest_ptr, src_buffer, copy_amount);
-                break;
-            }
-            case Common::PageType::RasterizerCachedMemory: {
-                u8* const host_ptr{GetPointerFromRasterizerCachedMemory(current_vaddr)};
-                system.GPU().InvalidateRegion(current_vaddr, copy_amount);
-                std::memcpy(host_ptr, src_buffer, copy_amount);
-                break;
-            }
-            default:
-                UNREACHABLE();
-            }
-
-            page_index++;
-            page_offset = 0;
-            src_buffer = static_cast<const u8*>(src_buffer) + copy_amount;
-            remaining_size -= copy_amount;
-        }
+            },
+            [&](VAddr run_addr, std::size_t run_size) {
+                block_stats.invalidate_calls.fetch_add(1, std::memory_order_relaxed);
+                system.GPU().InvalidateRegion(run_addr, run_size);
+            },
+            [&](const Common::PageTable& page_table, VAddr vaddr, std::size_t offset,
+                std::size_t amount) {
+                return WriteBlockToDebugHooks(page_table, vaddr, src + offset, amount);
+            },
+            [&](u8* dest_ptr, std::size_t offset, std::size_t amount) {
+                std::memcpy(dest_ptr, src + offset, amount);
+            });
     }
 
     void WriteBlockUnsafe(const Kernel::Process& process, const VAddr dest_addr,
                           const void* src_buffer, const std::size_t size) {
-        const auto& page_table = process.PageTable().PageTableImpl();
-        std::size_t remaining_size = size;
-        std::size_t page_index = dest_addr >> PAGE_BITS;
-        std::size_t page_offset = dest_addr & PAGE_MASK;
-
-        while (remaining_size > 0) {
-            const std::size_t copy_amount =
-                std::min(static_cast<std::size_t>(PAGE_SIZE) - page_offset, remaining_size);
-            const auto current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
-
-            switch (page_table.attributes[page_index]) {
-            case Common::PageType::Unmapped: {
+        const u8* const src = static_cast<const u8*>(src_buffer);
+        WalkBlock(
+            process, dest_addr, size,
+            [&](VAddr current_vaddr, std::size_t, std::size_t) {
                 LOG_ERROR(HW_Memory,
                           "Unmapped WriteBlock @ 0x{:016X} (start address = 0x{:016X}, size = {})",
                           current_vaddr, dest_addr, size);
-                break;
-            }
-            case Common::PageType::Memory: {
-                DEBUG_ASSERT(page_table.pointers[page_index]);
-
-                u8* const dest_ptr =
-                    page_table.pointers[page_index] + page_offset + (page_index << PAGE_BITS);
-                std::memcpy(dest_ptr, src_buffer, copy_amount);
-                break;
-            }
-            case Common::PageType::RasterizerCachedMemory: {
-                u8* const host_ptr{GetPointerFromRasterizerCachedMemory(current_vaddr)};
-                std::memcpy(host_ptr, src_buffer, copy_amount);
-                break;
-            }
-            default:
-                UNREACHABLE();
-            }
-
-            page_index++;
-            page_offset = 0;
-            src_buffer = static_cast<const u8*>(src_buffer) + copy_amount;
-            remaining_size -= copy_amount;
-        }
+            },
+            [](VAddr, std::size_t) {},
+            [&](const Common::PageTable& page_table, VAddr vaddr, std::size_t offset,
+                std::size_t amount) {
+                return WriteBlockToDebugHooks(page_table, vaddr, src + offset, amount);
+            },
+            [&](u8* dest_ptr, std::size_t offset, std::size_t amount) {
+                std::memcpy(dest_ptr, src + offset, amount);
+            });
     }
 
     void WriteBlock(const VAddr dest_addr, const void* src_buffer, const std::size_t size) {
@@ -403,45 +583,26 @@ struct Memory::Impl {
     }
 
     void ZeroBlock(const Kernel::Process& process, const VAddr dest_addr, const std::size_t size) {
-        const auto& page_table = process.PageTable().PageTableImpl();
-        std::size_t remaining_size = size;
-        std::size_t page_index = dest_addr >> PAGE_BITS;
-        std::size_t page_offset = dest_addr & PAGE_MASK;
-
-        while (remaining_size > 0) {
-            const std::size_t copy_amount =
-                std::min(static_cast<std::size_t>(PAGE_SIZE) - page_offset, remaining_size);
-            const auto current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
-
-            switch (page_table.attributes[page_index]) {
-            case Common::PageType::Unmapped: {
+        block_stats.block_operations.fetch_add(1, std::memory_order_relaxed);
+        WalkBlock(
+            process, dest_addr, size,
+            [&](VAddr current_vaddr, std::size_t, std::size_t) {
                 LOG_ERROR(HW_Memory,
                           "Unmapped ZeroBlock @ 0x{:016X} (start address = 0x{:016X}, size = {})",
                           current_vaddr, dest_addr, size);
-                break;
-            }
-            case Common::PageType::Memory: {
-                DEBUG_ASSERT(page_table.pointers[page_index]);
-
-                u8* dest_ptr =
-                    page_table.pointers[page_index] + page_offset + (page_index << PAGE_BITS);
-                std::memset(dest_ptr, 0, copy_amount);
-                break;
-            }
-            case Common::PageType::RasterizerCachedMemory: {
-                u8* const host_ptr{GetPointerFromRasterizerCachedMemory(current_vaddr)};
-                system.GPU().InvalidateRegion(current_vaddr, copy_amount);
-                std::memset(host_ptr, 0, copy_amount);
-                break;
-            }
-            default:
-                UNREACHABLE();
-            }
-
-            page_index++;
-            page_offset = 0;
-            remaining_size -= copy_amount;
-        }
+            },
+            [&](VAddr run_addr, std::size_t run_size) {
+                block_stats.invalidate_calls.fetch_add(1, std::memory_order_relaxed);
+                system.GPU().InvalidateRegion(run_addr, run_size);
+            },
+            [&](const Common::PageTable& page_table, VAddr vaddr, std::size_t,
+                std::size_t amount) {
+                const std::vector<u8> zeros(amount);
+                return WriteBlockToDebugHooks(page_table, vaddr, zeros.data(), amount);
+            },
+            [](u8* dest_ptr, std::size_t, std::size_t amount) {
+                std::memset(dest_ptr, 0, amount);
+            });
     }
 
     void ZeroBlock(const VAddr dest_addr, const std::size_t size) {
@@ -450,53 +611,45 @@ struct Memory::Impl {
 
     void CopyBlock(const Kernel::Process& process, VAddr dest_addr, VAddr src_addr,
                    const std::size_t size) {
-        const auto& page_table = process.PageTable().PageTableImpl();
-        std::size_t remaining_size = size;
-        std::size_t page_index = src_addr >> PAGE_BITS;
-        std::size_t page_offset = src_addr & PAGE_MASK;
-
-        while (remaining_size > 0) {
-            const std::size_t copy_amount =
-                std::min(static_cast<std::size_t>(PAGE_SIZE) - page_offset, remaining_size);
-            const auto current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
-
-            switch (page_table.attributes[page_index]) {
-            case Common::PageType::Unmapped: {
+        block_stats.block_operations.fetch_add(1, std::memory_order_relaxed);
+        WalkBlock(
+            process, src_addr, size,
+            [&](VAddr current_vaddr, std::size_t offset, std::size_t amount) {
                 LOG_ERROR(HW_Memory,
                           "Unmapped CopyBlock @ 0x{:016X} (start address = 0x{:016X}, size = {})",
                           current_vaddr, src_addr, size);
-                ZeroBlock(process, dest_addr, copy_amount);
-                break;
-            }
-            case Common::PageType::Memory: {
-                DEBUG_ASSERT(page_table.pointers[page_index]);
-                const u8* src_ptr =
-                    page_table.pointers[page_index] + page_offset + (page_index << PAGE_BITS);
-                WriteBlock(process, dest_addr, src_ptr, copy_amount);
-                break;
-            }
-            case Common::PageType::RasterizerCachedMemory: {
-                const u8* const host_ptr{GetPointerFromRasterizerCachedMemory(current_vaddr)};
-                system.GPU().FlushRegion(current_vaddr, copy_amount);
-                WriteBlock(process, dest_addr, host_ptr, copy_amount);
-                break;
-            }
-            default:
-                UNREACHABLE();
-            }
-
-            page_index++;
-            page_offset = 0;
-            dest_addr += static_cast<VAddr>(copy_amount);
-            src_addr += static_cast<VAddr>(copy_amount);
-            remaining_size -= copy_amount;
-        }
+                ZeroBlock(process, dest_addr + offset, amount);
+            },
+            [&](VAddr run_addr, std::size_t run_size) {
+                block_stats.flush_calls.fetch_add(1, std::memory_order_relaxed);
+                system.GPU().FlushRegion(run_addr, run_size);
+            },
+            [&](const Common::PageTable& page_table, VAddr vaddr, std::size_t offset,
+                std::size_t amount) {
+                std::vector<u8> buffer(amount);
+                if (!ReadBlockFromDebugHooks(page_table, vaddr, buffer.data(), amount)) {
+                    return false;
+                }
+                WriteBlock(process, dest_addr + offset, buffer.data(), amount);
+                return true;
+            },
+            [&](const u8* src_ptr, std::size_t offset, std::size_t amount) {
+                WriteBlock(process, dest_addr + offset, src_ptr, amount);
+            });
     }
 
     void CopyBlock(VAddr dest_addr, VAddr src_addr, std::size_t size) {
         return CopyBlock(*system.CurrentProcess(), dest_addr, src_addr, size);
     }
 
+    BlockStats GetBlockStats() const {
+        return {
+            .block_operations = block_stats.block_operations.load(std::memory_order_relaxed),
+            .flush_calls = block_stats.flush_calls.load(std::memory_order_relaxed),
+            .invalidate_calls = block_stats.invalidate_calls.load(std::memory_order_relaxed),
+        };
+    }
+
     void RasterizerMarkRegionCached(VAddr vaddr, u64 size, bool cached) {
         if (vaddr == 0) {
             return;
@@ -507,6 +660,8 @@ struct Memory::Impl {
         // granularity of CPU pages, hence why we iterate on a CPU page basis (note: GPU page size
         // is different). This assumes the specified GPU address region is contiguous as well.
 
+        std::lock_guard lock{debug_hooks_mutex};
+        bool changed = false;
         u64 num_pages = ((vaddr + size - 1) >> PAGE_BITS) - (vaddr >> PAGE_BITS) + 1;
         for (unsigned i = 0; i < num_pages; ++i, vaddr += PAGE_SIZE) {
             Common::PageType& page_type{current_page_table->attributes[vaddr >> PAGE_BITS]};
@@ -519,8 +674,11 @@ struct Memory::Impl {
                     // space, for example, a system module need not have a VRAM mapping.
                     break;
                 case Common::PageType::Memory:
+                case Common::PageType::Special:
+                    // Hooked pages don't call their hooks while they're cached
                     page_type = Common::PageType::RasterizerCachedMemory;
                     current_page_table->pointers[vaddr >> PAGE_BITS] = nullptr;
+                    changed = true;
                     break;
                 case Common::PageType::RasterizerCachedMemory:
                     // There can be more than one GPU region mapped per CPU region, so it's common
@@ -537,6 +695,7 @@ struct Memory::Impl {
                     // space, for example, a system module need not have a VRAM mapping.
                     break;
                 case Common::PageType::Memory:
+                case Common::PageType::Special:
                     // There can be more than one GPU region mapped per CPU region, so it's common
                     // that this area is already unmarked as cached.
                     break;
@@ -547,10 +706,17 @@ struct Memory::Impl {
                         // pagetable after unmapping a VMA. In that case the underlying VMA will no
                         // longer exist, and we should just leave the pagetable entry blank.
                         page_type = Common::PageType::Unmapped;
+                        changed = true;
+                    } else if (!current_page_table->special_regions.empty() &&
+                               HasDebugHooks(*current_page_table, vaddr & ~PAGE_MASK)) {
+                        // Hooked pages go back to calling their hooks
+                        page_type = Common::PageType::Special;
+                        changed = true;
                     } else {
                         current_page_table->pointers[vaddr >> PAGE_BITS] =
                             pointer - (vaddr & ~PAGE_MASK);
                         page_type = Common::PageType::Memory;
+                        changed = true;
                     }
                     break;
                 }
@@ -559,6 +725,9 @@ struct Memory::Impl {
                 }
             }
         }
+        if (changed) {
+            page_table_generation.fetch_add(1, std::memory_order_release);
+        }
     }
 
     /**
@@ -575,45 +744,78 @@ struct Memory::Impl {
         LOG_DEBUG(HW_Memory, "Mapping {:016X} onto {:016X}-{:016X}", target, base * PAGE_SIZE,
                   (base + size) * PAGE_SIZE);
 
+        const VAddr end = base + size;
+        ASSERT_MSG(end <= page_table.pointers.size(), "out of range mapping at {:016X}",
+                   base + page_table.pointers.size());
+
         // During boot, current_page_table might not be set yet, in which case we need not flush
-        if (system.IsPoweredOn()) {
+        if (system.IsPoweredOn() && size != 0) {
             auto& gpu = system.GPU();
-            for (u64 i = 0; i < size; i++) {
-                const auto page = base + i;
+            for (VAddr page = base; page < end;) {
+                const VAddr run_end =
+                    Common::FindPageTypeRunEnd(page_table.attributes.data(), page, end);
                 if (page_table.attributes[page] == Common::PageType::RasterizerCachedMemory) {
-                    gpu.FlushAndInvalidateRegion(page << PAGE_BITS, PAGE_SIZE);
+                    gpu.FlushAndInvalidateRegion(page << PAGE_BITS, (run_end - page) << PAGE_BITS);
                 }
+                page = run_end;
             }
         }
 
-        const VAddr end = base + size;
-        ASSERT_MSG(end <= page_table.pointers.size(), "out of range mapping at {:016X}",
-                   base + page_table.pointers.size());
-
         if (!target) {
             ASSERT_MSG(type != Common::PageType::Memory,
                        "Mapping memory page without a pointer @ {:016x}", base * PAGE_SIZE);
 
-            while (base != end) {
-                page_table.attributes[base] = type;
-                page_table.pointers[base] = nullptr;
-                page_table.backing_addr[base] = 0;
+            Common::FillPageRun(page_table, base, size, nullptr, 0, type);
+        } else {
+            // DRAM is contiguous on the host, the whole range shares the same entries
+            u8* const pointer = system.DeviceMemory().GetPointer(target);
+            ASSERT_MSG(pointer, "memory mapping base yield a nullptr within the table");
+
+            Common::FillPageRun(page_table, base, size, pointer - (base << PAGE_BITS),
+                                target - (base << PAGE_BITS), type);
+        }
+        page_table_generation.fetch_add(1, std::memory_order_release);
 
-                base += 1;
+        if (type == Common::PageType::Memory) {
+            // Memory mapped over hooked addresses keeps calling the hooks
+            std::lock_guard lock{debug_hooks_mutex};
+            if (!page_table.special_regions.empty()) {
+                UpdateHookedPages(page_table, base * PAGE_SIZE, size * PAGE_SIZE);
             }
-        } else {
-            while (base != end) {
-                page_table.pointers[base] =
-                    system.DeviceMemory().GetPointer(target) - (base << PAGE_BITS);
-                page_table.attributes[base] = type;
-                page_table.backing_addr[base] = target - (base << PAGE_BITS);
+        }
 
-                ASSERT_MSG(page_table.pointers[base],
-                           "memory mapping base yield a nullptr within the table");
+        InvalidateTranslatedCode(page_table, base, end);
+    }
 
-                base += 1;
-                target += PAGE_SIZE;
+    /**
+     * Invalidates the CPU instruction caches of the code translated from remapped pages. Only the
+     * runs of pages instructions were read from are invalidated.
+     *
+     * @param page_table The page table the pages were remapped in.
+     * @param first      Index of the first remapped page.
+     * @param last       Index past the last remapped page.
+     */
+    void InvalidateTranslatedCode(Common::PageTable& page_table, VAddr first, VAddr last) {
+        u8* const translated_code = page_table.translated_code.data();
+        // Clears the flag of a page, returning whether code was translated from it
+        const auto take_flag = [translated_code](VAddr page) {
+            std::atomic_ref flag{translated_code[page]};
+            if (flag.load(std::memory_order_relaxed) == 0) {
+                return false;
             }
+            flag.store(0, std::memory_order_relaxed);
+            return true;
+        };
+        for (VAddr page = first; page < last; ++page) {
+            if (!take_flag(page)) {
+                continue;
+            }
+            const VAddr run_begin = page;
+            while (page + 1 < last && take_flag(page + 1)) {
+                ++page;
+            }
+            system.InvalidateCpuInstructionCacheRange(run_begin << PAGE_BITS,
+                                                      (page + 1 - run_begin) << PAGE_BITS);
         }
     }
 
@@ -653,6 +855,14 @@ struct Memory::Impl {
             std::memcpy(&value, host_ptr, sizeof(T));
             return value;
         }
+        case Common::PageType::Special: {
+            if (const std::optional<T> value = ReadFromDebugHooks<T>(vaddr)) {
+                return *value;
+            }
+            T value;
+            std::memcpy(&value, GetPointerFromRasterizerCachedMemory(vaddr), sizeof(T));
+            return value;
+        }
         default:
             UNREACHABLE();
         }
@@ -694,6 +904,11 @@ struct Memory::Impl {
             std::memcpy(host_ptr, &data, sizeof(T));
             break;
         }
+        case Common::PageType::Special:
+            if (!WriteToDebugHooks(vaddr, data)) {
+                std::memcpy(GetPointerFromRasterizerCachedMemory(vaddr), &data, sizeof(T));
+            }
+            break;
         default:
             UNREACHABLE();
         }
@@ -723,6 +938,8 @@ struct Memory::Impl {
             auto* pointer = reinterpret_cast<volatile T*>(&host_ptr);
             return Common::AtomicCompareAndSwap(pointer, data, expected);
         }
+        case Common::PageType::Special:
+            return WriteExclusiveToDebugHooks(vaddr, data, expected);
         default:
             UNREACHABLE();
         }
@@ -752,6 +969,8 @@ struct Memory::Impl {
             auto* pointer = reinterpret_cast<volatile u64*>(&host_ptr);
             return Common::AtomicCompareAndSwap(pointer, data, expected);
         }
+        case Common::PageType::Special:
+            return WriteExclusiveToDebugHooks(vaddr, data, expected);
         default:
             UNREACHABLE();
         }
@@ -760,6 +979,19 @@ struct Memory::Impl {
 
     Common::PageTable* current_page_table = nullptr;
     Core::System& system;
+
+    struct {
+        std::atomic<u64> block_operations{};
+        std::atomic<u64> flush_calls{};
+        std::atomic<u64> invalidate_calls{};
+    } block_stats;
+
+    /// Incremented whenever pointers returned by GetUncachedPointer may have become stale
+    std::atomic<u64> page_table_generation{};
+
+    /// Guards the special regions of the page tables. Hooks are called with it held, so they must
+    /// not wait on threads adding or removing hooks.
+    std::recursive_mutex debug_hooks_mutex;
 };
 
 Memory::Memory(Core::System& system) : impl{std::make_unique<Impl>(system)} {}
@@ -792,6 +1024,14 @@ void Memory::RemoveDebugHook(Common::PageTable& page_table, VAddr base, u64 size
     impl->RemoveDebugHook(page_table, base, size, std::move(hook));
 }
 
+void Memory::AddDebugHook(VAddr base, u64 size, Common::MemoryHookPointer hook) {
+    impl->AddDebugHook(base, size, std::move(hook));
+}
+
+void Memory::RemoveDebugHook(VAddr base, u64 size, Common::MemoryHookPointer hook) {
+    impl->RemoveDebugHook(base, size, std::move(hook));
+}
+
 bool Memory::IsValidVirtualAddress(const Kernel::Process& process, const VAddr vaddr) const {
     return impl->IsValidVirtualAddress(process, vaddr);
 }
@@ -808,6 +1048,14 @@ const u8* Memory::GetPointer(VAddr vaddr) const {
     return impl->GetPointer(vaddr);
 }
 
+u8* Memory::GetUncachedPointer(VAddr vaddr) {
+    return impl->GetUncachedPointer(vaddr);
+}
+
+u64 Memory::GetPageTableGeneration() const {
+    return impl->GetPageTableGeneration();
+}
+
 u8 Memory::Read8(const VAddr addr) {
     return impl->Read8(addr);
 }
@@ -820,6 +1068,10 @@ u32 Memory::Read32(const VAddr addr) {
     return impl->Read32(addr);
 }
 
+u32 Memory::ReadCode32(const VAddr addr) {
+    return impl->ReadCode32(addr);
+}
+
 u64 Memory::Read64(const VAddr addr) {
     return impl->Read64(addr);
 }
@@ -922,6 +1174,10 @@ void Memory::RasterizerMarkRegionCached(VAddr vaddr, u64 size, bool cached) {
     impl->RasterizerMarkRegionCached(vaddr, size, cached);
 }
 
+BlockStats Memory::GetBlockStats() const {
+    return impl->GetBlockStats();
+}
+
 bool IsKernelVirtualAddress(const VAddr vaddr) {
     return KERNEL_REGION_VADDR <= vaddr && vaddr < KERNEL_REGION_END;
 }
@@ -47,6 +47,17 @@ enum : VAddr {
     KERNEL_REGION_END = KERNEL_REGION_VADDR + KERNEL_REGION_SIZE,
 };
 
+/// Counters of the rasterizer cache synchronization done by block operations
+struct BlockStats {
+    /// Block reads, writes, zeroes and copies that check the rasterizer cache, including the
+    /// writes issued by copies
+    u64 block_operations{};
+    /// Flushes of rasterizer cached runs of pages before they are read
+    u64 flush_calls{};
+    /// Invalidations of rasterizer cached runs of pages before they are written
+    u64 invalidate_calls{};
+};
+
 /// Central class that handles all memory operations and state.
 class Memory {
 public:
@@ -119,6 +130,29 @@ public:
     void RemoveDebugHook(Common::PageTable& page_table, VAddr base, u64 size,
                          Common::MemoryHookPointer hook);
 
+    /**
+     * Adds a memory hook to intercept reads and writes to given region of the current process'
+     * memory. Pages covered by hooks are taken off the fast paths until the hooks are removed.
+     *
+     * Hooks are called with a lock held that adding and removing hooks also take, so they must
+     * not wait on threads doing either.
+     *
+     * @param base The starting address to apply the hook to.
+     * @param size The size of the memory region to apply the hook to, in bytes.
+     * @param hook The hook to apply to the region of memory.
+     */
+    void AddDebugHook(VAddr base, u64 size, Common::MemoryHookPointer hook);
+
+    /**
+     * Removes a memory hook from a given range of the current process' memory. Does nothing when
+     * there is no current process, its hooks went away with its page table.
+     *
+     * @param base The starting address to remove the hook from.
+     * @param size The size of the memory region to remove the hook from, in bytes.
+     * @param hook The hook to remove from the specified region of memory.
+     */
+    void RemoveDebugHook(VAddr base, u64 size, Common::MemoryHookPointer hook);
+
     /**
      * Checks whether or not the supplied address is a valid virtual
      * address for the given process.
@@ -160,6 +194,21 @@ public:
      */
     const u8* GetPointer(VAddr vaddr) const;
 
+    /**
+     * Gets a pointer to the given address if it is mapped to memory that isn't cached by the
+     * rasterizer, so it can be accessed directly without synchronizing with the GPU.
+     *
+     * The pointer stays valid until GetPageTableGeneration changes.
+     *
+     * @param vaddr Virtual address to retrieve a pointer to.
+     *
+     * @returns The pointer to the given address, or nullptr if the page isn't plain memory.
+     */
+    u8* GetUncachedPointer(VAddr vaddr);
+
+    /// Returns a counter incremented whenever pages are mapped, unmapped or change cache state
+    u64 GetPageTableGeneration() const;
+
     /**
      * Reads an 8-bit unsigned value from the current process' address space
      * at the given virtual address.
@@ -190,6 +239,16 @@ public:
      */
     u32 Read32(VAddr addr);
 
+    /**
+     * Reads a 32-bit instruction from the current process' address space for translation.
+     * Remapping the page it was read from invalidates the CPU instruction caches of its range.
+     *
+     * @param addr The virtual address to read the instruction from.
+     *
+     * @returns the read 32-bit instruction.
+     */
+    u32 ReadCode32(VAddr addr);
+
     /**
      * Reads a 64-bit unsigned value from the current process' address space
      * at the given virtual address.
@@ -547,6 +606,9 @@ public:
      */
     void RasterizerMarkRegionCached(VAddr vaddr, u64 size, bool cached);
 
+    /// Returns the rasterizer cache synchronization counters of block operations
+    BlockStats GetBlockStats() const;
+
 private:
     struct Impl;
     std::unique_ptr<Impl> impl;
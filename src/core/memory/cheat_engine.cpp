@@ -61,11 +61,28 @@ void StandardVmCallbacks::CommandLog(std::string_view data) {
               data.back() == '\n' ? data.substr(0, data.size() - 1) : data);
 }
 
+u8* StandardVmCallbacks::GetPagePointer(VAddr address) {
+    // Pages outside of the cheat regions go through SanitizeAddress, which reports them
+    if (!IsValidCheatAddress(address)) {
+        return nullptr;
+    }
+    u8* const pointer = system.Memory().GetUncachedPointer(address);
+    return pointer ? pointer - (address & PAGE_MASK) : nullptr;
+}
+
+u64 StandardVmCallbacks::GetMemoryGeneration() {
+    return system.Memory().GetPageTableGeneration();
+}
+
+bool StandardVmCallbacks::IsValidCheatAddress(VAddr address) const {
+    return (address >= metadata.main_nso_extents.base &&
+            address < metadata.main_nso_extents.base + metadata.main_nso_extents.size) ||
+           (address >= metadata.heap_extents.base &&
+            address < metadata.heap_extents.base + metadata.heap_extents.size);
+}
+
 VAddr StandardVmCallbacks::SanitizeAddress(VAddr in) const {
-    if ((in < metadata.main_nso_extents.base ||
-         in >= metadata.main_nso_extents.base + metadata.main_nso_extents.size) &&
-        (in < metadata.heap_extents.base ||
-         in >= metadata.heap_extents.base + metadata.heap_extents.size)) {
+    if (!IsValidCheatAddress(in)) {
         LOG_ERROR(CheatEngine,
                   "Cheat attempting to access memory at invalid address={:016X}, if this "
                   "persists, "
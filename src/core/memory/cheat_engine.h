@@ -33,8 +33,11 @@ public:
     u64 HidKeysDown() override;
     void DebugLog(u8 id, u64 value) override;
     void CommandLog(std::string_view data) override;
+    u8* GetPagePointer(VAddr address) override;
+    u64 GetMemoryGeneration() override;
 
 private:
+    bool IsValidCheatAddress(VAddr address) const;
     VAddr SanitizeAddress(VAddr address) const;
 
     const CheatProcessMetadata& metadata;
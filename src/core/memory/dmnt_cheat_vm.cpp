@@ -22,8 +22,11 @@
  * Refer to the license.txt file included.
  */
 
+#include <cstring>
+#include <type_traits>
 #include "common/assert.h"
 #include "common/scope_exit.h"
+#include "core/memory.h"
 #include "core/memory/dmnt_cheat_types.h"
 #include "core/memory/dmnt_cheat_vm.h"
 
@@ -240,6 +243,14 @@ void DmntCheatVm::LogOpcode(const CheatVmOpcode& opcode) {
 
 DmntCheatVm::Callbacks::~Callbacks() = default;
 
+u8* DmntCheatVm::Callbacks::GetPagePointer(VAddr) {
+    return nullptr;
+}
+
+u64 DmntCheatVm::Callbacks::GetMemoryGeneration() {
+    return 0;
+}
+
 bool DmntCheatVm::DecodeNextOpcode(CheatVmOpcode& out) {
     // If we've ever seen a decode failure, return false.
     bool valid = decode_success;
@@ -641,36 +652,6 @@ bool DmntCheatVm::DecodeNextOpcode(CheatVmOpcode& out) {
     return valid;
 }
 
-void DmntCheatVm::SkipConditionalBlock() {
-    if (condition_depth > 0) {
-        // We want to continue until we're out of the current block.
-        const std::size_t desired_depth = condition_depth - 1;
-
-        CheatVmOpcode skip_opcode{};
-        while (condition_depth > desired_depth && DecodeNextOpcode(skip_opcode)) {
-            // Decode instructions until we see end of the current conditional block.
-            // NOTE: This is broken in gateway's implementation.
-            // Gateway currently checks for "0x2" instead of "0x20000000"
-            // In addition, they do a linear scan instead of correctly decoding opcodes.
-            // This causes issues if "0x2" appears as an immediate in the conditional block...
-
-            // We also support nesting of conditional blocks, and Gateway does not.
-            if (skip_opcode.begin_conditional_block) {
-                condition_depth++;
-            } else if (std::holds_alternative<EndConditionalOpcode>(skip_opcode.opcode)) {
-                condition_depth--;
-            }
-        }
-    } else {
-        // Skipping, but condition_depth = 0.
-        // This is an error condition.
-        // However, I don't actually believe it is possible for this to happen.
-        // I guess we'll throw a fatal error here, so as to encourage me to fix the VM
-        // in the event that someone triggers it? I don't know how you'd do that.
-        UNREACHABLE_MSG("Invalid condition depth in DMNT Cheat VM");
-    }
-}
-
 u64 DmntCheatVm::GetVmInt(VmInt value, u32 bit_width) {
     switch (bit_width) {
     case 1:
@@ -703,9 +684,6 @@ void DmntCheatVm::ResetState() {
     saved_values.fill(0);
     loop_tops.fill(0);
     static_registers.fill(0);
-    instruction_ptr = 0;
-    condition_depth = 0;
-    decode_success = true;
 }
 
 bool DmntCheatVm::LoadProgram(const std::vector<CheatEntry>& entries) {
@@ -717,6 +695,7 @@ bool DmntCheatVm::LoadProgram(const std::vector<CheatEntry>& entries) {
             // Bounds check.
             if (entries[i].definition.num_opcodes + num_opcodes > MaximumProgramOpcodeCount) {
                 num_opcodes = 0;
+                compiled_program.clear();
                 return false;
             }
 
@@ -726,532 +705,638 @@ bool DmntCheatVm::LoadProgram(const std::vector<CheatEntry>& entries) {
         }
     }
 
+    CompileProgram();
     return true;
 }
 
-void DmntCheatVm::Execute(const CheatProcessMetadata& metadata) {
-    CheatVmOpcode cur_opcode{};
+void DmntCheatVm::ReadMemory(VAddr address, void* data, u64 size) {
+    if (const u8* const pointer = GetDirectPointer(address, size)) {
+        std::memcpy(data, pointer, size);
+    } else {
+        callbacks->MemoryRead(address, data, size);
+    }
+}
 
-    // Get Keys down.
-    u64 kDown = callbacks->HidKeysDown();
+void DmntCheatVm::WriteMemory(VAddr address, const void* data, u64 size) {
+    if (u8* const pointer = GetDirectPointer(address, size)) {
+        std::memcpy(pointer, data, size);
+    } else {
+        callbacks->MemoryWrite(address, data, size);
+    }
+}
 
-    callbacks->CommandLog("Started VM execution.");
-    callbacks->CommandLog(fmt::format("Main NSO:  {:012X}", metadata.main_nso_extents.base));
-    callbacks->CommandLog(fmt::format("Heap:      {:012X}", metadata.main_nso_extents.base));
-    callbacks->CommandLog(fmt::format("Keys Down: {:08X}", static_cast<u32>(kDown & 0x0FFFFFFF)));
+u8* DmntCheatVm::GetDirectPointer(VAddr address, u64 size) {
+    const u64 page = address >> PAGE_BITS;
+    const u64 page_offset = address & PAGE_MASK;
+    if (page_offset + size > PAGE_SIZE) {
+        return nullptr;
+    }
+    // The page table can change while the VM runs, so pointers are revalidated on every access
+    const u64 generation = callbacks->GetMemoryGeneration();
+    PageCacheEntry& entry = page_cache[page % page_cache.size()];
+    if (entry.page != page || entry.generation != generation) {
+        entry.page = page;
+        entry.generation = generation;
+        entry.pointer = callbacks->GetPagePointer(page << PAGE_BITS);
+    }
+    return entry.pointer ? entry.pointer + page_offset : nullptr;
+}
 
-    // Clear VM state.
-    ResetState();
+namespace {
+bool IsConditionMet(ConditionalComparisonType cond_type, u64 src_value, u64 cond_value) {
+    switch (cond_type) {
+    case ConditionalComparisonType::GT:
+        return src_value > cond_value;
+    case ConditionalComparisonType::GE:
+        return src_value >= cond_value;
+    case ConditionalComparisonType::LT:
+        return src_value < cond_value;
+    case ConditionalComparisonType::LE:
+        return src_value <= cond_value;
+    case ConditionalComparisonType::EQ:
+        return src_value == cond_value;
+    case ConditionalComparisonType::NE:
+        return src_value != cond_value;
+    }
+    return false;
+}
+} // Anonymous namespace
 
-    // Loop until program finishes.
-    while (DecodeNextOpcode(cur_opcode)) {
-        callbacks->CommandLog(
-            fmt::format("Instruction Ptr: {:04X}", static_cast<u32>(instruction_ptr)));
+template <>
+std::size_t DmntCheatVm::ExecuteOpcode<StoreStaticOpcode>(const CompiledOpcode& op,
+                                                          std::size_t index) {
+    const auto& store_static = std::get<StoreStaticOpcode>(op.opcode.opcode);
+    // Calculate address, write value to memory.
+    u64 dst_address =
+        GetCheatProcessAddress(*current_metadata, store_static.mem_type,
+                               store_static.rel_address + registers[store_static.offset_register]);
+    u64 dst_value = GetVmInt(store_static.value, store_static.bit_width);
+    switch (store_static.bit_width) {
+    case 1:
+    case 2:
+    case 4:
+    case 8:
+        WriteMemory(dst_address, &dst_value, store_static.bit_width);
+        break;
+    }
+    return index + 1;
+}
 
-        for (std::size_t i = 0; i < NumRegisters; i++) {
-            callbacks->CommandLog(fmt::format("Registers[{:02X}]: {:016X}", i, registers[i]));
-        }
+template <>
+std::size_t DmntCheatVm::ExecuteOpcode<BeginConditionalOpcode>(const CompiledOpcode& op,
+                                                               std::size_t index) {
+    const auto& begin_cond = std::get<BeginConditionalOpcode>(op.opcode.opcode);
+    // Read value from memory.
+    u64 src_address =
+        GetCheatProcessAddress(*current_metadata, begin_cond.mem_type, begin_cond.rel_address);
+    u64 src_value = 0;
+    switch (begin_cond.bit_width) {
+    case 1:
+    case 2:
+    case 4:
+    case 8:
+        ReadMemory(src_address, &src_value, begin_cond.bit_width);
+        break;
+    }
+    // Check against condition, skip conditional block if condition not met.
+    u64 cond_value = GetVmInt(begin_cond.value, begin_cond.bit_width);
+    if (!IsConditionMet(begin_cond.cond_type, src_value, cond_value)) {
+        return op.skip_target;
+    }
+    return index + 1;
+}
 
-        for (std::size_t i = 0; i < NumRegisters; i++) {
-            callbacks->CommandLog(fmt::format("SavedRegs[{:02X}]: {:016X}", i, saved_values[i]));
-        }
-        LogOpcode(cur_opcode);
+template <>
+std::size_t DmntCheatVm::ExecuteOpcode<EndConditionalOpcode>(const CompiledOpcode&,
+                                                             std::size_t index) {
+    // We will assume, graciously, that mismatched conditional block ends are a nop.
+    return index + 1;
+}
 
-        // Increment conditional depth, if relevant.
-        if (cur_opcode.begin_conditional_block) {
-            condition_depth++;
+template <>
+std::size_t DmntCheatVm::ExecuteOpcode<ControlLoopOpcode>(const CompiledOpcode& op,
+                                                          std::size_t index) {
+    const auto& ctrl_loop = std::get<ControlLoopOpcode>(op.opcode.opcode);
+    if (ctrl_loop.start_loop) {
+        // Start a loop.
+        registers[ctrl_loop.reg_index] = ctrl_loop.num_iters;
+        loop_tops[ctrl_loop.reg_index] = index + 1;
+    } else {
+        // End a loop.
+        registers[ctrl_loop.reg_index]--;
+        if (registers[ctrl_loop.reg_index] != 0) {
+            return loop_tops[ctrl_loop.reg_index];
         }
+    }
+    return index + 1;
+}
 
-        if (auto store_static = std::get_if<StoreStaticOpcode>(&cur_opcode.opcode)) {
-            // Calculate address, write value to memory.
-            u64 dst_address = GetCheatProcessAddress(metadata, store_static->mem_type,
-                                                     store_static->rel_address +
-                                                         registers[store_static->offset_register]);
-            u64 dst_value = GetVmInt(store_static->value, store_static->bit_width);
-            switch (store_static->bit_width) {
-            case 1:
-            case 2:
-            case 4:
-            case 8:
-                callbacks->MemoryWrite(dst_address, &dst_value, store_static->bit_width);
-                break;
-            }
-        } else if (auto begin_cond = std::get_if<BeginConditionalOpcode>(&cur_opcode.opcode)) {
-            // Read value from memory.
-            u64 src_address =
-                GetCheatProcessAddress(metadata, begin_cond->mem_type, begin_cond->rel_address);
-            u64 src_value = 0;
-            switch (store_static->bit_width) {
-            case 1:
-            case 2:
-            case 4:
-            case 8:
-                callbacks->MemoryRead(src_address, &src_value, begin_cond->bit_width);
-                break;
-            }
-            // Check against condition.
-            u64 cond_value = GetVmInt(begin_cond->value, begin_cond->bit_width);
-            bool cond_met = false;
-            switch (begin_cond->cond_type) {
-            case ConditionalComparisonType::GT:
-                cond_met = src_value > cond_value;
-                break;
-            case ConditionalComparisonType::GE:
-                cond_met = src_value >= cond_value;
-                break;
-            case ConditionalComparisonType::LT:
-                cond_met = src_value < cond_value;
-                break;
-            case ConditionalComparisonType::LE:
-                cond_met = src_value <= cond_value;
-                break;
-            case ConditionalComparisonType::EQ:
-                cond_met = src_value == cond_value;
-                break;
-            case ConditionalComparisonType::NE:
-                cond_met = src_value != cond_value;
-                break;
-            }
-            // Skip conditional block if condition not met.
-            if (!cond_met) {
-                SkipConditionalBlock();
-            }
-        } else if (std::holds_alternative<EndConditionalOpcode>(cur_opcode.opcode)) {
-            // Decrement the condition depth.
-            // We will assume, graciously, that mismatched conditional block ends are a nop.
-            if (condition_depth > 0) {
-                condition_depth--;
-            }
-        } else if (auto ctrl_loop = std::get_if<ControlLoopOpcode>(&cur_opcode.opcode)) {
-            if (ctrl_loop->start_loop) {
-                // Start a loop.
-                registers[ctrl_loop->reg_index] = ctrl_loop->num_iters;
-                loop_tops[ctrl_loop->reg_index] = instruction_ptr;
-            } else {
-                // End a loop.
-                registers[ctrl_loop->reg_index]--;
-                if (registers[ctrl_loop->reg_index] != 0) {
-                    instruction_ptr = loop_tops[ctrl_loop->reg_index];
-                }
-            }
-        } else if (auto ldr_static = std::get_if<LoadRegisterStaticOpcode>(&cur_opcode.opcode)) {
-            // Set a register to a static value.
-            registers[ldr_static->reg_index] = ldr_static->value;
-        } else if (auto ldr_memory = std::get_if<LoadRegisterMemoryOpcode>(&cur_opcode.opcode)) {
-            // Choose source address.
-            u64 src_address;
-            if (ldr_memory->load_from_reg) {
-                src_address = registers[ldr_memory->reg_index] + ldr_memory->rel_address;
-            } else {
-                src_address =
-                    GetCheatProcessAddress(metadata, ldr_memory->mem_type, ldr_memory->rel_address);
-            }
-            // Read into register. Gateway only reads on valid bitwidth.
-            switch (ldr_memory->bit_width) {
-            case 1:
-            case 2:
-            case 4:
-            case 8:
-                callbacks->MemoryRead(src_address, &registers[ldr_memory->reg_index],
-                                      ldr_memory->bit_width);
-                break;
-            }
-        } else if (auto str_static = std::get_if<StoreStaticToAddressOpcode>(&cur_opcode.opcode)) {
-            // Calculate address.
-            u64 dst_address = registers[str_static->reg_index];
-            u64 dst_value = str_static->value;
-            if (str_static->add_offset_reg) {
-                dst_address += registers[str_static->offset_reg_index];
-            }
-            // Write value to memory. Gateway only writes on valid bitwidth.
-            switch (str_static->bit_width) {
-            case 1:
-            case 2:
-            case 4:
-            case 8:
-                callbacks->MemoryWrite(dst_address, &dst_value, str_static->bit_width);
-                break;
-            }
-            // Increment register if relevant.
-            if (str_static->increment_reg) {
-                registers[str_static->reg_index] += str_static->bit_width;
-            }
-        } else if (auto perform_math_static =
-                       std::get_if<PerformArithmeticStaticOpcode>(&cur_opcode.opcode)) {
-            // Do requested math.
-            switch (perform_math_static->math_type) {
-            case RegisterArithmeticType::Addition:
-                registers[perform_math_static->reg_index] +=
-                    static_cast<u64>(perform_math_static->value);
-                break;
-            case RegisterArithmeticType::Subtraction:
-                registers[perform_math_static->reg_index] -=
-                    static_cast<u64>(perform_math_static->value);
-                break;
-            case RegisterArithmeticType::Multiplication:
-                registers[perform_math_static->reg_index] *=
-                    static_cast<u64>(perform_math_static->value);
-                break;
-            case RegisterArithmeticType::LeftShift:
-                registers[perform_math_static->reg_index] <<=
-                    static_cast<u64>(perform_math_static->value);
-                break;
-            case RegisterArithmeticType::RightShift:
-                registers[perform_math_static->reg_index] >>=
-                    static_cast<u64>(perform_math_static->value);
-                break;
-            default:
-                // Do not handle extensions here.
-                break;
-            }
-            // Apply bit width.
-            switch (perform_math_static->bit_width) {
-            case 1:
-                registers[perform_math_static->reg_index] =
-                    static_cast<u8>(registers[perform_math_static->reg_index]);
-                break;
-            case 2:
-                registers[perform_math_static->reg_index] =
-                    static_cast<u16>(registers[perform_math_static->reg_index]);
-                break;
-            case 4:
-                registers[perform_math_static->reg_index] =
-                    static_cast<u32>(registers[perform_math_static->reg_index]);
-                break;
-            case 8:
-                registers[perform_math_static->reg_index] =
-                    static_cast<u64>(registers[perform_math_static->reg_index]);
-                break;
-            }
-        } else if (auto begin_keypress_cond =
-                       std::get_if<BeginKeypressConditionalOpcode>(&cur_opcode.opcode)) {
-            // Check for keypress.
-            if ((begin_keypress_cond->key_mask & kDown) != begin_keypress_cond->key_mask) {
-                // Keys not pressed. Skip conditional block.
-                SkipConditionalBlock();
-            }
-        } else if (auto perform_math_reg =
-                       std::get_if<PerformArithmeticRegisterOpcode>(&cur_opcode.opcode)) {
-            const u64 operand_1_value = registers[perform_math_reg->src_reg_1_index];
-            const u64 operand_2_value =
-                perform_math_reg->has_immediate
-                    ? GetVmInt(perform_math_reg->value, perform_math_reg->bit_width)
-                    : registers[perform_math_reg->src_reg_2_index];
-
-            u64 res_val = 0;
-            // Do requested math.
-            switch (perform_math_reg->math_type) {
-            case RegisterArithmeticType::Addition:
-                res_val = operand_1_value + operand_2_value;
-                break;
-            case RegisterArithmeticType::Subtraction:
-                res_val = operand_1_value - operand_2_value;
-                break;
-            case RegisterArithmeticType::Multiplication:
-                res_val = operand_1_value * operand_2_value;
-                break;
-            case RegisterArithmeticType::LeftShift:
-                res_val = operand_1_value << operand_2_value;
-                break;
-            case RegisterArithmeticType::RightShift:
-                res_val = operand_1_value >> operand_2_value;
-                break;
-            case RegisterArithmeticType::LogicalAnd:
-                res_val = operand_1_value & operand_2_value;
-                break;
-            case RegisterArithmeticType::LogicalOr:
-                res_val = operand_1_value | operand_2_value;
-                break;
-            case RegisterArithmeticType::LogicalNot:
-                res_val = ~operand_1_value;
-                break;
-            case RegisterArithmeticType::LogicalXor:
-                res_val = operand_1_value ^ operand_2_value;
-                break;
-            case RegisterArithmeticType::None:
-                res_val = operand_1_value;
-                break;
-            }
+template <>
+std::size_t DmntCheatVm::ExecuteOpcode<LoadRegisterStaticOpcode>(const CompiledOpcode& op,
+                                                                 std::size_t index) {
+    const auto& ldr_static = std::get<LoadRegisterStaticOpcode>(op.opcode.opcode);
+    // Set a register to a static value.
+    registers[ldr_static.reg_index] = ldr_static.value;
+    return index + 1;
+}
 
-            // Apply bit width.
-            switch (perform_math_reg->bit_width) {
-            case 1:
-                res_val = static_cast<u8>(res_val);
-                break;
-            case 2:
-                res_val = static_cast<u16>(res_val);
-                break;
-            case 4:
-                res_val = static_cast<u32>(res_val);
-                break;
-            case 8:
-                res_val = static_cast<u64>(res_val);
-                break;
-            }
+template <>
+std::size_t DmntCheatVm::ExecuteOpcode<LoadRegisterMemoryOpcode>(const CompiledOpcode& op,
+                                                                 std::size_t index) {
+    const auto& ldr_memory = std::get<LoadRegisterMemoryOpcode>(op.opcode.opcode);
+    // Choose source address.
+    u64 src_address;
+    if (ldr_memory.load_from_reg) {
+        src_address = registers[ldr_memory.reg_index] + ldr_memory.rel_address;
+    } else {
+        src_address =
+            GetCheatProcessAddress(*current_metadata, ldr_memory.mem_type, ldr_memory.rel_address);
+    }
+    // Read into register. Gateway only reads on valid bitwidth.
+    switch (ldr_memory.bit_width) {
+    case 1:
+    case 2:
+    case 4:
+    case 8:
+        ReadMemory(src_address, &registers[ldr_memory.reg_index], ldr_memory.bit_width);
+        break;
+    }
+    return index + 1;
+}
 
-            // Save to register.
-            registers[perform_math_reg->dst_reg_index] = res_val;
-        } else if (auto str_register =
-                       std::get_if<StoreRegisterToAddressOpcode>(&cur_opcode.opcode)) {
-            // Calculate address.
-            u64 dst_value = registers[str_register->str_reg_index];
-            u64 dst_address = registers[str_register->addr_reg_index];
-            switch (str_register->ofs_type) {
-            case StoreRegisterOffsetType::None:
-                // Nothing more to do
-                break;
-            case StoreRegisterOffsetType::Reg:
-                dst_address += registers[str_register->ofs_reg_index];
-                break;
-            case StoreRegisterOffsetType::Imm:
-                dst_address += str_register->rel_address;
-                break;
-            case StoreRegisterOffsetType::MemReg:
-                dst_address = GetCheatProcessAddress(metadata, str_register->mem_type,
-                                                     registers[str_register->addr_reg_index]);
-                break;
-            case StoreRegisterOffsetType::MemImm:
-                dst_address = GetCheatProcessAddress(metadata, str_register->mem_type,
-                                                     str_register->rel_address);
-                break;
-            case StoreRegisterOffsetType::MemImmReg:
-                dst_address = GetCheatProcessAddress(metadata, str_register->mem_type,
-                                                     registers[str_register->addr_reg_index] +
-                                                         str_register->rel_address);
-                break;
-            }
+template <>
+std::size_t DmntCheatVm::ExecuteOpcode<StoreStaticToAddressOpcode>(const CompiledOpcode& op,
+                                                                   std::size_t index) {
+    const auto& str_static = std::get<StoreStaticToAddressOpcode>(op.opcode.opcode);
+    // Calculate address.
+    u64 dst_address = registers[str_static.reg_index];
+    u64 dst_value = str_static.value;
+    if (str_static.add_offset_reg) {
+        dst_address += registers[str_static.offset_reg_index];
+    }
+    // Write value to memory. Gateway only writes on valid bitwidth.
+    switch (str_static.bit_width) {
+    case 1:
+    case 2:
+    case 4:
+    case 8:
+        WriteMemory(dst_address, &dst_value, str_static.bit_width);
+        break;
+    }
+    // Increment register if relevant.
+    if (str_static.increment_reg) {
+        registers[str_static.reg_index] += str_static.bit_width;
+    }
+    return index + 1;
+}
 
-            // Write value to memory. Write only on valid bitwidth.
-            switch (str_register->bit_width) {
-            case 1:
-            case 2:
-            case 4:
-            case 8:
-                callbacks->MemoryWrite(dst_address, &dst_value, str_register->bit_width);
-                break;
-            }
+template <>
+std::size_t DmntCheatVm::ExecuteOpcode<PerformArithmeticStaticOpcode>(const CompiledOpcode& op,
+                                                                      std::size_t index) {
+    const auto& perform_math_static = std::get<PerformArithmeticStaticOpcode>(op.opcode.opcode);
+    u64& reg = registers[perform_math_static.reg_index];
+    // Do requested math.
+    switch (perform_math_static.math_type) {
+    case RegisterArithmeticType::Addition:
+        reg += static_cast<u64>(perform_math_static.value);
+        break;
+    case RegisterArithmeticType::Subtraction:
+        reg -= static_cast<u64>(perform_math_static.value);
+        break;
+    case RegisterArithmeticType::Multiplication:
+        reg *= static_cast<u64>(perform_math_static.value);
+        break;
+    case RegisterArithmeticType::LeftShift:
+        reg <<= static_cast<u64>(perform_math_static.value);
+        break;
+    case RegisterArithmeticType::RightShift:
+        reg >>= static_cast<u64>(perform_math_static.value);
+        break;
+    default:
+        // Do not handle extensions here.
+        break;
+    }
+    // Apply bit width.
+    switch (perform_math_static.bit_width) {
+    case 1:
+        reg = static_cast<u8>(reg);
+        break;
+    case 2:
+        reg = static_cast<u16>(reg);
+        break;
+    case 4:
+        reg = static_cast<u32>(reg);
+        break;
+    case 8:
+        reg = static_cast<u64>(reg);
+        break;
+    }
+    return index + 1;
+}
 
-            // Increment register if relevant.
-            if (str_register->increment_reg) {
-                registers[str_register->addr_reg_index] += str_register->bit_width;
-            }
-        } else if (auto begin_reg_cond =
-                       std::get_if<BeginRegisterConditionalOpcode>(&cur_opcode.opcode)) {
-            // Get value from register.
-            u64 src_value = 0;
-            switch (begin_reg_cond->bit_width) {
-            case 1:
-                src_value = static_cast<u8>(registers[begin_reg_cond->val_reg_index] & 0xFFul);
-                break;
-            case 2:
-                src_value = static_cast<u16>(registers[begin_reg_cond->val_reg_index] & 0xFFFFul);
-                break;
-            case 4:
-                src_value =
-                    static_cast<u32>(registers[begin_reg_cond->val_reg_index] & 0xFFFFFFFFul);
-                break;
-            case 8:
-                src_value = static_cast<u64>(registers[begin_reg_cond->val_reg_index] &
-                                             0xFFFFFFFFFFFFFFFFul);
-                break;
-            }
+template <>
+std::size_t DmntCheatVm::ExecuteOpcode<BeginKeypressConditionalOpcode>(const CompiledOpcode& op,
+                                                                       std::size_t index) {
+    const auto& begin_keypress_cond = std::get<BeginKeypressConditionalOpcode>(op.opcode.opcode);
+    // Check for keypress.
+    if ((begin_keypress_cond.key_mask & keys_down) != begin_keypress_cond.key_mask) {
+        // Keys not pressed. Skip conditional block.
+        return op.skip_target;
+    }
+    return index + 1;
+}
 
-            // Read value from memory.
-            u64 cond_value = 0;
-            if (begin_reg_cond->comp_type == CompareRegisterValueType::StaticValue) {
-                cond_value = GetVmInt(begin_reg_cond->value, begin_reg_cond->bit_width);
-            } else if (begin_reg_cond->comp_type == CompareRegisterValueType::OtherRegister) {
-                switch (begin_reg_cond->bit_width) {
-                case 1:
-                    cond_value =
-                        static_cast<u8>(registers[begin_reg_cond->other_reg_index] & 0xFFul);
-                    break;
-                case 2:
-                    cond_value =
-                        static_cast<u16>(registers[begin_reg_cond->other_reg_index] & 0xFFFFul);
-                    break;
-                case 4:
-                    cond_value =
-                        static_cast<u32>(registers[begin_reg_cond->other_reg_index] & 0xFFFFFFFFul);
-                    break;
-                case 8:
-                    cond_value = static_cast<u64>(registers[begin_reg_cond->other_reg_index] &
-                                                  0xFFFFFFFFFFFFFFFFul);
-                    break;
-                }
-            } else {
-                u64 cond_address = 0;
-                switch (begin_reg_cond->comp_type) {
-                case CompareRegisterValueType::MemoryRelAddr:
-                    cond_address = GetCheatProcessAddress(metadata, begin_reg_cond->mem_type,
-                                                          begin_reg_cond->rel_address);
-                    break;
-                case CompareRegisterValueType::MemoryOfsReg:
-                    cond_address = GetCheatProcessAddress(metadata, begin_reg_cond->mem_type,
-                                                          registers[begin_reg_cond->ofs_reg_index]);
-                    break;
-                case CompareRegisterValueType::RegisterRelAddr:
-                    cond_address =
-                        registers[begin_reg_cond->addr_reg_index] + begin_reg_cond->rel_address;
-                    break;
-                case CompareRegisterValueType::RegisterOfsReg:
-                    cond_address = registers[begin_reg_cond->addr_reg_index] +
-                                   registers[begin_reg_cond->ofs_reg_index];
-                    break;
-                default:
-                    break;
-                }
-                switch (begin_reg_cond->bit_width) {
-                case 1:
-                case 2:
-                case 4:
-                case 8:
-                    callbacks->MemoryRead(cond_address, &cond_value, begin_reg_cond->bit_width);
-                    break;
-                }
-            }
+template <>
+std::size_t DmntCheatVm::ExecuteOpcode<PerformArithmeticRegisterOpcode>(const CompiledOpcode& op,
+                                                                        std::size_t index) {
+    const auto& perform_math_reg = std::get<PerformArithmeticRegisterOpcode>(op.opcode.opcode);
+    const u64 operand_1_value = registers[perform_math_reg.src_reg_1_index];
+    const u64 operand_2_value = perform_math_reg.has_immediate
+                                    ? GetVmInt(perform_math_reg.value, perform_math_reg.bit_width)
+                                    : registers[perform_math_reg.src_reg_2_index];
 
-            // Check against condition.
-            bool cond_met = false;
-            switch (begin_reg_cond->cond_type) {
-            case ConditionalComparisonType::GT:
-                cond_met = src_value > cond_value;
-                break;
-            case ConditionalComparisonType::GE:
-                cond_met = src_value >= cond_value;
-                break;
-            case ConditionalComparisonType::LT:
-                cond_met = src_value < cond_value;
-                break;
-            case ConditionalComparisonType::LE:
-                cond_met = src_value <= cond_value;
-                break;
-            case ConditionalComparisonType::EQ:
-                cond_met = src_value == cond_value;
-                break;
-            case ConditionalComparisonType::NE:
-                cond_met = src_value != cond_value;
-                break;
-            }
+    u64 res_val = 0;
+    // Do requested math.
+    switch (perform_math_reg.math_type) {
+    case RegisterArithmeticType::Addition:
+        res_val = operand_1_value + operand_2_value;
+        break;
+    case RegisterArithmeticType::Subtraction:
+        res_val = operand_1_value - operand_2_value;
+        break;
+    case RegisterArithmeticType::Multiplication:
+        res_val = operand_1_value * operand_2_value;
+        break;
+    case RegisterArithmeticType::LeftShift:
+        res_val = operand_1_value << operand_2_value;
+        break;
+    case RegisterArithmeticType::RightShift:
+        res_val = operand_1_value >> operand_2_value;
+        break;
+    case RegisterArithmeticType::LogicalAnd:
+        res_val = operand_1_value & operand_2_value;
+        break;
+    case RegisterArithmeticType::LogicalOr:
+        res_val = operand_1_value | operand_2_value;
+        break;
+    case RegisterArithmeticType::LogicalNot:
+        res_val = ~operand_1_value;
+        break;
+    case RegisterArithmeticType::LogicalXor:
+        res_val = operand_1_value ^ operand_2_value;
+        break;
+    case RegisterArithmeticType::None:
+        res_val = operand_1_value;
+        break;
+    }
 
-            // Skip conditional block if condition not met.
-            if (!cond_met) {
-                SkipConditionalBlock();
-            }
-        } else if (auto save_restore_reg =
-                       std::get_if<SaveRestoreRegisterOpcode>(&cur_opcode.opcode)) {
-            // Save or restore a register.
-            switch (save_restore_reg->op_type) {
-            case SaveRestoreRegisterOpType::ClearRegs:
-                registers[save_restore_reg->dst_index] = 0ul;
-                break;
+    // Apply bit width.
+    switch (perform_math_reg.bit_width) {
+    case 1:
+        res_val = static_cast<u8>(res_val);
+        break;
+    case 2:
+        res_val = static_cast<u16>(res_val);
+        break;
+    case 4:
+        res_val = static_cast<u32>(res_val);
+        break;
+    case 8:
+        res_val = static_cast<u64>(res_val);
+        break;
+    }
+
+    // Save to register.
+    registers[perform_math_reg.dst_reg_index] = res_val;
+    return index + 1;
+}
+
+template <>
+std::size_t DmntCheatVm::ExecuteOpcode<StoreRegisterToAddressOpcode>(const CompiledOpcode& op,
+                                                                     std::size_t index) {
+    const auto& str_register = std::get<StoreRegisterToAddressOpcode>(op.opcode.opcode);
+    // Calculate address.
+    u64 dst_value = registers[str_register.str_reg_index];
+    u64 dst_address = registers[str_register.addr_reg_index];
+    switch (str_register.ofs_type) {
+    case StoreRegisterOffsetType::None:
+        // Nothing more to do
+        break;
+    case StoreRegisterOffsetType::Reg:
+        dst_address += registers[str_register.ofs_reg_index];
+        break;
+    case StoreRegisterOffsetType::Imm:
+        dst_address += str_register.rel_address;
+        break;
+    case StoreRegisterOffsetType::MemReg:
+        dst_address = GetCheatProcessAddress(*current_metadata, str_register.mem_type,
+                                             registers[str_register.addr_reg_index]);
+        break;
+    case StoreRegisterOffsetType::MemImm:
+        dst_address = GetCheatProcessAddress(*current_metadata, str_register.mem_type,
+                                             str_register.rel_address);
+        break;
+    case StoreRegisterOffsetType::MemImmReg:
+        dst_address = GetCheatProcessAddress(*current_metadata, str_register.mem_type,
+                                             registers[str_register.addr_reg_index] +
+                                                 str_register.rel_address);
+        break;
+    }
+
+    // Write value to memory. Write only on valid bitwidth.
+    switch (str_register.bit_width) {
+    case 1:
+    case 2:
+    case 4:
+    case 8:
+        WriteMemory(dst_address, &dst_value, str_register.bit_width);
+        break;
+    }
+
+    // Increment register if relevant.
+    if (str_register.increment_reg) {
+        registers[str_register.addr_reg_index] += str_register.bit_width;
+    }
+    return index + 1;
+}
+
+template <>
+std::size_t DmntCheatVm::ExecuteOpcode<BeginRegisterConditionalOpcode>(const CompiledOpcode& op,
+                                                                       std::size_t index) {
+    const auto& begin_reg_cond = std::get<BeginRegisterConditionalOpcode>(op.opcode.opcode);
+    // Get value from register.
+    u64 src_value = 0;
+    switch (begin_reg_cond.bit_width) {
+    case 1:
+        src_value = static_cast<u8>(registers[begin_reg_cond.val_reg_index] & 0xFFul);
+        break;
+    case 2:
+        src_value = static_cast<u16>(registers[begin_reg_cond.val_reg_index] & 0xFFFFul);
+        break;
+    case 4:
+        src_value = static_cast<u32>(registers[begin_reg_cond.val_reg_index] & 0xFFFFFFFFul);
+        break;
+    case 8:
+        src_value =
+            static_cast<u64>(registers[begin_reg_cond.val_reg_index] & 0xFFFFFFFFFFFFFFFFul);
+        break;
+    }
+
+    // Read value from memory.
+    u64 cond_value = 0;
+    if (begin_reg_cond.comp_type == CompareRegisterValueType::StaticValue) {
+        cond_value = GetVmInt(begin_reg_cond.value, begin_reg_cond.bit_width);
+    } else if (begin_reg_cond.comp_type == CompareRegisterValueType::OtherRegister) {
+        switch (begin_reg_cond.bit_width) {
+        case 1:
+            cond_value = static_cast<u8>(registers[begin_reg_cond.other_reg_index] & 0xFFul);
+            break;
+        case 2:
+            cond_value = static_cast<u16>(registers[begin_reg_cond.other_reg_index] & 0xFFFFul);
+            break;
+        case 4:
+            cond_value =
+                static_cast<u32>(registers[begin_reg_cond.other_reg_index] & 0xFFFFFFFFul);
+            break;
+        case 8:
+            cond_value = static_cast<u64>(registers[begin_reg_cond.other_reg_index] &
+                                          0xFFFFFFFFFFFFFFFFul);
+            break;
+        }
+    } else {
+        u64 cond_address = 0;
+        switch (begin_reg_cond.comp_type) {
+        case CompareRegisterValueType::MemoryRelAddr:
+            cond_address = GetCheatProcessAddress(*current_metadata, begin_reg_cond.mem_type,
+                                                  begin_reg_cond.rel_address);
+            break;
+        case CompareRegisterValueType::MemoryOfsReg:
+            cond_address = GetCheatProcessAddress(*current_metadata, begin_reg_cond.mem_type,
+                                                  registers[begin_reg_cond.ofs_reg_index]);
+            break;
+        case CompareRegisterValueType::RegisterRelAddr:
+            cond_address = registers[begin_reg_cond.addr_reg_index] + begin_reg_cond.rel_address;
+            break;
+        case CompareRegisterValueType::RegisterOfsReg:
+            cond_address = registers[begin_reg_cond.addr_reg_index] +
+                           registers[begin_reg_cond.ofs_reg_index];
+            break;
+        default:
+            break;
+        }
+        switch (begin_reg_cond.bit_width) {
+        case 1:
+        case 2:
+        case 4:
+        case 8:
+            ReadMemory(cond_address, &cond_value, begin_reg_cond.bit_width);
+            break;
+        }
+    }
+
+    // Check against condition, skip conditional block if condition not met.
+    if (!IsConditionMet(begin_reg_cond.cond_type, src_value, cond_value)) {
+        return op.skip_target;
+    }
+    return index + 1;
+}
+
+template <>
+std::size_t DmntCheatVm::ExecuteOpcode<SaveRestoreRegisterOpcode>(const CompiledOpcode& op,
+                                                                  std::size_t index) {
+    const auto& save_restore_reg = std::get<SaveRestoreRegisterOpcode>(op.opcode.opcode);
+    // Save or restore a register.
+    switch (save_restore_reg.op_type) {
+    case SaveRestoreRegisterOpType::ClearRegs:
+        registers[save_restore_reg.dst_index] = 0ul;
+        break;
+    case SaveRestoreRegisterOpType::ClearSaved:
+        saved_values[save_restore_reg.dst_index] = 0ul;
+        break;
+    case SaveRestoreRegisterOpType::Save:
+        saved_values[save_restore_reg.dst_index] = registers[save_restore_reg.src_index];
+        break;
+    case SaveRestoreRegisterOpType::Restore:
+    default:
+        registers[save_restore_reg.dst_index] = saved_values[save_restore_reg.src_index];
+        break;
+    }
+    return index + 1;
+}
+
+template <>
+std::size_t DmntCheatVm::ExecuteOpcode<SaveRestoreRegisterMaskOpcode>(const CompiledOpcode& op,
+                                                                      std::size_t index) {
+    const auto& save_restore_regmask = std::get<SaveRestoreRegisterMaskOpcode>(op.opcode.opcode);
+    // Save or restore register mask.
+    u64* src;
+    u64* dst;
+    switch (save_restore_regmask.op_type) {
+    case SaveRestoreRegisterOpType::ClearSaved:
+    case SaveRestoreRegisterOpType::Save:
+        src = registers.data();
+        dst = saved_values.data();
+        break;
+    case SaveRestoreRegisterOpType::ClearRegs:
+    case SaveRestoreRegisterOpType::Restore:
+    default:
+        src = saved_values.data();
+        dst = registers.data();
+        break;
+    }
+    for (std::size_t i = 0; i < NumRegisters; i++) {
+        if (save_restore_regmask.should_operate[i]) {
+            switch (save_restore_regmask.op_type) {
             case SaveRestoreRegisterOpType::ClearSaved:
-                saved_values[save_restore_reg->dst_index] = 0ul;
-                break;
-            case SaveRestoreRegisterOpType::Save:
-                saved_values[save_restore_reg->dst_index] = registers[save_restore_reg->src_index];
-                break;
-            case SaveRestoreRegisterOpType::Restore:
-            default:
-                registers[save_restore_reg->dst_index] = saved_values[save_restore_reg->src_index];
+            case SaveRestoreRegisterOpType::ClearRegs:
+                dst[i] = 0ul;
                 break;
-            }
-        } else if (auto save_restore_regmask =
-                       std::get_if<SaveRestoreRegisterMaskOpcode>(&cur_opcode.opcode)) {
-            // Save or restore register mask.
-            u64* src;
-            u64* dst;
-            switch (save_restore_regmask->op_type) {
-            case SaveRestoreRegisterOpType::ClearSaved:
             case SaveRestoreRegisterOpType::Save:
-                src = registers.data();
-                dst = saved_values.data();
-                break;
-            case SaveRestoreRegisterOpType::ClearRegs:
             case SaveRestoreRegisterOpType::Restore:
             default:
-                src = saved_values.data();
-                dst = registers.data();
+                dst[i] = src[i];
                 break;
             }
-            for (std::size_t i = 0; i < NumRegisters; i++) {
-                if (save_restore_regmask->should_operate[i]) {
-                    switch (save_restore_regmask->op_type) {
-                    case SaveRestoreRegisterOpType::ClearSaved:
-                    case SaveRestoreRegisterOpType::ClearRegs:
-                        dst[i] = 0ul;
-                        break;
-                    case SaveRestoreRegisterOpType::Save:
-                    case SaveRestoreRegisterOpType::Restore:
-                    default:
-                        dst[i] = src[i];
-                        break;
-                    }
-                }
-            }
-        } else if (auto rw_static_reg =
-                       std::get_if<ReadWriteStaticRegisterOpcode>(&cur_opcode.opcode)) {
-            if (rw_static_reg->static_idx < NumReadableStaticRegisters) {
-                // Load a register with a static register.
-                registers[rw_static_reg->idx] = static_registers[rw_static_reg->static_idx];
-            } else {
-                // Store a register to a static register.
-                static_registers[rw_static_reg->static_idx] = registers[rw_static_reg->idx];
-            }
-        } else if (auto debug_log = std::get_if<DebugLogOpcode>(&cur_opcode.opcode)) {
-            // Read value from memory.
-            u64 log_value = 0;
-            if (debug_log->val_type == DebugLogValueType::RegisterValue) {
-                switch (debug_log->bit_width) {
-                case 1:
-                    log_value = static_cast<u8>(registers[debug_log->val_reg_index] & 0xFFul);
-                    break;
-                case 2:
-                    log_value = static_cast<u16>(registers[debug_log->val_reg_index] & 0xFFFFul);
-                    break;
-                case 4:
-                    log_value =
-                        static_cast<u32>(registers[debug_log->val_reg_index] & 0xFFFFFFFFul);
-                    break;
-                case 8:
-                    log_value = static_cast<u64>(registers[debug_log->val_reg_index] &
-                                                 0xFFFFFFFFFFFFFFFFul);
-                    break;
-                }
-            } else {
-                u64 val_address = 0;
-                switch (debug_log->val_type) {
-                case DebugLogValueType::MemoryRelAddr:
-                    val_address = GetCheatProcessAddress(metadata, debug_log->mem_type,
-                                                         debug_log->rel_address);
-                    break;
-                case DebugLogValueType::MemoryOfsReg:
-                    val_address = GetCheatProcessAddress(metadata, debug_log->mem_type,
-                                                         registers[debug_log->ofs_reg_index]);
-                    break;
-                case DebugLogValueType::RegisterRelAddr:
-                    val_address = registers[debug_log->addr_reg_index] + debug_log->rel_address;
-                    break;
-                case DebugLogValueType::RegisterOfsReg:
-                    val_address =
-                        registers[debug_log->addr_reg_index] + registers[debug_log->ofs_reg_index];
-                    break;
-                default:
-                    break;
-                }
-                switch (debug_log->bit_width) {
-                case 1:
-                case 2:
-                case 4:
-                case 8:
-                    callbacks->MemoryRead(val_address, &log_value, debug_log->bit_width);
-                    break;
-                }
-            }
+        }
+    }
+    return index + 1;
+}
 
-            // Log value.
-            DebugLog(debug_log->log_id, log_value);
+template <>
+std::size_t DmntCheatVm::ExecuteOpcode<ReadWriteStaticRegisterOpcode>(const CompiledOpcode& op,
+                                                                      std::size_t index) {
+    const auto& rw_static_reg = std::get<ReadWriteStaticRegisterOpcode>(op.opcode.opcode);
+    if (rw_static_reg.static_idx < NumReadableStaticRegisters) {
+        // Load a register with a static register.
+        registers[rw_static_reg.idx] = static_registers[rw_static_reg.static_idx];
+    } else {
+        // Store a register to a static register.
+        static_registers[rw_static_reg.static_idx] = registers[rw_static_reg.idx];
+    }
+    return index + 1;
+}
+
+template <>
+std::size_t DmntCheatVm::ExecuteOpcode<DebugLogOpcode>(const CompiledOpcode& op,
+                                                       std::size_t index) {
+    const auto& debug_log = std::get<DebugLogOpcode>(op.opcode.opcode);
+    // Read value from memory.
+    u64 log_value = 0;
+    if (debug_log.val_type == DebugLogValueType::RegisterValue) {
+        switch (debug_log.bit_width) {
+        case 1:
+            log_value = static_cast<u8>(registers[debug_log.val_reg_index] & 0xFFul);
+            break;
+        case 2:
+            log_value = static_cast<u16>(registers[debug_log.val_reg_index] & 0xFFFFul);
+            break;
+        case 4:
+            log_value = static_cast<u32>(registers[debug_log.val_reg_index] & 0xFFFFFFFFul);
+            break;
+        case 8:
+            log_value =
+                static_cast<u64>(registers[debug_log.val_reg_index] & 0xFFFFFFFFFFFFFFFFul);
+            break;
         }
+    } else {
+        u64 val_address = 0;
+        switch (debug_log.val_type) {
+        case DebugLogValueType::MemoryRelAddr:
+            val_address = GetCheatProcessAddress(*current_metadata, debug_log.mem_type,
+                                                 debug_log.rel_address);
+            break;
+        case DebugLogValueType::MemoryOfsReg:
+            val_address = GetCheatProcessAddress(*current_metadata, debug_log.mem_type,
+                                                 registers[debug_log.ofs_reg_index]);
+            break;
+        case DebugLogValueType::RegisterRelAddr:
+            val_address = registers[debug_log.addr_reg_index] + debug_log.rel_address;
+            break;
+        case DebugLogValueType::RegisterOfsReg:
+            val_address = registers[debug_log.addr_reg_index] + registers[debug_log.ofs_reg_index];
+            break;
+        default:
+            break;
+        }
+        switch (debug_log.bit_width) {
+        case 1:
+        case 2:
+        case 4:
+        case 8:
+            ReadMemory(val_address, &log_value, debug_log.bit_width);
+            break;
+        }
+    }
+
+    // Log value.
+    DebugLog(debug_log.log_id, log_value);
+    return index + 1;
+}
+
+template <>
+std::size_t DmntCheatVm::ExecuteOpcode<UnrecognizedInstruction>(const CompiledOpcode&,
+                                                                std::size_t) {
+    // Never compiled, decoding stops at unrecognized instructions.
+    return compiled_program.size();
+}
+
+void DmntCheatVm::CompileProgram() {
+    compiled_program.clear();
+    instruction_ptr = 0;
+    decode_success = true;
+
+    // Decode the program once, up to the first opcode that fails to decode, which is where
+    // execution would stop.
+    CheatVmOpcode opcode{};
+    while (DecodeNextOpcode(opcode)) {
+        compiled_program.push_back({
+            .handler = std::visit(
+                [](const auto& decoded) -> CompiledOpcode::Handler {
+                    using Opcode = std::decay_t<decltype(decoded)>;
+                    return &DmntCheatVm::ExecuteOpcode<Opcode>;
+                },
+                opcode.opcode),
+            .skip_target = 0,
+            .opcode = opcode,
+        });
+        LogOpcode(opcode);
+    }
+
+    // Skipping a conditional block continues after its end conditional opcode, accounting for
+    // nested blocks. Blocks that aren't closed skip to the end of the program.
+    std::vector<std::size_t> open_blocks;
+    for (std::size_t i = 0; i < compiled_program.size(); ++i) {
+        CompiledOpcode& op = compiled_program[i];
+        op.skip_target = compiled_program.size();
+        if (op.opcode.begin_conditional_block) {
+            open_blocks.push_back(i);
+        } else if (std::holds_alternative<EndConditionalOpcode>(op.opcode.opcode) &&
+                   !open_blocks.empty()) {
+            compiled_program[open_blocks.back()].skip_target = i + 1;
+            open_blocks.pop_back();
+        }
+    }
+}
+
+void DmntCheatVm::Execute(const CheatProcessMetadata& metadata) {
+    // Get Keys down.
+    keys_down = callbacks->HidKeysDown();
+
+    callbacks->CommandLog("Started VM execution.");
+    callbacks->CommandLog(fmt::format("Main NSO:  {:012X}", metadata.main_nso_extents.base));
+    callbacks->CommandLog(fmt::format("Heap:      {:012X}", metadata.main_nso_extents.base));
+    callbacks->CommandLog(
+        fmt::format("Keys Down: {:08X}", static_cast<u32>(keys_down & 0x0FFFFFFF)));
+
+    // Clear VM state.
+    ResetState();
+    current_metadata = &metadata;
+
+    // Loop until program finishes.
+    std::size_t index = 0;
+    while (index < compiled_program.size()) {
+        const CompiledOpcode& op = compiled_program[index];
+        index = (this->*op.handler)(op, index);
     }
 }
 
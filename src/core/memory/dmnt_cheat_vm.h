@@ -284,6 +284,15 @@ public:
 
         virtual void DebugLog(u8 id, u64 value) = 0;
         virtual void CommandLog(std::string_view data) = 0;
+
+        /**
+         * Returns a host pointer to the page at address that the VM may access directly instead
+         * of calling MemoryRead and MemoryWrite, or nullptr if the page must go through them.
+         * Pointers are reused while GetMemoryGeneration returns the value it returned when they
+         * were looked up, which is checked on every access.
+         */
+        virtual u8* GetPagePointer(VAddr address);
+        virtual u64 GetMemoryGeneration();
     };
 
     static constexpr std::size_t MaximumProgramOpcodeCount = 0x400;
@@ -304,22 +313,52 @@ public:
     void Execute(const CheatProcessMetadata& metadata);
 
 private:
+    /// Opcode of the program decoded when it's loaded, executed by its handler
+    struct CompiledOpcode {
+        /// Executes the opcode at index and returns the index of the next opcode to execute
+        using Handler = std::size_t (DmntCheatVm::*)(const CompiledOpcode& op, std::size_t index);
+
+        Handler handler{};
+        /// Index of the opcode following the end of the conditional block this opcode begins
+        std::size_t skip_target{};
+        CheatVmOpcode opcode{};
+    };
+
+    /// Direct pointer to a page of the process, nullptr when it's accessed through the callbacks
+    struct PageCacheEntry {
+        u64 page = ~0ULL;
+        u64 generation = 0;
+        u8* pointer = nullptr;
+    };
+
     std::unique_ptr<Callbacks> callbacks;
 
     std::size_t num_opcodes = 0;
     std::size_t instruction_ptr = 0;
-    std::size_t condition_depth = 0;
     bool decode_success = false;
     std::array<u32, MaximumProgramOpcodeCount> program{};
+    std::vector<CompiledOpcode> compiled_program;
     std::array<u64, NumRegisters> registers{};
     std::array<u64, NumRegisters> saved_values{};
     std::array<u64, NumStaticRegisters> static_registers{};
     std::array<std::size_t, NumRegisters> loop_tops{};
 
+    const CheatProcessMetadata* current_metadata = nullptr;
+    u64 keys_down = 0;
+
+    std::array<PageCacheEntry, 64> page_cache{};
+
     bool DecodeNextOpcode(CheatVmOpcode& out);
-    void SkipConditionalBlock();
+    void CompileProgram();
     void ResetState();
 
+    template <typename Opcode>
+    std::size_t ExecuteOpcode(const CompiledOpcode& op, std::size_t index);
+
+    void ReadMemory(VAddr address, void* data, u64 size);
+    void WriteMemory(VAddr address, const void* data, u64 size);
+    u8* GetDirectPointer(VAddr address, u64 size);
+
     // For implementing the DebugLog opcode.
     void DebugLog(u32 log_id, u64 value);
 
@@ -4,9 +4,9 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <iterator>
 #include <mutex>
-#include <numeric>
 #include <sstream>
 #include <thread>
 #include <fmt/chrono.h>
@@ -25,8 +25,41 @@ using std::chrono::microseconds;
 // booting that we shouldn't account for
 constexpr std::size_t IgnoreFrames = 5;
 
+// Frame times recorded for the frame time log, an hour of frames at 60 Hz
+constexpr std::size_t MaxRecordedFrames = 216000;
+
 namespace Core {
 
+void FrameTimeHistogram::AddSample(std::chrono::nanoseconds duration) {
+    const auto bucket_index = static_cast<std::size_t>(
+        std::clamp<s64>(duration / BucketWidth, 0, static_cast<s64>(NumBuckets - 1)));
+    if (num_samples == WindowSize) {
+        --buckets[window[window_index]];
+    } else {
+        ++num_samples;
+    }
+    ++buckets[bucket_index];
+    window[window_index] = static_cast<u16>(bucket_index);
+    window_index = (window_index + 1) % WindowSize;
+}
+
+std::chrono::nanoseconds FrameTimeHistogram::GetPercentile(double fraction) const {
+    if (num_samples == 0) {
+        return std::chrono::nanoseconds::zero();
+    }
+    const auto rank = std::clamp<std::size_t>(
+        static_cast<std::size_t>(std::ceil(fraction * static_cast<double>(num_samples))), 1,
+        num_samples);
+    std::size_t count = 0;
+    for (std::size_t bucket = 0; bucket < NumBuckets; ++bucket) {
+        count += buckets[bucket];
+        if (count >= rank) {
+            return BucketWidth * static_cast<s64>(bucket + 1);
+        }
+    }
+    return BucketWidth * static_cast<s64>(NumBuckets);
+}
+
 PerfStats::PerfStats(u64 title_id) : title_id(title_id) {}
 
 PerfStats::~PerfStats() {
@@ -36,8 +69,8 @@ PerfStats::~PerfStats() {
 
     const std::time_t t = std::time(nullptr);
     std::ostringstream stream;
-    std::copy(perf_history.begin() + IgnoreFrames, perf_history.begin() + current_index,
-              std::ostream_iterator<double>(stream, "\n"));
+    std::copy(perf_history.begin() + std::min(IgnoreFrames, perf_history.size()),
+              perf_history.end(), std::ostream_iterator<double>(stream, "\n"));
     const std::string& path = Common::FS::GetUserPath(Common::FS::UserPath::LogDir);
     // %F Date format expanded is "%Y-%m-%d"
     const std::string filename =
@@ -57,33 +90,40 @@ void PerfStats::EndSystemFrame() {
 
     auto frame_end = Clock::now();
     const auto frame_time = frame_end - frame_begin;
-    if (current_index < perf_history.size()) {
-        perf_history[current_index++] =
-            std::chrono::duration<double, std::milli>(frame_time).count();
+    const double frame_time_ms = std::chrono::duration<double, std::milli>(frame_time).count();
+    if (num_frames >= IgnoreFrames) {
+        frametime_sum += frame_time_ms;
     }
+    if (Settings::values.record_frame_times && title_id != 0 &&
+        perf_history.size() < MaxRecordedFrames) {
+        perf_history.push_back(frame_time_ms);
+    }
+    ++num_frames;
     accumulated_frametime += frame_time;
     system_frames += 1;
 
     previous_frame_length = frame_end - previous_frame_end;
     previous_frame_end = frame_end;
+    if (num_frames > IgnoreFrames) {
+        frame_length_histogram.AddSample(previous_frame_length);
+    }
 }
 
 void PerfStats::EndGameFrame() {
     std::lock_guard lock{object_mutex};
 
     game_frames += 1;
+    ++num_game_frames;
 }
 
 double PerfStats::GetMeanFrametime() const {
     std::lock_guard lock{object_mutex};
 
-    if (current_index <= IgnoreFrames) {
+    if (num_frames <= IgnoreFrames) {
         return 0;
     }
 
-    const double sum = std::accumulate(perf_history.begin() + IgnoreFrames,
-                                       perf_history.begin() + current_index, 0.0);
-    return sum / static_cast<double>(current_index - IgnoreFrames);
+    return frametime_sum / static_cast<double>(num_frames - IgnoreFrames);
 }
 
 PerfStatsResults PerfStats::GetAndResetStats(microseconds current_system_time_us) {
@@ -101,6 +141,9 @@ PerfStatsResults PerfStats::GetAndResetStats(microseconds current_system_time_us
         .frametime = duration_cast<DoubleSecs>(accumulated_frametime).count() /
                      static_cast<double>(system_frames),
         .emulation_speed = system_us_per_second.count() / 1'000'000.0,
+        .frame_length_p50 = DoubleSecs(frame_length_histogram.GetPercentile(0.5)).count(),
+        .frame_length_p99 = DoubleSecs(frame_length_histogram.GetPercentile(0.99)).count(),
+        .frame_length_p999 = DoubleSecs(frame_length_histogram.GetPercentile(0.999)).count(),
     };
 
     // Reset counters
@@ -120,12 +163,31 @@ double PerfStats::GetLastFrameTimeScale() const {
     return duration_cast<DoubleSecs>(previous_frame_length).count() / FRAME_LENGTH;
 }
 
+std::size_t PerfStats::GetNumGameFrames() const {
+    std::lock_guard lock{object_mutex};
+
+    return num_game_frames;
+}
+
 void FrameLimiter::DoFrameLimiting(microseconds current_system_time_us) {
     if (!Settings::values.use_frame_limit.GetValue() ||
         Settings::values.use_multi_core.GetValue()) {
         return;
     }
 
+    if (Settings::values.use_precise_frame_pacing.GetValue()) {
+        PaceFrame(current_system_time_us);
+    } else {
+        SleepFrameDelta(current_system_time_us);
+    }
+    previous_system_time_us = current_system_time_us;
+}
+
+void FrameLimiter::SetVSyncPeriod(std::chrono::nanoseconds period) {
+    vsync_period = period;
+}
+
+void FrameLimiter::SleepFrameDelta(microseconds current_system_time_us) {
     auto now = Clock::now();
 
     const double sleep_scale = Settings::values.frame_limit.GetValue() / 100.0;
@@ -150,8 +212,37 @@ void FrameLimiter::DoFrameLimiting(microseconds current_system_time_us) {
         now = now_after_sleep;
     }
 
-    previous_system_time_us = current_system_time_us;
     previous_walltime = now;
 }
 
+void FrameLimiter::PaceFrame(microseconds current_system_time_us) {
+    const auto now = Clock::now();
+    const double sleep_scale = Settings::values.frame_limit.GetValue() / 100.0;
+
+    // Deadlines are absolute, so the time spent emulating the frame and any sleep inaccuracy
+    // don't accumulate. Like the sleeping limiter, slow frames may be caught up for at most the
+    // max lag and the deadline never runs ahead of walltime by more than that.
+    const auto max_lag = duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::chrono::nanoseconds::period>(25ms / sleep_scale));
+    next_deadline += ScaledFrameDelta(current_system_time_us);
+    next_deadline = std::clamp(next_deadline, now - max_lag, now + max_lag);
+
+    if (next_deadline > now) {
+        waiter.SleepUntil(next_deadline);
+    }
+    previous_walltime = Clock::now();
+}
+
+FrameLimiter::Clock::duration FrameLimiter::ScaledFrameDelta(
+    microseconds current_system_time_us) const {
+    std::chrono::nanoseconds delta = current_system_time_us - previous_system_time_us;
+    if (vsync_period > std::chrono::nanoseconds::zero() && delta >= vsync_period / 2) {
+        // Round to whole vsync periods, removing the jitter of the composition event
+        delta = vsync_period * ((delta + vsync_period / 2) / vsync_period);
+    }
+    const double sleep_scale = Settings::values.frame_limit.GetValue() / 100.0;
+    return duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::chrono::nanoseconds::period>(delta / sleep_scale));
+}
+
 } // namespace Core
@@ -8,7 +8,9 @@
 #include <chrono>
 #include <cstddef>
 #include <mutex>
+#include <vector>
 #include "common/common_types.h"
+#include "common/precision_waiter.h"
 
 namespace Core {
 
@@ -21,6 +23,45 @@ struct PerfStatsResults {
     double frametime;
     /// Ratio of walltime / emulated time elapsed
     double emulation_speed;
+    /// Percentiles of the visible frame duration (including frame-limiting, etc.) over the last
+    /// FrameTimeHistogram::WindowSize system frames, in seconds
+    double frame_length_p50;
+    double frame_length_p99;
+    double frame_length_p999;
+};
+
+/**
+ * Sliding window histogram of frame durations. Percentiles are queried from fixed width buckets,
+ * so the window doesn't have to be stored or sorted.
+ */
+class FrameTimeHistogram {
+public:
+    /// Number of samples in the window, a minute of frames at 60 Hz
+    static constexpr std::size_t WindowSize = 3600;
+    /// Resolution of the histogram
+    static constexpr std::chrono::nanoseconds BucketWidth{50'000};
+    /// Number of buckets, durations longer than 100ms fall in the last bucket
+    static constexpr std::size_t NumBuckets = 2000;
+
+    /// Adds a sample to the window, evicting the oldest sample when the window is full
+    void AddSample(std::chrono::nanoseconds duration);
+
+    /**
+     * Returns the duration that the given fraction of the samples in the window don't exceed,
+     * rounded up to the bucket width. Returns zero when the window is empty.
+     */
+    std::chrono::nanoseconds GetPercentile(double fraction) const;
+
+    /// Returns the number of samples in the window
+    std::size_t NumSamples() const {
+        return num_samples;
+    }
+
+private:
+    std::array<u16, NumBuckets> buckets{};
+    std::array<u16, WindowSize> window{};
+    std::size_t window_index = 0;
+    std::size_t num_samples = 0;
 };
 
 /**
@@ -51,16 +92,25 @@ public:
      */
     double GetLastFrameTimeScale() const;
 
+    /// Returns the number of game frames submitted since the game started
+    std::size_t GetNumGameFrames() const;
+
 private:
     mutable std::mutex object_mutex;
 
     /// Title ID for the game that is running. 0 if there is no game running yet
     u64 title_id{0};
-    /// Current index for writing to the perf_history array
-    std::size_t current_index{0};
-    /// Stores an hour of historical frametime data useful for processing and tracking performance
-    /// regressions with code changes.
-    std::array<double, 216000> perf_history{};
+    /// Number of system frames ended since the game started
+    std::size_t num_frames{0};
+    /// Number of game frames submitted since the game started
+    std::size_t num_game_frames{0};
+    /// Sum of the frametimes after the ignored boot frames, in milliseconds
+    double frametime_sum{0.0};
+    /// Stores up to an hour of frametime data when recording frame times is enabled, useful for
+    /// processing and tracking performance regressions with code changes.
+    std::vector<double> perf_history;
+    /// Visible frame durations of the most recent system frames
+    FrameTimeHistogram frame_length_histogram;
 
     /// Point when the cumulative counters were reset
     Clock::time_point reset_point = Clock::now();
@@ -84,11 +134,27 @@ private:
 
 class FrameLimiter {
 public:
-    using Clock = std::chrono::high_resolution_clock;
+    using Clock = Common::PrecisionWaiter::Clock;
 
     void DoFrameLimiting(std::chrono::microseconds current_system_time_us);
 
+    /**
+     * Sets the emulated vsync period frames are presented at. Frame pacing deadlines are aligned
+     * to multiples of this period. Not thread-safe, it must be called from the thread that
+     * presents frames.
+     */
+    void SetVSyncPeriod(std::chrono::nanoseconds period);
+
 private:
+    /// Sleeps for the accumulated difference between walltime and emulated time
+    void SleepFrameDelta(std::chrono::microseconds current_system_time_us);
+
+    /// Waits until the next frame deadline aligned to the vsync period
+    void PaceFrame(std::chrono::microseconds current_system_time_us);
+
+    /// Returns the emulated time elapsed since the previous frame in walltime
+    Clock::duration ScaledFrameDelta(std::chrono::microseconds current_system_time_us) const;
+
     /// Emulated system time (in microseconds) at the last limiter invocation
     std::chrono::microseconds previous_system_time_us{0};
     /// Walltime at the last limiter invocation
@@ -96,6 +162,13 @@ private:
 
     /// Accumulated difference between walltime and emulated time
     std::chrono::microseconds frame_limiting_delta_err{0};
+
+    /// Emulated vsync period, zero when unknown
+    std::chrono::nanoseconds vsync_period{0};
+    /// Walltime the next frame should be presented at
+    Clock::time_point next_deadline = previous_walltime;
+    /// Waits for frame deadlines, busy-waiting the tail of each wait
+    Common::PrecisionWaiter waiter;
 };
 
 } // namespace Core
@@ -103,6 +103,8 @@ struct Values {
     Setting<int> max_anisotropy;
     Setting<bool> use_frame_limit;
     Setting<u16> frame_limit;
+    /// Paces frames to absolute deadlines, busy-waiting the tail of each wait
+    Setting<bool> use_precise_frame_pacing;
     Setting<bool> use_disk_shader_cache;
     Setting<GPUAccuracy> gpu_accuracy;
     Setting<bool> use_asynchronous_gpu_emulation;
@@ -110,6 +112,8 @@ struct Values {
     Setting<bool> use_assembly_shaders;
     Setting<bool> use_asynchronous_shaders;
     Setting<bool> use_fast_gpu_time;
+    /// Host memory the texture cache may use before evicting surfaces, in MiB. 0 is unlimited.
+    Setting<u32> texture_cache_budget_mb;
 
     Setting<float> bg_red;
     Setting<float> bg_green;
@@ -171,6 +175,7 @@ struct Values {
     bool reporting_services;
     bool quest_flag;
     bool disable_macro_jit;
+    u32 handle_table_capacity;
 
     // Misceallaneous
     std::string log_filter;
@@ -16,45 +16,58 @@ namespace {
 
 constexpr auto memory_freezer_ns = std::chrono::nanoseconds{1000000000 / 60};
 
-u64 MemoryReadWidth(Core::Memory::Memory& memory, u32 width, VAddr addr) {
-    switch (width) {
-    case 1:
-        return memory.Read8(addr);
-    case 2:
-        return memory.Read16(addr);
-    case 4:
-        return memory.Read32(addr);
-    case 8:
-        return memory.Read64(addr);
-    default:
-        UNREACHABLE();
-        return 0;
+class StandardCallbacks final : public Freezer::Callbacks {
+public:
+    explicit StandardCallbacks(Core::Memory::Memory& memory_) : memory{memory_} {}
+
+    u64 Read(VAddr address, u32 width) override {
+        switch (width) {
+        case 1:
+            return memory.Read8(address);
+        case 2:
+            return memory.Read16(address);
+        case 4:
+            return memory.Read32(address);
+        case 8:
+            return memory.Read64(address);
+        default:
+            UNREACHABLE();
+            return 0;
+        }
     }
-}
 
-void MemoryWriteWidth(Core::Memory::Memory& memory, u32 width, VAddr addr, u64 value) {
-    switch (width) {
-    case 1:
-        memory.Write8(addr, static_cast<u8>(value));
-        break;
-    case 2:
-        memory.Write16(addr, static_cast<u16>(value));
-        break;
-    case 4:
-        memory.Write32(addr, static_cast<u32>(value));
-        break;
-    case 8:
-        memory.Write64(addr, value);
-        break;
-    default:
-        UNREACHABLE();
+    void Write(VAddr address, u32 width, u64 value) override {
+        switch (width) {
+        case 1:
+            memory.Write8(address, static_cast<u8>(value));
+            break;
+        case 2:
+            memory.Write16(address, static_cast<u16>(value));
+            break;
+        case 4:
+            memory.Write32(address, static_cast<u32>(value));
+            break;
+        case 8:
+            memory.Write64(address, value);
+            break;
+        default:
+            UNREACHABLE();
+        }
     }
-}
+
+private:
+    Core::Memory::Memory& memory;
+};
 
 } // Anonymous namespace
 
+Freezer::Callbacks::~Callbacks() = default;
+
 Freezer::Freezer(Core::Timing::CoreTiming& core_timing_, Core::Memory::Memory& memory_)
-    : core_timing{core_timing_}, memory{memory_} {
+    : Freezer{core_timing_, std::make_unique<StandardCallbacks>(memory_)} {}
+
+Freezer::Freezer(Core::Timing::CoreTiming& core_timing_, std::unique_ptr<Callbacks> callbacks_)
+    : core_timing{core_timing_}, callbacks{std::move(callbacks_)} {
     event = Core::Timing::CreateEvent(
         "MemoryFreezer::FrameCallback",
         [this](std::uintptr_t user_data, std::chrono::nanoseconds ns_late) {
@@ -68,8 +81,13 @@ Freezer::~Freezer() {
 }
 
 void Freezer::SetActive(bool active) {
-    if (!this->active.exchange(active)) {
+    if (this->active.exchange(active) == active) {
+        return;
+    }
+    if (active) {
         FillEntryReads();
+        // The callback of a previous activation may still be pending
+        core_timing.UnscheduleEvent(event, 0);
         core_timing.ScheduleEvent(memory_freezer_ns, event);
         LOG_DEBUG(Common_Memory, "Memory freezer activated!");
     } else {
@@ -92,7 +110,7 @@ void Freezer::Clear() {
 u64 Freezer::Freeze(VAddr address, u32 width) {
     std::lock_guard lock{entries_mutex};
 
-    const auto current_value = MemoryReadWidth(memory, width, address);
+    const auto current_value = callbacks->Read(address, width);
     entries.push_back({address, width, current_value});
 
     LOG_DEBUG(Common_Memory,
@@ -173,7 +191,7 @@ void Freezer::FrameCallback(std::uintptr_t, std::chrono::nanoseconds ns_late) {
         LOG_DEBUG(Common_Memory,
                   "Enforcing memory freeze at address={:016X}, value={:016X}, width={:02X}",
                   entry.address, entry.value, entry.width);
-        MemoryWriteWidth(memory, entry.width, entry.address, entry.value);
+        callbacks->Write(entry.address, entry.width, entry.value);
     }
 
     core_timing.ScheduleEvent(memory_freezer_ns - ns_late, event);
@@ -185,7 +203,7 @@ void Freezer::FillEntryReads() {
     LOG_DEBUG(Common_Memory, "Updating memory freeze entries to current values.");
 
     for (auto& entry : entries) {
-        entry.value = MemoryReadWidth(memory, entry.width, entry.address);
+        entry.value = callbacks->Read(entry.address, entry.width);
     }
 }
 
@@ -39,7 +39,21 @@ public:
         u64 value;
     };
 
+    /// Accesses of the freezer to the memory of the current process
+    class Callbacks {
+    public:
+        virtual ~Callbacks();
+
+        /// Reads a value of width bytes at address
+        virtual u64 Read(VAddr address, u32 width) = 0;
+
+        /// Writes a value of width bytes at address
+        virtual void Write(VAddr address, u32 width, u64 value) = 0;
+    };
+
     explicit Freezer(Core::Timing::CoreTiming& core_timing_, Core::Memory::Memory& memory_);
+    explicit Freezer(Core::Timing::CoreTiming& core_timing_,
+                     std::unique_ptr<Callbacks> callbacks_);
     ~Freezer();
 
     // Enables or disables the entire memory freezer.
@@ -88,7 +102,7 @@ private:
 
     std::shared_ptr<Core::Timing::EventType> event;
     Core::Timing::CoreTiming& core_timing;
-    Core::Memory::Memory& memory;
+    std::unique_ptr<Callbacks> callbacks;
 };
 
 } // namespace Tools
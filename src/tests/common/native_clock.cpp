@@ -0,0 +1,163 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#ifdef ARCHITECTURE_x86_64
+
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "common/spin_lock.h"
+#include "common/x64/native_clock.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr u64 CPU_FREQUENCY = 1'020'000'000;
+constexpr u64 CLOCK_FREQUENCY = 19'200'000;
+constexpr u64 TSC_FREQUENCY = 1'000'000'000;
+
+/// Returns the number of reads per second the given number of threads achieve together
+template <typename Func>
+double MeasureConcurrentReads(std::size_t num_threads, Func&& read) {
+    std::atomic_bool stop{false};
+    std::atomic<u64> total_reads{0};
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&] {
+            u64 reads = 0;
+            u64 sink = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                sink += read();
+                ++reads;
+            }
+            total_reads += reads + (sink == 1 ? 1 : 0);
+        });
+    }
+    constexpr auto duration = 250ms;
+    std::this_thread::sleep_for(duration);
+    stop = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return static_cast<double>(total_reads) / std::chrono::duration<double>(duration).count();
+}
+
+} // Anonymous namespace
+
+TEST_CASE("NativeClock[Calibration]", "[common]") {
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "yuzu_rdtsc_calibration_test.txt").string();
+    Common::FS::Delete(path);
+    REQUIRE(Common::LoadRDTSCCalibration(path, "key") == 0);
+
+    Common::SaveRDTSCCalibration(path, "Some CPU 6-9E-A 0xde", 3'600'012'345);
+    REQUIRE(Common::LoadRDTSCCalibration(path, "Some CPU 6-9E-A 0xde") == 3'600'012'345);
+    // A calibration made on another CPU or microcode revision is ignored
+    REQUIRE(Common::LoadRDTSCCalibration(path, "Some CPU 6-9E-A 0xea") == 0);
+    Common::FS::Delete(path);
+
+    REQUIRE(!Common::GetRDTSCCalibrationKey().empty());
+}
+
+TEST_CASE("NativeClock[Pause]", "[common]") {
+    Common::X64::NativeClock clock(CPU_FREQUENCY, CLOCK_FREQUENCY, TSC_FREQUENCY);
+    const auto start = clock.GetTimeNS();
+    std::this_thread::sleep_for(10ms);
+    const auto running = clock.GetTimeNS();
+    REQUIRE(running > start);
+
+    // Time spent paused is not counted
+    clock.Pause(true);
+    std::this_thread::sleep_for(50ms);
+    clock.Pause(false);
+    const auto resumed = clock.GetTimeNS();
+    REQUIRE(resumed >= running);
+    REQUIRE(resumed - running < 5ms);
+
+    // Reads made while paused return the time the clock stopped at
+    clock.Pause(true);
+    const auto paused = clock.GetTimeNS();
+    std::this_thread::sleep_for(10ms);
+    REQUIRE(clock.GetTimeNS() == paused);
+    REQUIRE(paused >= resumed);
+    clock.Pause(false);
+    REQUIRE(clock.GetTimeNS() >= paused);
+}
+
+TEST_CASE("NativeClock[PauseMonotonic]", "[common]") {
+    Common::X64::NativeClock clock(CPU_FREQUENCY, CLOCK_FREQUENCY, TSC_FREQUENCY);
+
+    // Readers never see the clock go backwards while it is paused and resumed under them
+    std::atomic_bool stop{false};
+    std::atomic_bool went_backwards{false};
+    std::vector<std::thread> readers;
+    for (std::size_t i = 0; i < 2; ++i) {
+        readers.emplace_back([&] {
+            u64 last = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                const u64 cycles = clock.GetCPUCycles();
+                if (cycles < last) {
+                    went_backwards = true;
+                }
+                last = cycles;
+            }
+        });
+    }
+    for (std::size_t i = 0; i < 1000; ++i) {
+        clock.Pause(true);
+        std::this_thread::yield();
+        clock.Pause(false);
+        std::this_thread::yield();
+    }
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    REQUIRE(!went_backwards);
+}
+
+TEST_CASE("NativeClock[ConcurrentReads]", "[.][Benchmark]") {
+    Common::X64::NativeClock clock(CPU_FREQUENCY, CLOCK_FREQUENCY, TSC_FREQUENCY);
+
+    // Reads serialized with a spin lock and a full fence, for comparison
+    Common::SpinLock lock;
+    u64 last_measure = __rdtsc();
+    u64 accumulated_ticks = 0;
+    const auto serialized_read = [&] {
+        std::scoped_lock scope{lock};
+        _mm_mfence();
+        const u64 current_measure = __rdtsc();
+        accumulated_ticks += current_measure - last_measure;
+        last_measure = current_measure;
+        return accumulated_ticks;
+    };
+
+    const std::size_t max_threads = std::max(4U, std::thread::hardware_concurrency());
+    for (std::size_t num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+        const double lock_free = MeasureConcurrentReads(num_threads, [&] {
+            return clock.GetCPUCycles();
+        });
+        const double serialized = MeasureConcurrentReads(num_threads, serialized_read);
+        std::printf("%2zu threads: %8.2f M reads/s lock-free, %8.2f M reads/s serialized\n",
+                    num_threads, lock_free / 1e6, serialized / 1e6);
+    }
+}
+
+#endif
@@ -0,0 +1,226 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/page_table.h"
+#include "core/core.h"
+#include "core/device_memory.h"
+#include "core/memory.h"
+
+using Common::FillPageRun;
+using Common::FindPageTypeRunEnd;
+using Common::PageTable;
+using Common::PageType;
+
+namespace {
+
+constexpr std::size_t PAGE_BITS = 12;
+constexpr std::size_t PAGE_SIZE = std::size_t{1} << PAGE_BITS;
+
+std::size_t FindRunEndScalar(const std::vector<PageType>& attributes, std::size_t first,
+                             std::size_t last) {
+    std::size_t page = first + 1;
+    while (page < last && attributes[page] == attributes[first]) {
+        ++page;
+    }
+    return page;
+}
+
+/// Page types in runs of random lengths, the way mappings and cached GPU resources cluster
+std::vector<PageType> MakeAttributes(std::size_t num_pages, std::size_t max_run,
+                                     std::mt19937& rng) {
+    std::vector<PageType> attributes;
+    attributes.reserve(num_pages);
+    std::uniform_int_distribution<std::size_t> run_length(1, max_run);
+    std::uniform_int_distribution<int> type(0, 2);
+    while (attributes.size() < num_pages) {
+        const auto run_type = static_cast<PageType>(type(rng));
+        const std::size_t length = std::min(run_length(rng), num_pages - attributes.size());
+        attributes.insert(attributes.end(), length, run_type);
+    }
+    return attributes;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("PageTable[FindPageTypeRunEnd]", "[common]") {
+    std::mt19937 rng(0x5EED);
+    for (const std::size_t max_run : {1, 3, 15, 16, 17, 40, 300}) {
+        const std::vector<PageType> attributes = MakeAttributes(4096, max_run, rng);
+        std::uniform_int_distribution<std::size_t> page(0, attributes.size() - 1);
+        for (int i = 0; i < 2000; ++i) {
+            std::size_t first = page(rng);
+            std::size_t last = page(rng) + 1;
+            if (first >= last) {
+                std::swap(first, last);
+                ++last;
+                --first;
+            }
+            REQUIRE(FindPageTypeRunEnd(attributes.data(), first, last) ==
+                    FindRunEndScalar(attributes, first, last));
+        }
+    }
+
+    // Runs ending exactly at vector boundaries
+    std::vector<PageType> attributes(64, PageType::Memory);
+    for (std::size_t end = 1; end < attributes.size(); ++end) {
+        attributes[end] = PageType::RasterizerCachedMemory;
+        REQUIRE(FindPageTypeRunEnd(attributes.data(), 0, attributes.size()) == end);
+        REQUIRE(FindPageTypeRunEnd(attributes.data(), 0, end) == end);
+        attributes[end] = PageType::Memory;
+    }
+}
+
+TEST_CASE("PageTable[FillPageRun]", "[common]") {
+    PageTable page_table;
+    page_table.Resize(24, PAGE_BITS, true);
+    std::vector<u8> memory(64 * PAGE_SIZE);
+
+    // Runs of every alignment and parity, with the neighbouring entries left untouched
+    for (std::size_t first = 1; first < 4; ++first) {
+        for (std::size_t num_pages = 0; num_pages < 9; ++num_pages) {
+            FillPageRun(page_table, 0, 16, nullptr, 0, PageType::Unmapped);
+            u8* const pointer = memory.data() - (first << PAGE_BITS);
+            const u64 backing_addr = 0x80000000 - (first << PAGE_BITS);
+            FillPageRun(page_table, first, num_pages, pointer, backing_addr, PageType::Memory);
+            for (std::size_t page = 0; page < 16; ++page) {
+                const bool in_run = page >= first && page < first + num_pages;
+                REQUIRE(page_table.pointers[page] == (in_run ? pointer : nullptr));
+                REQUIRE(page_table.backing_addr[page] == (in_run ? backing_addr : 0));
+                REQUIRE(page_table.attributes[page] ==
+                        (in_run ? PageType::Memory : PageType::Unmapped));
+            }
+        }
+    }
+
+    // Entries address contiguous memory relative to the virtual address of each page
+    FillPageRun(page_table, 4, 8, memory.data() - (4 << PAGE_BITS), 0, PageType::Memory);
+    for (std::size_t page = 4; page < 12; ++page) {
+        const VAddr addr = (page << PAGE_BITS) + 0x123;
+        REQUIRE(page_table.pointers[page] + addr == memory.data() + addr - (4 << PAGE_BITS));
+    }
+
+    // Large runs
+    const std::size_t num_pages = page_table.pointers.size() - 3;
+    FillPageRun(page_table, 1, num_pages, memory.data(), 0x1000, PageType::Memory);
+    for (const std::size_t page : {std::size_t{1}, num_pages / 2, num_pages}) {
+        REQUIRE(page_table.pointers[page] == memory.data());
+        REQUIRE(page_table.backing_addr[page] == 0x1000);
+        REQUIRE(page_table.attributes[page] == PageType::Memory);
+    }
+    REQUIRE(page_table.pointers[0] == nullptr);
+    REQUIRE(page_table.pointers[num_pages + 1] == nullptr);
+}
+
+TEST_CASE("PageTable[MapThroughput]", "[.][Benchmark]") {
+    constexpr std::size_t ADDRESS_SPACE_BITS = 33;
+
+    Core::Memory::Memory& memory = Core::System::GetInstance().Memory();
+    PageTable page_table;
+    page_table.Resize(ADDRESS_SPACE_BITS, PAGE_BITS, true);
+
+    std::printf("%-12s %16s %16s\n", "Range (KiB)", "Map GiB/s", "Unmap GiB/s");
+    for (u64 range = PAGE_SIZE; range <= (u64{4} << 30); range *= 16) {
+        const int iterations = static_cast<int>(std::max<u64>(1, (u64{64} << 30) / range / 16));
+        std::chrono::duration<double> map_time{};
+        std::chrono::duration<double> unmap_time{};
+        for (int i = 0; i < iterations; ++i) {
+            const auto start = std::chrono::steady_clock::now();
+            memory.MapMemoryRegion(page_table, range, range, Core::DramMemoryMap::Base);
+            const auto mapped = std::chrono::steady_clock::now();
+            memory.UnmapRegion(page_table, range, range);
+            map_time += mapped - start;
+            unmap_time += std::chrono::steady_clock::now() - mapped;
+        }
+        const auto throughput = [&](std::chrono::duration<double> elapsed) {
+            return static_cast<double>(range) * iterations / elapsed.count() / (1ULL << 30);
+        };
+        std::printf("%-12llu %16.1f %16.1f\n", static_cast<unsigned long long>(range >> 10),
+                    throughput(map_time), throughput(unmap_time));
+    }
+}
+
+TEST_CASE("PageTable[MixedBlockRead]", "[.][Benchmark]") {
+    constexpr std::size_t NUM_PAGES = 16384;
+    constexpr std::size_t BLOCK_SIZE = std::size_t{1} << 20;
+    constexpr int ITERATIONS = 200;
+
+    std::mt19937 rng(0x5EED);
+    std::vector<PageType> attributes = MakeAttributes(NUM_PAGES, 64, rng);
+    for (PageType& type : attributes) {
+        // Mix mapped and rasterizer cached memory only, unmapped reads would just log
+        if (type == PageType::Unmapped) {
+            type = PageType::RasterizerCachedMemory;
+        }
+    }
+    std::vector<u8> memory(NUM_PAGES * PAGE_SIZE, 1);
+    std::vector<u8> destination(BLOCK_SIZE);
+
+    // Stand-in for the rasterizer, which looks up the cached resources overlapping each flush
+    std::map<VAddr, std::size_t> cached_resources;
+    for (std::size_t page = 0; page < NUM_PAGES; page += 4) {
+        cached_resources.emplace(page << PAGE_BITS, 4 * PAGE_SIZE);
+    }
+    u64 flush_calls = 0;
+    u64 lookups = 0;
+    const auto flush = [&](VAddr addr, std::size_t size) {
+        ++flush_calls;
+        for (auto it = cached_resources.lower_bound(addr);
+             it != cached_resources.end() && it->first < addr + size; ++it) {
+            lookups += it->second;
+        }
+    };
+
+    const auto read_per_page = [&](VAddr addr) {
+        for (std::size_t offset = 0; offset < BLOCK_SIZE; offset += PAGE_SIZE) {
+            const VAddr page_addr = addr + offset;
+            if (attributes[page_addr >> PAGE_BITS] == PageType::RasterizerCachedMemory) {
+                flush(page_addr, PAGE_SIZE);
+            }
+            std::memcpy(destination.data() + offset, memory.data() + page_addr, PAGE_SIZE);
+        }
+    };
+    const auto read_coalesced = [&](VAddr addr) {
+        const std::size_t end_page = (addr + BLOCK_SIZE) >> PAGE_BITS;
+        std::size_t page = addr >> PAGE_BITS;
+        while (page < end_page) {
+            const std::size_t run_end = FindPageTypeRunEnd(attributes.data(), page, end_page);
+            const std::size_t run_size = (run_end - page) << PAGE_BITS;
+            if (attributes[page] == PageType::RasterizerCachedMemory) {
+                flush(page << PAGE_BITS, run_size);
+            }
+            std::memcpy(destination.data() + ((page << PAGE_BITS) - addr),
+                        memory.data() + (page << PAGE_BITS), run_size);
+            page = run_end;
+        }
+    };
+
+    const auto measure = [&](const char* name, auto&& read) {
+        std::uniform_int_distribution<std::size_t> start_page(0,
+                                                              NUM_PAGES - BLOCK_SIZE / PAGE_SIZE);
+        std::mt19937 block_rng(1);
+        flush_calls = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < ITERATIONS; ++i) {
+            read(static_cast<VAddr>(start_page(block_rng) << PAGE_BITS));
+        }
+        const std::chrono::duration<double, std::micro> elapsed =
+            std::chrono::steady_clock::now() - start;
+        std::printf("%-22s %8.1fus per 1 MiB read, %6.1f flush calls per read\n", name,
+                    elapsed.count() / ITERATIONS, static_cast<double>(flush_calls) / ITERATIONS);
+    };
+    measure("Per page flushes", read_per_page);
+    measure("Coalesced flushes", read_coalesced);
+    REQUIRE(lookups != 0);
+}
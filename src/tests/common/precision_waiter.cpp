@@ -0,0 +1,128 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "common/precision_waiter.h"
+#include "common/thread.h"
+
+using namespace std::chrono_literals;
+using Common::PrecisionWaiter;
+using Clock = PrecisionWaiter::Clock;
+
+namespace {
+
+struct LatencyDistribution {
+    std::chrono::nanoseconds min;
+    std::chrono::nanoseconds p50;
+    std::chrono::nanoseconds p99;
+    std::chrono::nanoseconds max;
+};
+
+/// Measures how late each of the waits returns after its deadline
+template <typename Func>
+LatencyDistribution MeasureWakeupLatency(std::size_t count, std::chrono::nanoseconds duration,
+                                         Func&& wait_until) {
+    std::vector<std::chrono::nanoseconds> latencies;
+    latencies.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto deadline = Clock::now() + duration;
+        wait_until(deadline);
+        latencies.push_back(Clock::now() - deadline);
+    }
+    std::sort(latencies.begin(), latencies.end());
+    return {
+        .min = latencies.front(),
+        .p50 = latencies[count / 2],
+        .p99 = latencies[count * 99 / 100],
+        .max = latencies.back(),
+    };
+}
+
+void PrintDistribution(const char* name, const LatencyDistribution& distribution) {
+    std::printf("%-32s min %7.1fus p50 %7.1fus p99 %7.1fus max %7.1fus\n", name,
+                distribution.min.count() / 1000.0, distribution.p50.count() / 1000.0,
+                distribution.p99.count() / 1000.0, distribution.max.count() / 1000.0);
+}
+
+} // Anonymous namespace
+
+TEST_CASE("PrecisionWaiter[Deadline]", "[common]") {
+    PrecisionWaiter waiter;
+    // Waits never return before their deadline unless the waiter is set
+    const auto wait = MeasureWakeupLatency(
+        50, 1ms, [&](Clock::time_point deadline) { REQUIRE(!waiter.WaitUntil(deadline)); });
+    REQUIRE(wait.min >= 0ns);
+    const auto sleep = MeasureWakeupLatency(
+        50, 1ms, [&](Clock::time_point deadline) { waiter.SleepUntil(deadline); });
+    REQUIRE(sleep.min >= 0ns);
+
+    // The busy-wait tail adapts to the host timer, within its bounds
+    REQUIRE(waiter.SpinMargin() >= 10us);
+    REQUIRE(waiter.SpinMargin() <= 2ms);
+}
+
+TEST_CASE("PrecisionWaiter[Set]", "[common]") {
+    PrecisionWaiter waiter;
+
+    // A pending set makes the next wait return immediately, once
+    waiter.Set();
+    waiter.Set();
+    REQUIRE(waiter.WaitFor(10s));
+    REQUIRE(!waiter.WaitFor(1ms));
+
+    // Set interrupts a waiting thread
+    const auto start = Clock::now();
+    std::thread thread([&] {
+        std::this_thread::sleep_for(10ms);
+        waiter.Set();
+    });
+    REQUIRE(waiter.WaitFor(10s));
+    REQUIRE(Clock::now() - start < 5s);
+    thread.join();
+
+    // Untimed waits
+    thread = std::thread([&] { waiter.Set(); });
+    waiter.Wait();
+    thread.join();
+
+    // SleepUntil ignores and keeps the set state
+    waiter.Set();
+    const auto deadline = Clock::now() + 1ms;
+    waiter.SleepUntil(deadline);
+    REQUIRE(Clock::now() >= deadline);
+    REQUIRE(waiter.WaitFor(0ns));
+}
+
+TEST_CASE("PrecisionWaiter[WakeupLatency]", "[.][Benchmark]") {
+    constexpr std::size_t COUNT = 1000;
+    for (const std::chrono::microseconds duration : {100us, 1000us, 5000us}) {
+        std::printf("Waits of %lldus\n", static_cast<long long>(duration / 1us));
+        Common::Event event;
+        PrintDistribution("  Common::Event::WaitUntil",
+                          MeasureWakeupLatency(COUNT, duration, [&](Clock::time_point deadline) {
+                              event.WaitUntil(deadline);
+                          }));
+        PrintDistribution("  std::this_thread::sleep_until",
+                          MeasureWakeupLatency(COUNT, duration, [](Clock::time_point deadline) {
+                              std::this_thread::sleep_until(deadline);
+                          }));
+        PrecisionWaiter waiter;
+        PrintDistribution("  PrecisionWaiter::WaitUntil",
+                          MeasureWakeupLatency(COUNT, duration, [&](Clock::time_point deadline) {
+                              waiter.WaitUntil(deadline);
+                          }));
+        PrintDistribution("  PrecisionWaiter::SleepUntil",
+                          MeasureWakeupLatency(COUNT, duration, [&](Clock::time_point deadline) {
+                              waiter.SleepUntil(deadline);
+                          }));
+        std::printf("  Spin margin %.1fus\n", waiter.SpinMargin().count() / 1000.0);
+    }
+}
@@ -0,0 +1,146 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "common/common_types.h"
+#include "core/core.h"
+#include "core/hle/kernel/address_arbiter.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/thread.h"
+
+using Kernel::ArbiterWaitQueues;
+using Kernel::Thread;
+
+namespace {
+
+std::vector<std::shared_ptr<Thread>> MakeThreads(Kernel::KernelCore& kernel, std::size_t count) {
+    std::vector<std::shared_ptr<Thread>> threads;
+    for (std::size_t i = 0; i < count; ++i) {
+        threads.push_back(std::make_shared<Thread>(kernel));
+    }
+    return threads;
+}
+
+/// Per-address lists of threads, the way waiters were stored before the intrusive queues
+class ListWaitQueues {
+public:
+    void Insert(Thread* thread) {
+        auto& list = lists[thread->GetArbiterWaitAddress()];
+        const auto it = std::find_if(list.begin(), list.end(), [thread](const Thread* entry) {
+            return entry->GetPriority() >= thread->GetPriority();
+        });
+        list.insert(it, thread);
+    }
+
+    void Remove(Thread* thread) {
+        const auto it = lists.find(thread->GetArbiterWaitAddress());
+        if (it == lists.end()) {
+            return;
+        }
+        it->second.remove(thread);
+        if (it->second.empty()) {
+            lists.erase(it);
+        }
+    }
+
+    Thread* Front(VAddr address) const {
+        const auto it = lists.find(address);
+        return it == lists.end() ? nullptr : it->second.front();
+    }
+
+private:
+    std::unordered_map<VAddr, std::list<Thread*>> lists;
+};
+
+/// Queues every thread on a few contended addresses, then times out every other waiter and wakes
+/// the rest one by one like SignalToAddress does. Returns nanoseconds per queue operation.
+template <typename Queues>
+double RunContention(std::vector<std::shared_ptr<Thread>>& threads, std::size_t num_addresses,
+                     std::size_t rounds) {
+    Queues queues;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t round = 0; round < rounds; ++round) {
+        for (std::size_t i = 0; i < threads.size(); ++i) {
+            threads[i]->SetArbiterWaitAddress(0x1000 + (i % num_addresses) * 4);
+            queues.Insert(threads[i].get());
+        }
+        for (std::size_t i = 0; i < threads.size(); i += 2) {
+            queues.Remove(threads[i].get());
+        }
+        for (std::size_t address = 0; address < num_addresses; ++address) {
+            while (Thread* const thread = queues.Front(0x1000 + address * 4)) {
+                queues.Remove(thread);
+            }
+        }
+    }
+    const std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / static_cast<double>(rounds * threads.size() * 2);
+}
+
+} // Anonymous namespace
+
+TEST_CASE("AddressArbiter[WaitQueues]", "[core][kernel]") {
+    Kernel::KernelCore kernel{Core::System::GetInstance()};
+    const auto threads = MakeThreads(kernel, 64);
+    ArbiterWaitQueues queues;
+
+    // Every address can be waited on, including zero
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        threads[i]->SetArbiterWaitAddress((i % 32) * 4);
+        queues.Insert(threads[i].get());
+    }
+    for (VAddr address = 0; address < 32 * 4; address += 4) {
+        REQUIRE(queues.Count(address) == 2);
+    }
+    REQUIRE(queues.Count(32 * 4) == 0);
+    REQUIRE(queues.Front(32 * 4) == nullptr);
+
+    // Threads of equal priority are woken in the reverse order they were queued
+    REQUIRE(queues.Front(0) == threads[32].get());
+
+    // Removing a thread that isn't queued is a no-op
+    queues.Remove(threads[32].get());
+    queues.Remove(threads[32].get());
+    REQUIRE(queues.Count(0) == 1);
+    REQUIRE(queues.Front(0) == threads[0].get());
+
+    // Emptied queues are dropped without breaking the probe sequences of the others
+    for (std::size_t i = 0; i < 32; i += 2) {
+        queues.Remove(threads[i].get());
+        queues.Remove(threads[i + 32].get());
+    }
+    for (std::size_t i = 0; i < 32; ++i) {
+        const VAddr address = i * 4;
+        if (i % 2 == 0) {
+            REQUIRE(queues.Front(address) == nullptr);
+        } else {
+            REQUIRE(queues.Count(address) == 2);
+            REQUIRE(queues.Front(address) == threads[i + 32].get());
+        }
+    }
+}
+
+TEST_CASE("AddressArbiter[Contention]", "[.][Benchmark]") {
+    Kernel::KernelCore kernel{Core::System::GetInstance()};
+    auto threads = MakeThreads(kernel, 256);
+    constexpr std::size_t ROUNDS = 2000;
+
+    std::printf("Arbiter wait queue operations (ns/op)\n");
+    std::printf("%-10s %-10s %-10s\n", "Addresses", "Lists", "Intrusive");
+    for (const std::size_t num_addresses : {1, 4, 64}) {
+        const double lists = RunContention<ListWaitQueues>(threads, num_addresses, ROUNDS);
+        const double intrusive = RunContention<ArbiterWaitQueues>(threads, num_addresses, ROUNDS);
+        std::printf("%-10zu %-10.2f %-10.2f\n", num_addresses, lists, intrusive);
+    }
+}
@@ -0,0 +1,131 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "common/common_types.h"
+#include "core/core.h"
+#include "core/hle/kernel/errors.h"
+#include "core/hle/kernel/handle_table.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/object.h"
+#include "core/hle/kernel/thread.h"
+
+namespace {
+
+class TestObject final : public Kernel::Object {
+public:
+    static constexpr Kernel::HandleType HANDLE_TYPE = Kernel::HandleType::Unknown;
+
+    explicit TestObject(Kernel::KernelCore& kernel) : Object{kernel} {}
+
+    Kernel::HandleType GetHandleType() const override {
+        return HANDLE_TYPE;
+    }
+};
+
+} // Anonymous namespace
+
+TEST_CASE("HandleTable[CreateAndClose]", "[core][kernel]") {
+    Kernel::KernelCore kernel{Core::System::GetInstance()};
+    Kernel::HandleTable table{kernel};
+
+    const auto object = std::make_shared<TestObject>(kernel);
+    const auto handle = table.Create(object);
+    REQUIRE(handle.Succeeded());
+    REQUIRE(table.IsValid(*handle));
+    REQUIRE(table.Get<TestObject>(*handle) == object);
+    REQUIRE(table.Get<Kernel::Thread>(*handle) == nullptr);
+
+    const auto duplicate = table.Duplicate(*handle);
+    REQUIRE(duplicate.Succeeded());
+    REQUIRE(*duplicate != *handle);
+    REQUIRE(table.Get<TestObject>(*duplicate) == object);
+
+    REQUIRE(table.Close(*handle) == RESULT_SUCCESS);
+    REQUIRE(!table.IsValid(*handle));
+    REQUIRE(table.GetGeneric(*handle) == nullptr);
+    REQUIRE(table.Close(*handle) == Kernel::ERR_INVALID_HANDLE);
+
+    // A new handle reusing the slot must not revive the closed one
+    const auto reused = table.Create(object);
+    REQUIRE(reused.Succeeded());
+    REQUIRE(table.GetGeneric(*handle) == nullptr);
+
+    REQUIRE(table.Close(*duplicate) == RESULT_SUCCESS);
+    REQUIRE(table.Close(*reused) == RESULT_SUCCESS);
+    REQUIRE(object.use_count() == 1);
+}
+
+TEST_CASE("HandleTable[Capacity]", "[core][kernel]") {
+    Kernel::KernelCore kernel{Core::System::GetInstance()};
+    Kernel::HandleTable table{kernel, 4096};
+    REQUIRE(table.GetCapacity() == 4096);
+    REQUIRE(table.SetSize(4097) == Kernel::ERR_OUT_OF_MEMORY);
+    REQUIRE(table.SetSize(2000) == RESULT_SUCCESS);
+
+    const auto object = std::make_shared<TestObject>(kernel);
+    std::vector<Kernel::Handle> handles;
+    for (int i = 0; i < 2000; ++i) {
+        const auto handle = table.Create(object);
+        REQUIRE(handle.Succeeded());
+        handles.push_back(*handle);
+    }
+    REQUIRE(table.Create(object).Code() == Kernel::ERR_HANDLE_TABLE_FULL);
+
+    for (const Kernel::Handle handle : handles) {
+        REQUIRE(table.Get<TestObject>(handle) == object);
+    }
+    table.Clear();
+    REQUIRE(object.use_count() == 1);
+}
+
+TEST_CASE("HandleTable[Benchmark]", "[.][Benchmark]") {
+    Kernel::KernelCore kernel{Core::System::GetInstance()};
+    Kernel::HandleTable table{kernel};
+
+    constexpr int rounds = 1000;
+    constexpr int lookups_per_handle = 16;
+    const auto object = std::make_shared<TestObject>(kernel);
+    std::vector<Kernel::Handle> handles(Kernel::HandleTable::MAX_COUNT);
+
+    std::chrono::nanoseconds create_time{};
+    std::chrono::nanoseconds get_time{};
+    std::chrono::nanoseconds close_time{};
+    std::size_t found = 0;
+    for (int round = 0; round < rounds; ++round) {
+        auto start = std::chrono::steady_clock::now();
+        for (auto& handle : handles) {
+            handle = table.Create(object).Unwrap();
+        }
+        create_time += std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < lookups_per_handle; ++i) {
+            for (const Kernel::Handle handle : handles) {
+                found += table.Get<TestObject>(handle) != nullptr ? 1 : 0;
+            }
+        }
+        get_time += std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (const Kernel::Handle handle : handles) {
+            table.Close(handle);
+        }
+        close_time += std::chrono::steady_clock::now() - start;
+    }
+    REQUIRE(found == std::size_t{1} * rounds * lookups_per_handle * handles.size());
+
+    const auto per_op = [&](std::chrono::nanoseconds time, int multiplier) {
+        return static_cast<double>(time.count()) / (rounds * multiplier * handles.size());
+    };
+    std::printf("Create: %.2f ns/handle\n", per_op(create_time, 1));
+    std::printf("Lookup: %.2f ns/lookup\n", per_op(get_time, lookups_per_handle));
+    std::printf("Close: %.2f ns/handle\n", per_op(close_time, 1));
+}
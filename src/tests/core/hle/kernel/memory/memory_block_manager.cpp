@@ -0,0 +1,329 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <list>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "common/alignment.h"
+#include "common/common_types.h"
+#include "core/hle/kernel/memory/memory_block.h"
+#include "core/hle/kernel/memory/memory_block_manager.h"
+#include "core/hle/kernel/memory/memory_types.h"
+
+using Kernel::Memory::MemoryAttribute;
+using Kernel::Memory::MemoryBlockManager;
+using Kernel::Memory::MemoryInfo;
+using Kernel::Memory::MemoryPermission;
+using Kernel::Memory::MemoryState;
+using Kernel::Memory::PageSize;
+
+namespace {
+
+constexpr VAddr START_ADDR = 0x8000000;
+constexpr std::size_t NUM_PAGES = 256;
+
+constexpr std::array STATES{MemoryState::Free, MemoryState::Normal, MemoryState::Code,
+                            MemoryState::Stack};
+constexpr std::array PERMISSIONS{MemoryPermission::None, MemoryPermission::Read,
+                                 MemoryPermission::ReadAndWrite};
+constexpr std::array ATTRIBUTES{MemoryAttribute::None, MemoryAttribute::Locked,
+                                MemoryAttribute::Uncached};
+
+/**
+ * Reference model of the memory block manager, keeping the properties of every page. Blocks are
+ * the maximal runs of pages with the same properties.
+ */
+class PageModel {
+public:
+    void Update(std::size_t first, std::size_t count, MemoryState state, MemoryPermission perm,
+                MemoryAttribute attribute) {
+        for (std::size_t page = first; page < first + count; ++page) {
+            Page& p = pages[page];
+            p.state = state;
+            p.perm = perm;
+            p.attribute = attribute | (p.attribute & (MemoryAttribute::IpcLocked |
+                                                      MemoryAttribute::DeviceShared));
+        }
+    }
+
+    void Update(std::size_t first, std::size_t count, MemoryState prev_state,
+                MemoryPermission prev_perm, MemoryAttribute prev_attribute, MemoryState state,
+                MemoryPermission perm, MemoryAttribute attribute) {
+        constexpr MemoryAttribute ignore_mask{MemoryAttribute::DontCareMask |
+                                              MemoryAttribute::IpcLocked |
+                                              MemoryAttribute::DeviceShared};
+        prev_attribute |= MemoryAttribute::IpcAndDeviceMapped;
+        for (std::size_t page = first; page < first + count; ++page) {
+            const Page& p = pages[page];
+            if (p.state == prev_state && p.perm == prev_perm &&
+                (p.attribute | ignore_mask) == (prev_attribute | ignore_mask)) {
+                Update(page, 1, state, perm, attribute);
+            }
+        }
+    }
+
+    void ShareToDevice(std::size_t first, std::size_t count) {
+        for (std::size_t page = first; page < first + count; ++page) {
+            pages[page].attribute |= MemoryAttribute::DeviceShared;
+            ++pages[page].device_use_count;
+        }
+    }
+
+    void UnshareToDevice(std::size_t first, std::size_t count) {
+        for (std::size_t page = first; page < first + count; ++page) {
+            if (--pages[page].device_use_count == 0) {
+                pages[page].attribute &= ~MemoryAttribute::DeviceShared;
+            }
+        }
+    }
+
+    std::vector<MemoryInfo> Blocks() const {
+        std::vector<MemoryInfo> blocks;
+        for (std::size_t page = 0; page < NUM_PAGES; ++page) {
+            const Page& p = pages[page];
+            if (!blocks.empty()) {
+                MemoryInfo& last = blocks.back();
+                if (last.state == p.state && last.perm == p.perm &&
+                    last.attribute == p.attribute && last.device_use_count == p.device_use_count) {
+                    last.size += PageSize;
+                    continue;
+                }
+            }
+            blocks.push_back({START_ADDR + page * PageSize, PageSize, p.state, p.perm, p.attribute,
+                              MemoryPermission::None, 0, p.device_use_count});
+        }
+        return blocks;
+    }
+
+    MemoryState State(std::size_t page) const {
+        return pages[page].state;
+    }
+    MemoryPermission Permission(std::size_t page) const {
+        return pages[page].perm;
+    }
+    MemoryAttribute Attribute(std::size_t page) const {
+        return pages[page].attribute;
+    }
+
+private:
+    struct Page {
+        MemoryState state = MemoryState::Free;
+        MemoryPermission perm = MemoryPermission::None;
+        MemoryAttribute attribute = MemoryAttribute::None;
+        u16 device_use_count = 0;
+    };
+    std::array<Page, NUM_PAGES> pages{};
+};
+
+std::vector<MemoryInfo> Blocks(const MemoryBlockManager& manager) {
+    std::vector<MemoryInfo> blocks;
+    for (auto it = manager.begin(); it != manager.end(); ++it) {
+        blocks.push_back(it->GetMemoryInfo());
+    }
+    return blocks;
+}
+
+bool SameBlocks(const std::vector<MemoryInfo>& lhs, const std::vector<MemoryInfo>& rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                      [](const MemoryInfo& a, const MemoryInfo& b) {
+                          return a.addr == b.addr && a.size == b.size && a.state == b.state &&
+                                 a.perm == b.perm && a.attribute == b.attribute &&
+                                 a.original_perm == b.original_perm &&
+                                 a.ipc_lock_count == b.ipc_lock_count &&
+                                 a.device_use_count == b.device_use_count;
+                      });
+}
+
+/// FindFreeArea as implemented over the blocks of the list based manager
+VAddr FindFreeAreaReference(const std::vector<MemoryInfo>& blocks, VAddr region_start,
+                            std::size_t region_num_pages, std::size_t num_pages, std::size_t align,
+                            std::size_t offset, std::size_t guard_pages) {
+    if (num_pages == 0) {
+        return {};
+    }
+    const VAddr region_last{region_start + region_num_pages * PageSize - 1};
+    for (const MemoryInfo& info : blocks) {
+        if (info.GetLastAddress() < region_start) {
+            continue;
+        }
+        if (region_last < info.GetAddress()) {
+            break;
+        }
+        if (info.state != MemoryState::Free) {
+            continue;
+        }
+
+        VAddr area{(info.GetAddress() <= region_start) ? region_start : info.GetAddress()};
+        area += guard_pages * PageSize;
+
+        const VAddr offset_area{Common::AlignDown(area, align) + offset};
+        area = (area <= offset_area) ? offset_area : offset_area + align;
+
+        const VAddr area_last{area + num_pages * PageSize + guard_pages * PageSize - 1};
+        if (info.GetAddress() <= area && area < area_last && area_last <= region_last &&
+            area_last <= info.GetLastAddress()) {
+            return area;
+        }
+    }
+    return {};
+}
+
+} // Anonymous namespace
+
+TEST_CASE("MemoryBlockManager[RandomizedEquivalence]", "[core][kernel]") {
+    for (u32 seed = 1; seed <= 20; ++seed) {
+        std::mt19937 rng(seed);
+        const auto random = [&](std::size_t bound) {
+            return static_cast<std::size_t>(rng() % bound);
+        };
+
+        MemoryBlockManager manager(START_ADDR, START_ADDR + NUM_PAGES * PageSize);
+        PageModel model;
+        std::vector<std::pair<std::size_t, std::size_t>> shared_ranges;
+
+        for (int op = 0; op < 500; ++op) {
+            const std::size_t first = random(NUM_PAGES);
+            const std::size_t count = 1 + random(std::min<std::size_t>(NUM_PAGES - first, 24));
+            const VAddr addr = START_ADDR + first * PageSize;
+            const MemoryState state = STATES[random(STATES.size())];
+            const MemoryPermission perm = PERMISSIONS[random(PERMISSIONS.size())];
+            const MemoryAttribute attribute = ATTRIBUTES[random(ATTRIBUTES.size())];
+
+            switch (random(5)) {
+            case 0:
+            case 1:
+                manager.Update(addr, count, state, perm, attribute);
+                model.Update(first, count, state, perm, attribute);
+                break;
+            case 2: {
+                // Expect the properties of a page in the range, so some blocks match
+                const std::size_t sample = first + random(count);
+                const MemoryState prev_state = model.State(sample);
+                const MemoryPermission prev_perm = model.Permission(sample);
+                const MemoryAttribute prev_attribute =
+                    model.Attribute(sample) &
+                    ~(MemoryAttribute::IpcLocked | MemoryAttribute::DeviceShared);
+                manager.Update(addr, count, prev_state, prev_perm, prev_attribute, state, perm,
+                               attribute);
+                model.Update(first, count, prev_state, prev_perm, prev_attribute, state, perm,
+                             attribute);
+                break;
+            }
+            case 3:
+                manager.UpdateLock(
+                    addr, count,
+                    [](MemoryBlockManager::iterator block, MemoryPermission block_perm) {
+                        block->ShareToDevice(block_perm);
+                    },
+                    perm);
+                model.ShareToDevice(first, count);
+                shared_ranges.emplace_back(first, count);
+                break;
+            case 4: {
+                if (shared_ranges.empty()) {
+                    break;
+                }
+                const auto [shared_first, shared_count] = shared_ranges.back();
+                shared_ranges.pop_back();
+                manager.UpdateLock(
+                    START_ADDR + shared_first * PageSize, shared_count,
+                    [](MemoryBlockManager::iterator block, MemoryPermission block_perm) {
+                        block->UnshareToDevice(block_perm);
+                    },
+                    perm);
+                model.UnshareToDevice(shared_first, shared_count);
+                break;
+            }
+            }
+
+            const std::vector<MemoryInfo> expected = model.Blocks();
+            REQUIRE(SameBlocks(Blocks(manager), expected));
+            REQUIRE(manager.GetNumBlocks() == expected.size());
+
+            // Lookups
+            const VAddr query = START_ADDR + random(NUM_PAGES * PageSize);
+            const MemoryInfo info = manager.FindBlock(query).GetMemoryInfo();
+            REQUIRE(info.GetAddress() <= query);
+            REQUIRE(query <= info.GetLastAddress());
+            REQUIRE(manager.FindIterator(START_ADDR + NUM_PAGES * PageSize) == manager.end());
+            REQUIRE(manager.FindIterator(START_ADDR - 1) == manager.end());
+
+            std::vector<MemoryInfo> iterated;
+            const VAddr range_start = START_ADDR + first * PageSize;
+            const VAddr range_end = range_start + count * PageSize;
+            manager.IterateForRange(range_start, range_end,
+                                    [&](const MemoryInfo& block) { iterated.push_back(block); });
+            std::vector<MemoryInfo> overlapping;
+            for (const MemoryInfo& block : expected) {
+                if (block.GetAddress() < range_end && range_start <= block.GetLastAddress()) {
+                    overlapping.push_back(block);
+                }
+            }
+            REQUIRE(SameBlocks(iterated, overlapping));
+
+            const std::size_t region_pages = 1 + random(NUM_PAGES - first);
+            const std::size_t num_pages = 1 + random(8);
+            const std::size_t align = PageSize << random(3);
+            const std::size_t guard_pages = random(2);
+            REQUIRE(manager.FindFreeArea(addr, region_pages, num_pages, align, 0, guard_pages) ==
+                    FindFreeAreaReference(expected, addr, region_pages, num_pages, align, 0,
+                                          guard_pages));
+        }
+    }
+}
+
+TEST_CASE("MemoryBlockManager[QueryMemoryLoop]", "[.][Benchmark]") {
+    std::printf("%-10s %16s %16s\n", "Blocks", "List us/loop", "Tree us/loop");
+    for (const std::size_t num_blocks : {1000, 10000, 50000}) {
+        const VAddr start = START_ADDR;
+        const VAddr end = start + num_blocks * PageSize;
+        MemoryBlockManager manager(start, end);
+        for (std::size_t page = 0; page < num_blocks; page += 2) {
+            manager.Update(start + page * PageSize, 1, MemoryState::Normal,
+                           MemoryPermission::ReadAndWrite);
+        }
+        REQUIRE(manager.GetNumBlocks() == num_blocks);
+
+        // The lookups of the list based manager, walking the blocks from the first one
+        std::list<MemoryInfo> list;
+        for (auto it = manager.begin(); it != manager.end(); ++it) {
+            list.push_back(it->GetMemoryInfo());
+        }
+        const auto find_in_list = [&](VAddr addr) {
+            for (const MemoryInfo& info : list) {
+                if (info.GetAddress() <= addr && addr <= info.GetLastAddress()) {
+                    return info;
+                }
+            }
+            return MemoryInfo{};
+        };
+        const auto find_in_tree = [&](VAddr addr) {
+            return manager.FindBlock(addr).GetMemoryInfo();
+        };
+
+        // svcQueryMemory loops over the whole address space, one call per block
+        const auto measure = [&](auto&& find) {
+            std::size_t blocks = 0;
+            const auto begin = std::chrono::steady_clock::now();
+            for (VAddr addr = start; addr < end; addr += find(addr).GetSize()) {
+                ++blocks;
+            }
+            const std::chrono::duration<double, std::micro> elapsed =
+                std::chrono::steady_clock::now() - begin;
+            REQUIRE(blocks == num_blocks);
+            return elapsed.count();
+        };
+        const double list_time = measure(find_in_list);
+        const double tree_time = measure(find_in_tree);
+        std::printf("%-10zu %16.1f %16.1f\n", num_blocks, list_time, tree_time);
+    }
+}
@@ -0,0 +1,252 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <list>
+#include <mutex>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "common/common_types.h"
+#include "core/hardware_properties.h"
+#include "core/hle/kernel/memory/memory_manager.h"
+#include "core/hle/kernel/memory/page_heap.h"
+#include "core/hle/kernel/memory/page_linked_list.h"
+
+using Kernel::Memory::MemoryManager;
+using Kernel::Memory::PageHeap;
+using Kernel::Memory::PageLinkedList;
+using Kernel::Memory::PageSize;
+
+namespace {
+
+constexpr u64 POOL_BASE = 0x80000000;
+constexpr u64 POOL_SIZE = 256ULL << 20;
+constexpr std::size_t POOL_PAGES = POOL_SIZE / PageSize;
+constexpr auto POOL = MemoryManager::Pool::Application;
+
+thread_local u32 current_core = Core::INVALID_HOST_THREAD_ID;
+
+u32 GetCurrentCore() {
+    return current_core;
+}
+
+/// Single heap behind one lock, the way the memory manager allocated before magazines
+class GlobalHeap {
+public:
+    GlobalHeap() {
+        heap.Initialize(POOL_BASE, POOL_SIZE, PageHeap::CalculateMetadataOverheadSize(POOL_SIZE));
+        heap.Free(POOL_BASE, POOL_PAGES);
+    }
+
+    bool Allocate(PageLinkedList& page_list, std::size_t num_pages) {
+        std::lock_guard lock{mutex};
+        ++heap_visits;
+        for (s32 index{PageHeap::GetBlockIndex(num_pages)}; index >= 0 && num_pages > 0;
+             index--) {
+            const std::size_t pages_per_alloc{PageHeap::GetBlockNumPages(index)};
+            while (num_pages >= pages_per_alloc) {
+                const VAddr block{heap.AllocateBlock(index)};
+                if (!block) {
+                    break;
+                }
+                page_list.AddBlock(block, pages_per_alloc);
+                num_pages -= pages_per_alloc;
+            }
+        }
+        return num_pages == 0;
+    }
+
+    void Free(PageLinkedList& page_list) {
+        std::lock_guard lock{mutex};
+        ++heap_visits;
+        for (const auto& node : page_list.Nodes()) {
+            heap.Free(node.GetAddress(), node.GetNumPages());
+        }
+    }
+
+    u64 heap_visits = 0;
+
+private:
+    std::mutex mutex;
+    PageHeap heap;
+};
+
+/// Adapts the memory manager to the interface of GlobalHeap
+struct CachedHeap {
+    CachedHeap() {
+        manager.InitializeManager(POOL, POOL_BASE, POOL_BASE + POOL_SIZE);
+    }
+
+    MemoryManager manager{GetCurrentCore};
+
+    bool Allocate(PageLinkedList& page_list, std::size_t num_pages) {
+        return manager.Allocate(page_list, num_pages, POOL).IsSuccess();
+    }
+
+    void Free(PageLinkedList& page_list) {
+        manager.Free(page_list, page_list.GetNumPages(), POOL);
+    }
+};
+
+/// Adds the pages of a list to a set, failing on pages allocated twice
+void TrackPages(std::set<VAddr>& pages, const PageLinkedList& page_list) {
+    for (const auto& node : page_list.Nodes()) {
+        for (std::size_t page = 0; page < node.GetNumPages(); ++page) {
+            REQUIRE(pages.insert(node.GetAddress() + page * PageSize).second);
+        }
+    }
+}
+
+/// Keeps up to `live_lists` small mappings alive while mapping and unmapping, returns ops/sec
+/// or a negative value when an allocation failed
+template <typename Heap>
+double RunChurn(Heap& heap, std::size_t core, std::size_t operations, std::size_t live_lists) {
+    current_core = static_cast<u32>(core);
+    std::mt19937 rng(static_cast<u32>(core + 1));
+    std::uniform_int_distribution<std::size_t> num_pages(1, 32);
+    std::vector<PageLinkedList> lists(live_lists);
+
+    bool failed = false;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < operations; ++i) {
+        PageLinkedList& page_list = lists[rng() % live_lists];
+        if (page_list.GetNumPages() != 0) {
+            heap.Free(page_list);
+            page_list = PageLinkedList{};
+        } else if (!heap.Allocate(page_list, num_pages(rng))) {
+            failed = true;
+        }
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    for (PageLinkedList& page_list : lists) {
+        if (page_list.GetNumPages() != 0) {
+            heap.Free(page_list);
+        }
+    }
+    return failed ? -1.0 : static_cast<double>(operations) / elapsed.count();
+}
+
+} // Anonymous namespace
+
+TEST_CASE("MemoryManager[Magazines]", "[core][kernel]") {
+    CachedHeap heap;
+    MemoryManager& manager = heap.manager;
+    current_core = 0;
+
+    // Small allocations are served from magazines and never overlap
+    std::set<VAddr> pages;
+    std::list<PageLinkedList> lists;
+    for (std::size_t i = 0; i < 200; ++i) {
+        PageLinkedList& page_list = lists.emplace_back();
+        REQUIRE(manager.Allocate(page_list, 1 + i % 20, POOL).IsSuccess());
+        TrackPages(pages, page_list);
+    }
+    const MemoryManager::Statistics stats = manager.GetStatistics(POOL);
+    REQUIRE(stats.cached_allocations != 0);
+    REQUIRE(stats.refills < stats.cached_allocations);
+
+    // Pages of a refill are handed out in ascending order
+    current_core = 2;
+    PageLinkedList contiguous;
+    REQUIRE(manager.Allocate(contiguous, 4, POOL).IsSuccess());
+    REQUIRE(contiguous.Nodes().size() == 1);
+    TrackPages(pages, contiguous);
+    lists.push_back(contiguous);
+
+    // Freed pages are cached and reused
+    for (PageLinkedList& page_list : lists) {
+        REQUIRE(manager.Free(page_list, page_list.GetNumPages(), POOL).IsSuccess());
+    }
+    REQUIRE(manager.GetStatistics(POOL).cached_frees != 0);
+    REQUIRE(manager.GetStatistics(POOL).flushes != 0);
+
+    // Cached pages still count as free, the whole pool can be allocated by another core
+    current_core = 1;
+    PageLinkedList everything;
+    REQUIRE(manager.Allocate(everything, POOL_PAGES, POOL).IsSuccess());
+    REQUIRE(everything.GetNumPages() == POOL_PAGES);
+    REQUIRE(manager.GetStatistics(POOL).drains != 0);
+    PageLinkedList exhausted;
+    REQUIRE(manager.Allocate(exhausted, 1, POOL).IsError());
+    REQUIRE(manager.Free(everything, POOL_PAGES, POOL).IsSuccess());
+
+    // Large allocations come from the heap, aligned as Horizon aligns them
+    current_core = Core::INVALID_HOST_THREAD_ID;
+    const VAddr large = manager.AllocateContinuous(600, 512, POOL);
+    REQUIRE(large != 0);
+    REQUIRE(large % PageHeap::GetBlockSize(3) == 0);
+    PageLinkedList large_list(large, 600);
+    REQUIRE(manager.Free(large_list, 600, POOL).IsSuccess());
+    REQUIRE(manager.AllocateContinuous(PageHeap::GetBlockNumPages(4), 1, POOL) == POOL_BASE);
+}
+
+TEST_CASE("MemoryManager[Concurrent]", "[core][kernel]") {
+    CachedHeap heap;
+    std::vector<std::thread> threads;
+    std::vector<double> rates(Core::Hardware::NUM_CPU_CORES + 1);
+    for (std::size_t core = 0; core < rates.size(); ++core) {
+        threads.emplace_back([&, core] { rates[core] = RunChurn(heap, core, 20000, 64); });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (const double rate : rates) {
+        REQUIRE(rate > 0.0);
+    }
+
+    // Every page went back to the pool
+    PageLinkedList everything;
+    REQUIRE(heap.Allocate(everything, POOL_PAGES));
+}
+
+TEST_CASE("MemoryManager[Churn]", "[.][Benchmark]") {
+    constexpr std::size_t OPERATIONS = 400000;
+
+    std::printf("Small map/unmap operations per second (millions)\n");
+    std::printf("%-8s %-10s %-10s\n", "Cores", "Global", "Magazines");
+    for (std::size_t num_cores = 1; num_cores <= Core::Hardware::NUM_CPU_CORES; ++num_cores) {
+        double results[2]{};
+        const auto run = [&](auto& heap, double& result) {
+            std::vector<std::thread> threads;
+            std::vector<double> rates(num_cores);
+            for (std::size_t core = 0; core < num_cores; ++core) {
+                threads.emplace_back([&, core] {
+                    rates[core] = RunChurn(heap, core, OPERATIONS / num_cores, 256);
+                });
+            }
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+            for (const double rate : rates) {
+                result += rate;
+            }
+        };
+        GlobalHeap global;
+        run(global, results[0]);
+        CachedHeap cached;
+        run(cached, results[1]);
+        std::printf("%-8zu %-10.2f %-10.2f\n", num_cores, results[0] / 1e6, results[1] / 1e6);
+    }
+
+    // Visits to the shared heap, each one takes the pool lock all cores contend on
+    GlobalHeap global;
+    RunChurn(global, 0, OPERATIONS, 256);
+    CachedHeap cached;
+    RunChurn(cached, 0, OPERATIONS, 256);
+    const MemoryManager::Statistics stats = cached.manager.GetStatistics(POOL);
+    const u64 cached_visits =
+        stats.heap_allocations + stats.heap_frees + stats.refills + stats.flushes + stats.drains;
+    std::printf("Heap visits: global %llu, magazines %llu (%llu of %llu blocks cached)\n",
+                static_cast<unsigned long long>(global.heap_visits),
+                static_cast<unsigned long long>(cached_visits),
+                static_cast<unsigned long long>(stats.cached_allocations),
+                static_cast<unsigned long long>(stats.cached_allocations +
+                                                stats.heap_allocations));
+}
@@ -0,0 +1,192 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "common/common_types.h"
+#include "core/core.h"
+#include "core/hle/kernel/client_session.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/object_slab.h"
+#include "core/hle/kernel/readable_event.h"
+#include "core/hle/kernel/resource_limit.h"
+#include "core/hle/kernel/server_session.h"
+#include "core/hle/kernel/session.h"
+#include "core/hle/kernel/thread.h"
+#include "core/hle/kernel/writable_event.h"
+
+using Kernel::MakeSlabObject;
+using Kernel::ResourceLimit;
+using Kernel::ResourceReservation;
+using Kernel::ResourceType;
+using Kernel::SlabAllocator;
+
+namespace {
+
+constexpr std::size_t TEST_SLAB_COUNT = 4;
+
+struct Payload {
+    std::array<u64, 8> data{};
+};
+
+using PayloadSlab = Kernel::impl::ObjectSlab<Payload, TEST_SLAB_COUNT>;
+
+int live_objects = 0;
+
+struct CountedObject {
+    explicit CountedObject(int value) : value{value} {
+        ++live_objects;
+    }
+    ~CountedObject() {
+        --live_objects;
+    }
+
+    int value;
+};
+
+/// Creates the objects of a kernel object type the way it was done before slabs
+struct GlobalHeapFactory {
+    template <typename T, std::size_t Count>
+    static std::shared_ptr<T> Make(Kernel::KernelCore& kernel) {
+        return std::make_shared<T>(kernel);
+    }
+};
+
+struct SlabFactory {
+    template <typename T, std::size_t Count>
+    static std::shared_ptr<T> Make(Kernel::KernelCore& kernel) {
+        return MakeSlabObject<T, Count>(kernel);
+    }
+};
+
+/// Keeps up to `live` objects alive while creating and destroying them, returns objects/sec
+template <typename T, std::size_t Count, typename Factory>
+double RunChurn(Kernel::KernelCore& kernel, std::size_t num_threads, std::size_t operations,
+                std::size_t live) {
+    std::vector<std::thread> threads;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&] {
+            std::vector<std::shared_ptr<T>> objects(live);
+            for (std::size_t op = 0; op < operations; ++op) {
+                objects[op % live] = Factory::template Make<T, Count>(kernel);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(num_threads * operations) / elapsed.count();
+}
+
+template <typename T, std::size_t Count>
+void PrintChurn(Kernel::KernelCore& kernel, const char* name) {
+    constexpr std::size_t OPERATIONS = 400000;
+
+    for (const std::size_t num_threads : {1, 4}) {
+        // Each thread keeps a share of the slab alive, like a pool of sessions or events
+        const std::size_t live = Count / (num_threads * 2);
+        const double global = RunChurn<T, Count, GlobalHeapFactory>(
+            kernel, num_threads, OPERATIONS / num_threads, live);
+        const double slab =
+            RunChurn<T, Count, SlabFactory>(kernel, num_threads, OPERATIONS / num_threads, live);
+        std::printf("%-16s %-8zu %-10.2f %-10.2f\n", name, num_threads, global / 1e6, slab / 1e6);
+    }
+}
+
+} // Anonymous namespace
+
+TEST_CASE("ObjectSlab[Allocation]", "[core][kernel]") {
+    PayloadSlab& slab = PayloadSlab::Get();
+    SlabAllocator<Payload, TEST_SLAB_COUNT> allocator;
+
+    // Slots are handed out until the slab is full, then the global heap is used
+    std::set<Payload*> objects;
+    for (std::size_t i = 0; i < TEST_SLAB_COUNT; ++i) {
+        Payload* const object = allocator.allocate(1);
+        REQUIRE(slab.Contains(object));
+        REQUIRE(objects.insert(object).second);
+    }
+    REQUIRE(slab.GetOverflowCount() == 0);
+    Payload* const overflow = allocator.allocate(1);
+    REQUIRE(!slab.Contains(overflow));
+    REQUIRE(slab.GetOverflowCount() == 1);
+
+    // Freed slots are reused before the global heap
+    Payload* const freed = *objects.begin();
+    allocator.deallocate(freed, 1);
+    allocator.deallocate(overflow, 1);
+    REQUIRE(allocator.allocate(1) == freed);
+    for (Payload* const object : objects) {
+        allocator.deallocate(object, 1);
+    }
+
+    // Shared objects beyond the slab count are constructed and destroyed like the others
+    {
+        std::vector<std::shared_ptr<CountedObject>> counted;
+        for (int i = 0; i < static_cast<int>(TEST_SLAB_COUNT) * 2; ++i) {
+            counted.push_back(MakeSlabObject<CountedObject, TEST_SLAB_COUNT>(i));
+        }
+        REQUIRE(live_objects == static_cast<int>(TEST_SLAB_COUNT) * 2);
+        for (int i = 0; i < static_cast<int>(counted.size()); ++i) {
+            REQUIRE(counted[i]->value == i);
+        }
+    }
+    REQUIRE(live_objects == 0);
+}
+
+TEST_CASE("ObjectSlab[KernelObjects]", "[core][kernel]") {
+    Kernel::KernelCore kernel{Core::System::GetInstance()};
+
+    const auto [readable, writable] = Kernel::WritableEvent::CreateEventPair(kernel, "Test");
+    REQUIRE(writable->GetReadableEvent() == readable);
+    writable->Signal();
+    REQUIRE(!readable->ShouldWait(nullptr));
+
+    const auto [client, server] = Kernel::Session::Create(kernel, "Test");
+    REQUIRE(client->GetName() == "Test_Client");
+    REQUIRE(server->GetName() == "Test_Server");
+}
+
+TEST_CASE("ObjectSlab[ResourceReservation]", "[core][kernel]") {
+    Kernel::KernelCore kernel{Core::System::GetInstance()};
+    const auto limit = ResourceLimit::Create(kernel);
+    REQUIRE(limit->SetLimitValue(ResourceType::Events, 2).IsSuccess());
+
+    // Reservations fail once the limit is reached
+    auto first = std::make_unique<ResourceReservation>(limit, ResourceType::Events);
+    ResourceReservation second{limit, ResourceType::Events};
+    REQUIRE(first->Succeeded());
+    REQUIRE(second.Succeeded());
+    REQUIRE(limit->GetCurrentResourceValue(ResourceType::Events) == 0);
+    REQUIRE(!ResourceReservation(limit, ResourceType::Events).Succeeded());
+
+    // Destroying the holder of a reservation releases it, moving one doesn't
+    ResourceReservation moved{std::move(*first)};
+    first.reset();
+    REQUIRE(limit->GetCurrentResourceValue(ResourceType::Events) == 0);
+    moved = ResourceReservation{};
+    REQUIRE(limit->GetCurrentResourceValue(ResourceType::Events) == 1);
+    REQUIRE(ResourceReservation(limit, ResourceType::Events).Succeeded());
+}
+
+TEST_CASE("ObjectSlab[Churn]", "[.][Benchmark]") {
+    Kernel::KernelCore kernel{Core::System::GetInstance()};
+
+    std::printf("Kernel objects created and destroyed per second (millions)\n");
+    std::printf("%-16s %-8s %-10s %-10s\n", "Object", "Threads", "Global", "Slab");
+    PrintChurn<Kernel::WritableEvent, Kernel::EventSlabCount>(kernel, "WritableEvent");
+    PrintChurn<Kernel::ReadableEvent, Kernel::EventSlabCount>(kernel, "ReadableEvent");
+    PrintChurn<Kernel::ServerSession, Kernel::SessionSlabCount>(kernel, "ServerSession");
+    PrintChurn<Kernel::Thread, Kernel::ThreadSlabCount>(kernel, "Thread");
+}
@@ -0,0 +1,263 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+#include "common/common_types.h"
+#include "core/memory/dmnt_cheat_types.h"
+#include "core/memory/dmnt_cheat_vm.h"
+
+using Core::Memory::CheatEntry;
+using Core::Memory::CheatProcessMetadata;
+using Core::Memory::DmntCheatVm;
+
+namespace {
+
+constexpr VAddr MAIN_BASE = 0x10000;
+constexpr VAddr HEAP_BASE = 0x40000;
+constexpr u64 REGION_SIZE = 0x10000;
+
+/// Process memory of the tests, addresses are offsets into a host buffer
+struct TestState {
+    std::vector<u8> memory = std::vector<u8>(HEAP_BASE + REGION_SIZE);
+    u64 keys_down = 0;
+    bool direct_pointers = false;
+    u64 generation = 0;
+    /// When nonzero, the page table changes on this read of the generation and pages stop being
+    /// directly accessible
+    u64 remap_on_generation_read = 0;
+    u64 memory_calls = 0;
+    u64 page_lookups = 0;
+
+    template <typename T>
+    T Read(VAddr address) const {
+        T value;
+        std::memcpy(&value, memory.data() + address, sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    void Write(VAddr address, T value) {
+        std::memcpy(memory.data() + address, &value, sizeof(T));
+    }
+};
+
+class TestCallbacks final : public DmntCheatVm::Callbacks {
+public:
+    explicit TestCallbacks(TestState& state) : state{state} {}
+
+    void MemoryRead(VAddr address, void* data, u64 size) override {
+        ++state.memory_calls;
+        std::memcpy(data, state.memory.data() + address, size);
+    }
+
+    void MemoryWrite(VAddr address, const void* data, u64 size) override {
+        ++state.memory_calls;
+        std::memcpy(state.memory.data() + address, data, size);
+    }
+
+    u64 HidKeysDown() override {
+        return state.keys_down;
+    }
+
+    void DebugLog(u8, u64) override {}
+
+    void CommandLog(std::string_view) override {}
+
+    u8* GetPagePointer(VAddr address) override {
+        ++state.page_lookups;
+        return state.direct_pointers ? state.memory.data() + address : nullptr;
+    }
+
+    u64 GetMemoryGeneration() override {
+        if (state.remap_on_generation_read != 0 && --state.remap_on_generation_read == 0) {
+            state.direct_pointers = false;
+            ++state.generation;
+        }
+        return state.generation;
+    }
+
+private:
+    TestState& state;
+};
+
+CheatProcessMetadata MakeMetadata() {
+    CheatProcessMetadata metadata{};
+    metadata.main_nso_extents = {MAIN_BASE, REGION_SIZE};
+    metadata.heap_extents = {HEAP_BASE, REGION_SIZE};
+    return metadata;
+}
+
+CheatEntry MakeCheat(std::initializer_list<u32> opcodes) {
+    CheatEntry entry{};
+    entry.enabled = true;
+    for (const u32 opcode : opcodes) {
+        entry.definition.opcodes[entry.definition.num_opcodes++] = opcode;
+    }
+    return entry;
+}
+
+// Stores 0x12345678 to main+0x10
+const CheatEntry STORE_STATIC = MakeCheat({0x04000000, 0x00000010, 0x12345678});
+
+// Stores 1 to main+0x20 if heap+0 is 5, and 2 to main+0x21 if A is also pressed, 3 to main+0x22
+const CheatEntry CONDITIONALS = MakeCheat({
+    0x14150000, 0x00000000, 0x00000005, // if u32 [heap+0] == 5
+    0x01000000, 0x00000020, 0x00000001, //   u8 [main+0x20] = 1
+    0x80000001,                         //   if A is pressed
+    0x01000000, 0x00000021, 0x00000002, //     u8 [main+0x21] = 2
+    0x20000000,                         //   end
+    0x20000000,                         // end
+    0x01000000, 0x00000022, 0x00000003, // u8 [main+0x22] = 3
+});
+
+// Fills main+0x100 with the u32 values 0 to 7
+const CheatEntry LOOP = MakeCheat({
+    0x40010000, 0x00000000, 0x00000000, // r1 = 0
+    0x40020000, 0x00000000, 0x00000000, // r2 = 0
+    0x30300000, 0x00000008,             // loop r3 = 8
+    0xA4210500, 0x00000100,             //   u32 [main + r1 + 0x100] = r2
+    0x78010000, 0x00000004,             //   r1 += 4
+    0x78020000, 0x00000001,             //   r2 += 1
+    0x31300000,                         // end loop r3
+});
+
+// Follows the pointer at heap+8, then the one at offset 0x10 of it, and stores to its target
+const CheatEntry POINTER_CHAIN = MakeCheat({
+    0x58100000, 0x00000008,             // r0 = u64 [heap+8]
+    0x58001000, 0x00000010,             // r0 = u64 [r0+0x10]
+    0x64000000, 0x00000000, 0xCAFEBABE, // u32 [r0] = 0xCAFEBABE
+});
+
+void RunCheats(TestState& state, const std::vector<CheatEntry>& cheats) {
+    const CheatProcessMetadata metadata = MakeMetadata();
+    DmntCheatVm vm(std::make_unique<TestCallbacks>(state));
+    REQUIRE(vm.LoadProgram(cheats));
+    vm.Execute(metadata);
+}
+
+} // Anonymous namespace
+
+TEST_CASE("DmntCheatVm[Opcodes]", "[core][memory]") {
+    for (const bool direct_pointers : {false, true}) {
+        TestState state;
+        state.direct_pointers = direct_pointers;
+        state.Write<u64>(HEAP_BASE + 8, MAIN_BASE + 0x200);
+        state.Write<u64>(MAIN_BASE + 0x210, MAIN_BASE + 0x300);
+        RunCheats(state, {STORE_STATIC, LOOP, POINTER_CHAIN});
+
+        REQUIRE(state.Read<u32>(MAIN_BASE + 0x10) == 0x12345678);
+        for (u32 i = 0; i < 8; ++i) {
+            REQUIRE(state.Read<u32>(MAIN_BASE + 0x100 + i * 4) == i);
+        }
+        REQUIRE(state.Read<u32>(MAIN_BASE + 0x100 + 8 * 4) == 0);
+        REQUIRE(state.Read<u32>(MAIN_BASE + 0x300) == 0xCAFEBABE);
+        REQUIRE((state.memory_calls == 0) == direct_pointers);
+    }
+}
+
+TEST_CASE("DmntCheatVm[Conditionals]", "[core][memory]") {
+    const auto run = [](u32 heap_value, u64 keys_down) {
+        TestState state;
+        state.Write<u32>(HEAP_BASE, heap_value);
+        state.keys_down = keys_down;
+        RunCheats(state, {CONDITIONALS});
+        return std::vector<u8>(state.memory.begin() + MAIN_BASE + 0x20,
+                               state.memory.begin() + MAIN_BASE + 0x23);
+    };
+    REQUIRE(run(5, 1) == std::vector<u8>{1, 2, 3});
+    REQUIRE(run(5, 0) == std::vector<u8>{1, 0, 3});
+    REQUIRE(run(4, 1) == std::vector<u8>{0, 0, 3});
+}
+
+TEST_CASE("DmntCheatVm[InvalidOpcode]", "[core][memory]") {
+    // Execution stops at reserved and truncated opcodes
+    TestState state;
+    RunCheats(state, {MakeCheat({0x04000000, 0x00000010, 0x00000001, 0xB0000000, 0x04000000,
+                                 0x00000014, 0x00000001})});
+    REQUIRE(state.Read<u32>(MAIN_BASE + 0x10) == 1);
+    REQUIRE(state.Read<u32>(MAIN_BASE + 0x14) == 0);
+
+    RunCheats(state, {MakeCheat({0x04000000, 0x00000018, 0x00000001, 0x04000000, 0x0000001C})});
+    REQUIRE(state.Read<u32>(MAIN_BASE + 0x18) == 1);
+}
+
+TEST_CASE("DmntCheatVm[PageRevalidation]", "[core][memory]") {
+    TestState state;
+    state.direct_pointers = true;
+    const CheatProcessMetadata metadata = MakeMetadata();
+    DmntCheatVm vm(std::make_unique<TestCallbacks>(state));
+    REQUIRE(vm.LoadProgram({STORE_STATIC}));
+
+    // Pages are looked up once while the page table doesn't change
+    vm.Execute(metadata);
+    vm.Execute(metadata);
+    REQUIRE(state.page_lookups == 1);
+
+    // Pages that stopped being directly accessible go through the callbacks
+    state.direct_pointers = false;
+    state.Write<u32>(MAIN_BASE + 0x10, 0);
+    ++state.generation;
+    vm.Execute(metadata);
+    REQUIRE(state.page_lookups == 2);
+    REQUIRE(state.memory_calls == 1);
+    REQUIRE(state.Read<u32>(MAIN_BASE + 0x10) == 0x12345678);
+}
+
+TEST_CASE("DmntCheatVm[PageRevalidationDuringExecution]", "[core][memory]") {
+    // The page table changes after the first store of the loop, later stores use the callbacks
+    TestState state;
+    state.direct_pointers = true;
+    state.remap_on_generation_read = 2;
+    RunCheats(state, {LOOP});
+    for (u32 i = 0; i < 8; ++i) {
+        REQUIRE(state.Read<u32>(MAIN_BASE + 0x100 + i * 4) == i);
+    }
+    REQUIRE(state.page_lookups == 2);
+    REQUIRE(state.memory_calls == 7);
+}
+
+TEST_CASE("DmntCheatVm[Corpus]", "[.][Benchmark]") {
+    constexpr int ITERATIONS = 20000;
+
+    // Typical cheat files, several pointer chain, loop and conditional cheats
+    std::vector<CheatEntry> cheats;
+    for (int i = 0; i < 6; ++i) {
+        cheats.push_back(STORE_STATIC);
+        cheats.push_back(CONDITIONALS);
+        cheats.push_back(LOOP);
+        cheats.push_back(POINTER_CHAIN);
+    }
+
+    std::printf("%-20s %10s %14s\n", "", "us/frame", "callbacks/frame");
+    for (const bool direct_pointers : {false, true}) {
+        TestState state;
+        state.direct_pointers = direct_pointers;
+        state.keys_down = 1;
+        state.Write<u32>(HEAP_BASE, 5);
+        state.Write<u64>(HEAP_BASE + 8, MAIN_BASE + 0x200);
+        state.Write<u64>(MAIN_BASE + 0x210, MAIN_BASE + 0x300);
+
+        const CheatProcessMetadata metadata = MakeMetadata();
+        DmntCheatVm vm(std::make_unique<TestCallbacks>(state));
+        REQUIRE(vm.LoadProgram(cheats));
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < ITERATIONS; ++i) {
+            vm.Execute(metadata);
+        }
+        const std::chrono::duration<double, std::micro> elapsed =
+            std::chrono::steady_clock::now() - start;
+        std::printf("%-20s %10.3f %14.1f\n", direct_pointers ? "Direct pointers" : "Callbacks",
+                    elapsed.count() / ITERATIONS,
+                    static_cast<double>(state.memory_calls) / ITERATIONS);
+    }
+}
@@ -0,0 +1,57 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+
+#include "core/perf_stats.h"
+
+using namespace std::chrono_literals;
+using Core::FrameTimeHistogram;
+
+TEST_CASE("FrameTimeHistogram[Percentiles]", "[core]") {
+    FrameTimeHistogram histogram;
+    REQUIRE(histogram.GetPercentile(0.5) == 0ns);
+
+    // 990 frames at 16.6ms, 9 at 33.3ms and one at 50ms
+    for (int i = 0; i < 990; ++i) {
+        histogram.AddSample(16600us);
+    }
+    for (int i = 0; i < 9; ++i) {
+        histogram.AddSample(33300us);
+    }
+    histogram.AddSample(50ms);
+    REQUIRE(histogram.NumSamples() == 1000);
+
+    // Percentiles are rounded up to the bucket width
+    REQUIRE(histogram.GetPercentile(0.5) == 16650us);
+    REQUIRE(histogram.GetPercentile(0.99) == 16650us);
+    REQUIRE(histogram.GetPercentile(0.995) == 33350us);
+    REQUIRE(histogram.GetPercentile(0.999) == 33350us);
+    REQUIRE(histogram.GetPercentile(1.0) == 50050us);
+}
+
+TEST_CASE("FrameTimeHistogram[SlidingWindow]", "[core]") {
+    FrameTimeHistogram histogram;
+    for (std::size_t i = 0; i < FrameTimeHistogram::WindowSize; ++i) {
+        histogram.AddSample(40ms);
+    }
+    REQUIRE(histogram.GetPercentile(0.5) == 40050us);
+
+    // Newer samples evict the oldest ones
+    for (std::size_t i = 0; i < FrameTimeHistogram::WindowSize / 2 + 1; ++i) {
+        histogram.AddSample(10ms);
+    }
+    REQUIRE(histogram.NumSamples() == FrameTimeHistogram::WindowSize);
+    REQUIRE(histogram.GetPercentile(0.5) == 10050us);
+    REQUIRE(histogram.GetPercentile(1.0) == 40050us);
+
+    // Durations out of range are clamped
+    histogram.AddSample(1s);
+    histogram.AddSample(-1ms);
+    REQUIRE(histogram.GetPercentile(1.0) == FrameTimeHistogram::BucketWidth *
+                                                FrameTimeHistogram::NumBuckets);
+    REQUIRE(histogram.GetPercentile(0.0) == FrameTimeHistogram::BucketWidth);
+}
@@ -0,0 +1,85 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "common/common_types.h"
+#include "core/core_timing.h"
+#include "core/core_timing_util.h"
+#include "core/tools/freezer.h"
+
+using Tools::Freezer;
+
+namespace {
+
+constexpr auto FRAME_NS = std::chrono::nanoseconds{1000000000 / 60};
+
+/// Process memory of the tests, addresses are offsets into a host buffer
+class TestCallbacks final : public Freezer::Callbacks {
+public:
+    explicit TestCallbacks(std::vector<u8>& memory) : memory{memory} {}
+
+    u64 Read(VAddr address, u32 width) override {
+        u64 value = 0;
+        std::memcpy(&value, memory.data() + address, width);
+        return value;
+    }
+
+    void Write(VAddr address, u32 width, u64 value) override {
+        std::memcpy(memory.data() + address, &value, width);
+    }
+
+private:
+    std::vector<u8>& memory;
+};
+
+/// Single core timing, advanced one frame at a time by the tests
+struct ScopeTiming final {
+    ScopeTiming() {
+        core_timing.SetMulticore(false);
+        core_timing.Initialize([]() {});
+    }
+    ~ScopeTiming() {
+        core_timing.Shutdown();
+    }
+
+    void AdvanceFrame() {
+        // One more tick keeps events due at the end of the frame from being missed to rounding
+        core_timing.AddTicks(static_cast<u64>(Core::Timing::nsToCycles(FRAME_NS)) + 1);
+        core_timing.Advance();
+    }
+
+    Core::Timing::CoreTiming core_timing;
+};
+
+} // Anonymous namespace
+
+TEST_CASE("Freezer[Timed]", "[core]") {
+    ScopeTiming timing;
+    std::vector<u8> memory(0x2000);
+    auto callbacks = std::make_unique<TestCallbacks>(memory);
+    TestCallbacks& process = *callbacks;
+    Freezer freezer{timing.core_timing, std::move(callbacks)};
+
+    process.Write(0x1000, 4, 0x12345678);
+    REQUIRE(freezer.Freeze(0x1000, 4) == 0x12345678);
+    freezer.SetActive(true);
+
+    // Writes go through until the next frame rewrites the frozen value
+    process.Write(0x1000, 4, 0);
+    REQUIRE(process.Read(0x1000, 4) == 0);
+    timing.AdvanceFrame();
+    REQUIRE(process.Read(0x1000, 4) == 0x12345678);
+
+    // Deactivating stops the rewrites
+    freezer.SetActive(false);
+    process.Write(0x1000, 4, 0);
+    timing.AdvanceFrame();
+    REQUIRE(process.Read(0x1000, 4) == 0);
+}
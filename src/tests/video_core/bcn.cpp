@@ -0,0 +1,402 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "common/common_types.h"
+#include "video_core/surface.h"
+#include "video_core/textures/bcn.h"
+#include "video_core/textures/convert.h"
+
+namespace BCn = Tegra::Texture::BCn;
+using VideoCore::Surface::PixelFormat;
+
+namespace {
+
+/// Writes bit fields to a 128 bits block, lowest bits first.
+class BitWriter {
+public:
+    BitWriter& Write(u64 value, u32 count) {
+        for (u32 i = 0; i < count; ++i, ++position) {
+            block[position / 8] |= static_cast<u8>(((value >> i) & 1) << (position % 8));
+        }
+        return *this;
+    }
+
+    const std::array<u8, 16>& Block() const {
+        REQUIRE(position == 128);
+        return block;
+    }
+
+private:
+    std::array<u8, 16> block{};
+    u32 position = 0;
+};
+
+template <typename T = u8>
+std::vector<std::array<T, 4>> DecodeBlock(PixelFormat format, const u8* block) {
+    std::vector<std::array<T, 4>> texels(16);
+    BCn::Decompress(format, block, 4, 4, 1, reinterpret_cast<u8*>(texels.data()));
+    return texels;
+}
+
+/// Returns the peak signal to noise ratio of the RGB channels of two RGBA8 images.
+double PSNR(const std::vector<u8>& lhs, const std::vector<u8>& rhs) {
+    double squared_error = 0.0;
+    std::size_t samples = 0;
+    for (std::size_t i = 0; i < lhs.size(); ++i) {
+        if (i % 4 == 3) {
+            continue;
+        }
+        const double delta = static_cast<double>(lhs[i]) - static_cast<double>(rhs[i]);
+        squared_error += delta * delta;
+        ++samples;
+    }
+    if (squared_error == 0.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return 10.0 * std::log10(255.0 * 255.0 / (squared_error / static_cast<double>(samples)));
+}
+
+/// Procedural RGBA8 images standing in for a texture corpus.
+std::vector<u8> MakeImage(u32 kind, u32 width, u32 height) {
+    std::vector<u8> image(std::size_t{width} * height * 4);
+    std::mt19937 rng{kind};
+    for (u32 y = 0; y < height; ++y) {
+        for (u32 x = 0; x < width; ++x) {
+            u8* const texel = &image[(std::size_t{y} * width + x) * 4];
+            const double u = static_cast<double>(x) / width;
+            const double v = static_cast<double>(y) / height;
+            switch (kind) {
+            case 0: // Smooth gradients
+                texel[0] = static_cast<u8>(255 * u);
+                texel[1] = static_cast<u8>(255 * v);
+                texel[2] = static_cast<u8>(255 * (1 - u) * v);
+                texel[3] = static_cast<u8>(255 * u * v);
+                break;
+            case 1: // Natural-ish detail, a sum of waves
+                texel[0] = static_cast<u8>(127.5 + 127.5 * std::sin(u * 23 + std::cos(v * 17)));
+                texel[1] = static_cast<u8>(127.5 + 127.5 * std::sin(v * 31 + u * 7));
+                texel[2] = static_cast<u8>(127.5 + 127.5 * std::cos((u + v) * 13));
+                texel[3] = 255;
+                break;
+            default: // Noise
+                for (u32 c = 0; c < 4; ++c) {
+                    texel[c] = static_cast<u8>(rng());
+                }
+                break;
+            }
+        }
+    }
+    return image;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("BCn[BC1]", "[video_core]") {
+    // Red and blue endpoints in four colors mode
+    std::array<u8, 8> block{0x00, 0xf8, 0x1f, 0x00, 0xe4, 0xe4, 0xe4, 0xe4};
+    auto texels = DecodeBlock(PixelFormat::BC1_RGBA_UNORM, block.data());
+    REQUIRE(texels[0] == std::array<u8, 4>{255, 0, 0, 255});
+    REQUIRE(texels[1] == std::array<u8, 4>{0, 0, 255, 255});
+    REQUIRE(texels[2] == std::array<u8, 4>{170, 0, 85, 255});
+    REQUIRE(texels[3] == std::array<u8, 4>{85, 0, 170, 255});
+
+    // Swapped endpoints select the three colors mode with transparent black
+    std::swap(block[0], block[2]);
+    std::swap(block[1], block[3]);
+    texels = DecodeBlock(PixelFormat::BC1_RGBA_UNORM, block.data());
+    REQUIRE(texels[0] == std::array<u8, 4>{0, 0, 255, 255});
+    REQUIRE(texels[2] == std::array<u8, 4>{128, 0, 128, 255});
+    REQUIRE(texels[3] == std::array<u8, 4>{0, 0, 0, 0});
+
+    // BC3 color blocks are always decoded in four colors mode
+    std::array<u8, 16> bc3{255, 255};
+    std::memcpy(bc3.data() + 8, block.data(), block.size());
+    texels = DecodeBlock(PixelFormat::BC3_UNORM, bc3.data());
+    REQUIRE(texels[3] == std::array<u8, 4>{170, 0, 85, 255});
+}
+
+TEST_CASE("BCn[BC4]", "[video_core]") {
+    // Texel i uses index i % 8
+    const std::array<u8, 8> block{200, 100, 0x88, 0xc6, 0xfa, 0x88, 0xc6, 0xfa};
+    const auto texels = DecodeBlock(PixelFormat::BC4_UNORM, block.data());
+    const std::array<u8, 8> expected{200, 100, 186, 171, 157, 143, 129, 114};
+    for (u32 i = 0; i < 16; ++i) {
+        REQUIRE(texels[i] == std::array<u8, 4>{expected[i % 8], 0, 0, 255});
+    }
+
+    // Six values mode with explicit extremes, -128 is clamped to -127
+    const std::array<u8, 8> snorm{0x80, 0x7f, 0x88, 0xc6, 0xfa, 0x88, 0xc6, 0xfa};
+    const auto signed_texels = DecodeBlock(PixelFormat::BC4_SNORM, snorm.data());
+    REQUIRE(static_cast<s8>(signed_texels[0][0]) == -127);
+    REQUIRE(static_cast<s8>(signed_texels[1][0]) == 127);
+    REQUIRE(static_cast<s8>(signed_texels[6][0]) == -127);
+    REQUIRE(static_cast<s8>(signed_texels[7][0]) == 127);
+}
+
+TEST_CASE("BCn[BC7]", "[video_core]") {
+    SECTION("Mode 6") {
+        BitWriter writer;
+        writer.Write(1 << 6, 7);
+        writer.Write(127, 7).Write(0, 7);   // Red
+        writer.Write(0, 7).Write(127, 7);   // Green
+        writer.Write(64, 7).Write(64, 7);   // Blue
+        writer.Write(127, 7).Write(127, 7); // Alpha
+        writer.Write(1, 1).Write(0, 1);     // Endpoint p-bits
+        writer.Write(0, 3);
+        for (u32 i = 1; i < 16; ++i) {
+            writer.Write(i, 4);
+        }
+        const auto texels = DecodeBlock(PixelFormat::BC7_UNORM, writer.Block().data());
+        REQUIRE(texels[0] == std::array<u8, 4>{255, 1, 129, 255});
+        REQUIRE(texels[15] == std::array<u8, 4>{0, 254, 128, 254});
+        // Weight 30 of 64
+        REQUIRE(texels[7] == std::array<u8, 4>{135, 120, 129, 255});
+    }
+    SECTION("Mode 5 with rotation") {
+        BitWriter writer;
+        writer.Write(1 << 5, 6);
+        writer.Write(1, 2); // Swap red and alpha
+        writer.Write(127, 7).Write(127, 7);
+        writer.Write(0, 7).Write(0, 7);
+        writer.Write(0, 7).Write(0, 7);
+        writer.Write(10, 8).Write(10, 8);
+        writer.Write(0, 31).Write(0, 31);
+        const auto texels = DecodeBlock(PixelFormat::BC7_UNORM, writer.Block().data());
+        for (const auto& texel : texels) {
+            REQUIRE(texel == std::array<u8, 4>{10, 0, 0, 255});
+        }
+    }
+    SECTION("Reserved mode") {
+        const std::array<u8, 16> block{};
+        for (const auto& texel : DecodeBlock(PixelFormat::BC7_UNORM, block.data())) {
+            REQUIRE(texel == std::array<u8, 4>{0, 0, 0, 0});
+        }
+    }
+}
+
+TEST_CASE("BCn[BC6H]", "[video_core]") {
+    SECTION("Mode 11") {
+        BitWriter writer;
+        writer.Write(0x03, 5);
+        writer.Write(1023, 10).Write(0, 10).Write(512, 10);
+        writer.Write(0, 10).Write(1023, 10).Write(512, 10);
+        writer.Write(0, 3);
+        for (u32 i = 1; i < 16; ++i) {
+            writer.Write(15, 4);
+        }
+        const auto texels = DecodeBlock<u16>(PixelFormat::BC6H_UFLOAT, writer.Block().data());
+        REQUIRE(texels[0] == std::array<u16, 4>{0x7bff, 0, 0x3e0f, 0x3c00});
+        REQUIRE(texels[15] == std::array<u16, 4>{0, 0x7bff, 0x3e0f, 0x3c00});
+    }
+    SECTION("Mode 12 transformed") {
+        // The second endpoint is stored as a signed delta from the first, red uses the
+        // eleventh endpoint bit to be negative in signed formats
+        BitWriter writer;
+        writer.Write(0x07, 5);
+        writer.Write(512, 10).Write(512, 10).Write(512, 10);
+        writer.Write(0x1ff, 9).Write(1, 1);
+        writer.Write(1, 9).Write(0, 1);
+        writer.Write(0, 9).Write(0, 1);
+        writer.Write(0, 3);
+        for (u32 i = 1; i < 16; ++i) {
+            writer.Write(15, 4);
+        }
+        const u8* const block = writer.Block().data();
+        const auto unsigned_texels = DecodeBlock<u16>(PixelFormat::BC6H_UFLOAT, block);
+        const auto signed_texels = DecodeBlock<u16>(PixelFormat::BC6H_SFLOAT, block);
+        // Endpoints are 1536 and 1535 for red, 512 and 513 for green, 512 for blue
+        const auto unsigned_half = [](u32 value) {
+            return static_cast<u16>(((((value << 16) + 0x8000) >> 11) * 31) >> 6);
+        };
+        REQUIRE(unsigned_texels[0] ==
+                std::array<u16, 4>{unsigned_half(1536), unsigned_half(512), unsigned_half(512),
+                                   0x3c00});
+        REQUIRE(unsigned_texels[15] ==
+                std::array<u16, 4>{unsigned_half(1535), unsigned_half(513), unsigned_half(512),
+                                   0x3c00});
+        // Signed red is -512 and -513
+        const auto signed_half = [](s32 value) {
+            const s32 unquantized = ((std::abs(value) << 15) + 0x4000) >> 10;
+            const u16 magnitude = static_cast<u16>((unquantized * 31) >> 5);
+            return static_cast<u16>(value < 0 ? 0x8000 | magnitude : magnitude);
+        };
+        REQUIRE(signed_texels[0] ==
+                std::array<u16, 4>{signed_half(-512), signed_half(512), signed_half(512), 0x3c00});
+        REQUIRE(signed_texels[15] ==
+                std::array<u16, 4>{signed_half(-513), signed_half(513), signed_half(512), 0x3c00});
+    }
+    SECTION("Reserved mode") {
+        BitWriter writer;
+        writer.Write(0x13, 5).Write(0, 64).Write(0, 59);
+        const auto texels = DecodeBlock<u16>(PixelFormat::BC6H_UFLOAT, writer.Block().data());
+        for (const auto& texel : texels) {
+            REQUIRE(texel == std::array<u16, 4>{0, 0, 0, 0x3c00});
+        }
+    }
+}
+
+TEST_CASE("BCn[Compress]", "[video_core]") {
+    // Texels representable in RGB565 compress losslessly
+    const std::vector<u8> solid(4 * 4 * 4, 0xff);
+    std::vector<u8> compressed(BCn::CompressedSize(PixelFormat::BC3_UNORM, 4, 4, 1));
+    BCn::Compress(PixelFormat::BC3_UNORM, solid.data(), 4, 4, 1, compressed.data());
+    std::vector<u8> decompressed(solid.size());
+    BCn::Decompress(PixelFormat::BC3_UNORM, compressed.data(), 4, 4, 1, decompressed.data());
+    REQUIRE(decompressed == solid);
+
+    // Sizes that aren't a multiple of the block size
+    for (const PixelFormat format : {PixelFormat::BC1_RGBA_UNORM, PixelFormat::BC3_UNORM}) {
+        constexpr u32 width = 61;
+        constexpr u32 height = 37;
+        const std::vector<u8> image = MakeImage(0, width, height);
+        compressed.assign(BCn::CompressedSize(format, width, height, 2), 0);
+        const std::size_t block_size = format == PixelFormat::BC1_RGBA_UNORM ? 8 : 16;
+        REQUIRE(compressed.size() == 16 * 10 * 2 * block_size);
+
+        std::vector<u8> layers = image;
+        layers.insert(layers.end(), image.begin(), image.end());
+        BCn::Compress(format, layers.data(), width, height, 2, compressed.data());
+        decompressed.assign(layers.size(), 0);
+        BCn::Decompress(format, compressed.data(), width, height, 2, decompressed.data());
+        if (format == PixelFormat::BC3_UNORM) {
+            for (std::size_t i = 3; i < layers.size(); i += 4) {
+                REQUIRE(std::abs(static_cast<int>(layers[i]) - decompressed[i]) <= 2);
+            }
+        } else {
+            // BC1 keeps punch through alpha, transparent texels decode to black
+            for (std::size_t i = 0; i < layers.size(); i += 4) {
+                const bool opaque = layers[i + 3] >= 128;
+                REQUIRE(decompressed[i + 3] == (opaque ? 255 : 0));
+                if (!opaque) {
+                    std::fill_n(&layers[i], 3, u8{0});
+                }
+            }
+        }
+        REQUIRE(PSNR(layers, decompressed) > 30.0);
+    }
+
+    // BC1 blocks mixing transparent and opaque texels, and fully transparent blocks
+    std::vector<u8> image(4 * 4 * 4, 0x80);
+    for (std::size_t i = 3; i < image.size(); i += 8) {
+        image[i] = 0;
+    }
+    compressed.assign(BCn::CompressedSize(PixelFormat::BC1_RGBA_UNORM, 4, 4, 1), 0);
+    BCn::Compress(PixelFormat::BC1_RGBA_UNORM, image.data(), 4, 4, 1, compressed.data());
+    decompressed.assign(image.size(), 0);
+    BCn::Decompress(PixelFormat::BC1_RGBA_UNORM, compressed.data(), 4, 4, 1,
+                    decompressed.data());
+    for (std::size_t i = 0; i < image.size(); i += 4) {
+        const bool opaque = i % 8 != 0;
+        REQUIRE(decompressed[i + 3] == (opaque ? 255 : 0));
+        if (opaque) {
+            REQUIRE(std::abs(static_cast<int>(decompressed[i]) - 0x80) <= 4);
+        }
+    }
+    std::fill(image.begin(), image.end(), u8{0});
+    BCn::Compress(PixelFormat::BC1_RGBA_UNORM, image.data(), 4, 4, 1, compressed.data());
+    BCn::Decompress(PixelFormat::BC1_RGBA_UNORM, compressed.data(), 4, 4, 1,
+                    decompressed.data());
+    REQUIRE(decompressed == image);
+}
+
+TEST_CASE("BCn[HostConversion]", "[video_core]") {
+    // Hosts without BCn support get surfaces decompressed in place by the texture cache
+    constexpr u32 width = 13;
+    constexpr u32 height = 9;
+    for (const PixelFormat format : {PixelFormat::BC1_RGBA_UNORM, PixelFormat::BC6H_UFLOAT}) {
+        constexpr std::size_t num_blocks = 4 * 3;
+        const std::size_t block_size = format == PixelFormat::BC1_RGBA_UNORM ? 8 : 16;
+        std::vector<u8> compressed(num_blocks * block_size);
+        std::mt19937 rng{1};
+        std::generate(compressed.begin(), compressed.end(),
+                      [&rng] { return static_cast<u8>(rng()); });
+
+        const std::size_t decompressed_size =
+            std::size_t{width} * height * BCn::DecompressedBytesPerPixel(format);
+        std::vector<u8> expected(decompressed_size);
+        BCn::Decompress(format, compressed.data(), width, height, 1, expected.data());
+
+        std::vector<u8> host(decompressed_size);
+        std::copy(compressed.begin(), compressed.end(), host.begin());
+        const PixelFormat host_format = Tegra::Texture::GetConvertedFormat(format, false);
+        Tegra::Texture::ConvertFromGuestToHost(host.data(), host.data(), format, host_format,
+                                               width, height, 1, true);
+        REQUIRE(host == expected);
+    }
+}
+
+TEST_CASE("BCn[ASTCTranscode]", "[video_core]") {
+    // Four 8x8 void extent blocks of opaque red
+    std::array<u8, 16> block{0xfc, 0xfd, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                             0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff};
+    std::vector<u8> astc;
+    for (u32 i = 0; i < 4; ++i) {
+        astc.insert(astc.end(), block.begin(), block.end());
+    }
+    std::vector<u8> bc3(BCn::CompressedSize(PixelFormat::BC3_UNORM, 16, 16, 1));
+    BCn::TranscodeASTCToBC3(astc.data(), 16, 16, 1, 8, 8, bc3.data());
+    std::vector<u8> rgba8(16 * 16 * 4);
+    BCn::Decompress(PixelFormat::BC3_UNORM, bc3.data(), 16, 16, 1, rgba8.data());
+    for (std::size_t i = 0; i < rgba8.size(); i += 4) {
+        REQUIRE(rgba8[i] == 255);
+        REQUIRE(rgba8[i + 1] == 0);
+        REQUIRE(rgba8[i + 2] == 0);
+        REQUIRE(rgba8[i + 3] == 255);
+    }
+}
+
+TEST_CASE("BCn[Benchmark]", "[.][Benchmark]") {
+    constexpr u32 SIZE = 1024;
+    const auto measure = [](auto&& func) {
+        constexpr int ITERATIONS = 4;
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < ITERATIONS; ++i) {
+            func();
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return SIZE * SIZE * ITERATIONS / elapsed.count() / 1e6;
+    };
+    const std::array<const char*, 3> corpus_names{"gradients", "waves", "noise"};
+    for (u32 kind = 0; kind < corpus_names.size(); ++kind) {
+        const std::vector<u8> image = MakeImage(kind, SIZE, SIZE);
+        for (const PixelFormat format : {PixelFormat::BC1_RGBA_UNORM, PixelFormat::BC3_UNORM}) {
+            std::vector<u8> compressed(BCn::CompressedSize(format, SIZE, SIZE, 1));
+            std::vector<u8> decompressed(image.size());
+            const double encode = measure(
+                [&] { BCn::Compress(format, image.data(), SIZE, SIZE, 1, compressed.data()); });
+            const double decode = measure([&] {
+                BCn::Decompress(format, compressed.data(), SIZE, SIZE, 1, decompressed.data());
+            });
+            std::printf("%-10s %s: encode %6.1f Mpixels/s, decode %6.1f Mpixels/s, %5.2f dB\n",
+                        corpus_names[kind], format == PixelFormat::BC1_RGBA_UNORM ? "BC1" : "BC3",
+                        encode, decode, PSNR(image, decompressed));
+        }
+    }
+    // Random blocks exercise every BC7 and BC6H mode
+    std::mt19937 rng{0};
+    std::vector<u8> blocks(SIZE * SIZE);
+    for (u8& value : blocks) {
+        value = static_cast<u8>(rng());
+    }
+    std::vector<u8> decompressed(std::size_t{SIZE} * SIZE * 8);
+    std::printf("BC7 decode %6.1f Mpixels/s\n", measure([&] {
+                    BCn::Decompress(PixelFormat::BC7_UNORM, blocks.data(), SIZE, SIZE, 1,
+                                    decompressed.data());
+                }));
+    std::printf("BC6H decode %6.1f Mpixels/s\n", measure([&] {
+                    BCn::Decompress(PixelFormat::BC6H_UFLOAT, blocks.data(), SIZE, SIZE, 1,
+                                    decompressed.data());
+                }));
+}
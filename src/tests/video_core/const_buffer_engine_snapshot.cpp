@@ -0,0 +1,109 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+
+#include <cstring>
+#include <vector>
+
+#include "common/common_types.h"
+#include "core/core.h"
+#include "video_core/engines/const_buffer_engine_snapshot.h"
+#include "video_core/engines/shader_type.h"
+#include "video_core/guest_driver.h"
+#include "video_core/memory_manager.h"
+#include "video_core/textures/texture.h"
+
+using Tegra::Engines::ConstBufferEngineSnapshot;
+using Tegra::Engines::SamplerDescriptor;
+using Tegra::Engines::ShaderType;
+using Tegra::Texture::TextureFormat;
+using Tegra::Texture::TextureType;
+using Tegra::Texture::TICEntry;
+using Tegra::Texture::TSCEntry;
+
+namespace {
+
+constexpr u32 BOUND_BUFFER = 2;
+
+/// Encodes a texture handle the way applications store them in const buffers
+constexpr u32 MakeHandle(u32 tic_id, u32 tsc_id) {
+    return tic_id | (tsc_id << 20);
+}
+
+ConstBufferEngineSnapshot MakeSnapshot(const VideoCore::GuestDriverProfile& profile) {
+    // Bound samplers 0 and 1, a bindless handle in buffer 1 and a separate sampler handle
+    std::vector<std::vector<u8>> const_buffers(3);
+    const std::vector<u32> handles{MakeHandle(1, 0), MakeHandle(2, 1)};
+    const_buffers[BOUND_BUFFER].resize(handles.size() * sizeof(u32));
+    std::memcpy(const_buffers[BOUND_BUFFER].data(), handles.data(),
+                const_buffers[BOUND_BUFFER].size());
+    const u32 bindless = MakeHandle(3, 1);
+    const_buffers[1].resize(0x20);
+    std::memcpy(const_buffers[1].data() + 0x10, &bindless, sizeof(bindless));
+
+    std::vector<TICEntry> tic(4);
+    tic[1].format.Assign(TextureFormat::A8R8G8B8);
+    tic[1].texture_type.Assign(TextureType::Texture2D);
+    tic[2].format.Assign(TextureFormat::BC1_RGBA);
+    tic[2].texture_type.Assign(TextureType::Texture2DArray);
+    tic[3].format.Assign(TextureFormat::R32);
+    tic[3].texture_type.Assign(TextureType::Texture3D);
+    std::vector<TSCEntry> tsc(2);
+    tsc[1].depth_compare_enabled.Assign(1);
+
+    return ConstBufferEngineSnapshot{ShaderType::Fragment, std::move(const_buffers), BOUND_BUFFER,
+                                     std::move(tic), std::move(tsc), profile};
+}
+
+} // Anonymous namespace
+
+TEST_CASE("ConstBufferEngineSnapshot[Samplers]", "[video_core]") {
+    const VideoCore::GuestDriverProfile profile;
+    const ConstBufferEngineSnapshot snapshot = MakeSnapshot(profile);
+
+    // Bound samplers are read through the handles of the bound buffer
+    const SamplerDescriptor bound = snapshot.AccessBoundSampler(ShaderType::Fragment, 0);
+    REQUIRE(bound.format == TextureFormat::A8R8G8B8);
+    REQUIRE(bound.texture_type == Tegra::Shader::TextureType::Texture2D);
+    REQUIRE(bound.is_shadow == 0);
+    const SamplerDescriptor shadow = snapshot.AccessBoundSampler(ShaderType::Fragment, 1);
+    REQUIRE(shadow.format == TextureFormat::BC1_RGBA);
+    REQUIRE(shadow.is_array == 1);
+    REQUIRE(shadow.is_shadow == 1);
+
+    // Bindless and separate samplers are served by the same tables
+    const SamplerDescriptor bindless =
+        snapshot.AccessBindlessSampler(ShaderType::Fragment, 1, 0x10);
+    REQUIRE(bindless.format == TextureFormat::R32);
+    REQUIRE(bindless.texture_type == Tegra::Shader::TextureType::Texture3D);
+    REQUIRE(snapshot.AccessSampler(MakeHandle(2, 0)).format == TextureFormat::BC1_RGBA);
+
+    // Entries past the table limits are read as cleared descriptors
+    REQUIRE(snapshot.AccessSampler(MakeHandle(4, 2)) == SamplerDescriptor{});
+
+    // Copies keep answering with the captured state
+    const auto copy = snapshot.CreateSnapshot(ShaderType::Fragment);
+    REQUIRE(copy->AccessBoundSampler(ShaderType::Fragment, 1) == shadow);
+    REQUIRE(copy->AccessBindlessSampler(ShaderType::Fragment, 1, 0x10) == bindless);
+}
+
+TEST_CASE("ConstBufferEngineSnapshot[Create]", "[video_core]") {
+    Tegra::MemoryManager memory_manager{Core::System::GetInstance()};
+    const VideoCore::GuestDriverProfile profile;
+    constexpr u32 max_limit = ConstBufferEngineSnapshot::MAX_DESCRIPTORS - 1;
+
+    const auto snapshot = ConstBufferEngineSnapshot::Create(
+        memory_manager, ShaderType::Fragment, {}, BOUND_BUFFER, 0, max_limit, 0, 0, profile);
+    REQUIRE(snapshot != nullptr);
+    REQUIRE(snapshot->GetBoundBuffer() == BOUND_BUFFER);
+
+    // Tables too large to be copied leave the shader to be built against the live engine
+    REQUIRE(ConstBufferEngineSnapshot::Create(memory_manager, ShaderType::Fragment, {},
+                                              BOUND_BUFFER, 0, max_limit + 1, 0, 0,
+                                              profile) == nullptr);
+    REQUIRE(ConstBufferEngineSnapshot::Create(memory_manager, ShaderType::Fragment, {},
+                                              BOUND_BUFFER, 0, 0, 0, max_limit + 1,
+                                              profile) == nullptr);
+}
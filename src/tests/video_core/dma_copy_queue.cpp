@@ -0,0 +1,69 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <future>
+#include <numeric>
+#include <vector>
+
+#include "common/common_types.h"
+#include "video_core/engines/dma_copy_queue.h"
+
+TEST_CASE("DMACopyQueue[Ticks]", "[video_core]") {
+    Tegra::Engines::DMACopyQueue queue;
+    REQUIRE(queue.CurrentTick() == 0);
+    REQUIRE(queue.IsIdle());
+
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    const u64 first = queue.Submit([released] { released.wait(); });
+    const u64 second = queue.Submit([] {});
+    REQUIRE(first == 1);
+    REQUIRE(second == 2);
+    REQUIRE(queue.CurrentTick() == second);
+
+    // Nothing completes while the first copy is blocked, later copies wait behind it
+    REQUIRE(!queue.IsComplete(first));
+    REQUIRE(!queue.IsComplete(second));
+    REQUIRE(!queue.IsIdle());
+    REQUIRE(queue.IsComplete(0));
+
+    release.set_value();
+    queue.Wait(first);
+    REQUIRE(queue.IsComplete(first));
+    queue.WaitIdle();
+    REQUIRE(queue.IsComplete(second));
+    REQUIRE(queue.IsIdle());
+}
+
+TEST_CASE("DMACopyQueue[Order]", "[video_core]") {
+    constexpr std::size_t size = 4 << 20;
+    constexpr std::size_t num_buffers = 8;
+    std::vector<std::vector<u8>> buffers(num_buffers, std::vector<u8>(size));
+    std::iota(buffers[0].begin(), buffers[0].end(), u8{0});
+
+    // Each copy reads what the previous one wrote, so it only ends up in the last buffer when
+    // the copies run in submission order and each one observes the one before it
+    Tegra::Engines::DMACopyQueue queue;
+    for (std::size_t i = 1; i < num_buffers; ++i) {
+        queue.Submit([&buffers, i] {
+            std::memcpy(buffers[i].data(), buffers[i - 1].data(), size);
+            // Clobber the source, a copy started too early reads this instead of the data
+            std::fill(buffers[i - 1].begin(), buffers[i - 1].end(), u8{0xFF});
+        });
+    }
+    queue.WaitIdle();
+
+    std::vector<u8> expected(size);
+    std::iota(expected.begin(), expected.end(), u8{0});
+    REQUIRE(buffers[num_buffers - 1] == expected);
+    for (std::size_t i = 0; i + 1 < num_buffers; ++i) {
+        REQUIRE(std::all_of(buffers[i].begin(), buffers[i].end(), [](u8 value) {
+            return value == 0xFF;
+        }));
+    }
+}
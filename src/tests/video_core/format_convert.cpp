@@ -0,0 +1,231 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "common/common_types.h"
+#include "video_core/surface.h"
+#include "video_core/textures/convert.h"
+
+using Tegra::Texture::ConvertToGuest;
+using Tegra::Texture::ConvertToHost;
+using Tegra::Texture::GetFormatConversion;
+using VideoCore::Surface::PixelFormat;
+
+namespace {
+
+// Odd amount of pixels to exercise both the vectorized loops and their scalar tails
+constexpr std::size_t NUM_PIXELS = 1027;
+
+template <typename T>
+std::vector<T> RandomValues(std::size_t count, u32 seed) {
+    std::mt19937_64 rng{seed};
+    std::vector<T> values(count);
+    for (T& value : values) {
+        value = static_cast<T>(rng());
+    }
+    return values;
+}
+
+template <typename Guest, typename Host>
+std::vector<Host> ToHost(PixelFormat format, const std::vector<Guest>& guest) {
+    const auto* const conversion = GetFormatConversion(format);
+    const std::size_t num_pixels = guest.size() * sizeof(Guest) / conversion->guest_bytes_per_pixel;
+    std::vector<Host> host(num_pixels * conversion->host_bytes_per_pixel / sizeof(Host));
+    ConvertToHost(format, reinterpret_cast<const u8*>(guest.data()),
+                  reinterpret_cast<u8*>(host.data()), num_pixels);
+    return host;
+}
+
+template <typename Guest, typename Host>
+std::vector<Guest> ToGuest(PixelFormat format, const std::vector<Host>& host) {
+    const auto* const conversion = GetFormatConversion(format);
+    const std::size_t num_pixels = host.size() * sizeof(Host) / conversion->host_bytes_per_pixel;
+    std::vector<Guest> guest(num_pixels * conversion->guest_bytes_per_pixel / sizeof(Guest));
+    ConvertToGuest(format, reinterpret_cast<const u8*>(host.data()),
+                   reinterpret_cast<u8*>(guest.data()), num_pixels);
+    return guest;
+}
+
+/// Reference half float to single float conversion, independent from the tested kernels.
+float HalfToFloat(u16 half) {
+    const float sign = (half & 0x8000) != 0 ? -1.0f : 1.0f;
+    const int exponent = (half >> 10) & 0x1f;
+    const int mantissa = half & 0x3ff;
+    if (exponent == 0) {
+        return sign * std::ldexp(static_cast<float>(mantissa), -24);
+    }
+    if (exponent == 0x1f) {
+        return mantissa == 0 ? sign * std::numeric_limits<float>::infinity()
+                             : std::numeric_limits<float>::quiet_NaN();
+    }
+    return sign * std::ldexp(static_cast<float>(0x400 | mantissa), exponent - 25);
+}
+
+bool IsHalfNaN(u16 half) {
+    return (half & 0x7fff) > 0x7c00;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("FormatConvert[Table]", "[video_core]") {
+    REQUIRE(GetFormatConversion(PixelFormat::A8B8G8R8_UNORM) == nullptr);
+    for (const PixelFormat format :
+         {PixelFormat::S8_UINT_D24_UNORM, PixelFormat::B8G8R8A8_UNORM, PixelFormat::A1B5G5R5_UNORM,
+          PixelFormat::B5G6R5_UNORM, PixelFormat::B10G11R11_FLOAT,
+          PixelFormat::R16G16B16A16_FLOAT}) {
+        const auto* const conversion = GetFormatConversion(format);
+        REQUIRE(conversion != nullptr);
+        REQUIRE(conversion->guest_bytes_per_pixel * 8 ==
+                VideoCore::Surface::GetFormatBpp(conversion->guest_format));
+        REQUIRE(conversion->host_bytes_per_pixel * 8 ==
+                VideoCore::Surface::GetFormatBpp(conversion->host_format));
+    }
+}
+
+TEST_CASE("FormatConvert[S8Z24]", "[video_core]") {
+    const std::vector<u32> guest = RandomValues<u32>(NUM_PIXELS, 1);
+    const std::vector<u32> host = ToHost<u32, u32>(PixelFormat::S8_UINT_D24_UNORM, guest);
+    for (std::size_t i = 0; i < NUM_PIXELS; ++i) {
+        // Stencil moves from the top byte to the bottom byte, depth moves up
+        REQUIRE((host[i] & 0xff) == guest[i] >> 24);
+        REQUIRE(host[i] >> 8 == (guest[i] & 0xffffff));
+    }
+    REQUIRE(ToGuest<u32, u32>(PixelFormat::S8_UINT_D24_UNORM, host) == guest);
+
+    // Conversions with equal pixel sizes can run in place
+    std::vector<u32> in_place = guest;
+    ConvertToHost(PixelFormat::S8_UINT_D24_UNORM, reinterpret_cast<const u8*>(in_place.data()),
+                  reinterpret_cast<u8*>(in_place.data()), NUM_PIXELS);
+    REQUIRE(in_place == host);
+}
+
+TEST_CASE("FormatConvert[B8G8R8A8]", "[video_core]") {
+    const std::vector<u32> guest = RandomValues<u32>(NUM_PIXELS, 2);
+    const std::vector<u32> host = ToHost<u32, u32>(PixelFormat::B8G8R8A8_UNORM, guest);
+    for (std::size_t i = 0; i < NUM_PIXELS; ++i) {
+        const auto* const bgra = reinterpret_cast<const u8*>(&guest[i]);
+        const auto* const rgba = reinterpret_cast<const u8*>(&host[i]);
+        REQUIRE(rgba[0] == bgra[2]);
+        REQUIRE(rgba[1] == bgra[1]);
+        REQUIRE(rgba[2] == bgra[0]);
+        REQUIRE(rgba[3] == bgra[3]);
+    }
+    REQUIRE(ToGuest<u32, u32>(PixelFormat::B8G8R8A8_UNORM, host) == guest);
+}
+
+TEST_CASE("FormatConvert[Packed16]", "[video_core]") {
+    std::vector<u16> guest(0x10000);
+    for (u32 i = 0; i < 0x10000; ++i) {
+        guest[i] = static_cast<u16>(i);
+    }
+    for (const PixelFormat format : {PixelFormat::A1B5G5R5_UNORM, PixelFormat::B5G6R5_UNORM}) {
+        const std::vector<u32> host = ToHost<u16, u32>(format, guest);
+        // Full intensity is preserved and every guest value survives a round trip
+        REQUIRE(host[0xffff] == 0xffffffff);
+        REQUIRE(ToGuest<u16, u32>(format, host) == guest);
+    }
+}
+
+TEST_CASE("FormatConvert[B10G11R11]", "[video_core]") {
+    // Sweep every value of each channel, the others take the next channel's value
+    std::vector<u32> guest(2048);
+    for (u32 i = 0; i < 2048; ++i) {
+        guest[i] = i | (((i + 1) & 0x7ff) << 11) | ((i & 0x3ff) << 22);
+    }
+    const std::vector<u64> host = ToHost<u32, u64>(PixelFormat::B10G11R11_FLOAT, guest);
+    for (u32 i = 0; i < 2048; ++i) {
+        const u16 red = static_cast<u16>(host[i]);
+        const u16 alpha = static_cast<u16>(host[i] >> 48);
+        REQUIRE(alpha == 0x3c00);
+        if (i < 0x7c0) {
+            // Finite unsigned 11 bits floats have the same value as half floats
+            const float expected = std::ldexp(static_cast<float>(i & 0x3f) / 64.0f + 1.0f,
+                                              static_cast<int>(i >> 6) - 15);
+            REQUIRE(HalfToFloat(red) == (i < 0x40 ? std::ldexp(i / 64.0f, -14) : expected));
+        }
+    }
+    REQUIRE(ToGuest<u32, u64>(PixelFormat::B10G11R11_FLOAT, host) == guest);
+
+    // Negative values clamp to zero, values above the largest finite one round to infinity
+    const std::vector<u64> special{0xbc00'bc00'bc00ULL, 0x3c00'7bff'7bff'7bffULL};
+    const std::vector<u32> clamped = ToGuest<u32, u64>(PixelFormat::B10G11R11_FLOAT, special);
+    REQUIRE(clamped[0] == 0);
+    REQUIRE(clamped[1] == (0x7c0U | (0x7c0U << 11) | (0x3e0U << 22)));
+}
+
+TEST_CASE("FormatConvert[R16G16B16A16F]", "[video_core]") {
+    std::vector<u16> guest(0x10000);
+    for (u32 i = 0; i < 0x10000; ++i) {
+        guest[i] = static_cast<u16>(i);
+    }
+    const std::vector<float> host = ToHost<u16, float>(PixelFormat::R16G16B16A16_FLOAT, guest);
+    for (u32 i = 0; i < 0x10000; ++i) {
+        const float expected = HalfToFloat(static_cast<u16>(i));
+        if (IsHalfNaN(static_cast<u16>(i))) {
+            REQUIRE(std::isnan(host[i]));
+        } else {
+            REQUIRE(std::memcmp(&host[i], &expected, sizeof(float)) == 0);
+        }
+    }
+    const std::vector<u16> round_trip = ToGuest<u16, float>(PixelFormat::R16G16B16A16_FLOAT, host);
+    for (u32 i = 0; i < 0x10000; ++i) {
+        if (IsHalfNaN(static_cast<u16>(i))) {
+            // Signaling NaNs are quieted, the rest of the payload is kept
+            REQUIRE(round_trip[i] == (i | 0x200));
+        } else {
+            REQUIRE(round_trip[i] == i);
+        }
+    }
+
+    // Rounding to nearest even
+    const std::vector<float> rounding{65519.0f, 65520.0f, std::ldexp(1.0f, -25),
+                                      std::ldexp(1.5f, -25), 1.0f + std::ldexp(1.0f, -11),
+                                      1.0f + std::ldexp(3.0f, -11), -1e10f, 0.0f};
+    const std::vector<u16> rounded = ToGuest<u16, float>(PixelFormat::R16G16B16A16_FLOAT, rounding);
+    REQUIRE(rounded == std::vector<u16>{0x7bff, 0x7c00, 0x0000, 0x0001, 0x3c00, 0x3c02, 0xfc00,
+                                        0x0000});
+}
+
+TEST_CASE("FormatConvert[Benchmark]", "[.][Benchmark]") {
+    constexpr std::size_t NUM_BENCH_PIXELS = 4096 * 4096;
+    std::vector<u8> in(NUM_BENCH_PIXELS * 16);
+    std::vector<u8> out(NUM_BENCH_PIXELS * 16);
+    const auto measure = [&](const char* name, auto&& func) {
+        constexpr int ITERATIONS = 8;
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < ITERATIONS; ++i) {
+            func();
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::printf("%-20s %8.1f Mpixels/s\n", name,
+                    NUM_BENCH_PIXELS * ITERATIONS / elapsed.count() / 1e6);
+    };
+    const std::array<std::pair<PixelFormat, const char*>, 6> formats{{
+        {PixelFormat::S8_UINT_D24_UNORM, "S8Z24"},
+        {PixelFormat::B8G8R8A8_UNORM, "B8G8R8A8"},
+        {PixelFormat::A1B5G5R5_UNORM, "A1B5G5R5"},
+        {PixelFormat::B5G6R5_UNORM, "B5G6R5"},
+        {PixelFormat::B10G11R11_FLOAT, "B10G11R11F"},
+        {PixelFormat::R16G16B16A16_FLOAT, "R16G16B16A16F"},
+    }};
+    for (const auto& [format, name] : formats) {
+        const auto* const conversion = GetFormatConversion(format);
+        char label[32];
+        std::snprintf(label, sizeof(label), "%s to host", name);
+        measure(label, [&] { conversion->to_host(in.data(), out.data(), NUM_BENCH_PIXELS); });
+        std::snprintf(label, sizeof(label), "%s to guest", name);
+        measure(label, [&] { conversion->to_guest(out.data(), in.data(), NUM_BENCH_PIXELS); });
+    }
+}
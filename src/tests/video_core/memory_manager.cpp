@@ -0,0 +1,160 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "common/common_types.h"
+#include "core/core.h"
+#include "video_core/memory_manager.h"
+
+namespace {
+
+constexpr u64 PAGE_SIZE = 0x10000;
+constexpr u64 LEAF_SPAN = PAGE_SIZE << 10;
+constexpr GPUVAddr ADDRESS_SPACE_START = 1ULL << 32;
+
+} // Anonymous namespace
+
+TEST_CASE("MemoryManager[Map]", "[video_core]") {
+    Tegra::MemoryManager memory_manager{Core::System::GetInstance()};
+    const VAddr cpu_addr = 0x80000000;
+    const GPUVAddr gpu_addr = ADDRESS_SPACE_START + 3 * PAGE_SIZE;
+
+    // A size that is not a multiple of the page size maps the last partial page
+    REQUIRE(memory_manager.Map(cpu_addr, gpu_addr, 2 * PAGE_SIZE + 1) == gpu_addr);
+    REQUIRE(memory_manager.GpuToCpuAddress(gpu_addr) == cpu_addr);
+    REQUIRE(memory_manager.GpuToCpuAddress(gpu_addr + 0x1234) == cpu_addr + 0x1234);
+    REQUIRE(memory_manager.GpuToCpuAddress(gpu_addr + 2 * PAGE_SIZE + 8) ==
+            cpu_addr + 2 * PAGE_SIZE + 8);
+    REQUIRE(!memory_manager.GpuToCpuAddress(gpu_addr - 1));
+    REQUIRE(!memory_manager.GpuToCpuAddress(gpu_addr + 3 * PAGE_SIZE));
+
+    // Remapping a page has to be visible right away, even if it was translated before
+    REQUIRE(memory_manager.Map(cpu_addr + 0x100000, gpu_addr, PAGE_SIZE) == gpu_addr);
+    REQUIRE(memory_manager.GpuToCpuAddress(gpu_addr + 4) == cpu_addr + 0x100004);
+}
+
+TEST_CASE("MemoryManager[ContiguousSize]", "[video_core]") {
+    Tegra::MemoryManager memory_manager{Core::System::GetInstance()};
+    const VAddr cpu_addr = 0x80000000;
+    // Map across a leaf boundary of the page table
+    const GPUVAddr gpu_addr = ADDRESS_SPACE_START + LEAF_SPAN - 2 * PAGE_SIZE;
+    (void)memory_manager.Map(cpu_addr, gpu_addr, 4 * PAGE_SIZE);
+    (void)memory_manager.Map(cpu_addr + 0x1000000, gpu_addr + 4 * PAGE_SIZE, PAGE_SIZE);
+
+    REQUIRE(memory_manager.GetContiguousSize(gpu_addr, 16 * PAGE_SIZE) == 4 * PAGE_SIZE);
+    REQUIRE(memory_manager.GetContiguousSize(gpu_addr + 0x10, 16 * PAGE_SIZE) ==
+            4 * PAGE_SIZE - 0x10);
+    REQUIRE(memory_manager.GetContiguousSize(gpu_addr + 0x10, 0x20) == 0x20);
+    REQUIRE(memory_manager.GetContiguousSize(gpu_addr + 4 * PAGE_SIZE, 16 * PAGE_SIZE) ==
+            PAGE_SIZE);
+    REQUIRE(memory_manager.GetContiguousSize(gpu_addr + 5 * PAGE_SIZE, PAGE_SIZE) == 0);
+    REQUIRE(memory_manager.GetContiguousSize(gpu_addr - PAGE_SIZE, PAGE_SIZE) == 0);
+}
+
+TEST_CASE("MemoryManager[Allocate]", "[video_core]") {
+    Tegra::MemoryManager memory_manager{Core::System::GetInstance()};
+
+    const GPUVAddr first = memory_manager.Allocate(PAGE_SIZE, 0);
+    REQUIRE(first == ADDRESS_SPACE_START);
+
+    // Allocations are aligned and never overlap used pages
+    const GPUVAddr second = memory_manager.Allocate(3 * PAGE_SIZE, 0x100000);
+    REQUIRE(second % 0x100000 == 0);
+    REQUIRE(second > first);
+
+    const GPUVAddr mapped = memory_manager.MapAllocate(0x80000000, PAGE_SIZE, 0);
+    REQUIRE(mapped == first + PAGE_SIZE);
+    REQUIRE(memory_manager.GpuToCpuAddress(mapped) == 0x80000000);
+
+    // Allocations larger than a page table leaf
+    const GPUVAddr large = memory_manager.Allocate(3 * LEAF_SPAN, 0);
+    REQUIRE(large >= second + 3 * PAGE_SIZE);
+    REQUIRE(!memory_manager.AllocateFixed(large + LEAF_SPAN, PAGE_SIZE));
+    REQUIRE(!memory_manager.AllocateFixed(large + 3 * LEAF_SPAN - PAGE_SIZE, PAGE_SIZE));
+    REQUIRE(memory_manager.AllocateFixed(large + 3 * LEAF_SPAN, PAGE_SIZE));
+
+    // Allocated pages are reserved but not mapped
+    REQUIRE(!memory_manager.GpuToCpuAddress(large));
+    REQUIRE(memory_manager.GetContiguousSize(large, PAGE_SIZE) == 0);
+}
+
+TEST_CASE("MemoryManager[AllocateFixed]", "[video_core]") {
+    Tegra::MemoryManager memory_manager{Core::System::GetInstance()};
+    const GPUVAddr gpu_addr = ADDRESS_SPACE_START + 0x100000;
+
+    REQUIRE(memory_manager.AllocateFixed(gpu_addr, 2 * PAGE_SIZE) == gpu_addr);
+    // Any overlap with a used page fails
+    REQUIRE(!memory_manager.AllocateFixed(gpu_addr + PAGE_SIZE, 2 * PAGE_SIZE));
+    REQUIRE(!memory_manager.AllocateFixed(gpu_addr - PAGE_SIZE, 2 * PAGE_SIZE));
+    REQUIRE(memory_manager.AllocateFixed(gpu_addr + 2 * PAGE_SIZE, PAGE_SIZE));
+
+    (void)memory_manager.Map(0x80000000, gpu_addr + 4 * PAGE_SIZE, PAGE_SIZE);
+    REQUIRE(!memory_manager.AllocateFixed(gpu_addr + 4 * PAGE_SIZE, PAGE_SIZE));
+}
+
+TEST_CASE("MemoryManager[Unmap]", "[video_core]") {
+    Tegra::MemoryManager memory_manager{Core::System::GetInstance()};
+
+    // Unmapping reserved ranges doesn't need to flush anything
+    const GPUVAddr gpu_addr = memory_manager.Allocate(4 * PAGE_SIZE, 0);
+    memory_manager.Unmap(gpu_addr, 0);
+    REQUIRE(!memory_manager.AllocateFixed(gpu_addr, PAGE_SIZE));
+
+    memory_manager.Unmap(gpu_addr + PAGE_SIZE, 2 * PAGE_SIZE);
+    REQUIRE(!memory_manager.AllocateFixed(gpu_addr, PAGE_SIZE));
+    REQUIRE(memory_manager.AllocateFixed(gpu_addr + PAGE_SIZE, 2 * PAGE_SIZE));
+
+    memory_manager.Unmap(gpu_addr, 4 * PAGE_SIZE);
+    REQUIRE(memory_manager.Allocate(4 * PAGE_SIZE, 0) == gpu_addr);
+}
+
+TEST_CASE("MemoryManager[Benchmark]", "[.][Benchmark]") {
+    using Clock = std::chrono::steady_clock;
+    constexpr std::size_t num_pages = 0x1000;
+    constexpr std::size_t num_translations = 1 << 24;
+
+    Tegra::MemoryManager memory_manager{Core::System::GetInstance()};
+    const GPUVAddr base = memory_manager.MapAllocate(0x80000000, num_pages * PAGE_SIZE, 0);
+
+    std::mt19937_64 engine{1234};
+    std::uniform_int_distribution<u64> distribution{0, num_pages * PAGE_SIZE - 1};
+    std::vector<GPUVAddr> random_addresses(0x10000);
+    for (GPUVAddr& address : random_addresses) {
+        address = base + (distribution(engine) & ~3ULL);
+    }
+
+    const auto measure = [&](auto&& next_address) {
+        VAddr checksum = 0;
+        const auto start = Clock::now();
+        for (std::size_t i = 0; i < num_translations; ++i) {
+            checksum += memory_manager.GpuToCpuAddress(next_address(i)).value_or(0);
+        }
+        const std::chrono::duration<double, std::nano> time = Clock::now() - start;
+        return std::make_pair(time.count() / num_translations, checksum);
+    };
+    const auto [sequential_ns, sequential_sum] =
+        measure([&](std::size_t i) { return base + (i * 4) % (num_pages * PAGE_SIZE); });
+    const auto [random_ns, random_sum] =
+        measure([&](std::size_t i) { return random_addresses[i % random_addresses.size()]; });
+
+    const auto find_start = Clock::now();
+    constexpr std::size_t num_allocations = 256;
+    for (std::size_t i = 0; i < num_allocations; ++i) {
+        (void)memory_manager.Allocate(PAGE_SIZE, 0);
+    }
+    const std::chrono::duration<double, std::micro> find_time = Clock::now() - find_start;
+
+    std::printf("Sequential translation: %.2f ns (%llx)\n", sequential_ns,
+                static_cast<unsigned long long>(sequential_sum));
+    std::printf("Random translation: %.2f ns (%llx)\n", random_ns,
+                static_cast<unsigned long long>(random_sum));
+    std::printf("Allocate after %zu mapped pages: %.2f us\n", num_pages,
+                find_time.count() / num_allocations);
+}
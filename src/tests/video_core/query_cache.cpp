@@ -0,0 +1,75 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+
+#include "common/common_types.h"
+#include "video_core/query_cache.h"
+
+namespace {
+
+class TestCache;
+
+class TestCounter final : public VideoCommon::HostCounterBase<TestCache, TestCounter> {
+public:
+    explicit TestCounter(std::shared_ptr<TestCounter> dependency, u64 value_, u64& num_waits_)
+        : HostCounterBase{std::move(dependency)}, value{value_}, num_waits{num_waits_} {}
+
+private:
+    u64 BlockingQuery() const override {
+        ++num_waits;
+        return value;
+    }
+
+    u64 value;
+    u64& num_waits;
+};
+
+} // Anonymous namespace
+
+using TestCounterBase = VideoCommon::HostCounterBase<TestCache, TestCounter>;
+
+TEST_CASE("QueryCache[DependencyChain]", "[video_core]") {
+    constexpr u64 length = TestCounterBase::MAX_DEPTH / 2;
+    u64 num_waits = 0;
+    std::shared_ptr<TestCounter> counter;
+    for (u64 i = 0; i < length; ++i) {
+        counter = std::make_shared<TestCounter>(counter, i, num_waits);
+    }
+    const std::shared_ptr<TestCounter> middle = counter;
+    for (u64 i = 0; i < length; ++i) {
+        counter = std::make_shared<TestCounter>(counter, 1, num_waits);
+    }
+    constexpr u64 middle_value = (length - 1) * length / 2;
+
+    // Nothing is waited on until a value is requested
+    REQUIRE(num_waits == 0);
+    REQUIRE(middle->WaitPending());
+
+    // Values accumulate along the chain and each counter is only waited on once
+    REQUIRE(middle->Query() == middle_value);
+    REQUIRE(!middle->WaitPending());
+    REQUIRE(num_waits == length);
+    REQUIRE(counter->Query() == middle_value + length);
+    REQUIRE(num_waits == length * 2);
+    REQUIRE(counter->Query() == middle_value + length);
+    REQUIRE(num_waits == length * 2);
+}
+
+TEST_CASE("QueryCache[DepthCap]", "[video_core]") {
+    constexpr u64 length = 1'000'000;
+    u64 num_waits = 0;
+    std::shared_ptr<TestCounter> counter;
+    for (u64 i = 0; i < length; ++i) {
+        counter = std::make_shared<TestCounter>(counter, 1, num_waits);
+    }
+
+    // Deep chains are resolved as they grow, without losing their value
+    REQUIRE(counter->Depth() <= TestCounterBase::MAX_DEPTH);
+    REQUIRE(num_waits >= length - TestCounterBase::MAX_DEPTH - 1);
+    REQUIRE(counter->Query() == length);
+    REQUIRE(num_waits == length);
+}
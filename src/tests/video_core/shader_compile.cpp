@@ -0,0 +1,185 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "video_core/renderer_opengl/gl_arb_decompiler.h"
+#include "video_core/renderer_opengl/gl_device.h"
+#include "video_core/renderer_opengl/gl_shader_cache.h"
+#include "video_core/renderer_opengl/gl_shader_decompiler.h"
+#include "video_core/renderer_opengl/gl_shader_disk_cache.h"
+#include "video_core/shader/compiler_settings.h"
+#include "video_core/shader/memory_util.h"
+#include "video_core/shader/node_helper.h"
+#include "video_core/shader/node_pool.h"
+#include "video_core/shader/registry.h"
+#include "video_core/shader/shader_ir.h"
+
+namespace {
+
+using Tegra::Engines::ShaderType;
+
+/// Loads every entry of a transferable shader cache file, the file's version is not validated
+std::vector<OpenGL::ShaderDiskCacheEntry> LoadCorpus(const std::string& path) {
+    std::vector<OpenGL::ShaderDiskCacheEntry> entries;
+    Common::FS::IOFile file(path, "rb");
+    u32 version{};
+    if (!file.IsOpen() || file.ReadBytes(&version, sizeof(version)) != sizeof(version)) {
+        return entries;
+    }
+    while (file.Tell() < file.GetSize()) {
+        OpenGL::ShaderDiskCacheEntry entry;
+        if (!entry.Load(file)) {
+            break;
+        }
+        entries.push_back(std::move(entry));
+    }
+    return entries;
+}
+
+double ShadersPerSecond(std::size_t count, std::chrono::nanoseconds time) {
+    return static_cast<double>(count) / std::chrono::duration<double>(time).count();
+}
+
+} // Anonymous namespace
+
+// Feeds a transferable shader cache (e.g. shader/opengl/transferable/<title_id>.bin) through the
+// decoder and the OpenGL backends without a host GPU. Run with: tests "[Benchmark]"
+TEST_CASE("ShaderCompile[Corpus]", "[.][Benchmark]") {
+    const char* const corpus_path = std::getenv("YUZU_SHADER_CORPUS");
+    if (!corpus_path) {
+        WARN("Set YUZU_SHADER_CORPUS to a transferable shader cache file");
+        return;
+    }
+    const std::vector entries = LoadCorpus(corpus_path);
+    REQUIRE(!entries.empty());
+
+    const OpenGL::Device device(nullptr);
+    const VideoCommon::Shader::CompilerSettings settings{};
+
+    std::chrono::nanoseconds decode_time{};
+    std::chrono::nanoseconds glsl_time{};
+    std::chrono::nanoseconds glasm_time{};
+    std::size_t glsl_length = 0;
+    std::size_t glasm_length = 0;
+    for (const auto& entry : entries) {
+        const auto registry = OpenGL::MakeRegistry(entry);
+        const u32 main_offset = entry.type == ShaderType::Compute
+                                    ? VideoCommon::Shader::KERNEL_MAIN_OFFSET
+                                    : VideoCommon::Shader::STAGE_MAIN_OFFSET;
+
+        const auto decode_start = std::chrono::steady_clock::now();
+        const VideoCommon::Shader::ShaderIR ir(entry.code, main_offset, settings, *registry);
+        const auto entries_info = OpenGL::MakeEntries(device, ir, entry.type);
+        const auto decode_end = std::chrono::steady_clock::now();
+
+        const std::string glsl = OpenGL::DecompileShader(device, ir, *registry, entry.type, "");
+        const auto glsl_end = std::chrono::steady_clock::now();
+
+        const std::string glasm =
+            OpenGL::DecompileAssemblyShader(device, ir, *registry, entry.type, "");
+        const auto glasm_end = std::chrono::steady_clock::now();
+
+        decode_time += decode_end - decode_start;
+        glsl_time += glsl_end - decode_end;
+        glasm_time += glasm_end - glsl_end;
+        glsl_length += glsl.size();
+        glasm_length += glasm.size();
+    }
+
+    // SPIR-V emission needs a Vulkan device and can't be measured headlessly
+    const std::size_t count = entries.size();
+    std::printf("Shaders: %zu\n", count);
+    std::printf("Decode: %.1f shaders/s\n", ShadersPerSecond(count, decode_time));
+    std::printf("GLSL emission: %.1f shaders/s (%zu bytes)\n", ShadersPerSecond(count, glsl_time),
+                glsl_length);
+    std::printf("GLASM emission: %.1f shaders/s (%zu bytes)\n",
+                ShadersPerSecond(count, glasm_time), glasm_length);
+    std::printf("Decode + GLSL: %.1f shaders/s\n",
+                ShadersPerSecond(count, decode_time + glsl_time));
+}
+
+// Compares IR construction with heap allocated nodes against the pooled, hash-consed nodes
+TEST_CASE("ShaderCompile[NodePool]", "[.][Benchmark]") {
+    const char* const corpus_path = std::getenv("YUZU_SHADER_CORPUS");
+    if (!corpus_path) {
+        WARN("Set YUZU_SHADER_CORPUS to a transferable shader cache file");
+        return;
+    }
+    const std::vector entries = LoadCorpus(corpus_path);
+    REQUIRE(!entries.empty());
+
+    VideoCommon::Shader::CompilerSettings heap_settings{};
+    heap_settings.use_node_pool = false;
+    const VideoCommon::Shader::CompilerSettings pool_settings{};
+
+    std::chrono::nanoseconds heap_time{};
+    std::chrono::nanoseconds pool_time{};
+    std::size_t pool_bytes = 0;
+    std::size_t num_allocations = 0;
+    std::size_t num_interned = 0;
+    std::size_t peak_pool_bytes = 0;
+    for (const auto& entry : entries) {
+        const u32 main_offset = entry.type == ShaderType::Compute
+                                    ? VideoCommon::Shader::KERNEL_MAIN_OFFSET
+                                    : VideoCommon::Shader::STAGE_MAIN_OFFSET;
+        {
+            const auto registry = OpenGL::MakeRegistry(entry);
+            const auto start = std::chrono::steady_clock::now();
+            const VideoCommon::Shader::ShaderIR ir(entry.code, main_offset, heap_settings,
+                                                   *registry);
+            heap_time += std::chrono::steady_clock::now() - start;
+        }
+        {
+            const auto registry = OpenGL::MakeRegistry(entry);
+            const auto start = std::chrono::steady_clock::now();
+            const VideoCommon::Shader::ShaderIR ir(entry.code, main_offset, pool_settings,
+                                                   *registry);
+            pool_time += std::chrono::steady_clock::now() - start;
+
+            const auto& pool = ir.GetNodePool();
+            pool_bytes += pool.GetAllocatedBytes();
+            peak_pool_bytes = std::max(peak_pool_bytes, pool.GetAllocatedBytes());
+            num_allocations += pool.GetNumAllocations();
+            num_interned += pool.GetNumInterned();
+        }
+    }
+
+    const std::size_t count = entries.size();
+    std::printf("Shaders: %zu\n", count);
+    std::printf("Heap nodes: %.1f shaders/s\n", ShadersPerSecond(count, heap_time));
+    std::printf("Pooled nodes: %.1f shaders/s\n", ShadersPerSecond(count, pool_time));
+    std::printf("Pooled allocations: %zu (%zu bytes, largest shader %zu bytes)\n", num_allocations,
+                pool_bytes, peak_pool_bytes);
+    std::printf("Nodes shared instead of allocated: %zu\n", num_interned);
+}
+
+TEST_CASE("ShaderCompile[NodePoolSharing]", "[video_core]") {
+    using namespace VideoCommon::Shader;
+
+    NodePool pool;
+    const NodePool::Scope scope{pool};
+
+    // Leaves and pure operations are shared
+    const Node a = Immediate(1U);
+    const Node b = Immediate(2U);
+    REQUIRE(Immediate(1U) == a);
+    const Node sum = Operation(OperationCode::IAdd, NO_PRECISE, a, b);
+    REQUIRE(Operation(OperationCode::IAdd, NO_PRECISE, a, b) == sum);
+    REQUIRE(Operation(OperationCode::IAdd, PRECISE, a, b) != sum);
+
+    // Statements may get amending code attached, they are never shared
+    const Node dest = MakeNode<GprNode>(1);
+    REQUIRE(Operation(OperationCode::Assign, dest, sum) !=
+            Operation(OperationCode::Assign, dest, sum));
+}
@@ -0,0 +1,112 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <vector>
+
+#include "common/common_types.h"
+#include "video_core/surface.h"
+#include "video_core/texture_cache/surface_base.h"
+#include "video_core/texture_cache/surface_eviction.h"
+#include "video_core/texture_cache/surface_params.h"
+
+namespace {
+
+using VideoCommon::SurfaceParams;
+using VideoCore::Surface::PixelFormat;
+using VideoCore::Surface::SurfaceTarget;
+using VideoCore::Surface::SurfaceType;
+
+using TestView = std::shared_ptr<int>;
+
+class TestSurface final : public VideoCommon::SurfaceBase<TestView> {
+public:
+    explicit TestSurface(const SurfaceParams& params) : SurfaceBase{0, params, true, true} {}
+
+    void UploadTexture(const std::vector<u8>&) override {}
+
+    void DownloadTexture(std::vector<u8>&) override {}
+
+private:
+    void DecorateSurfaceName() override {}
+
+    TestView CreateView(const VideoCommon::ViewParams&) override {
+        return {};
+    }
+};
+
+using TSurface = std::shared_ptr<TestSurface>;
+
+SurfaceParams MakeParams() {
+    SurfaceParams params{};
+    params.is_tiled = false;
+    params.srgb_conversion = false;
+    params.is_layered = false;
+    params.width = 64;
+    params.height = 64;
+    params.depth = 1;
+    params.pitch = 64 * 4;
+    params.num_levels = 1;
+    params.emulated_levels = 1;
+    params.pixel_format = PixelFormat::A8B8G8R8_UNORM;
+    params.type = SurfaceType::ColorTexture;
+    params.target = SurfaceTarget::Texture2D;
+    return params;
+}
+
+TSurface MakeSurface(u64 last_use_frame) {
+    auto surface = std::make_shared<TestSurface>(MakeParams());
+    surface->MarkAsUsed(last_use_frame);
+    return surface;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("TextureCacheEviction[Evictable]", "[video_core]") {
+    constexpr u64 frame = 100;
+    const TSurface old_surface = MakeSurface(frame - VideoCommon::MIN_EVICTION_AGE);
+    const TSurface recent_surface = MakeSurface(frame - VideoCommon::MIN_EVICTION_AGE + 1);
+    REQUIRE(VideoCommon::IsEvictable(old_surface, frame));
+    REQUIRE(!VideoCommon::IsEvictable(recent_surface, frame));
+
+    // Surfaces holding data that only lives on the host are never evicted
+    const TSurface modified = MakeSurface(0);
+    modified->MarkAsModified(true, 0);
+    REQUIRE(!VideoCommon::IsEvictable(modified, frame));
+
+    const TSurface render_target = MakeSurface(0);
+    render_target->MarkAsRenderTarget(true, 0);
+    REQUIRE(!VideoCommon::IsEvictable(render_target, frame));
+
+    const TSurface sync_pending = MakeSurface(0);
+    sync_pending->SetSyncPending(true);
+    REQUIRE(!VideoCommon::IsEvictable(sync_pending, frame));
+}
+
+TEST_CASE("TextureCacheEviction[LeastRecentlyUsed]", "[video_core]") {
+    std::vector<TSurface> candidates{MakeSurface(5), MakeSurface(1), MakeSurface(3),
+                                     MakeSurface(1), MakeSurface(4)};
+    const std::vector<TSurface> original = candidates;
+
+    std::vector<TSurface> released;
+    std::size_t num_resident = candidates.size();
+    const u64 num_evicted = VideoCommon::EvictLeastRecentlyUsed(
+        candidates, [&num_resident] { return num_resident > 2; },
+        [&](const TSurface& surface) {
+            released.push_back(surface);
+            --num_resident;
+        });
+
+    // Eviction stops as soon as the cache is within its budget, oldest surfaces first and ties
+    // broken by the order the candidates were gathered in
+    REQUIRE(num_evicted == 3);
+    REQUIRE(released == std::vector<TSurface>{original[1], original[3], original[2]});
+
+    // Nothing is released when the cache is already within its budget
+    const u64 none = VideoCommon::EvictLeastRecentlyUsed(
+        candidates, [] { return false; }, [](const TSurface&) { FAIL(); });
+    REQUIRE(none == 0);
+}
@@ -0,0 +1,169 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/thread_worker.h"
+#include "video_core/surface.h"
+#include "video_core/texture_cache/surface_base.h"
+#include "video_core/texture_cache/surface_params.h"
+#include "video_core/textures/bcn.h"
+
+namespace {
+
+using VideoCommon::SurfaceParams;
+using VideoCore::Surface::PixelFormat;
+using VideoCore::Surface::SurfaceTarget;
+using VideoCore::Surface::SurfaceType;
+
+class TestSurface final : public VideoCommon::SurfaceBaseImpl {
+public:
+    explicit TestSurface(const SurfaceParams& params, bool is_astc_supported = true)
+        : SurfaceBaseImpl{0, params, is_astc_supported, true} {}
+
+private:
+    void DecorateSurfaceName() override {}
+};
+
+SurfaceParams MakeParams(SurfaceTarget target, u32 width, u32 height, u32 depth, u32 num_levels) {
+    SurfaceParams params{};
+    params.is_tiled = true;
+    params.srgb_conversion = false;
+    params.is_layered = target != SurfaceTarget::Texture3D;
+    params.block_width = 0;
+    params.block_height = 4;
+    params.block_depth = target == SurfaceTarget::Texture3D ? 2 : 0;
+    params.tile_width_spacing = 1;
+    params.width = width;
+    params.height = height;
+    params.depth = depth;
+    params.pitch = 0;
+    params.num_levels = num_levels;
+    params.emulated_levels = num_levels;
+    params.pixel_format = PixelFormat::A8B8G8R8_UNORM;
+    params.type = SurfaceType::ColorTexture;
+    params.target = target;
+    return params;
+}
+
+std::vector<u8> MakeGuestData(const TestSurface& surface) {
+    std::vector<u8> data(surface.GetSizeInBytes());
+    std::mt19937 engine{1234};
+    std::uniform_int_distribution<u32> distribution{0, 0xFF};
+    for (u8& value : data) {
+        value = static_cast<u8>(distribution(engine));
+    }
+    return data;
+}
+
+const std::vector<SurfaceParams>& TestSurfaces() {
+    static const std::vector<SurfaceParams> surfaces{
+        MakeParams(SurfaceTarget::Texture2DArray, 1024, 1024, 8, 11),
+        MakeParams(SurfaceTarget::Texture3D, 256, 256, 64, 9),
+        MakeParams(SurfaceTarget::TextureCubemap, 512, 512, 6, 10),
+    };
+    return surfaces;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("TextureUpload[Parallel]", "[video_core]") {
+    Common::ThreadWorker workers{4, "TextureUploadTest"};
+    for (const SurfaceParams& params : TestSurfaces()) {
+        const TestSurface surface{params};
+        std::vector<u8> guest = MakeGuestData(surface);
+
+        std::vector<u8> serial(surface.GetHostSizeInBytes());
+        std::vector<u8> parallel(surface.GetHostSizeInBytes());
+        surface.DecodeGuestData(guest.data(), serial.data(), nullptr);
+        surface.DecodeGuestData(guest.data(), parallel.data(), &workers);
+        REQUIRE(serial == parallel);
+
+        // Swizzling back and decoding again has to produce the same host image
+        std::vector<u8> flushed(surface.GetSizeInBytes());
+        surface.EncodeGuestData(flushed.data(), parallel.data(), &workers);
+        std::vector<u8> reloaded(surface.GetHostSizeInBytes());
+        surface.DecodeGuestData(flushed.data(), reloaded.data(), nullptr);
+        REQUIRE(serial == reloaded);
+    }
+}
+
+TEST_CASE("TextureUpload[ASTCToBC3]", "[video_core]") {
+    // Hosts with BCn but without ASTC get ASTC surfaces transcoded to BC3 on upload
+    SurfaceParams params = MakeParams(SurfaceTarget::Texture2DArray, 64, 64, 2, 3);
+    params.pixel_format = PixelFormat::ASTC_2D_4X4_UNORM;
+    const TestSurface native{params};
+    const TestSurface converted{params, false};
+    REQUIRE(!native.IsConverted());
+    REQUIRE(converted.IsConverted());
+    REQUIRE(converted.GetHostFormat() == PixelFormat::BC3_UNORM);
+
+    // Void extent blocks of random colors, each block is swizzled as a whole
+    std::vector<u8> guest(native.GetSizeInBytes());
+    std::mt19937 engine{1234};
+    for (std::size_t offset = 0; offset + 16 <= guest.size(); offset += 16) {
+        std::fill_n(guest.begin() + offset, 10, u8{0xff});
+        guest[offset] = 0xfc;
+        guest[offset + 1] = 0xfd;
+        for (std::size_t i = 10; i < 16; ++i) {
+            guest[offset + i] = static_cast<u8>(engine());
+        }
+    }
+
+    std::vector<u8> astc(native.GetHostSizeInBytes());
+    native.DecodeGuestData(guest.data(), astc.data(), nullptr);
+    std::vector<u8> expected;
+    for (u32 level = 0; level < params.num_levels; ++level) {
+        const u32 width = params.GetMipWidth(level);
+        const u32 height = params.GetMipHeight(level);
+        const std::size_t level_offset =
+            params.GetHostMipmapLevelOffset(level, params.pixel_format);
+        for (u32 layer = 0; layer < params.depth; ++layer) {
+            const u8* const slice =
+                astc.data() + level_offset + layer * params.GetHostLayerSize(level);
+            std::vector<u8> bc3(
+                Tegra::Texture::BCn::CompressedSize(PixelFormat::BC3_UNORM, width, height, 1));
+            Tegra::Texture::BCn::TranscodeASTCToBC3(slice, width, height, 1, 4, 4, bc3.data());
+            expected.insert(expected.end(), bc3.begin(), bc3.end());
+        }
+    }
+    REQUIRE(converted.GetHostSizeInBytes() == expected.size());
+
+    std::vector<u8> host(converted.GetHostSizeInBytes());
+    converted.DecodeGuestData(guest.data(), host.data(), nullptr);
+    REQUIRE(host == expected);
+}
+
+TEST_CASE("TextureUpload[Benchmark]", "[.][Benchmark]") {
+    constexpr int iterations = 20;
+    Common::ThreadWorker workers{4, "TextureUploadBench"};
+    for (const SurfaceParams& params : TestSurfaces()) {
+        const TestSurface surface{params};
+        std::vector<u8> guest = MakeGuestData(surface);
+        std::vector<u8> host(surface.GetHostSizeInBytes());
+
+        const auto measure = [&](Common::ThreadWorker* pool) {
+            const auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; ++i) {
+                surface.DecodeGuestData(guest.data(), host.data(), pool);
+            }
+            const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+            const double bytes = static_cast<double>(surface.GetSizeInBytes()) * iterations;
+            return bytes / time.count() / (1024.0 * 1024.0);
+        };
+        const double serial_speed = measure(nullptr);
+        const double parallel_speed = measure(&workers);
+        std::printf("Target %u, %ux%ux%u, %u levels:\n", static_cast<u32>(params.target),
+                    params.width, params.height, params.depth, params.num_levels);
+        std::printf("  Serial: %.1f MiB/s\n", serial_speed);
+        std::printf("  Parallel (%zu workers): %.1f MiB/s\n", workers.NumWorkers(), parallel_speed);
+    }
+}
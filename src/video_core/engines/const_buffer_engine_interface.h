@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <memory>
 #include <type_traits>
 #include "common/bit_field.h"
 #include "common/common_types.h"
@@ -14,6 +15,8 @@
 
 namespace Tegra::Engines {
 
+class ConstBufferEngineSnapshot;
+
 struct SamplerDescriptor {
     union {
         u32 raw = 0;
@@ -98,6 +101,10 @@ public:
 
     virtual VideoCore::GuestDriverProfile& AccessGuestDriverProfile() = 0;
     virtual const VideoCore::GuestDriverProfile& AccessGuestDriverProfile() const = 0;
+
+    /// Copies the state required to decode a shader of the given stage, allowing the decoder to
+    /// run away from the GPU thread. Returns nullptr when the state is too large to be copied.
+    virtual std::unique_ptr<ConstBufferEngineSnapshot> CreateSnapshot(ShaderType stage) const = 0;
 };
 
 } // namespace Tegra::Engines
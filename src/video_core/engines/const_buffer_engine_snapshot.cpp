@@ -0,0 +1,95 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+
+#include "common/assert.h"
+#include "video_core/engines/const_buffer_engine_snapshot.h"
+#include "video_core/memory_manager.h"
+
+namespace Tegra::Engines {
+
+ConstBufferEngineSnapshot::ConstBufferEngineSnapshot(
+    ShaderType stage, std::vector<std::vector<u8>> const_buffers, u32 bound_buffer,
+    std::vector<Texture::TICEntry> tic, std::vector<Texture::TSCEntry> tsc,
+    const VideoCore::GuestDriverProfile& guest_driver_profile)
+    : stage{stage}, const_buffers{std::move(const_buffers)}, bound_buffer{bound_buffer},
+      tic{std::move(tic)}, tsc{std::move(tsc)}, guest_driver_profile{guest_driver_profile} {}
+
+ConstBufferEngineSnapshot::~ConstBufferEngineSnapshot() = default;
+
+std::unique_ptr<ConstBufferEngineSnapshot> ConstBufferEngineSnapshot::Create(
+    MemoryManager& memory_manager, ShaderType stage,
+    const std::vector<ConstBufferInfo>& const_buffer_infos, u32 bound_buffer,
+    GPUVAddr tic_address, u32 tic_limit, GPUVAddr tsc_address, u32 tsc_limit,
+    const VideoCore::GuestDriverProfile& guest_driver_profile) {
+    if (tic_limit >= MAX_DESCRIPTORS || tsc_limit >= MAX_DESCRIPTORS) {
+        return nullptr;
+    }
+
+    std::vector<std::vector<u8>> const_buffers(const_buffer_infos.size());
+    for (std::size_t index = 0; index < const_buffer_infos.size(); ++index) {
+        const ConstBufferInfo& info = const_buffer_infos[index];
+        if (!info.enabled || info.address == 0 || info.size == 0) {
+            continue;
+        }
+        std::vector<u8>& data = const_buffers[index];
+        data.resize(info.size);
+        memory_manager.ReadBlockUnsafe(info.address, data.data(), data.size());
+    }
+
+    std::vector<Texture::TICEntry> tic(tic_limit + 1);
+    memory_manager.ReadBlockUnsafe(tic_address, tic.data(), tic.size() * sizeof(Texture::TICEntry));
+    std::vector<Texture::TSCEntry> tsc(tsc_limit + 1);
+    memory_manager.ReadBlockUnsafe(tsc_address, tsc.data(), tsc.size() * sizeof(Texture::TSCEntry));
+
+    return std::make_unique<ConstBufferEngineSnapshot>(stage, std::move(const_buffers),
+                                                       bound_buffer, std::move(tic),
+                                                       std::move(tsc), guest_driver_profile);
+}
+
+u32 ConstBufferEngineSnapshot::AccessConstBuffer32(ShaderType stage_, u64 const_buffer,
+                                                   u64 offset) const {
+    ASSERT(stage_ == stage);
+    if (const_buffer >= const_buffers.size()) {
+        return 0;
+    }
+    const std::vector<u8>& data = const_buffers[const_buffer];
+    if (offset + sizeof(u32) > data.size()) {
+        return 0;
+    }
+    u32 result;
+    std::memcpy(&result, data.data() + offset, sizeof(u32));
+    return result;
+}
+
+SamplerDescriptor ConstBufferEngineSnapshot::AccessBoundSampler(ShaderType stage_,
+                                                                u64 offset) const {
+    return AccessBindlessSampler(stage_, bound_buffer, offset * sizeof(Texture::TextureHandle));
+}
+
+SamplerDescriptor ConstBufferEngineSnapshot::AccessBindlessSampler(ShaderType stage_,
+                                                                   u64 const_buffer,
+                                                                   u64 offset) const {
+    return AccessSampler(AccessConstBuffer32(stage_, const_buffer, offset));
+}
+
+SamplerDescriptor ConstBufferEngineSnapshot::AccessSampler(u32 handle) const {
+    const Texture::TextureHandle tex_handle{handle};
+    // Entries past the table limits are not valid descriptors, they are read as cleared ones
+    const Texture::TICEntry tic_entry =
+        tex_handle.tic_id < tic.size() ? tic[tex_handle.tic_id] : Texture::TICEntry{};
+    const Texture::TSCEntry tsc_entry =
+        tex_handle.tsc_id < tsc.size() ? tsc[tex_handle.tsc_id] : Texture::TSCEntry{};
+    SamplerDescriptor result = SamplerDescriptor::FromTIC(tic_entry);
+    result.is_shadow.Assign(tsc_entry.depth_compare_enabled.Value());
+    return result;
+}
+
+std::unique_ptr<ConstBufferEngineSnapshot> ConstBufferEngineSnapshot::CreateSnapshot(
+    ShaderType) const {
+    return std::make_unique<ConstBufferEngineSnapshot>(*this);
+}
+
+} // namespace Tegra::Engines
@@ -0,0 +1,85 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "common/common_types.h"
+#include "video_core/engines/const_buffer_engine_interface.h"
+#include "video_core/engines/const_buffer_info.h"
+#include "video_core/engines/shader_type.h"
+#include "video_core/guest_driver.h"
+#include "video_core/textures/texture.h"
+
+namespace Tegra {
+class MemoryManager;
+}
+
+namespace Tegra::Engines {
+
+/**
+ * Copy of the engine state that the shader decoder can query. It is taken on the GPU thread so a
+ * shader can be decoded on a worker thread while the engine keeps processing commands.
+ * Const buffers and the TIC and TSC tables are copied when the snapshot is taken, so bound,
+ * bindless and separate samplers are all read as they were at that time.
+ */
+class ConstBufferEngineSnapshot final : public ConstBufferEngineInterface {
+public:
+    /// Largest TIC or TSC table that is copied into a snapshot, in entries
+    static constexpr u32 MAX_DESCRIPTORS = 0x10000;
+
+    explicit ConstBufferEngineSnapshot(ShaderType stage,
+                                       std::vector<std::vector<u8>> const_buffers,
+                                       u32 bound_buffer, std::vector<Texture::TICEntry> tic,
+                                       std::vector<Texture::TSCEntry> tsc,
+                                       const VideoCore::GuestDriverProfile& guest_driver_profile);
+    ~ConstBufferEngineSnapshot() override;
+
+    /**
+     * Copies the given engine state from GPU memory.
+     * @param tic_limit Index of the last entry of the TIC table
+     * @param tsc_limit Index of the last entry of the TSC table
+     * @returns The snapshot, or nullptr when the tables are too large to be copied
+     */
+    static std::unique_ptr<ConstBufferEngineSnapshot> Create(
+        MemoryManager& memory_manager, ShaderType stage,
+        const std::vector<ConstBufferInfo>& const_buffer_infos, u32 bound_buffer,
+        GPUVAddr tic_address, u32 tic_limit, GPUVAddr tsc_address, u32 tsc_limit,
+        const VideoCore::GuestDriverProfile& guest_driver_profile);
+
+    u32 AccessConstBuffer32(ShaderType stage, u64 const_buffer, u64 offset) const override;
+
+    SamplerDescriptor AccessBoundSampler(ShaderType stage, u64 offset) const override;
+
+    SamplerDescriptor AccessBindlessSampler(ShaderType stage, u64 const_buffer,
+                                            u64 offset) const override;
+
+    SamplerDescriptor AccessSampler(u32 handle) const override;
+
+    u32 GetBoundBuffer() const override {
+        return bound_buffer;
+    }
+
+    VideoCore::GuestDriverProfile& AccessGuestDriverProfile() override {
+        return guest_driver_profile;
+    }
+
+    const VideoCore::GuestDriverProfile& AccessGuestDriverProfile() const override {
+        return guest_driver_profile;
+    }
+
+    std::unique_ptr<ConstBufferEngineSnapshot> CreateSnapshot(ShaderType stage) const override;
+
+private:
+    ShaderType stage;
+    std::vector<std::vector<u8>> const_buffers;
+    u32 bound_buffer = 0;
+    std::vector<Texture::TICEntry> tic;
+    std::vector<Texture::TSCEntry> tsc;
+    VideoCore::GuestDriverProfile guest_driver_profile;
+};
+
+} // namespace Tegra::Engines
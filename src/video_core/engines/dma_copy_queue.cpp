@@ -0,0 +1,32 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "video_core/engines/dma_copy_queue.h"
+
+namespace Tegra::Engines {
+
+DMACopyQueue::DMACopyQueue() : worker{1, "yuzu:DMACopy"} {}
+
+DMACopyQueue::~DMACopyQueue() {
+    WaitIdle();
+}
+
+u64 DMACopyQueue::Submit(std::function<void()> copy) {
+    const u64 tick = ++current_tick;
+    worker.QueueWork([this, tick, copy = std::move(copy)] {
+        copy();
+        completed_tick.store(tick, std::memory_order_release);
+    });
+    return tick;
+}
+
+void DMACopyQueue::Wait(u64 tick) {
+    if (IsComplete(tick)) {
+        return;
+    }
+    // The queue has a single worker, waiting for every request also waits for this one
+    worker.WaitForRequests();
+}
+
+} // namespace Tegra::Engines
@@ -0,0 +1,62 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+
+#include "common/common_types.h"
+#include "common/thread_worker.h"
+
+namespace Tegra::Engines {
+
+/**
+ * Runs DMA copies on a dedicated thread in submission order.
+ *
+ * Every submitted copy gets an increasing tick, so fences and other consumers can record the last
+ * copy they depend on and later check whether it has landed in memory. Copies are submitted and
+ * waited on from the GPU thread only.
+ */
+class DMACopyQueue final {
+public:
+    DMACopyQueue();
+    ~DMACopyQueue();
+
+    DMACopyQueue(const DMACopyQueue&) = delete;
+    DMACopyQueue& operator=(const DMACopyQueue&) = delete;
+
+    /// Queues a copy and returns its tick
+    u64 Submit(std::function<void()> copy);
+
+    /// Returns the tick of the last submitted copy, zero when nothing has been submitted
+    u64 CurrentTick() const {
+        return current_tick;
+    }
+
+    /// Returns true when the copy with the given tick and every copy before it have completed
+    bool IsComplete(u64 tick) const {
+        return completed_tick.load(std::memory_order_acquire) >= tick;
+    }
+
+    /// Returns true when no copy is running or queued
+    bool IsIdle() const {
+        return IsComplete(current_tick);
+    }
+
+    /// Blocks until the copy with the given tick has completed
+    void Wait(u64 tick);
+
+    /// Blocks until every submitted copy has completed
+    void WaitIdle() {
+        Wait(current_tick);
+    }
+
+private:
+    u64 current_tick = 0;
+    std::atomic<u64> completed_tick{0};
+    Common::ThreadWorker worker; ///< Declared last, its thread stops before the ticks go away
+};
+
+} // namespace Tegra::Engines
@@ -6,6 +6,7 @@
 #include "common/assert.h"
 #include "common/logging/log.h"
 #include "core/core.h"
+#include "video_core/engines/const_buffer_engine_snapshot.h"
 #include "video_core/engines/kepler_compute.h"
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/engines/shader_type.h"
@@ -112,6 +113,25 @@ const VideoCore::GuestDriverProfile& KeplerCompute::AccessGuestDriverProfile() c
     return rasterizer->AccessGuestDriverProfile();
 }
 
+std::unique_ptr<ConstBufferEngineSnapshot> KeplerCompute::CreateSnapshot(ShaderType stage) const {
+    ASSERT(stage == ShaderType::Compute);
+    std::vector<ConstBufferInfo> const_buffers(NumConstBuffers);
+    const std::bitset<NumConstBuffers> enable_mask{
+        launch_description.const_buffer_enable_mask.Value()};
+    for (std::size_t index = 0; index < NumConstBuffers; ++index) {
+        const auto& config = launch_description.const_buffer_config[index];
+        const_buffers[index] = {
+            .address = config.Address(),
+            .size = config.size.Value(),
+            .enabled = enable_mask[index],
+        };
+    }
+    return ConstBufferEngineSnapshot::Create(memory_manager, stage, const_buffers,
+                                             regs.tex_cb_index, regs.tic.Address(), regs.tic.limit,
+                                             regs.tsc.Address(), regs.tsc.limit,
+                                             AccessGuestDriverProfile());
+}
+
 void KeplerCompute::ProcessLaunch() {
     const GPUVAddr launch_desc_loc = regs.launch_desc_loc.Address();
     memory_manager.ReadBlockUnsafe(launch_desc_loc, &launch_description,
@@ -231,6 +231,8 @@ public:
 
     const VideoCore::GuestDriverProfile& AccessGuestDriverProfile() const override;
 
+    std::unique_ptr<ConstBufferEngineSnapshot> CreateSnapshot(ShaderType stage) const override;
+
 private:
     void ProcessLaunch();
 
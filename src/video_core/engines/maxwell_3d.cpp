@@ -8,6 +8,7 @@
 #include "common/assert.h"
 #include "core/core.h"
 #include "core/core_timing.h"
+#include "video_core/engines/const_buffer_engine_snapshot.h"
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/engines/shader_type.h"
 #include "video_core/gpu.h"
@@ -295,6 +296,29 @@ void Maxwell3D::CallMethod(u32 method, u32 method_argument, bool is_last_call) {
     }
 }
 
+bool Maxwell3D::AccessesMemory(u32 method) const {
+    // Macros may draw, and pending constant buffer data is written by the next method
+    if (method >= MacroRegistersStart || cb_data_state.current != null_cb_data) {
+        return true;
+    }
+    if (method >= MAXWELL3D_REG_INDEX(const_buffer.cb_data[0]) &&
+        method <= MAXWELL3D_REG_INDEX(const_buffer.cb_data[15])) {
+        return true;
+    }
+    switch (method) {
+    case MAXWELL3D_REG_INDEX(draw.vertex_end_gl):
+    case MAXWELL3D_REG_INDEX(clear_buffers):
+    case MAXWELL3D_REG_INDEX(query.query_get):
+    case MAXWELL3D_REG_INDEX(condition.mode):
+    case MAXWELL3D_REG_INDEX(exec_upload):
+    case MAXWELL3D_REG_INDEX(data_upload):
+        return true;
+    default:
+        // Sync points are ordered against the copies by the fence manager
+        return false;
+    }
+}
+
 void Maxwell3D::CallMultiMethod(u32 method, const u32* base_start, u32 amount,
                                 u32 methods_pending) {
     // Methods after 0xE00 are special, they're actually triggers for some microcode that was
@@ -764,4 +788,15 @@ const VideoCore::GuestDriverProfile& Maxwell3D::AccessGuestDriverProfile() const
     return rasterizer->AccessGuestDriverProfile();
 }
 
+std::unique_ptr<ConstBufferEngineSnapshot> Maxwell3D::CreateSnapshot(ShaderType stage) const {
+    ASSERT(stage != ShaderType::Compute);
+    const auto& shader_stage = state.shader_stages[static_cast<std::size_t>(stage)];
+    const std::vector<ConstBufferInfo> const_buffers(shader_stage.const_buffers.begin(),
+                                                     shader_stage.const_buffers.end());
+    return ConstBufferEngineSnapshot::Create(memory_manager, stage, const_buffers,
+                                             regs.tex_cb_index, regs.tic.TICAddress(),
+                                             regs.tic.tic_limit, regs.tsc.TSCAddress(),
+                                             regs.tsc.tsc_limit, AccessGuestDriverProfile());
+}
+
 } // namespace Tegra::Engines
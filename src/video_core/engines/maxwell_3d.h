@@ -1391,6 +1391,10 @@ public:
     /// Write the value to the register identified by method.
     void CallMethodFromMME(u32 method, u32 method_argument);
 
+    /// Returns true when writing the method may read or write guest memory, either directly or
+    /// through the rasterizer. Other methods only update registers.
+    bool AccessesMemory(u32 method) const;
+
     void FlushMMEInlineDraw();
 
     /// Given a texture handle, returns the TSC and TIC entries.
@@ -1416,6 +1420,8 @@ public:
 
     const VideoCore::GuestDriverProfile& AccessGuestDriverProfile() const override;
 
+    std::unique_ptr<ConstBufferEngineSnapshot> CreateSnapshot(ShaderType stage) const override;
+
     bool ShouldExecute() const {
         return execute_on;
     }
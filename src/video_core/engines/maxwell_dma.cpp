@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <cstring>
+
 #include "common/assert.h"
 #include "common/logging/log.h"
 #include "core/core.h"
@@ -19,6 +21,8 @@ using namespace Texture;
 MaxwellDMA::MaxwellDMA(Core::System& system, MemoryManager& memory_manager)
     : system{system}, memory_manager{memory_manager} {}
 
+MaxwellDMA::~MaxwellDMA() = default;
+
 void MaxwellDMA::CallMethod(u32 method, u32 method_argument, bool is_last_call) {
     ASSERT_MSG(method < NUM_REGS, "Invalid MaxwellDMA register");
 
@@ -36,6 +40,18 @@ void MaxwellDMA::CallMultiMethod(u32 method, const u32* base_start, u32 amount,
     }
 }
 
+void MaxwellDMA::WaitForCopies() {
+    if (pending_invalidations.empty()) {
+        return;
+    }
+    copy_queue.WaitIdle();
+    // The caches may have been filled from the destinations while the copies were running
+    for (const PendingInvalidation& range : pending_invalidations) {
+        memory_manager.InvalidateRegion(range.addr, range.size);
+    }
+    pending_invalidations.clear();
+}
+
 void MaxwellDMA::Launch() {
     LOG_TRACE(Render_OpenGL, "DMA copy 0x{:x} -> 0x{:x}", static_cast<GPUVAddr>(regs.offset_in),
               static_cast<GPUVAddr>(regs.offset_out));
@@ -61,52 +77,166 @@ void MaxwellDMA::Launch() {
     // All copies here update the main memory, so mark all rasterizer states as invalid.
     system.GPU().Maxwell3D().OnMemoryWrite();
 
+    // The rasterizer can only be accessed from the GPU thread, synchronize it before the copy is
+    // possibly deferred to the copy thread.
+    const CopySize copy_size = SynchronizeCaches(is_src_pitch, is_dst_pitch);
+
     if (is_src_pitch && is_dst_pitch) {
-        CopyPitchToPitch();
+        Submit(copy_size, &MaxwellDMA::CopyPitchToPitch);
     } else {
         ASSERT(launch.multi_line_enable == 1);
 
         if (!is_src_pitch && is_dst_pitch) {
-            CopyBlockLinearToPitch();
+            Submit(copy_size, &MaxwellDMA::CopyBlockLinearToPitch);
         } else {
-            CopyPitchToBlockLinear();
+            Submit(copy_size, &MaxwellDMA::CopyPitchToBlockLinear);
         }
     }
 }
 
-void MaxwellDMA::CopyPitchToPitch() {
+MaxwellDMA::CopySize MaxwellDMA::SynchronizeCaches(bool is_src_pitch, bool is_dst_pitch) {
+    std::size_t src_size;
+    std::size_t dst_size;
+    bool flush_src = true;
+    bool flush_dst = false;
+    if (is_src_pitch && is_dst_pitch) {
+        if (!regs.launch_dma.multi_line_enable || regs.line_count == 0) {
+            src_size = regs.line_length_in;
+            dst_size = regs.line_length_in;
+        } else {
+            const std::size_t last_line = regs.line_count - 1;
+            src_size = last_line * regs.pitch_in + regs.line_length_in;
+            dst_size = last_line * regs.pitch_out + regs.line_length_in;
+        }
+    } else if (is_dst_pitch) {
+        const Parameters& src_params = regs.src_params;
+        const u32 bytes_per_pixel = regs.pitch_out / regs.line_length_in;
+        src_size = CalculateSize(true, bytes_per_pixel, src_params.width, src_params.height,
+                                 src_params.depth, src_params.block_size.height,
+                                 src_params.block_size.depth);
+        dst_size = static_cast<size_t>(regs.pitch_out) * regs.line_count;
+        // Micro copies only read the destination when the GPU accuracy is extreme
+        const bool is_micro_copy = dst_size < GOB_SIZE && regs.pitch_out <= GOB_SIZE_X;
+        flush_src = !is_micro_copy || Settings::IsGPULevelExtreme();
+        flush_dst = flush_src;
+    } else {
+        const Parameters& dst_params = regs.dst_params;
+        const u32 bytes_per_pixel = regs.pitch_in / regs.line_length_in;
+        src_size = static_cast<size_t>(regs.pitch_in) * regs.line_count;
+        dst_size = CalculateSize(true, bytes_per_pixel, dst_params.width, dst_params.height,
+                                 dst_params.depth, dst_params.block_size.height,
+                                 dst_params.block_size.depth);
+        flush_src = Settings::IsGPULevelExtreme();
+        flush_dst = flush_src;
+    }
+
+    if (flush_src) {
+        memory_manager.FlushRegion(regs.offset_in, src_size);
+    }
+    if (flush_dst) {
+        memory_manager.FlushRegion(regs.offset_out, dst_size);
+    }
+    return {.src = src_size, .dst = dst_size};
+}
+
+void MaxwellDMA::Submit(const CopySize& size, CopyFunction copy) {
+    const bool is_large = size.src + size.dst >= ASYNC_COPY_THRESHOLD;
+    if (!system.GPU().IsAsync() || (copy_queue.IsIdle() && !is_large)) {
+        (this->*copy)(regs);
+        memory_manager.InvalidateRegion(regs.offset_out, size.dst);
+        return;
+    }
+    // Drop the cached destination now so it is not written back over the copy while it runs,
+    // WaitForCopies invalidates it again once the copy has landed.
+    memory_manager.InvalidateRegion(regs.offset_out, size.dst);
+    pending_invalidations.push_back({.addr = regs.offset_out, .size = size.dst});
+    copy_queue.Submit([this, copy, copy_regs = std::make_shared<const Regs>(regs)] {
+        (this->*copy)(*copy_regs);
+    });
+}
+
+void MaxwellDMA::CopyLinear(GPUVAddr dest_addr, GPUVAddr src_addr, std::size_t size) {
+    u8* const dest = memory_manager.GetContiguousPointer(dest_addr, size);
+    const u8* const src = memory_manager.GetContiguousPointer(src_addr, size);
+    if (dest && src) {
+        std::memmove(dest, src, size);
+        return;
+    }
+    const bool overlaps = dest_addr < src_addr + size && src_addr < dest_addr + size;
+    if (src && !overlaps) {
+        memory_manager.WriteBlockUnsafe(dest_addr, src, size);
+        return;
+    }
+    if (dest && !overlaps) {
+        memory_manager.ReadBlockUnsafe(src_addr, dest, size);
+        return;
+    }
+    if (read_buffer.size() < size) {
+        read_buffer.resize(size);
+    }
+    memory_manager.ReadBlockUnsafe(src_addr, read_buffer.data(), size);
+    memory_manager.WriteBlockUnsafe(dest_addr, read_buffer.data(), size);
+}
+
+const u8* MaxwellDMA::ReadSource(GPUVAddr gpu_addr, std::size_t size) {
+    if (const u8* const src = memory_manager.GetContiguousPointer(gpu_addr, size)) {
+        return src;
+    }
+    if (read_buffer.size() < size) {
+        read_buffer.resize(size);
+    }
+    memory_manager.ReadBlockUnsafe(gpu_addr, read_buffer.data(), size);
+    return read_buffer.data();
+}
+
+template <typename Func>
+void MaxwellDMA::ModifyDestination(GPUVAddr gpu_addr, std::size_t size, Func&& func) {
+    if (u8* const dest = memory_manager.GetContiguousPointer(gpu_addr, size)) {
+        func(dest);
+        return;
+    }
+    if (write_buffer.size() < size) {
+        write_buffer.resize(size);
+    }
+    memory_manager.ReadBlockUnsafe(gpu_addr, write_buffer.data(), size);
+    func(write_buffer.data());
+    memory_manager.WriteBlockUnsafe(gpu_addr, write_buffer.data(), size);
+}
+
+void MaxwellDMA::CopyPitchToPitch(const Regs& copy_regs) {
     // When `multi_line_enable` bit is disabled the copy is performed as if we were copying a 1D
     // buffer of length `line_length_in`.
     // Otherwise we copy a 2D image of dimensions (line_length_in, line_count).
-    if (!regs.launch_dma.multi_line_enable) {
-        memory_manager.CopyBlock(regs.offset_out, regs.offset_in, regs.line_length_in);
+    if (!copy_regs.launch_dma.multi_line_enable) {
+        CopyLinear(copy_regs.offset_out, copy_regs.offset_in, copy_regs.line_length_in);
         return;
     }
 
     // Perform a line-by-line copy.
     // We're going to take a subrect of size (line_length_in, line_count) from the source rectangle.
-    // There is no need to manually flush/invalidate the regions because CopyBlock does that for us.
-    for (u32 line = 0; line < regs.line_count; ++line) {
-        const GPUVAddr source_line = regs.offset_in + static_cast<size_t>(line) * regs.pitch_in;
-        const GPUVAddr dest_line = regs.offset_out + static_cast<size_t>(line) * regs.pitch_out;
-        memory_manager.CopyBlock(dest_line, source_line, regs.line_length_in);
+    for (u32 line = 0; line < copy_regs.line_count; ++line) {
+        const GPUVAddr source_line =
+            copy_regs.offset_in + static_cast<size_t>(line) * copy_regs.pitch_in;
+        const GPUVAddr dest_line =
+            copy_regs.offset_out + static_cast<size_t>(line) * copy_regs.pitch_out;
+        CopyLinear(dest_line, source_line, copy_regs.line_length_in);
     }
 }
 
-void MaxwellDMA::CopyBlockLinearToPitch() {
-    UNIMPLEMENTED_IF(regs.src_params.block_size.depth != 0);
-    UNIMPLEMENTED_IF(regs.src_params.layer != 0);
+void MaxwellDMA::CopyBlockLinearToPitch(const Regs& copy_regs) {
+    UNIMPLEMENTED_IF(copy_regs.src_params.block_size.depth != 0);
+    UNIMPLEMENTED_IF(copy_regs.src_params.layer != 0);
 
     // Optimized path for micro copies.
-    const size_t dst_size = static_cast<size_t>(regs.pitch_out) * regs.line_count;
-    if (dst_size < GOB_SIZE && regs.pitch_out <= GOB_SIZE_X) {
-        FastCopyBlockLinearToPitch();
+    const size_t dst_size = static_cast<size_t>(copy_regs.pitch_out) * copy_regs.line_count;
+    if (dst_size < GOB_SIZE && copy_regs.pitch_out <= GOB_SIZE_X) {
+        FastCopyBlockLinearToPitch(copy_regs);
         return;
     }
 
     // Deswizzle the input and copy it over.
-    const u32 bytes_per_pixel = regs.pitch_out / regs.line_length_in;
-    const Parameters& src_params = regs.src_params;
+    const u32 bytes_per_pixel = copy_regs.pitch_out / copy_regs.line_length_in;
+    const Parameters& src_params = copy_regs.src_params;
     const u32 width = src_params.width;
     const u32 height = src_params.height;
     const u32 depth = src_params.depth;
@@ -114,29 +244,18 @@ void MaxwellDMA::CopyBlockLinearToPitch() {
     const u32 block_depth = src_params.block_size.depth;
     const size_t src_size =
         CalculateSize(true, bytes_per_pixel, width, height, depth, block_height, block_depth);
-    const size_t src_layer_size =
-        CalculateSize(true, bytes_per_pixel, width, height, 1, block_height, block_depth);
-
-    if (read_buffer.size() < src_size) {
-        read_buffer.resize(src_size);
-    }
-    if (write_buffer.size() < dst_size) {
-        write_buffer.resize(dst_size);
-    }
 
-    memory_manager.ReadBlock(regs.offset_in, read_buffer.data(), src_size);
-    memory_manager.ReadBlock(regs.offset_out, write_buffer.data(), dst_size);
-
-    UnswizzleSubrect(regs.line_length_in, regs.line_count, regs.pitch_out, width, bytes_per_pixel,
-                     block_height, src_params.origin.x, src_params.origin.y, write_buffer.data(),
-                     read_buffer.data());
-
-    memory_manager.WriteBlock(regs.offset_out, write_buffer.data(), dst_size);
+    const u8* const src = ReadSource(copy_regs.offset_in, src_size);
+    ModifyDestination(copy_regs.offset_out, dst_size, [&](u8* dst) {
+        UnswizzleSubrect(copy_regs.line_length_in, copy_regs.line_count, copy_regs.pitch_out,
+                         width, bytes_per_pixel, block_height, src_params.origin.x,
+                         src_params.origin.y, dst, src);
+    });
 }
 
-void MaxwellDMA::CopyPitchToBlockLinear() {
-    const auto& dst_params = regs.dst_params;
-    const u32 bytes_per_pixel = regs.pitch_in / regs.line_length_in;
+void MaxwellDMA::CopyPitchToBlockLinear(const Regs& copy_regs) {
+    const auto& dst_params = copy_regs.dst_params;
+    const u32 bytes_per_pixel = copy_regs.pitch_in / copy_regs.line_length_in;
     const u32 width = dst_params.width;
     const u32 height = dst_params.height;
     const u32 depth = dst_params.depth;
@@ -147,70 +266,43 @@ void MaxwellDMA::CopyPitchToBlockLinear() {
     const size_t dst_layer_size =
         CalculateSize(true, bytes_per_pixel, width, height, 1, block_height, block_depth);
 
-    const size_t src_size = static_cast<size_t>(regs.pitch_in) * regs.line_count;
-
-    if (read_buffer.size() < src_size) {
-        read_buffer.resize(src_size);
-    }
-    if (write_buffer.size() < dst_size) {
-        write_buffer.resize(dst_size);
-    }
-
-    if (Settings::IsGPULevelExtreme()) {
-        memory_manager.ReadBlock(regs.offset_in, read_buffer.data(), src_size);
-        memory_manager.ReadBlock(regs.offset_out, write_buffer.data(), dst_size);
-    } else {
-        memory_manager.ReadBlockUnsafe(regs.offset_in, read_buffer.data(), src_size);
-        memory_manager.ReadBlockUnsafe(regs.offset_out, write_buffer.data(), dst_size);
-    }
-
-    // If the input is linear and the output is tiled, swizzle the input and copy it over.
-    if (regs.dst_params.block_size.depth > 0) {
-        ASSERT(dst_params.layer == 0);
-        SwizzleSliceToVoxel(regs.line_length_in, regs.line_count, regs.pitch_in, width, height,
-                            bytes_per_pixel, block_height, block_depth, dst_params.origin.x,
-                            dst_params.origin.y, write_buffer.data(), read_buffer.data());
-    } else {
-        SwizzleSubrect(regs.line_length_in, regs.line_count, regs.pitch_in, width, bytes_per_pixel,
-                       write_buffer.data() + dst_layer_size * dst_params.layer, read_buffer.data(),
-                       block_height, dst_params.origin.x, dst_params.origin.y);
-    }
+    const size_t src_size = static_cast<size_t>(copy_regs.pitch_in) * copy_regs.line_count;
 
-    memory_manager.WriteBlock(regs.offset_out, write_buffer.data(), dst_size);
+    const u8* const src = ReadSource(copy_regs.offset_in, src_size);
+    ModifyDestination(copy_regs.offset_out, dst_size, [&](u8* dst) {
+        // If the input is linear and the output is tiled, swizzle the input and copy it over.
+        if (dst_params.block_size.depth > 0) {
+            ASSERT(dst_params.layer == 0);
+            SwizzleSliceToVoxel(copy_regs.line_length_in, copy_regs.line_count, copy_regs.pitch_in,
+                                width, height, bytes_per_pixel, block_height, block_depth,
+                                dst_params.origin.x, dst_params.origin.y, dst, src);
+        } else {
+            SwizzleSubrect(copy_regs.line_length_in, copy_regs.line_count, copy_regs.pitch_in,
+                           width, bytes_per_pixel, dst + dst_layer_size * dst_params.layer, src,
+                           block_height, dst_params.origin.x, dst_params.origin.y);
+        }
+    });
 }
 
-void MaxwellDMA::FastCopyBlockLinearToPitch() {
-    const u32 bytes_per_pixel = regs.pitch_out / regs.line_length_in;
+void MaxwellDMA::FastCopyBlockLinearToPitch(const Regs& copy_regs) {
+    const u32 bytes_per_pixel = copy_regs.pitch_out / copy_regs.line_length_in;
     const size_t src_size = GOB_SIZE;
-    const size_t dst_size = static_cast<size_t>(regs.pitch_out) * regs.line_count;
-    u32 pos_x = regs.src_params.origin.x;
-    u32 pos_y = regs.src_params.origin.y;
-    const u64 offset = GetGOBOffset(regs.src_params.width, regs.src_params.height, pos_x, pos_y,
-                                    regs.src_params.block_size.height, bytes_per_pixel);
+    const size_t dst_size = static_cast<size_t>(copy_regs.pitch_out) * copy_regs.line_count;
+    u32 pos_x = copy_regs.src_params.origin.x;
+    u32 pos_y = copy_regs.src_params.origin.y;
+    const u64 offset =
+        GetGOBOffset(copy_regs.src_params.width, copy_regs.src_params.height, pos_x, pos_y,
+                     copy_regs.src_params.block_size.height, bytes_per_pixel);
     const u32 x_in_gob = 64 / bytes_per_pixel;
     pos_x = pos_x % x_in_gob;
     pos_y = pos_y % 8;
 
-    if (read_buffer.size() < src_size) {
-        read_buffer.resize(src_size);
-    }
-    if (write_buffer.size() < dst_size) {
-        write_buffer.resize(dst_size);
-    }
-
-    if (Settings::IsGPULevelExtreme()) {
-        memory_manager.ReadBlock(regs.offset_in + offset, read_buffer.data(), src_size);
-        memory_manager.ReadBlock(regs.offset_out, write_buffer.data(), dst_size);
-    } else {
-        memory_manager.ReadBlockUnsafe(regs.offset_in + offset, read_buffer.data(), src_size);
-        memory_manager.ReadBlockUnsafe(regs.offset_out, write_buffer.data(), dst_size);
-    }
-
-    UnswizzleSubrect(regs.line_length_in, regs.line_count, regs.pitch_out, regs.src_params.width,
-                     bytes_per_pixel, regs.src_params.block_size.height, pos_x, pos_y,
-                     write_buffer.data(), read_buffer.data());
-
-    memory_manager.WriteBlock(regs.offset_out, write_buffer.data(), dst_size);
+    const u8* const src = ReadSource(copy_regs.offset_in + offset, src_size);
+    ModifyDestination(copy_regs.offset_out, dst_size, [&](u8* dst) {
+        UnswizzleSubrect(copy_regs.line_length_in, copy_regs.line_count, copy_regs.pitch_out,
+                         copy_regs.src_params.width, bytes_per_pixel,
+                         copy_regs.src_params.block_size.height, pos_x, pos_y, dst, src);
+    });
 }
 
 } // namespace Tegra::Engines
@@ -6,10 +6,12 @@
 
 #include <array>
 #include <cstddef>
+#include <memory>
 #include <vector>
 #include "common/bit_field.h"
 #include "common/common_funcs.h"
 #include "common/common_types.h"
+#include "video_core/engines/dma_copy_queue.h"
 #include "video_core/engines/engine_interface.h"
 #include "video_core/gpu.h"
 
@@ -186,7 +188,7 @@ public:
     static_assert(sizeof(RemapConst) == 12);
 
     explicit MaxwellDMA(Core::System& system, MemoryManager& memory_manager);
-    ~MaxwellDMA() = default;
+    ~MaxwellDMA();
 
     /// Write the value to the register identified by method.
     void CallMethod(u32 method, u32 method_argument, bool is_last_call) override;
@@ -195,18 +197,54 @@ public:
     void CallMultiMethod(u32 method, const u32* base_start, u32 amount,
                          u32 methods_pending) override;
 
+    /// Blocks until all the copies queued on the copy thread have been written to memory and
+    /// invalidates the host caches overlapping their destinations.
+    void WaitForCopies();
+
+    /// Returns the tick of the last copy launched, fences signalled after it have to wait for it.
+    u64 CurrentCopyTick() const {
+        return copy_queue.CurrentTick();
+    }
+
+    /// Returns true when the copy with the given tick has been written to memory.
+    bool IsCopyComplete(u64 tick) const {
+        return copy_queue.IsComplete(tick);
+    }
+
 private:
+    /// Copies reading or writing at least this many bytes are executed on the copy thread.
+    static constexpr std::size_t ASYNC_COPY_THRESHOLD = 1024 * 1024;
+
+    /// Guest memory ranges accessed by a copy.
+    struct CopySize {
+        std::size_t src;
+        std::size_t dst;
+    };
+
+    /// Destination of a deferred copy, invalidated in the host caches once the copy completed.
+    struct PendingInvalidation {
+        GPUVAddr addr;
+        std::size_t size;
+    };
+
     /// Performs the copy from the source buffer to the destination buffer as configured in the
     /// registers.
     void Launch();
 
-    void CopyPitchToPitch();
+    /// Flushes the host caches overlapping the copy described by the registers.
+    CopySize SynchronizeCaches(bool is_src_pitch, bool is_dst_pitch);
 
-    void CopyBlockLinearToPitch();
+    /// Copies a linear range of GPU memory, without going through the rasterizer caches.
+    void CopyLinear(GPUVAddr dest_addr, GPUVAddr src_addr, std::size_t size);
 
-    void CopyPitchToBlockLinear();
+    /// Returns a pointer to a source range, it is read into read_buffer when it is not
+    /// contiguous in host memory.
+    const u8* ReadSource(GPUVAddr gpu_addr, std::size_t size);
 
-    void FastCopyBlockLinearToPitch();
+    /// Calls func with a pointer to a destination range, which is directly guest memory when it
+    /// is contiguous in host memory.
+    template <typename Func>
+    void ModifyDestination(GPUVAddr gpu_addr, std::size_t size, Func&& func);
 
     Core::System& system;
 
@@ -215,6 +253,9 @@ private:
     std::vector<u8> read_buffer;
     std::vector<u8> write_buffer;
 
+    std::vector<PendingInvalidation> pending_invalidations;
+    DMACopyQueue copy_queue;
+
     static constexpr std::size_t NUM_REGS = 0x800;
     struct Regs {
         union {
@@ -267,6 +308,22 @@ private:
     ASSERT_REG_POSITION(src_params, 0x1CA);
 
 #undef ASSERT_REG_POSITION
+
+private:
+    using CopyFunction = void (MaxwellDMA::*)(const Regs&);
+
+    /// Executes a copy on the GPU thread, or on the copy thread when it is large or other copies
+    /// are still in flight, so copies always land in order. The GPU thread never defers copies
+    /// when the GPU is synchronous.
+    void Submit(const CopySize& size, CopyFunction copy);
+
+    void CopyPitchToPitch(const Regs& copy_regs);
+
+    void CopyBlockLinearToPitch(const Regs& copy_regs);
+
+    void CopyPitchToBlockLinear(const Regs& copy_regs);
+
+    void FastCopyBlockLinearToPitch(const Regs& copy_regs);
 };
 
 } // namespace Tegra::Engines
@@ -9,6 +9,7 @@
 
 #include "common/common_types.h"
 #include "core/core.h"
+#include "video_core/engines/maxwell_dma.h"
 #include "video_core/gpu.h"
 #include "video_core/memory_manager.h"
 #include "video_core/rasterizer_interface.h"
@@ -35,10 +36,20 @@ public:
         return is_semaphore;
     }
 
+    /// Returns the tick of the last DMA copy launched before the fence was signalled.
+    u64 GetCopyTick() const {
+        return copy_tick;
+    }
+
+    void SetCopyTick(u64 tick) {
+        copy_tick = tick;
+    }
+
 private:
     GPUVAddr address;
     u32 payload;
     bool is_semaphore;
+    u64 copy_tick{};
 
 protected:
     bool is_stubbed;
@@ -52,6 +63,7 @@ public:
         const bool should_flush = ShouldFlush();
         CommitAsyncFlushes();
         TFence new_fence = CreateFence(addr, value, !should_flush);
+        new_fence->SetCopyTick(system.GPU().MaxwellDMA().CurrentCopyTick());
         fences.push(new_fence);
         QueueFence(new_fence);
         if (should_flush) {
@@ -65,6 +77,7 @@ public:
         const bool should_flush = ShouldFlush();
         CommitAsyncFlushes();
         TFence new_fence = CreateFence(value, !should_flush);
+        new_fence->SetCopyTick(system.GPU().MaxwellDMA().CurrentCopyTick());
         fences.push(new_fence);
         QueueFence(new_fence);
         if (should_flush) {
@@ -81,6 +94,9 @@ public:
             if (ShouldWait()) {
                 WaitFence(current_fence);
             }
+            if (!gpu.MaxwellDMA().IsCopyComplete(current_fence->GetCopyTick())) {
+                gpu.MaxwellDMA().WaitForCopies();
+            }
             PopAsyncFlushes();
             if (current_fence->IsSemaphore()) {
                 memory_manager.template Write<u32>(current_fence->GetAddress(),
@@ -128,6 +144,10 @@ private:
             if (ShouldWait() && !IsFenceSignaled(current_fence)) {
                 return;
             }
+            // The guest may read what the DMA copies before the fence wrote
+            if (!gpu.MaxwellDMA().IsCopyComplete(current_fence->GetCopyTick())) {
+                return;
+            }
             PopAsyncFlushes();
             if (current_fence->IsSemaphore()) {
                 memory_manager.template Write<u32>(current_fence->GetAddress(),
@@ -19,8 +19,10 @@
 #include "video_core/engines/maxwell_dma.h"
 #include "video_core/gpu.h"
 #include "video_core/memory_manager.h"
+#include "video_core/query_cache_stats.h"
 #include "video_core/renderer_base.h"
 #include "video_core/shader_notify.h"
+#include "video_core/texture_cache/texture_cache_stats.h"
 #include "video_core/video_core.h"
 
 namespace Tegra {
@@ -35,7 +37,9 @@ GPU::GPU(Core::System& system_, bool is_async_)
       kepler_compute{std::make_unique<Engines::KeplerCompute>(system, *memory_manager)},
       maxwell_dma{std::make_unique<Engines::MaxwellDMA>(system, *memory_manager)},
       kepler_memory{std::make_unique<Engines::KeplerMemory>(system, *memory_manager)},
-      shader_notify{std::make_unique<VideoCore::ShaderNotify>()}, is_async{is_async_} {}
+      shader_notify{std::make_unique<VideoCore::ShaderNotify>()},
+      query_cache_stats{std::make_unique<VideoCommon::QueryCacheStats>()},
+      texture_cache_stats{std::make_unique<VideoCommon::TextureCacheStats>()}, is_async{is_async_} {}
 
 GPU::~GPU() = default;
 
@@ -65,6 +69,10 @@ const Engines::KeplerCompute& GPU::KeplerCompute() const {
     return *kepler_compute;
 }
 
+Engines::MaxwellDMA& GPU::MaxwellDMA() {
+    return *maxwell_dma;
+}
+
 MemoryManager& GPU::MemoryManager() {
     return *memory_manager;
 }
@@ -246,6 +254,19 @@ void GPU::CallMultiMethod(u32 method, u32 subchannel, const u32* base_start, u32
     }
 }
 
+bool GPU::MethodAccessesMemory(EngineID engine, u32 method) const {
+    switch (engine) {
+    case EngineID::MAXWELL_B:
+        return maxwell_3d->AccessesMemory(method);
+    case EngineID::MAXWELL_DMA_COPY_A:
+        // DMA copies are ordered by the copy queue
+        return false;
+    default:
+        // The remaining engines receive few methods, don't bother filtering them
+        return true;
+    }
+}
+
 bool GPU::ExecuteMethodOnEngine(u32 method) {
     const auto buffer_method = static_cast<BufferMethods>(method);
     return buffer_method >= BufferMethods::NonPullerMethods;
@@ -271,6 +292,8 @@ void GPU::CallPullerMethod(const MethodCall& method_call) {
     case BufferMethods::FenceAction:
         break;
     case BufferMethods::SemaphoreTrigger: {
+        // Semaphores access memory and signal the guest, pending copies must have landed
+        maxwell_dma->WaitForCopies();
         ProcessSemaphoreTriggerMethod();
         break;
     }
@@ -285,10 +308,12 @@ void GPU::CallPullerMethod(const MethodCall& method_call) {
         break;
     }
     case BufferMethods::SemaphoreAcquire: {
+        maxwell_dma->WaitForCopies();
         ProcessSemaphoreAcquire();
         break;
     }
     case BufferMethods::SemaphoreRelease: {
+        maxwell_dma->WaitForCopies();
         ProcessSemaphoreRelease();
         break;
     }
@@ -306,6 +331,9 @@ void GPU::CallPullerMethod(const MethodCall& method_call) {
 
 void GPU::CallEngineMethod(const MethodCall& method_call) {
     const EngineID engine = bound_engines[method_call.subchannel];
+    if (MethodAccessesMemory(engine, method_call.method)) {
+        maxwell_dma->WaitForCopies();
+    }
 
     switch (engine) {
     case EngineID::FERMI_TWOD_A:
@@ -333,6 +361,9 @@ void GPU::CallEngineMethod(const MethodCall& method_call) {
 void GPU::CallEngineMultiMethod(u32 method, u32 subchannel, const u32* base_start, u32 amount,
                                 u32 methods_pending) {
     const EngineID engine = bound_engines[subchannel];
+    if (MethodAccessesMemory(engine, method)) {
+        maxwell_dma->WaitForCopies();
+    }
 
     switch (engine) {
     case EngineID::FERMI_TWOD_A:
@@ -36,6 +36,11 @@ class RendererBase;
 class ShaderNotify;
 } // namespace VideoCore
 
+namespace VideoCommon {
+class QueryCacheStats;
+class TextureCacheStats;
+}
+
 namespace Tegra {
 
 enum class RenderTargetFormat : u32 {
@@ -200,6 +205,9 @@ public:
     /// Returns a reference to the KeplerCompute GPU engine.
     const Engines::KeplerCompute& KeplerCompute() const;
 
+    /// Returns a reference to the MaxwellDMA GPU engine.
+    Engines::MaxwellDMA& MaxwellDMA();
+
     /// Returns a reference to the GPU memory manager.
     Tegra::MemoryManager& MemoryManager();
 
@@ -225,6 +233,22 @@ public:
         return *shader_notify;
     }
 
+    VideoCommon::QueryCacheStats& QueryCacheStats() {
+        return *query_cache_stats;
+    }
+
+    const VideoCommon::QueryCacheStats& QueryCacheStats() const {
+        return *query_cache_stats;
+    }
+
+    VideoCommon::TextureCacheStats& TextureCacheStats() {
+        return *texture_cache_stats;
+    }
+
+    const VideoCommon::TextureCacheStats& TextureCacheStats() const {
+        return *texture_cache_stats;
+    }
+
     // Waits for the GPU to finish working
     virtual void WaitIdle() const = 0;
 
@@ -342,6 +366,9 @@ private:
     void CallEngineMultiMethod(u32 method, u32 subchannel, const u32* base_start, u32 amount,
                                u32 methods_pending);
 
+    /// Returns true when the engine method may access memory still being written by DMA copies.
+    bool MethodAccessesMemory(EngineID engine, u32 method) const;
+
     /// Determines where the method should be executed.
     bool ExecuteMethodOnEngine(u32 method);
 
@@ -367,6 +394,10 @@ private:
     std::unique_ptr<Engines::KeplerMemory> kepler_memory;
     /// Shader build notifier
     std::unique_ptr<VideoCore::ShaderNotify> shader_notify;
+    /// Query cache per-frame resolution and stall counters
+    std::unique_ptr<VideoCommon::QueryCacheStats> query_cache_stats;
+    /// Texture cache size and hit rate counters
+    std::unique_ptr<VideoCommon::TextureCacheStats> texture_cache_stats;
 
     std::array<std::atomic<u32>, Service::Nvidia::MaxSyncPoints> syncpoints{};
 
@@ -9,6 +9,7 @@
 #include "core/frontend/emu_window.h"
 #include "core/settings.h"
 #include "video_core/dma_pusher.h"
+#include "video_core/engines/maxwell_dma.h"
 #include "video_core/gpu.h"
 #include "video_core/gpu_thread.h"
 #include "video_core/renderer_base.h"
@@ -43,6 +44,8 @@ static void RunThread(Core::System& system, VideoCore::RendererBase& renderer,
             dma_pusher.Push(std::move(submit_list->entries));
             dma_pusher.DispatchCalls();
         } else if (const auto data = std::get_if<SwapBuffersCommand>(&next.data)) {
+            // The framebuffer may have been written by a DMA copy
+            system.GPU().MaxwellDMA().WaitForCopies();
             renderer.SwapBuffers(data->framebuffer ? &*data->framebuffer : nullptr);
         } else if (std::holds_alternative<OnCommandListEndCommand>(next.data)) {
             renderer.Rasterizer().ReleaseFences();
@@ -2,6 +2,10 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
 #include "common/alignment.h"
 #include "common/assert.h"
 #include "core/core.h"
@@ -15,7 +19,7 @@
 namespace Tegra {
 
 MemoryManager::MemoryManager(Core::System& system_)
-    : system{system_}, page_table(page_table_size) {}
+    : system{system_}, page_directory(directory_size) {}
 
 MemoryManager::~MemoryManager() = default;
 
@@ -50,7 +54,12 @@ void MemoryManager::Unmap(GPUVAddr gpu_addr, std::size_t size) {
     }
 
     // Flush and invalidate through the GPU interface, to be asynchronous if possible.
-    system.GPU().FlushAndInvalidateRegion(*GpuToCpuAddress(gpu_addr), size);
+    WalkBlock(
+        gpu_addr, size,
+        [this](VAddr cpu_addr, std::size_t, std::size_t run_size) {
+            system.GPU().FlushAndInvalidateRegion(cpu_addr, run_size);
+        },
+        [](std::size_t, std::size_t) {});
 
     UpdateRange(gpu_addr, PageEntry::State::Unmapped, size);
 }
@@ -92,7 +101,12 @@ void MemoryManager::TryUnlockPage(PageEntry page_entry, std::size_t size) {
 }
 
 PageEntry MemoryManager::GetPageEntry(GPUVAddr gpu_addr) const {
-    return page_table[PageEntryIndex(gpu_addr)];
+    const std::size_t page_index{PageEntryIndex(gpu_addr)};
+    const auto& leaf{page_directory[page_index >> leaf_bits]};
+    if (!leaf) {
+        return PageEntry::State::Unmapped;
+    }
+    return leaf->entries[page_index & leaf_mask];
 }
 
 void MemoryManager::SetPageEntry(GPUVAddr gpu_addr, PageEntry page_entry, std::size_t size) {
@@ -105,7 +119,23 @@ void MemoryManager::SetPageEntry(GPUVAddr gpu_addr, PageEntry page_entry, std::s
     //// Lock the new page
     // TryLockPage(page_entry, size);
 
-    page_table[PageEntryIndex(gpu_addr)] = page_entry;
+    const std::size_t page_index{PageEntryIndex(gpu_addr)};
+    auto& leaf{page_directory[page_index >> leaf_bits]};
+    if (!leaf) {
+        if (page_entry.IsUnmapped()) {
+            return;
+        }
+        leaf = std::make_unique<PageTableLeaf>();
+    }
+    PageEntry& entry{leaf->entries[page_index & leaf_mask]};
+    if (entry.IsUnmapped() != page_entry.IsUnmapped()) {
+        if (page_entry.IsUnmapped()) {
+            --leaf->num_used;
+        } else {
+            ++leaf->num_used;
+        }
+    }
+    entry = page_entry;
 }
 
 std::optional<GPUVAddr> MemoryManager::FindFreeRange(std::size_t size, std::size_t align) const {
@@ -118,20 +148,30 @@ std::optional<GPUVAddr> MemoryManager::FindFreeRange(std::size_t size, std::size
     u64 available_size{};
     GPUVAddr gpu_addr{address_space_start};
     while (gpu_addr + available_size < address_space_size) {
-        if (GetPageEntry(gpu_addr + available_size).IsUnmapped()) {
+        const GPUVAddr page_addr{gpu_addr + available_size};
+        const std::size_t page_index{PageEntryIndex(page_addr)};
+        const auto& leaf{page_directory[page_index >> leaf_bits]};
+        if (!leaf || leaf->num_used == 0) {
+            // Skip over the whole leaf, none of its pages are in use
+            available_size += leaf_span - (page_addr & (leaf_span - 1));
+        } else if (leaf->entries[page_index & leaf_mask].IsUnmapped()) {
             available_size += page_size;
-
-            if (available_size >= size) {
-                return gpu_addr;
-            }
         } else {
-            gpu_addr += available_size + page_size;
+            // Restart after the used page, or after the whole leaf when all its pages are used
+            const u64 used_size{leaf->num_used == leaf_size
+                                    ? leaf_span - (page_addr & (leaf_span - 1))
+                                    : page_size};
+            gpu_addr += available_size + used_size;
             available_size = 0;
 
             const auto remainder{gpu_addr % align};
             if (remainder) {
                 gpu_addr = (gpu_addr - remainder) + align;
             }
+            continue;
+        }
+        if (available_size >= size) {
+            return gpu_addr;
         }
     }
 
@@ -207,100 +247,133 @@ const u8* MemoryManager::GetPointer(GPUVAddr gpu_addr) const {
     return system.Memory().GetPointer(*address);
 }
 
-void MemoryManager::ReadBlock(GPUVAddr gpu_src_addr, void* dest_buffer, std::size_t size) const {
-    std::size_t remaining_size{size};
-    std::size_t page_index{gpu_src_addr >> page_bits};
-    std::size_t page_offset{gpu_src_addr & page_mask};
-
-    while (remaining_size > 0) {
-        const std::size_t copy_amount{
-            std::min(static_cast<std::size_t>(page_size) - page_offset, remaining_size)};
-
-        if (const auto page_addr{GpuToCpuAddress(page_index << page_bits)}; page_addr) {
-            const auto src_addr{*page_addr + page_offset};
+u8* MemoryManager::GetContiguousPointer(GPUVAddr gpu_addr, std::size_t size) {
+    return const_cast<u8*>(std::as_const(*this).GetContiguousPointer(gpu_addr, size));
+}
 
-            // Flush must happen on the rasterizer interface, such that memory is always synchronous
-            // when it is read (even when in asynchronous GPU mode). Fixes Dead Cells title menu.
-            rasterizer->FlushRegion(src_addr, copy_amount);
-            system.Memory().ReadBlockUnsafe(src_addr, dest_buffer, copy_amount);
+const u8* MemoryManager::GetContiguousPointer(GPUVAddr gpu_addr, std::size_t size) const {
+    if (size == 0 || GetContiguousSize(gpu_addr, size) != size) {
+        return {};
+    }
+    const VAddr cpu_addr{*GpuToCpuAddress(gpu_addr)};
+    const u8* const host_ptr{system.Memory().GetPointer(cpu_addr)};
+    if (!host_ptr) {
+        return {};
+    }
+    // CPU pages are not guaranteed to be contiguous in host memory, check each of them
+    const VAddr cpu_end{cpu_addr + size};
+    VAddr cpu_page{(cpu_addr & ~Core::Memory::PAGE_MASK) + Core::Memory::PAGE_SIZE};
+    for (; cpu_page < cpu_end; cpu_page += Core::Memory::PAGE_SIZE) {
+        if (system.Memory().GetPointer(cpu_page) != host_ptr + (cpu_page - cpu_addr)) {
+            return {};
         }
-
-        page_index++;
-        page_offset = 0;
-        dest_buffer = static_cast<u8*>(dest_buffer) + copy_amount;
-        remaining_size -= copy_amount;
     }
+    return host_ptr;
 }
 
-void MemoryManager::ReadBlockUnsafe(GPUVAddr gpu_src_addr, void* dest_buffer,
-                                    const std::size_t size) const {
-    std::size_t remaining_size{size};
-    std::size_t page_index{gpu_src_addr >> page_bits};
-    std::size_t page_offset{gpu_src_addr & page_mask};
-
-    while (remaining_size > 0) {
-        const std::size_t copy_amount{
-            std::min(static_cast<std::size_t>(page_size) - page_offset, remaining_size)};
+std::size_t MemoryManager::GetContiguousSize(GPUVAddr gpu_addr, std::size_t size) const {
+    const PageEntry first_entry{GetPageEntry(gpu_addr)};
+    if (!first_entry.IsValid()) {
+        return 0;
+    }
+    std::size_t contiguous_size{page_size - (gpu_addr & page_mask)};
+    VAddr expected_addr{first_entry.ToAddress() + page_size};
+    while (contiguous_size < size) {
+        const PageEntry page_entry{GetPageEntry(gpu_addr + contiguous_size)};
+        if (!page_entry.IsValid() || page_entry.ToAddress() != expected_addr) {
+            break;
+        }
+        contiguous_size += page_size;
+        expected_addr += page_size;
+    }
+    return std::min(contiguous_size, size);
+}
 
-        if (const auto page_addr{GpuToCpuAddress(page_index << page_bits)}; page_addr) {
-            const auto src_addr{*page_addr + page_offset};
-            system.Memory().ReadBlockUnsafe(src_addr, dest_buffer, copy_amount);
+template <typename MappedFunc, typename UnmappedFunc>
+void MemoryManager::WalkBlock(GPUVAddr gpu_addr, std::size_t size, MappedFunc&& mapped_func,
+                              UnmappedFunc&& unmapped_func) const {
+    std::size_t offset{};
+    while (offset < size) {
+        const GPUVAddr current_addr{gpu_addr + offset};
+        const std::size_t remaining_size{size - offset};
+        if (const std::size_t run_size{GetContiguousSize(current_addr, remaining_size)}) {
+            mapped_func(*GpuToCpuAddress(current_addr), offset, run_size);
+            offset += run_size;
         } else {
-            std::memset(dest_buffer, 0, copy_amount);
+            const std::size_t skip_size{std::min(
+                static_cast<std::size_t>(page_size - (current_addr & page_mask)), remaining_size)};
+            unmapped_func(offset, skip_size);
+            offset += skip_size;
         }
-
-        page_index++;
-        page_offset = 0;
-        dest_buffer = static_cast<u8*>(dest_buffer) + copy_amount;
-        remaining_size -= copy_amount;
     }
 }
 
-void MemoryManager::WriteBlock(GPUVAddr gpu_dest_addr, const void* src_buffer, std::size_t size) {
-    std::size_t remaining_size{size};
-    std::size_t page_index{gpu_dest_addr >> page_bits};
-    std::size_t page_offset{gpu_dest_addr & page_mask};
-
-    while (remaining_size > 0) {
-        const std::size_t copy_amount{
-            std::min(static_cast<std::size_t>(page_size) - page_offset, remaining_size)};
+void MemoryManager::ReadBlock(GPUVAddr gpu_src_addr, void* dest_buffer, std::size_t size) const {
+    u8* const dest{static_cast<u8*>(dest_buffer)};
+    WalkBlock(
+        gpu_src_addr, size,
+        [this, dest](VAddr src_addr, std::size_t offset, std::size_t copy_amount) {
+            // Flush must happen on the rasterizer interface, such that memory is always synchronous
+            // when it is read (even when in asynchronous GPU mode). Fixes Dead Cells title menu.
+            rasterizer->FlushRegion(src_addr, copy_amount);
+            system.Memory().ReadBlockUnsafe(src_addr, dest + offset, copy_amount);
+        },
+        [](std::size_t, std::size_t) {});
+}
 
-        if (const auto page_addr{GpuToCpuAddress(page_index << page_bits)}; page_addr) {
-            const auto dest_addr{*page_addr + page_offset};
+void MemoryManager::ReadBlockUnsafe(GPUVAddr gpu_src_addr, void* dest_buffer,
+                                    const std::size_t size) const {
+    u8* const dest{static_cast<u8*>(dest_buffer)};
+    WalkBlock(
+        gpu_src_addr, size,
+        [this, dest](VAddr src_addr, std::size_t offset, std::size_t copy_amount) {
+            system.Memory().ReadBlockUnsafe(src_addr, dest + offset, copy_amount);
+        },
+        [dest](std::size_t offset, std::size_t copy_amount) {
+            std::memset(dest + offset, 0, copy_amount);
+        });
+}
 
+void MemoryManager::WriteBlock(GPUVAddr gpu_dest_addr, const void* src_buffer, std::size_t size) {
+    const u8* const src{static_cast<const u8*>(src_buffer)};
+    WalkBlock(
+        gpu_dest_addr, size,
+        [this, src](VAddr dest_addr, std::size_t offset, std::size_t copy_amount) {
             // Invalidate must happen on the rasterizer interface, such that memory is always
             // synchronous when it is written (even when in asynchronous GPU mode).
             rasterizer->InvalidateRegion(dest_addr, copy_amount);
-            system.Memory().WriteBlockUnsafe(dest_addr, src_buffer, copy_amount);
-        }
-
-        page_index++;
-        page_offset = 0;
-        src_buffer = static_cast<const u8*>(src_buffer) + copy_amount;
-        remaining_size -= copy_amount;
-    }
+            system.Memory().WriteBlockUnsafe(dest_addr, src + offset, copy_amount);
+        },
+        [](std::size_t, std::size_t) {});
 }
 
 void MemoryManager::WriteBlockUnsafe(GPUVAddr gpu_dest_addr, const void* src_buffer,
                                      std::size_t size) {
-    std::size_t remaining_size{size};
-    std::size_t page_index{gpu_dest_addr >> page_bits};
-    std::size_t page_offset{gpu_dest_addr & page_mask};
-
-    while (remaining_size > 0) {
-        const std::size_t copy_amount{
-            std::min(static_cast<std::size_t>(page_size) - page_offset, remaining_size)};
+    const u8* const src{static_cast<const u8*>(src_buffer)};
+    WalkBlock(
+        gpu_dest_addr, size,
+        [this, src](VAddr dest_addr, std::size_t offset, std::size_t copy_amount) {
+            system.Memory().WriteBlockUnsafe(dest_addr, src + offset, copy_amount);
+        },
+        [](std::size_t, std::size_t) {});
+}
 
-        if (const auto page_addr{GpuToCpuAddress(page_index << page_bits)}; page_addr) {
-            const auto dest_addr{*page_addr + page_offset};
-            system.Memory().WriteBlockUnsafe(dest_addr, src_buffer, copy_amount);
-        }
+void MemoryManager::FlushRegion(GPUVAddr gpu_addr, std::size_t size) const {
+    WalkBlock(
+        gpu_addr, size,
+        [this](VAddr cpu_addr, std::size_t, std::size_t run_size) {
+            rasterizer->FlushRegion(cpu_addr, run_size);
+        },
+        [](std::size_t, std::size_t) {});
+}
 
-        page_index++;
-        page_offset = 0;
-        src_buffer = static_cast<const u8*>(src_buffer) + copy_amount;
-        remaining_size -= copy_amount;
-    }
+void MemoryManager::InvalidateRegion(GPUVAddr gpu_addr, std::size_t size) {
+    WalkBlock(
+        gpu_addr, size,
+        [this](VAddr cpu_addr, std::size_t, std::size_t run_size) {
+            rasterizer->InvalidateRegion(cpu_addr, run_size);
+        },
+        [](std::size_t, std::size_t) {});
 }
 
 void MemoryManager::CopyBlock(GPUVAddr gpu_dest_addr, GPUVAddr gpu_src_addr, std::size_t size) {
@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include <array>
 #include <map>
+#include <memory>
 #include <optional>
 #include <vector>
 
@@ -85,6 +87,20 @@ public:
     [[nodiscard]] u8* GetPointer(GPUVAddr addr);
     [[nodiscard]] const u8* GetPointer(GPUVAddr addr) const;
 
+    /**
+     * Returns a host pointer to the whole [gpu_addr, gpu_addr + size) range when it is backed by
+     * contiguous host memory, so it can be accessed without copying it page by page.
+     * Returns nullptr otherwise.
+     */
+    [[nodiscard]] u8* GetContiguousPointer(GPUVAddr gpu_addr, std::size_t size);
+    [[nodiscard]] const u8* GetContiguousPointer(GPUVAddr gpu_addr, std::size_t size) const;
+
+    /**
+     * Returns the number of bytes, up to size, starting at gpu_addr that are mapped to a single
+     * contiguous CPU address range. Returns zero when gpu_addr is not mapped.
+     */
+    [[nodiscard]] std::size_t GetContiguousSize(GPUVAddr gpu_addr, std::size_t size) const;
+
     /**
      * ReadBlock and WriteBlock are full read and write operations over virtual
      * GPU Memory. It's important to use these when GPU memory may not be continuous
@@ -109,6 +125,13 @@ public:
     void WriteBlockUnsafe(GPUVAddr gpu_dest_addr, const void* src_buffer, std::size_t size);
     void CopyBlockUnsafe(GPUVAddr gpu_dest_addr, GPUVAddr gpu_src_addr, std::size_t size);
 
+    /**
+     * FlushRegion and InvalidateRegion flush and invalidate the host GPU caches overlapping a
+     * range of GPU memory, without accessing the memory itself.
+     */
+    void FlushRegion(GPUVAddr gpu_addr, std::size_t size) const;
+    void InvalidateRegion(GPUVAddr gpu_addr, std::size_t size);
+
     /**
      * IsGranularRange checks if a gpu region can be simply read with a pointer.
      */
@@ -129,6 +152,11 @@ private:
     void TryLockPage(PageEntry page_entry, std::size_t size);
     void TryUnlockPage(PageEntry page_entry, std::size_t size);
 
+    /// Splits a GPU range in runs contiguous in CPU memory and runs of unmapped pages
+    template <typename MappedFunc, typename UnmappedFunc>
+    void WalkBlock(GPUVAddr gpu_addr, std::size_t size, MappedFunc&& mapped_func,
+                   UnmappedFunc&& unmapped_func) const;
+
     [[nodiscard]] static constexpr std::size_t PageEntryIndex(GPUVAddr gpu_addr) {
         return (gpu_addr >> page_bits) & page_table_mask;
     }
@@ -141,12 +169,24 @@ private:
     static constexpr u64 page_table_bits{24};
     static constexpr u64 page_table_size{1 << page_table_bits};
     static constexpr u64 page_table_mask{page_table_size - 1};
+    static constexpr u64 leaf_bits{10};
+    static constexpr u64 leaf_size{1ULL << leaf_bits};
+    static constexpr u64 leaf_mask{leaf_size - 1};
+    static constexpr u64 leaf_span{page_size << leaf_bits};
+    static constexpr u64 directory_size{page_table_size >> leaf_bits};
+
+    /// Second level of the page table, covering leaf_span bytes of GPU memory
+    struct PageTableLeaf {
+        std::array<PageEntry, leaf_size> entries{};
+        std::size_t num_used{}; ///< Number of entries that are not unmapped
+    };
 
     Core::System& system;
 
     VideoCore::RasterizerInterface* rasterizer = nullptr;
 
-    std::vector<PageEntry> page_table;
+    /// Two level page table, leaves are only allocated once a page in their range is used
+    std::vector<std::unique_ptr<PageTableLeaf>> page_directory;
 };
 
 } // namespace Tegra
@@ -6,13 +6,15 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <cstring>
 #include <iterator>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <unordered_map>
-#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "common/assert.h"
@@ -21,6 +23,7 @@
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/gpu.h"
 #include "video_core/memory_manager.h"
+#include "video_core/query_cache_stats.h"
 #include "video_core/rasterizer_interface.h"
 
 namespace VideoCommon {
@@ -132,6 +135,7 @@ public:
         }
 
         query->BindCounter(Stream(type).Current(), timestamp);
+        ++frame_stats.queries;
         if (Settings::values.use_asynchronous_gpu_emulation.GetValue()) {
             AsyncFlushQuery(cpu_addr);
         }
@@ -158,6 +162,13 @@ public:
         }
     }
 
+    /// Publishes the counters of the current frame and starts a new one.
+    void TickFrame() {
+        std::unique_lock lock{mutex};
+        system.GPU().QueryCacheStats().PublishFrame(frame_stats);
+        frame_stats = {};
+    }
+
     /// Returns a new host counter.
     std::shared_ptr<HostCounter> Counter(std::shared_ptr<HostCounter> dependency,
                                          VideoCore::QueryType type) {
@@ -176,6 +187,12 @@ public:
     }
 
     void CommitAsyncFlushes() {
+        if (uncommitted_flushes) {
+            // Games usually rewrite the same queries several times per fence, flush them once.
+            auto& addresses = *uncommitted_flushes;
+            std::sort(addresses.begin(), addresses.end());
+            addresses.erase(std::unique(addresses.begin(), addresses.end()), addresses.end());
+        }
         committed_flushes.push_back(uncommitted_flushes);
         uncommitted_flushes.reset();
     }
@@ -232,13 +249,28 @@ private:
                     continue;
                 }
                 rasterizer.UpdatePagesCachedCount(query.GetCpuAddr(), query.SizeInBytes(), -1);
-                query.Flush();
+                FlushQuery(query);
             }
             contents.erase(std::remove_if(std::begin(contents), std::end(contents), in_range),
                            std::end(contents));
         }
     }
 
+    /// Writes a query to guest memory, accounting the time spent waiting for the host GPU.
+    void FlushQuery(CachedQuery& query) {
+        ++frame_stats.resolutions;
+        if (!query.WaitPending()) {
+            query.Flush();
+            return;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        query.Flush();
+        const auto stall_time = std::chrono::steady_clock::now() - start;
+        ++frame_stats.stalls;
+        frame_stats.stall_ns += static_cast<u64>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(stall_time).count());
+    }
+
     /// Registers the passed parameters as cached and returns a pointer to the stored cached query.
     CachedQuery* Register(VideoCore::QueryType type, VAddr cpu_addr, u8* host_ptr, bool timestamp) {
         rasterizer.UpdatePagesCachedCount(cpu_addr, CachedQuery::SizeInBytes(timestamp), 1);
@@ -262,9 +294,9 @@ private:
 
     void AsyncFlushQuery(VAddr addr) {
         if (!uncommitted_flushes) {
-            uncommitted_flushes = std::make_shared<std::unordered_set<VAddr>>();
+            uncommitted_flushes = std::make_shared<std::vector<VAddr>>();
         }
-        uncommitted_flushes->insert(addr);
+        uncommitted_flushes->push_back(addr);
     }
 
     static constexpr std::uintptr_t PAGE_SIZE = 4096;
@@ -279,18 +311,23 @@ private:
 
     std::array<CounterStream, VideoCore::NumQueryTypes> streams;
 
-    std::shared_ptr<std::unordered_set<VAddr>> uncommitted_flushes{};
-    std::list<std::shared_ptr<std::unordered_set<VAddr>>> committed_flushes;
+    QueryCacheStats::Frame frame_stats{};
+
+    std::shared_ptr<std::vector<VAddr>> uncommitted_flushes{};
+    std::list<std::shared_ptr<std::vector<VAddr>>> committed_flushes;
 };
 
 template <class QueryCache, class HostCounter>
 class HostCounterBase {
 public:
+    /// Number of nested dependencies a counter can have before its chain is collapsed.
+    static constexpr u64 MAX_DEPTH = 96;
+
     explicit HostCounterBase(std::shared_ptr<HostCounter> dependency_)
         : dependency{std::move(dependency_)}, depth{dependency ? (dependency->Depth() + 1) : 0} {
-        // Avoid nesting too many dependencies to avoid a stack overflow when these are deleted.
-        constexpr u64 depth_threshold = 96;
-        if (depth > depth_threshold) {
+        // Collapse deep chains into their value, unresolved chains would otherwise keep growing
+        // along with the host queries they hold when the game never reads its queries back.
+        if (depth > MAX_DEPTH) {
             depth = 0;
             base_result = dependency->Query();
             dependency = nullptr;
@@ -304,19 +341,30 @@ public:
             return *result;
         }
 
-        u64 value = BlockingQuery() + base_result;
-        if (dependency) {
-            value += dependency->Query();
-            dependency = nullptr;
+        // Resolve the chain of pending dependencies from the oldest to the newest counter without
+        // recursing, accumulating their values as we go.
+        std::vector<HostCounterBase*> pending;
+        for (HostCounterBase* it = this; it && !it->result;
+             it = it->dependency ? &Base(*it->dependency) : nullptr) {
+            pending.push_back(it);
+        }
+        const HostCounterBase* const oldest = pending.back();
+        u64 value = oldest->base_result;
+        if (oldest->dependency) {
+            value += *Base(*oldest->dependency).result;
+        }
+        for (auto it = pending.rbegin(); it != pending.rend(); ++it) {
+            HostCounterBase* const counter = *it;
+            value += counter->BlockingQuery();
+            counter->result = value;
+            counter->dependency = nullptr;
         }
-
-        result = value;
         return *result;
     }
 
     /// Returns true when flushing this query will potentially wait.
     bool WaitPending() const noexcept {
-        return result.has_value();
+        return !result.has_value();
     }
 
     u64 Depth() const noexcept {
@@ -328,6 +376,10 @@ protected:
     virtual u64 BlockingQuery() const = 0;
 
 private:
+    static HostCounterBase& Base(HostCounter& counter) noexcept {
+        return static_cast<HostCounterBase&>(counter);
+    }
+
     std::shared_ptr<HostCounter> dependency; ///< Counter to add to this value.
     std::optional<u64> result;               ///< Filled with the already returned value.
     u64 depth;                               ///< Number of nested dependencies.
@@ -361,9 +413,10 @@ public:
 
     /// Binds a counter to this query.
     void BindCounter(std::shared_ptr<HostCounter> counter_, std::optional<u64> timestamp_) {
-        if (counter) {
-            // If there's an old counter set it means the query is being rewritten by the game.
-            // To avoid losing the data forever, flush here.
+        if (counter && !counter->WaitPending()) {
+            // The query is being rewritten by the game. Its old value is only written when it is
+            // already available: every guest read of this memory flushes the cache first and
+            // observes the new counter, so waiting for the old one here would be a pure stall.
             Flush();
         }
         counter = std::move(counter_);
@@ -382,7 +435,6 @@ public:
         return with_timestamp ? LARGE_QUERY_SIZE : SMALL_QUERY_SIZE;
     }
 
-protected:
     /// Returns true when querying the counter may potentially block.
     bool WaitPending() const noexcept {
         return counter && counter->WaitPending();
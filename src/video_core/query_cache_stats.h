@@ -0,0 +1,57 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+
+#include "common/common_types.h"
+
+namespace VideoCommon {
+
+/// Query cache counters published by the GPU thread once per frame and read by the frontend.
+class QueryCacheStats {
+public:
+    struct Frame {
+        u64 queries;     ///< Queries recorded by the guest
+        u64 resolutions; ///< Queries written back to guest memory
+        u64 stalls;      ///< Resolutions that had to wait for the host GPU
+        u64 stall_ns;    ///< Time spent waiting for the host GPU, in nanoseconds
+    };
+
+    struct Snapshot {
+        Frame last_frame;   ///< Counters of the last completed frame
+        u64 total_stall_ns; ///< Time spent waiting for the host GPU since boot, in nanoseconds
+    };
+
+    void PublishFrame(const Frame& frame) {
+        queries.store(frame.queries, std::memory_order_relaxed);
+        resolutions.store(frame.resolutions, std::memory_order_relaxed);
+        stalls.store(frame.stalls, std::memory_order_relaxed);
+        stall_ns.store(frame.stall_ns, std::memory_order_relaxed);
+        total_stall_ns.fetch_add(frame.stall_ns, std::memory_order_relaxed);
+    }
+
+    Snapshot GetSnapshot() const {
+        return {
+            .last_frame =
+                {
+                    .queries = queries.load(std::memory_order_relaxed),
+                    .resolutions = resolutions.load(std::memory_order_relaxed),
+                    .stalls = stalls.load(std::memory_order_relaxed),
+                    .stall_ns = stall_ns.load(std::memory_order_relaxed),
+                },
+            .total_stall_ns = total_stall_ns.load(std::memory_order_relaxed),
+        };
+    }
+
+private:
+    std::atomic<u64> queries{};
+    std::atomic<u64> resolutions{};
+    std::atomic<u64> stalls{};
+    std::atomic<u64> stall_ns{};
+    std::atomic<u64> total_stall_ns{};
+};
+
+} // namespace VideoCommon
@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <array>
 #include <cstddef>
+#include <iterator>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -38,6 +39,11 @@ using Operation = const OperationNode&;
 
 constexpr std::array INTERNAL_FLAG_NAMES = {"ZERO", "SIGN", "CARRY", "OVERFLOW"};
 
+/// Approximate number of assembly bytes emitted per guest instruction, used to size the output
+constexpr std::size_t ASSEMBLY_BYTES_PER_INSTRUCTION = 64;
+/// Space reserved for the declarations emitted before the program body
+constexpr std::size_t ASSEMBLY_HEADER_RESERVE = 4 * 1024;
+
 char Swizzle(std::size_t component) {
     ASSERT(component < 4);
     return component["xyzw"];
@@ -444,7 +450,7 @@ private:
 
     template <typename... Args>
     void AddExpression(std::string_view text, Args&&... args) {
-        shader_source += fmt::format(text, std::forward<Args>(args)...);
+        fmt::vformat_to(std::back_inserter(shader_source), text, fmt::make_format_args(args...));
     }
 
     template <typename... Args>
@@ -795,6 +801,9 @@ private:
 ARBDecompiler::ARBDecompiler(const Device& device, const ShaderIR& ir, const Registry& registry,
                              ShaderType stage, std::string_view identifier)
     : device{device}, ir{ir}, registry{registry}, stage{stage} {
+    const std::size_t num_instructions = ir.GetLength() / sizeof(u64);
+    shader_source.reserve(num_instructions * ASSEMBLY_BYTES_PER_INSTRUCTION);
+
     DefineGlobalMemory();
 
     AddLine("TEMP RC;");
@@ -808,6 +817,7 @@ ARBDecompiler::ARBDecompiler(const Device& device, const ShaderIR& ir, const Reg
     AddLine("END");
 
     const std::string code = std::move(shader_source);
+    shader_source.reserve(code.size() + ASSEMBLY_HEADER_RESERVE);
     DeclareHeader();
     DeclareVertex();
     DeclareGeometry();
@@ -869,10 +869,13 @@ void RasterizerOpenGL::FlushCommands() {
 }
 
 void RasterizerOpenGL::TickFrame() {
+    MICROPROFILE_SCOPE(OpenGL_CacheManagement);
     // Ticking a frame means that buffers will be swapped, calling glFlush implicitly.
     num_queued_commands = 0;
 
     buffer_cache.TickFrame();
+    texture_cache.TickFrame();
+    query_cache.TickFrame();
 }
 
 bool RasterizerOpenGL::AccelerateSurfaceCopy(const Tegra::Engines::Fermi2D::Regs::Surface& src,
@@ -123,6 +123,22 @@ std::string MakeShaderID(u64 unique_identifier, ShaderType shader_type) {
     return fmt::format("{}{:016X}", GetShaderTypeName(shader_type), unique_identifier);
 }
 
+std::unordered_set<GLenum> GetSupportedFormats() {
+    GLint num_formats;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &num_formats);
+
+    std::vector<GLint> formats(num_formats);
+    glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data());
+
+    std::unordered_set<GLenum> supported_formats;
+    for (const GLint format : formats) {
+        supported_formats.insert(static_cast<GLenum>(format));
+    }
+    return supported_formats;
+}
+
+} // Anonymous namespace
+
 std::shared_ptr<Registry> MakeRegistry(const ShaderDiskCacheEntry& entry) {
     const VideoCore::GuestDriverProfile guest_profile{entry.texture_handler_size};
     const VideoCommon::Shader::SerializedRegistryInfo info{guest_profile, entry.bound_buffer,
@@ -142,22 +158,6 @@ std::shared_ptr<Registry> MakeRegistry(const ShaderDiskCacheEntry& entry) {
     return registry;
 }
 
-std::unordered_set<GLenum> GetSupportedFormats() {
-    GLint num_formats;
-    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &num_formats);
-
-    std::vector<GLint> formats(num_formats);
-    glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data());
-
-    std::unordered_set<GLenum> supported_formats;
-    for (const GLint format : formats) {
-        supported_formats.insert(static_cast<GLenum>(format));
-    }
-    return supported_formats;
-}
-
-} // Anonymous namespace
-
 ProgramSharedPtr BuildShader(const Device& device, ShaderType shader_type, u64 unique_identifier,
                              const ShaderIR& ir, const Registry& registry, bool hint_retrievable) {
     const std::string shader_id = MakeShaderID(unique_identifier, shader_type);
@@ -222,14 +222,20 @@ bool Shader::IsBuilt() const {
     return is_built;
 }
 
-void Shader::AsyncOpenGLBuilt(OGLProgram new_program) {
+void Shader::AsyncOpenGLBuilt(OGLProgram new_program, ShaderEntries new_entries,
+                              std::shared_ptr<Registry> new_registry) {
     program->source_program = std::move(new_program);
+    entries = std::move(new_entries);
+    registry = std::move(new_registry);
     handle = program->source_program.handle;
     is_built = true;
 }
 
-void Shader::AsyncGLASMBuilt(OGLAssemblyProgram new_program) {
+void Shader::AsyncGLASMBuilt(OGLAssemblyProgram new_program, ShaderEntries new_entries,
+                             std::shared_ptr<Registry> new_registry) {
     program->assembly_program = std::move(new_program);
+    entries = std::move(new_entries);
+    registry = std::move(new_registry);
     handle = program->assembly_program.handle;
     is_built = true;
 }
@@ -243,8 +249,17 @@ std::unique_ptr<Shader> Shader::CreateStageFromMemory(
     gpu.ShaderNotify().MarkSharderBuilding();
 
     auto registry = std::make_shared<Registry>(shader_type, gpu.Maxwell3D());
-    if (!async_shaders.IsShaderAsync(params.system.GPU()) ||
-        !params.device.UseAsynchronousShaders()) {
+    std::shared_ptr<Registry> async_registry;
+    if (async_shaders.IsShaderAsync(params.system.GPU()) &&
+        params.device.UseAsynchronousShaders()) {
+        // Workers decode against a copy of the engine state, when it can't be copied the shader
+        // is built here like any other synchronous shader
+        async_registry = std::make_shared<Registry>(*registry);
+        if (!async_registry->SnapshotEngine()) {
+            async_registry.reset();
+        }
+    }
+    if (!async_registry) {
         const ShaderIR ir(code, STAGE_MAIN_OFFSET, COMPILER_SETTINGS, *registry);
         // TODO(Rodrigo): Handle VertexA shaders
         // std::optional<ShaderIR> ir_b;
@@ -271,17 +286,15 @@ std::unique_ptr<Shader> Shader::CreateStageFromMemory(
                                                   MakeEntries(params.device, ir, shader_type),
                                                   std::move(program), true));
     } else {
-        // Required for entries
-        const ShaderIR ir(code, STAGE_MAIN_OFFSET, COMPILER_SETTINGS, *registry);
-        auto entries = MakeEntries(params.device, ir, shader_type);
-
+        // The IR is built by the worker, entries are filled once the shader has been compiled.
+        // Until then the shader is not bound, so its empty entries are never used for drawing.
         async_shaders.QueueOpenGLShader(params.device, shader_type, params.unique_identifier,
                                         std::move(code), std::move(code_b), STAGE_MAIN_OFFSET,
-                                        COMPILER_SETTINGS, *registry, cpu_addr);
+                                        COMPILER_SETTINGS, std::move(async_registry), cpu_addr);
 
         auto program = std::make_shared<ProgramHandle>();
         return std::unique_ptr<Shader>(
-            new Shader(std::move(registry), std::move(entries), std::move(program), false));
+            new Shader(std::move(registry), ShaderEntries{}, std::move(program), false));
     }
 }
 
@@ -501,10 +514,14 @@ Shader* ShaderCacheOpenGL::GetStageProgram(Maxwell::ShaderProgram program,
                 continue;
             }
             using namespace VideoCommon::Shader;
+            // Keys were gathered from a snapshot, check them against the live engine from now on
+            work.registry->BindEngine(gpu.Maxwell3D());
             if (work.backend == AsyncShaders::Backend::OpenGL) {
-                shader->AsyncOpenGLBuilt(std::move(work.program.opengl));
+                shader->AsyncOpenGLBuilt(std::move(work.program.opengl), std::move(work.entries),
+                                         std::move(work.registry));
             } else if (work.backend == AsyncShaders::Backend::GLASM) {
-                shader->AsyncGLASMBuilt(std::move(work.program.glasm));
+                shader->AsyncGLASMBuilt(std::move(work.program.glasm), std::move(work.entries),
+                                        std::move(work.registry));
             }
 
             ShaderDiskCacheEntry entry;
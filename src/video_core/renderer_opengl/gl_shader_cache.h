@@ -65,6 +65,9 @@ struct ShaderParameters {
     u64 unique_identifier;
 };
 
+/// Creates a registry holding the keys recorded in a transferable cache entry
+std::shared_ptr<VideoCommon::Shader::Registry> MakeRegistry(const ShaderDiskCacheEntry& entry);
+
 ProgramSharedPtr BuildShader(const Device& device, Tegra::Engines::ShaderType shader_type,
                              u64 unique_identifier, const VideoCommon::Shader::ShaderIR& ir,
                              const VideoCommon::Shader::Registry& registry,
@@ -89,10 +92,12 @@ public:
     }
 
     /// Mark a OpenGL shader as built
-    void AsyncOpenGLBuilt(OGLProgram new_program);
+    void AsyncOpenGLBuilt(OGLProgram new_program, ShaderEntries new_entries,
+                          std::shared_ptr<VideoCommon::Shader::Registry> new_registry);
 
     /// Mark a GLASM shader as built
-    void AsyncGLASMBuilt(OGLAssemblyProgram new_program);
+    void AsyncGLASMBuilt(OGLAssemblyProgram new_program, ShaderEntries new_entries,
+                         std::shared_ptr<VideoCommon::Shader::Registry> new_registry);
 
     static std::unique_ptr<Shader> CreateStageFromMemory(
         const ShaderParameters& params, Maxwell::ShaderProgram program_type,
@@ -2,7 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
+#include <iterator>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -84,8 +86,18 @@ layout (std140, binding = {}) uniform vs_config {{
 }};
 )";
 
+/// Approximate number of GLSL bytes emitted per guest instruction, used to size the output
+constexpr std::size_t GLSL_BYTES_PER_INSTRUCTION = 96;
+/// Minimum size reserved for the output, it covers the declarations of small shaders
+constexpr std::size_t MIN_GLSL_RESERVE = 16 * 1024;
+
 class ShaderWriter final {
 public:
+    /// Reserves output space up front, so lines are formatted in place without reallocating
+    void Reserve(std::size_t size) {
+        shader_source.reserve(size);
+    }
+
     void AddExpression(std::string_view text) {
         DEBUG_ASSERT(scope >= 0);
         if (!text.empty()) {
@@ -101,7 +113,15 @@ public:
     // etc).
     template <typename... Args>
     void AddLine(std::string_view text, Args&&... args) {
-        AddExpression(fmt::format(text, std::forward<Args>(args)...));
+        DEBUG_ASSERT(scope >= 0);
+        const std::size_t line_begin = shader_source.size();
+        AppendIndentation();
+        const std::size_t text_begin = shader_source.size();
+        fmt::vformat_to(std::back_inserter(shader_source), text, fmt::make_format_args(args...));
+        if (shader_source.size() == text_begin) {
+            // Empty lines are not indented
+            shader_source.resize(line_begin);
+        }
         AddNewLine();
     }
 
@@ -426,6 +446,8 @@ public:
         if (stage != ShaderType::Compute) {
             transform_feedback = BuildTransformFeedback(registry.GetGraphicsInfo());
         }
+        const std::size_t num_instructions = ir.GetLength() / sizeof(u64);
+        code.Reserve(std::max(MIN_GLSL_RESERVE, num_instructions * GLSL_BYTES_PER_INSTRUCTION));
     }
 
     void Decompile() {
@@ -258,19 +258,23 @@ constexpr u32 EncodeSwizzle(SwizzleSource x_source, SwizzleSource y_source, Swiz
 
 } // Anonymous namespace
 
+// BCn is always sampled natively, OpenGL drivers expose S3TC along with core RGTC and BPTC.
+// ASTC is transcoded to BC3 when the driver can't sample it.
 CachedSurface::CachedSurface(const GPUVAddr gpu_addr, const SurfaceParams& params,
                              bool is_astc_supported)
-    : VideoCommon::SurfaceBase<View>(gpu_addr, params, is_astc_supported) {
-    if (is_converted) {
+    : VideoCommon::SurfaceBase<View>(gpu_addr, params, is_astc_supported, true) {
+    const bool is_host_compressed = VideoCore::Surface::GetDefaultBlockWidth(host_format) > 1 ||
+                                    VideoCore::Surface::GetDefaultBlockHeight(host_format) > 1;
+    if (is_converted && !is_host_compressed) {
         internal_format = params.srgb_conversion ? GL_SRGB8_ALPHA8 : GL_RGBA8;
         format = GL_RGBA;
         type = GL_UNSIGNED_BYTE;
     } else {
-        const auto& tuple{GetFormatTuple(params.pixel_format)};
+        const auto& tuple{GetFormatTuple(host_format)};
         internal_format = tuple.internal_format;
         format = tuple.format;
         type = tuple.type;
-        is_compressed = params.IsCompressed();
+        is_compressed = is_host_compressed;
     }
     target = GetTextureTarget(params.target);
     texture = CreateTexture(params, target, internal_format, texture_buffer);
@@ -291,21 +295,20 @@ void CachedSurface::DownloadTexture(std::vector<u8>& staging_buffer) {
     MICROPROFILE_SCOPE(OpenGL_Texture_Download);
 
     if (params.IsBuffer()) {
-        glGetNamedBufferSubData(texture_buffer.handle, 0,
-                                static_cast<GLsizeiptr>(params.GetHostSizeInBytes(false)),
-                                staging_buffer.data());
+        const auto size = static_cast<GLsizeiptr>(params.GetHostSizeInBytes(params.pixel_format));
+        glGetNamedBufferSubData(texture_buffer.handle, 0, size, staging_buffer.data());
         return;
     }
 
     SCOPE_EXIT({ glPixelStorei(GL_PACK_ROW_LENGTH, 0); });
 
     for (u32 level = 0; level < params.emulated_levels; ++level) {
-        glPixelStorei(GL_PACK_ALIGNMENT, std::min(8U, params.GetRowAlignment(level, is_converted)));
+        glPixelStorei(GL_PACK_ALIGNMENT, std::min(8U, params.GetRowAlignment(level, host_format)));
         glPixelStorei(GL_PACK_ROW_LENGTH, static_cast<GLint>(params.GetMipWidth(level)));
-        const std::size_t mip_offset = params.GetHostMipmapLevelOffset(level, is_converted);
+        const std::size_t mip_offset = params.GetHostMipmapLevelOffset(level, host_format);
 
         u8* const mip_data = staging_buffer.data() + mip_offset;
-        const GLsizei size = static_cast<GLsizei>(params.GetHostMipmapSize(level));
+        const GLsizei size = static_cast<GLsizei>(GetHostMipmapSize(level));
         if (is_compressed) {
             glGetCompressedTextureImage(texture.handle, level, size, mip_data);
         } else {
@@ -314,6 +317,13 @@ void CachedSurface::DownloadTexture(std::vector<u8>& staging_buffer) {
     }
 }
 
+std::size_t CachedSurface::GetHostMipmapSize(u32 level) const {
+    if (is_converted) {
+        return params.GetConvertedMipmapSize(level, host_format) * params.GetNumLayers();
+    }
+    return params.GetHostMipmapSize(level);
+}
+
 void CachedSurface::UploadTexture(const std::vector<u8>& staging_buffer) {
     MICROPROFILE_SCOPE(OpenGL_Texture_Upload);
     SCOPE_EXIT({ glPixelStorei(GL_UNPACK_ROW_LENGTH, 0); });
@@ -323,13 +333,13 @@ void CachedSurface::UploadTexture(const std::vector<u8>& staging_buffer) {
 }
 
 void CachedSurface::UploadTextureMipmap(u32 level, const std::vector<u8>& staging_buffer) {
-    glPixelStorei(GL_UNPACK_ALIGNMENT, std::min(8U, params.GetRowAlignment(level, is_converted)));
+    glPixelStorei(GL_UNPACK_ALIGNMENT, std::min(8U, params.GetRowAlignment(level, host_format)));
     glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(params.GetMipWidth(level)));
 
-    const std::size_t mip_offset = params.GetHostMipmapLevelOffset(level, is_converted);
+    const std::size_t mip_offset = params.GetHostMipmapLevelOffset(level, host_format);
     const u8* buffer{staging_buffer.data() + mip_offset};
     if (is_compressed) {
-        const auto image_size{static_cast<GLsizei>(params.GetHostMipmapSize(level))};
+        const auto image_size{static_cast<GLsizei>(GetHostMipmapSize(level))};
         switch (params.target) {
         case SurfaceTarget::Texture2D:
             glCompressedTextureSubImage2D(texture.handle, level, 0, 0,
@@ -347,7 +357,7 @@ void CachedSurface::UploadTextureMipmap(u32 level, const std::vector<u8>& stagin
                                           internal_format, image_size, buffer);
             break;
         case SurfaceTarget::TextureCubemap: {
-            const std::size_t layer_size{params.GetHostLayerSize(level)};
+            const std::size_t layer_size{GetHostMipmapSize(level) / params.GetNumLayers()};
             for (std::size_t face = 0; face < params.depth; ++face) {
                 glCompressedTextureSubImage3D(texture.handle, level, 0, 0, static_cast<GLint>(face),
                                               static_cast<GLsizei>(params.GetMipWidth(level)),
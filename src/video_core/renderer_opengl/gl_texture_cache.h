@@ -64,6 +64,9 @@ protected:
 private:
     void UploadTextureMipmap(u32 level, const std::vector<u8>& staging_buffer);
 
+    /// Returns the size in bytes of a mipmap level as uploaded to the driver.
+    std::size_t GetHostMipmapSize(u32 level) const;
+
     GLenum internal_format{};
     GLenum format{};
     GLenum type{};
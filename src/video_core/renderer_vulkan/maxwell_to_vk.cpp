@@ -12,6 +12,8 @@
 #include "video_core/renderer_vulkan/vk_device.h"
 #include "video_core/renderer_vulkan/wrapper.h"
 #include "video_core/surface.h"
+#include "video_core/textures/bcn.h"
+#include "video_core/textures/convert.h"
 
 namespace Vulkan::MaxwellToVK {
 
@@ -232,11 +234,13 @@ FormatInfo SurfaceFormat(const VKDevice& device, FormatType format_type, PixelFo
         return {VK_FORMAT_A8B8G8R8_UNORM_PACK32, true, true};
     }
 
-    // Use A8B8G8R8_UNORM on hardware that doesn't support ASTC natively
-    if (!device.IsOptimalAstcSupported() && VideoCore::Surface::IsPixelFormatASTC(pixel_format)) {
-        tuple.format = VideoCore::Surface::IsPixelFormatSRGB(pixel_format)
-                           ? VK_FORMAT_A8B8G8R8_SRGB_PACK32
-                           : VK_FORMAT_A8B8G8R8_UNORM_PACK32;
+    // ASTC and BCn are converted in software on hardware that doesn't sample them natively,
+    // ASTC is transcoded to BC3 when BCn is supported
+    if ((VideoCore::Surface::IsPixelFormatASTC(pixel_format) && !device.IsOptimalAstcSupported()) ||
+        (Tegra::Texture::BCn::IsBCnFormat(pixel_format) && !device.IsBCnSupported())) {
+        const PixelFormat host_format =
+            Tegra::Texture::GetConvertedFormat(pixel_format, device.IsBCnSupported());
+        tuple.format = tex_format_tuples[static_cast<std::size_t>(host_format)].format;
     }
     const bool attachable = tuple.usage & Attachable;
     const bool storage = tuple.usage & Storage;
@@ -215,7 +215,7 @@ bool VKDevice::Create() {
         .samplerAnisotropy = true,
         .textureCompressionETC2 = false,
         .textureCompressionASTC_LDR = is_optimal_astc_supported,
-        .textureCompressionBC = false,
+        .textureCompressionBC = is_bcn_supported,
         .occlusionQueryPrecise = true,
         .pipelineStatisticsQuery = false,
         .vertexPipelineStoresAndAtomics = true,
@@ -741,6 +741,7 @@ void VKDevice::SetupFeatures() {
     const auto supported_features{physical.GetFeatures()};
     is_formatless_image_load_supported = supported_features.shaderStorageImageReadWithoutFormat;
     is_optimal_astc_supported = IsOptimalAstcSupported(supported_features);
+    is_bcn_supported = supported_features.textureCompressionBC;
 }
 
 void VKDevice::CollectTelemetryParameters() {
@@ -132,6 +132,11 @@ public:
         return is_optimal_astc_supported;
     }
 
+    /// Returns true if BC1 to BC7 textures are natively supported.
+    bool IsBCnSupported() const {
+        return is_bcn_supported;
+    }
+
     /// Returns true if the device supports float16 natively
     bool IsFloat16Supported() const {
         return is_float16_supported;
@@ -244,6 +249,7 @@ private:
     VkDriverIdKHR driver_id{};              ///< Driver ID.
     VkShaderStageFlags guest_warp_stages{}; ///< Stages where the guest warp size can be forced.ed
     bool is_optimal_astc_supported{};       ///< Support for native ASTC.
+    bool is_bcn_supported{};                ///< Support for native BC1 to BC7.
     bool is_float16_supported{};            ///< Support for float16 arithmetics.
     bool is_warp_potentially_bigger{};      ///< Host warp size can be bigger than guest.
     bool is_formatless_image_load_supported{}; ///< Support for shader image read without format.
@@ -56,6 +56,7 @@ MICROPROFILE_DEFINE(Vulkan_RenderTargets, "Vulkan", "Setup render targets", MP_R
 MICROPROFILE_DEFINE(Vulkan_Textures, "Vulkan", "Setup textures", MP_RGB(192, 128, 128));
 MICROPROFILE_DEFINE(Vulkan_Images, "Vulkan", "Setup images", MP_RGB(192, 128, 128));
 MICROPROFILE_DEFINE(Vulkan_PipelineCache, "Vulkan", "Pipeline cache", MP_RGB(192, 128, 128));
+MICROPROFILE_DEFINE(Vulkan_CacheManagement, "Vulkan", "Cache management", MP_RGB(192, 128, 128));
 
 namespace {
 
@@ -715,9 +716,12 @@ void RasterizerVulkan::FlushCommands() {
 }
 
 void RasterizerVulkan::TickFrame() {
+    MICROPROFILE_SCOPE(Vulkan_CacheManagement);
     draw_counter = 0;
     update_descriptor_queue.TickFrame();
     buffer_cache.TickFrame();
+    texture_cache.TickFrame();
+    query_cache.TickFrame();
     staging_pool.TickFrame();
 }
 
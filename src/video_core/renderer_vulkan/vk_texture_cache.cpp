@@ -192,8 +192,9 @@ CachedSurface::CachedSurface(Core::System& system, const VKDevice& device,
                              VKResourceManager& resource_manager, VKMemoryManager& memory_manager,
                              VKScheduler& scheduler, VKStagingBufferPool& staging_pool,
                              GPUVAddr gpu_addr, const SurfaceParams& params)
-    : SurfaceBase<View>{gpu_addr, params, device.IsOptimalAstcSupported()}, system{system},
-      device{device}, resource_manager{resource_manager},
+    : SurfaceBase<View>{gpu_addr, params, device.IsOptimalAstcSupported(),
+                        device.IsBCnSupported()},
+      system{system}, device{device}, resource_manager{resource_manager},
       memory_manager{memory_manager}, scheduler{scheduler}, staging_pool{staging_pool} {
     if (params.IsBuffer()) {
         buffer = CreateBuffer(device, params, host_memory_size);
@@ -325,7 +326,7 @@ void CachedSurface::UploadImage(const std::vector<u8>& staging_buffer) {
 
 VkBufferImageCopy CachedSurface::GetBufferImageCopy(u32 level) const {
     return {
-        .bufferOffset = params.GetHostMipmapLevelOffset(level, is_converted),
+        .bufferOffset = params.GetHostMipmapLevelOffset(level, host_format),
         .bufferRowLength = 0,
         .bufferImageHeight = 0,
         .imageSubresource =
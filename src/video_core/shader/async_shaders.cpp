@@ -117,7 +117,7 @@ void AsyncShaders::QueueOpenGLShader(const OpenGL::Device& device,
                                      std::vector<u64> code, std::vector<u64> code_b,
                                      u32 main_offset,
                                      VideoCommon::Shader::CompilerSettings compiler_settings,
-                                     const VideoCommon::Shader::Registry& registry,
+                                     std::shared_ptr<VideoCommon::Shader::Registry> registry,
                                      VAddr cpu_addr) {
     WorkerParams params{
         .backend = device.UseAssemblyShaders() ? Backend::GLASM : Backend::OpenGL,
@@ -128,9 +128,10 @@ void AsyncShaders::QueueOpenGLShader(const OpenGL::Device& device,
         .code_b = std::move(code_b),
         .main_offset = main_offset,
         .compiler_settings = compiler_settings,
-        .registry = registry,
+        .registry = std::move(registry),
         .cpu_address = cpu_addr,
     };
+
     std::unique_lock lock(queue_mutex);
     pending_queue.push(std::move(params));
     cv.notify_one();
@@ -186,6 +187,7 @@ void AsyncShaders::ShaderCompilerThread(Core::Frontend::GraphicsContext* context
 
         if (work.backend == Backend::OpenGL || work.backend == Backend::GLASM) {
             const ShaderIR ir(work.code, work.main_offset, work.compiler_settings, *work.registry);
+            auto entries = OpenGL::MakeEntries(*work.device, ir, work.shader_type);
             const auto scope = context->Acquire();
             auto program =
                 OpenGL::BuildShader(*work.device, work.shader_type, work.uid, ir, *work.registry);
@@ -196,6 +198,8 @@ void AsyncShaders::ShaderCompilerThread(Core::Frontend::GraphicsContext* context
             result.code = std::move(work.code);
             result.code_b = std::move(work.code_b);
             result.shader_type = work.shader_type;
+            result.entries = std::move(entries);
+            result.registry = std::move(work.registry);
 
             if (work.backend == Backend::OpenGL) {
                 result.program.opengl = std::move(program->source_program);
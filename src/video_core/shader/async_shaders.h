@@ -55,6 +55,8 @@ public:
         std::vector<u64> code;
         std::vector<u64> code_b;
         Tegra::Engines::ShaderType shader_type;
+        OpenGL::ShaderEntries entries;
+        std::shared_ptr<VideoCommon::Shader::Registry> registry;
     };
 
     explicit AsyncShaders(Core::Frontend::EmuWindow& emu_window);
@@ -80,10 +82,13 @@ public:
     /// Pulls completed compiled shaders
     std::vector<Result> GetCompletedWork();
 
+    /// Queues the decoding and compilation of an OpenGL shader. The registry has to hold a
+    /// snapshot of the engine state, so the IR can be built on a worker thread.
     void QueueOpenGLShader(const OpenGL::Device& device, Tegra::Engines::ShaderType shader_type,
                            u64 uid, std::vector<u64> code, std::vector<u64> code_b, u32 main_offset,
                            VideoCommon::Shader::CompilerSettings compiler_settings,
-                           const VideoCommon::Shader::Registry& registry, VAddr cpu_addr);
+                           std::shared_ptr<VideoCommon::Shader::Registry> registry,
+                           VAddr cpu_addr);
 
     void QueueVulkanShader(Vulkan::VKPipelineCache* pp_cache, const Vulkan::VKDevice& device,
                            Vulkan::VKScheduler& scheduler,
@@ -109,7 +114,7 @@ private:
         std::vector<u64> code_b;
         u32 main_offset;
         VideoCommon::Shader::CompilerSettings compiler_settings;
-        std::optional<VideoCommon::Shader::Registry> registry;
+        std::shared_ptr<VideoCommon::Shader::Registry> registry;
         VAddr cpu_address;
 
         // For Vulkan
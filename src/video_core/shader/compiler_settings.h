@@ -21,6 +21,8 @@ std::string CompileDepthAsString(CompileDepth cd);
 struct CompilerSettings {
     CompileDepth depth{CompileDepth::NoFlowStack};
     bool disable_else_derivation{true};
+    /// Allocates the IR from a per shader arena and shares equal immediates and expressions
+    bool use_node_pool{true};
 };
 
 } // namespace VideoCommon::Shader
@@ -20,7 +20,8 @@ Node Comment(std::string text) {
 }
 
 Node Immediate(u32 value) {
-    return MakeNode<ImmediateNode>(value);
+    return InternLeaf(NodePool::LeafKind::Immediate, value,
+                      [value] { return MakeNode<ImmediateNode>(value); });
 }
 
 Node Immediate(s32 value) {
@@ -33,6 +34,13 @@ Node Immediate(f32 value) {
     return Immediate(integral);
 }
 
+bool IsInternableOperation(OperationCode code) {
+    // Operations between Select and the half float comparisons are pure arithmetic and logic,
+    // assignments are statements and may be amended after they are created
+    return code >= OperationCode::Select && code <= OperationCode::Logical2HGreaterEqualWithNan &&
+           code != OperationCode::LogicalAssign;
+}
+
 OperationCode SignedToUnsignedCode(OperationCode operation_code, bool is_signed) {
     if (is_signed) {
         return operation_code;
@@ -13,6 +13,7 @@
 
 #include "common/common_types.h"
 #include "video_core/shader/node.h"
+#include "video_core/shader/node_pool.h"
 
 namespace VideoCommon::Shader {
 
@@ -39,10 +40,12 @@ Node Immediate(f32 value);
 /// Converts an signed operation code to an unsigned operation code
 OperationCode SignedToUnsignedCode(OperationCode operation_code, bool is_signed);
 
+/// Creates a node, nodes are allocated from the calling thread's node pool when there is one
 template <typename T, typename... Args>
 Node MakeNode(Args&&... args) {
     static_assert(std::is_convertible_v<T, NodeData>);
-    return std::make_shared<NodeData>(T(std::forward<Args>(args)...));
+    return std::allocate_shared<NodeData>(NodeAllocator<NodeData>{NodePool::Current()},
+                                          T(std::forward<Args>(args)...));
 }
 
 template <typename T, typename... Args>
@@ -51,15 +54,53 @@ TrackSampler MakeTrackSampler(Args&&... args) {
     return std::make_shared<TrackSamplerData>(T{std::forward<Args>(args)...});
 }
 
+/// Returns true when the operation has no side effects and can be shared between expressions
+bool IsInternableOperation(OperationCode code);
+
+/// Creates a leaf node, sharing it with equal leaves when there is a node pool on this thread
+template <typename Factory>
+Node InternLeaf(NodePool::LeafKind kind, u32 value, Factory&& factory) {
+    if (NodePool* const pool = NodePool::Current()) {
+        return pool->InternLeaf(kind, value, std::forward<Factory>(factory));
+    }
+    return factory();
+}
+
+/// Creates an arithmetic operation, sharing it with equal operations when there is a node pool
+template <typename... Operands>
+Node ArithmeticOperation(OperationCode code, MetaArithmetic meta, Operands&&... operands) {
+    if constexpr (sizeof...(Operands) <= MAX_INTERNED_OPERANDS &&
+                  (std::is_convertible_v<Operands, const Node&> && ...)) {
+        NodePool* const pool = NodePool::Current();
+        if (pool && IsInternableOperation(code)) {
+            const OperationKey key{
+                .code = code,
+                .precise = meta.precise,
+                .num_operands = sizeof...(Operands),
+                .operands = {static_cast<const Node&>(operands).get()...},
+            };
+            return pool->InternOperation(key, [&] {
+                return MakeNode<OperationNode>(code, Meta{meta},
+                                               std::forward<Operands>(operands)...);
+            });
+        }
+    }
+    return MakeNode<OperationNode>(code, Meta{meta}, std::forward<Operands>(operands)...);
+}
+
 template <typename... Args>
 Node Operation(OperationCode code, Args&&... args) {
     if constexpr (sizeof...(args) == 0) {
         return MakeNode<OperationNode>(code);
+    } else if constexpr (std::is_same_v<
+                             std::decay_t<std::tuple_element_t<0, std::tuple<Args...>>>,
+                             MetaArithmetic>) {
+        return ArithmeticOperation(code, std::forward<Args>(args)...);
     } else if constexpr (std::is_convertible_v<std::tuple_element_t<0, std::tuple<Args...>>,
                                                Meta>) {
         return MakeNode<OperationNode>(code, std::forward<Args>(args)...);
     } else {
-        return MakeNode<OperationNode>(code, Meta{}, std::forward<Args>(args)...);
+        return ArithmeticOperation(code, MetaArithmetic{}, std::forward<Args>(args)...);
     }
 }
 
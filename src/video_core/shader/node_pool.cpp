@@ -0,0 +1,64 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstdint>
+#include <boost/functional/hash.hpp>
+
+#include "common/alignment.h"
+#include "common/assert.h"
+#include "video_core/shader/node_pool.h"
+
+namespace VideoCommon::Shader {
+
+namespace {
+thread_local NodePool* current_pool = nullptr;
+} // Anonymous namespace
+
+std::size_t OperationKeyHash::operator()(const OperationKey& key) const noexcept {
+    std::size_t seed = static_cast<std::size_t>(key.code);
+    boost::hash_combine(seed, key.precise);
+    for (std::size_t index = 0; index < key.num_operands; ++index) {
+        boost::hash_combine(seed, key.operands[index]);
+    }
+    return seed;
+}
+
+NodePool::Scope::Scope(NodePool& pool) : previous{current_pool} {
+    current_pool = &pool;
+}
+
+NodePool::Scope::~Scope() {
+    current_pool = previous;
+}
+
+NodePool::NodePool() = default;
+
+NodePool::~NodePool() = default;
+
+void* NodePool::Allocate(std::size_t size, std::size_t alignment) {
+    ASSERT(alignment <= alignof(std::max_align_t));
+    const auto address = reinterpret_cast<std::uintptr_t>(cursor);
+    const std::size_t padding = Common::AlignUp(address, alignment) - address;
+    if (cursor == nullptr || padding + size > remaining) {
+        const std::size_t chunk_size = std::max(CHUNK_SIZE, size);
+        // Chunks are left uninitialized, nodes are constructed in place
+        chunks.emplace_back(new u8[chunk_size]);
+        cursor = chunks.back().get();
+        remaining = chunk_size;
+        return Allocate(size, alignment);
+    }
+    u8* const result = cursor + padding;
+    cursor = result + size;
+    remaining -= padding + size;
+    allocated_bytes += size;
+    ++num_allocations;
+    return result;
+}
+
+NodePool* NodePool::Current() {
+    return current_pool;
+}
+
+} // namespace VideoCommon::Shader
@@ -0,0 +1,176 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "common/common_types.h"
+#include "video_core/shader/node.h"
+
+namespace VideoCommon::Shader {
+
+/// Maximum number of operands an operation can have to be interned
+constexpr std::size_t MAX_INTERNED_OPERANDS = 4;
+
+/// Identifies a pure operation by its code, precision and operand identities
+struct OperationKey {
+    OperationCode code{};
+    bool precise{};
+    std::size_t num_operands{};
+    std::array<const NodeData*, MAX_INTERNED_OPERANDS> operands{};
+
+    bool operator==(const OperationKey& rhs) const noexcept {
+        return code == rhs.code && precise == rhs.precise && num_operands == rhs.num_operands &&
+               operands == rhs.operands;
+    }
+};
+
+struct OperationKeyHash {
+    std::size_t operator()(const OperationKey& key) const noexcept;
+};
+
+/**
+ * Monotonic arena backing the IR nodes of a shader. Nodes allocated from it share the lifetime of
+ * the pool, so individual deallocations are no-ops and the memory is released at once when the
+ * pool is destroyed. The pool must outlive every node allocated from it.
+ *
+ * The pool also hash-conses immutable nodes: leaves and pure operations with equal contents are
+ * created once and shared through the rest of the shader.
+ */
+class NodePool final {
+public:
+    /// Kinds of leaf nodes that can be interned
+    enum class LeafKind : u32 {
+        Immediate,
+        Register,
+    };
+
+    /// Makes a pool current on the calling thread for the lifetime of the scope
+    class Scope final {
+    public:
+        explicit Scope(NodePool& pool);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        NodePool* previous;
+    };
+
+    NodePool();
+    ~NodePool();
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    /// Allocates memory with the given size and alignment from the arena
+    void* Allocate(std::size_t size, std::size_t alignment);
+
+    /// Returns the interned leaf for the given kind and value, creating it with factory on a miss
+    template <typename Factory>
+    Node InternLeaf(LeafKind kind, u32 value, Factory&& factory) {
+        const u64 key = (static_cast<u64>(kind) << 32) | value;
+        const auto [it, is_new] = leaves.try_emplace(key);
+        if (is_new) {
+            it->second = factory();
+        } else {
+            ++num_interned;
+        }
+        return it->second;
+    }
+
+    /// Returns the interned operation for the given key, creating it with factory on a miss
+    template <typename Factory>
+    Node InternOperation(const OperationKey& key, Factory&& factory) {
+        const auto [it, is_new] = operations.try_emplace(key);
+        if (is_new) {
+            it->second = factory();
+        } else {
+            ++num_interned;
+        }
+        return it->second;
+    }
+
+    /// Returns the number of bytes handed out by the pool
+    std::size_t GetAllocatedBytes() const {
+        return allocated_bytes;
+    }
+
+    /// Returns the number of allocations served by the pool
+    std::size_t GetNumAllocations() const {
+        return num_allocations;
+    }
+
+    /// Returns the number of node creations avoided by sharing an equal node
+    std::size_t GetNumInterned() const {
+        return num_interned;
+    }
+
+    /// Returns the pool nodes are allocated from on the calling thread, null when nodes are
+    /// allocated from the heap
+    static NodePool* Current();
+
+private:
+    static constexpr std::size_t CHUNK_SIZE = 64 * 1024;
+
+    std::vector<std::unique_ptr<u8[]>> chunks;
+    u8* cursor = nullptr;
+    std::size_t remaining = 0;
+    std::size_t allocated_bytes = 0;
+    std::size_t num_allocations = 0;
+    std::size_t num_interned = 0;
+
+    // Declared after the chunks, interned nodes are released before the memory backing them
+    std::unordered_map<u64, Node> leaves;
+    std::unordered_map<OperationKey, Node, OperationKeyHash> operations;
+};
+
+/// Standard allocator that takes memory from a node pool, or from the heap when there is none
+template <typename T>
+class NodeAllocator {
+public:
+    using value_type = T;
+
+    explicit NodeAllocator(NodePool* pool) noexcept : pool{pool} {}
+
+    template <typename U>
+    NodeAllocator(const NodeAllocator<U>& other) noexcept : pool{other.pool} {}
+
+    T* allocate(std::size_t n) {
+        if (pool) {
+            return static_cast<T*>(pool->Allocate(n * sizeof(T), alignof(T)));
+        }
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* pointer, std::size_t n) noexcept {
+        if (!pool) {
+            std::allocator<T>{}.deallocate(pointer, n);
+        }
+    }
+
+    template <typename U>
+    bool operator==(const NodeAllocator<U>& rhs) const noexcept {
+        return pool == rhs.pool;
+    }
+
+    template <typename U>
+    bool operator!=(const NodeAllocator<U>& rhs) const noexcept {
+        return pool != rhs.pool;
+    }
+
+private:
+    template <typename U>
+    friend class NodeAllocator;
+
+    NodePool* pool;
+};
+
+} // namespace VideoCommon::Shader
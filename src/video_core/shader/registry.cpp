@@ -7,6 +7,7 @@
 
 #include "common/assert.h"
 #include "common/common_types.h"
+#include "video_core/engines/const_buffer_engine_snapshot.h"
 #include "video_core/engines/kepler_compute.h"
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/engines/shader_type.h"
@@ -140,6 +141,23 @@ void Registry::InsertBindlessSampler(u32 buffer, u32 offset, SamplerDescriptor s
     bindless_samplers.insert_or_assign({buffer, offset}, sampler);
 }
 
+bool Registry::SnapshotEngine() {
+    if (!engine) {
+        return false;
+    }
+    engine_snapshot = engine->CreateSnapshot(stage);
+    if (!engine_snapshot) {
+        return false;
+    }
+    engine = engine_snapshot.get();
+    return true;
+}
+
+void Registry::BindEngine(ConstBufferEngineInterface& new_engine) {
+    engine = &new_engine;
+    engine_snapshot.reset();
+}
+
 bool Registry::IsConsistent() const {
     if (!engine) {
         return true;
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <array>
+#include <memory>
 #include <optional>
 #include <type_traits>
 #include <unordered_map>
@@ -118,6 +119,14 @@ public:
     /// Inserts a bindless sampler key.
     void InsertBindlessSampler(u32 buffer, u32 offset, Tegra::Engines::SamplerDescriptor sampler);
 
+    /// Replaces the engine with a snapshot of its current state, so the registry can be used to
+    /// decode a shader on a thread other than the GPU thread. Returns false and keeps the engine
+    /// when its state can't be copied.
+    bool SnapshotEngine();
+
+    /// Binds the registry to a live engine again, releasing any snapshot.
+    void BindEngine(Tegra::Engines::ConstBufferEngineInterface& new_engine);
+
     /// Checks keys and samplers against engine's current const buffers.
     /// Returns true if they are the same value, false otherwise.
     bool IsConsistent() const;
@@ -160,6 +169,7 @@ private:
     const Tegra::Engines::ShaderType stage;
     VideoCore::GuestDriverProfile stored_guest_driver_profile;
     Tegra::Engines::ConstBufferEngineInterface* engine = nullptr;
+    std::shared_ptr<Tegra::Engines::ConstBufferEngineSnapshot> engine_snapshot;
     KeyMap keys;
     BoundSamplerMap bound_samplers;
     SeparateSamplerMap separate_samplers;
@@ -28,6 +28,10 @@ using Tegra::Shader::Register;
 ShaderIR::ShaderIR(const ProgramCode& program_code, u32 main_offset, CompilerSettings settings,
                    Registry& registry)
     : program_code{program_code}, main_offset{main_offset}, settings{settings}, registry{registry} {
+    std::optional<NodePool::Scope> pool_scope;
+    if (settings.use_node_pool) {
+        pool_scope.emplace(node_pool);
+    }
     Decode();
     PostDecode();
 }
@@ -38,7 +42,8 @@ Node ShaderIR::GetRegister(Register reg) {
     if (reg != Register::ZeroIndex) {
         used_registers.insert(static_cast<u32>(reg));
     }
-    return MakeNode<GprNode>(reg);
+    return InternLeaf(NodePool::LeafKind::Register, static_cast<u32>(reg),
+                      [reg] { return MakeNode<GprNode>(reg); });
 }
 
 Node ShaderIR::GetCustomVariable(u32 id) {
@@ -20,6 +20,7 @@
 #include "video_core/shader/compiler_settings.h"
 #include "video_core/shader/memory_util.h"
 #include "video_core/shader/node.h"
+#include "video_core/shader/node_pool.h"
 #include "video_core/shader/registry.h"
 
 namespace VideoCommon::Shader {
@@ -111,6 +112,10 @@ public:
         return used_global_memory;
     }
 
+    const NodePool& GetNodePool() const {
+        return node_pool;
+    }
+
     std::size_t GetLength() const {
         return static_cast<std::size_t>(coverage_end * sizeof(u64));
     }
@@ -443,6 +448,9 @@ private:
     u32 coverage_begin{};
     u32 coverage_end{};
 
+    // Declared before any member holding nodes, so it is destroyed after them
+    NodePool node_pool;
+
     std::map<u32, NodeBlock> basic_blocks;
     NodeBlock global_code;
     ASTManager program_manager{true, true};
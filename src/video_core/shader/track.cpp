@@ -62,6 +62,8 @@ std::optional<std::pair<Node, Node>> DecoupleIndirectRead(const OperationNode& o
 
 bool AmendNodeCv(std::size_t amend_index, Node node) {
     if (const auto operation = std::get_if<OperationNode>(&*node)) {
+        // Amended nodes are statements found by TrackRegister, assignments are never interned
+        ASSERT(!IsInternableOperation(operation->GetCode()));
         operation->SetAmendIndex(amend_index);
         return true;
     }
@@ -6,9 +6,11 @@
 #include "common/assert.h"
 #include "common/common_types.h"
 #include "common/microprofile.h"
+#include "common/thread_worker.h"
 #include "video_core/memory_manager.h"
 #include "video_core/texture_cache/surface_base.h"
 #include "video_core/texture_cache/surface_params.h"
+#include "video_core/textures/bcn.h"
 #include "video_core/textures/convert.h"
 
 namespace VideoCommon {
@@ -17,6 +19,8 @@ MICROPROFILE_DEFINE(GPU_Load_Texture, "GPU", "Texture Load", MP_RGB(128, 192, 12
 MICROPROFILE_DEFINE(GPU_Flush_Texture, "GPU", "Texture Flush", MP_RGB(128, 192, 128));
 
 using Tegra::Texture::ConvertFromGuestToHost;
+using Tegra::Texture::GetConvertedFormat;
+using Tegra::Texture::BCn::IsBCnFormat;
 using VideoCore::MortonSwizzleMode;
 using VideoCore::Surface::IsPixelFormatASTC;
 using VideoCore::Surface::PixelFormat;
@@ -26,11 +30,17 @@ StagingCache::StagingCache() = default;
 StagingCache::~StagingCache() = default;
 
 SurfaceBaseImpl::SurfaceBaseImpl(GPUVAddr gpu_addr, const SurfaceParams& params,
-                                 bool is_astc_supported)
+                                 bool is_astc_supported, bool is_bcn_supported)
     : params{params}, gpu_addr{gpu_addr}, mipmap_sizes(params.num_levels),
       mipmap_offsets(params.num_levels) {
-    is_converted = IsPixelFormatASTC(params.pixel_format) && !is_astc_supported;
-    host_memory_size = params.GetHostSizeInBytes(is_converted);
+    if ((IsPixelFormatASTC(params.pixel_format) && !is_astc_supported) ||
+        (IsBCnFormat(params.pixel_format) && !is_bcn_supported)) {
+        host_format = GetConvertedFormat(params.pixel_format, is_bcn_supported);
+    } else {
+        host_format = params.pixel_format;
+    }
+    is_converted = host_format != params.pixel_format;
+    host_memory_size = params.GetHostSizeInBytes(host_format);
 
     std::size_t offset = 0;
     for (u32 level = 0; level < params.num_levels; ++level) {
@@ -163,113 +173,138 @@ std::vector<CopyParams> SurfaceBaseImpl::BreakDownNonLayered(const SurfaceParams
     return result;
 }
 
-void SurfaceBaseImpl::SwizzleFunc(MortonSwizzleMode mode, u8* memory, const SurfaceParams& params,
-                                  u8* buffer, u32 level) {
+void SurfaceBaseImpl::SwizzleSlice(MortonSwizzleMode mode, u8* guest_data, u8* host_data,
+                                   u32 level, u32 layer) const {
     const u32 width{params.GetMipWidth(level)};
     const u32 height{params.GetMipHeight(level)};
     const u32 block_height{params.GetMipBlockHeight(level)};
     const u32 block_depth{params.GetMipBlockDepth(level)};
+    const u32 depth{params.is_layered ? 1U : params.GetMipDepth(level)};
+    MortonSwizzle(mode, params.pixel_format, width, block_height, height, block_depth, depth,
+                  params.tile_width_spacing, host_data,
+                  guest_data + mipmap_offsets[level] + layer * layer_size);
+}
 
-    std::size_t guest_offset{mipmap_offsets[level]};
-    if (params.is_layered) {
-        std::size_t host_offset = 0;
-        const std::size_t guest_stride = layer_size;
-        const std::size_t host_stride = params.GetHostLayerSize(level);
-        for (u32 layer = 0; layer < params.depth; ++layer) {
-            MortonSwizzle(mode, params.pixel_format, width, block_height, height, block_depth, 1,
-                          params.tile_width_spacing, buffer + host_offset, memory + guest_offset);
-            guest_offset += guest_stride;
-            host_offset += host_stride;
-        }
-    } else {
-        MortonSwizzle(mode, params.pixel_format, width, block_height, height, block_depth,
-                      params.GetMipDepth(level), params.tile_width_spacing, buffer,
-                      memory + guest_offset);
+std::size_t SurfaceBaseImpl::GetHostSliceSize(u32 level) const {
+    return params.is_layered ? params.GetHostLayerSize(level) : params.GetHostMipmapSize(level);
+}
+
+void SurfaceBaseImpl::DecodeSlice(u8* guest_data, u8* host_data, u32 level, u32 layer) const {
+    const u32 width{params.GetMipWidth(level)};
+    const u32 height{params.GetMipHeight(level)};
+    const u32 depth{params.is_layered ? 1U : params.GetMipDepth(level)};
+    const std::size_t slice_size{GetHostSliceSize(level)};
+    if (is_converted) {
+        // Converted slices are decoded into a scratch buffer owned by the worker, so the
+        // conversion can run right after the swizzle without overlapping other slices' output.
+        thread_local std::vector<u8> scratch;
+        scratch.resize(slice_size);
+        SwizzleSlice(MortonSwizzleMode::MortonToLinear, guest_data, scratch.data(), level, layer);
+
+        const std::size_t out_offset{params.GetHostMipmapLevelOffset(level, host_format) +
+                                     layer * params.GetConvertedMipmapSize(level, host_format)};
+        ConvertFromGuestToHost(scratch.data(), host_data + out_offset, params.pixel_format,
+                               host_format, width, height, depth, true);
+        return;
+    }
+    u8* const slice{host_data + params.GetHostMipmapLevelOffset(level, host_format) +
+                    layer * slice_size};
+    SwizzleSlice(MortonSwizzleMode::MortonToLinear, guest_data, slice, level, layer);
+    if (params.pixel_format == PixelFormat::S8_UINT_D24_UNORM) {
+        ConvertFromGuestToHost(slice, slice, params.pixel_format, host_format, width, height,
+                               depth, true);
     }
 }
 
-void SurfaceBaseImpl::LoadBuffer(Tegra::MemoryManager& memory_manager,
-                                 StagingCache& staging_cache) {
-    MICROPROFILE_SCOPE(GPU_Load_Texture);
-    auto& staging_buffer = staging_cache.GetBuffer(0);
-    u8* host_ptr;
-    // Use an extra temporal buffer
-    auto& tmp_buffer = staging_cache.GetBuffer(1);
-    tmp_buffer.resize(guest_memory_size);
-    host_ptr = tmp_buffer.data();
-    memory_manager.ReadBlockUnsafe(gpu_addr, host_ptr, guest_memory_size);
+void SurfaceBaseImpl::EncodeSlice(u8* guest_data, u8* host_data, u32 level, u32 layer) const {
+    const std::size_t slice_size{GetHostSliceSize(level)};
+    u8* const slice{host_data + params.GetHostMipmapLevelOffset(level, params.pixel_format) +
+                    layer * slice_size};
+    SwizzleSlice(MortonSwizzleMode::LinearToMorton, guest_data, slice, level, layer);
+}
 
-    if (params.is_tiled) {
-        ASSERT_MSG(params.block_width == 0, "Block width is defined as {} on texture target {}",
-                   params.block_width, static_cast<u32>(params.target));
-        for (u32 level = 0; level < params.num_levels; ++level) {
-            const std::size_t host_offset{params.GetHostMipmapLevelOffset(level, false)};
-            SwizzleFunc(MortonSwizzleMode::MortonToLinear, host_ptr, params,
-                        staging_buffer.data() + host_offset, level);
+template <typename Func>
+void SurfaceBaseImpl::ForEachSlice(Common::ThreadWorker* workers, Func&& func) const {
+    const u32 num_layers{params.is_layered ? params.depth : 1U};
+    const u32 num_levels{params.num_levels};
+    if (workers == nullptr || guest_memory_size < PARALLEL_SWIZZLE_THRESHOLD ||
+        num_layers * num_levels == 1) {
+        for (u32 layer = 0; layer < num_layers; ++layer) {
+            for (u32 level = 0; level < num_levels; ++level) {
+                func(level, layer);
+            }
+        }
+        return;
+    }
+    if (num_layers >= workers->NumWorkers()) {
+        // Enough layers to keep every worker busy, queue whole layers to reduce the number of
+        // tiny tasks coming from the smaller mipmap levels.
+        for (u32 layer = 0; layer < num_layers; ++layer) {
+            workers->QueueWork([&func, num_levels, layer] {
+                for (u32 level = 0; level < num_levels; ++level) {
+                    func(level, layer);
+                }
+            });
         }
     } else {
-        ASSERT_MSG(params.num_levels == 1, "Linear mipmap loading is not implemented");
-        const u32 bpp{params.GetBytesPerPixel()};
-        const u32 block_width{params.GetDefaultBlockWidth()};
-        const u32 block_height{params.GetDefaultBlockHeight()};
-        const u32 width{(params.width + block_width - 1) / block_width};
-        const u32 height{(params.height + block_height - 1) / block_height};
-        const u32 copy_size{width * bpp};
-        if (params.pitch == copy_size) {
-            std::memcpy(staging_buffer.data(), host_ptr, params.GetHostSizeInBytes(false));
-        } else {
-            const u8* start{host_ptr};
-            u8* write_to{staging_buffer.data()};
-            for (u32 h = height; h > 0; --h) {
-                std::memcpy(write_to, start, copy_size);
-                start += params.pitch;
-                write_to += copy_size;
+        for (u32 layer = 0; layer < num_layers; ++layer) {
+            for (u32 level = 0; level < num_levels; ++level) {
+                workers->QueueWork([&func, level, layer] { func(level, layer); });
             }
         }
     }
+    workers->WaitForRequests();
+}
 
-    if (!is_converted && params.pixel_format != PixelFormat::S8_UINT_D24_UNORM) {
+void SurfaceBaseImpl::DecodeGuestData(u8* guest_data, u8* host_data,
+                                      Common::ThreadWorker* workers) const {
+    if (params.is_tiled) {
+        ASSERT_MSG(params.block_width == 0, "Block width is defined as {} on texture target {}",
+                   params.block_width, static_cast<u32>(params.target));
+        ForEachSlice(workers, [this, guest_data, host_data](u32 level, u32 layer) {
+            DecodeSlice(guest_data, host_data, level, layer);
+        });
         return;
     }
 
-    for (u32 level = params.num_levels; level--;) {
-        const std::size_t in_host_offset{params.GetHostMipmapLevelOffset(level, false)};
-        const std::size_t out_host_offset{params.GetHostMipmapLevelOffset(level, is_converted)};
-        u8* const in_buffer = staging_buffer.data() + in_host_offset;
-        u8* const out_buffer = staging_buffer.data() + out_host_offset;
-        ConvertFromGuestToHost(in_buffer, out_buffer, params.pixel_format,
-                               params.GetMipWidth(level), params.GetMipHeight(level),
-                               params.GetMipDepth(level), true, true);
+    ASSERT_MSG(params.num_levels == 1, "Linear mipmap loading is not implemented");
+    const u32 bpp{params.GetBytesPerPixel()};
+    const u32 block_width{params.GetDefaultBlockWidth()};
+    const u32 block_height{params.GetDefaultBlockHeight()};
+    const u32 width{(params.width + block_width - 1) / block_width};
+    const u32 height{(params.height + block_height - 1) / block_height};
+    const u32 copy_size{width * bpp};
+    if (params.pitch == copy_size) {
+        std::memcpy(host_data, guest_data, params.GetHostSizeInBytes(params.pixel_format));
+    } else {
+        const u8* start{guest_data};
+        u8* write_to{host_data};
+        for (u32 h = height; h > 0; --h) {
+            std::memcpy(write_to, start, copy_size);
+            start += params.pitch;
+            write_to += copy_size;
+        }
     }
-}
 
-void SurfaceBaseImpl::FlushBuffer(Tegra::MemoryManager& memory_manager,
-                                  StagingCache& staging_cache) {
-    MICROPROFILE_SCOPE(GPU_Flush_Texture);
-    auto& staging_buffer = staging_cache.GetBuffer(0);
-    u8* host_ptr;
-
-    // Use an extra temporal buffer
-    auto& tmp_buffer = staging_cache.GetBuffer(1);
-    tmp_buffer.resize(guest_memory_size);
-    host_ptr = tmp_buffer.data();
-
-    if (params.target == SurfaceTarget::Texture3D) {
-        // Special case for 3D texture segments
-        memory_manager.ReadBlockUnsafe(gpu_addr, host_ptr, guest_memory_size);
+    if (!is_converted && params.pixel_format != PixelFormat::S8_UINT_D24_UNORM) {
+        return;
     }
+    ConvertFromGuestToHost(host_data, host_data, params.pixel_format, host_format,
+                           params.GetMipWidth(0), params.GetMipHeight(0), params.GetMipDepth(0),
+                           true);
+}
 
+void SurfaceBaseImpl::EncodeGuestData(u8* guest_data, u8* host_data,
+                                      Common::ThreadWorker* workers) const {
     if (params.is_tiled) {
         ASSERT_MSG(params.block_width == 0, "Block width is defined as {}", params.block_width);
-        for (u32 level = 0; level < params.num_levels; ++level) {
-            const std::size_t host_offset{params.GetHostMipmapLevelOffset(level, false)};
-            SwizzleFunc(MortonSwizzleMode::LinearToMorton, host_ptr, params,
-                        staging_buffer.data() + host_offset, level);
-        }
+        ForEachSlice(workers, [this, guest_data, host_data](u32 level, u32 layer) {
+            EncodeSlice(guest_data, host_data, level, layer);
+        });
     } else if (params.IsBuffer()) {
         // Buffers don't have pitch or any fancy layout property. We can just memcpy them to guest
         // memory.
-        std::memcpy(host_ptr, staging_buffer.data(), guest_memory_size);
+        std::memcpy(guest_data, host_data, guest_memory_size);
     } else {
         ASSERT(params.target == SurfaceTarget::Texture2D);
         ASSERT(params.num_levels == 1);
@@ -277,10 +312,10 @@ void SurfaceBaseImpl::FlushBuffer(Tegra::MemoryManager& memory_manager,
         const u32 bpp{params.GetBytesPerPixel()};
         const u32 copy_size{params.width * bpp};
         if (params.pitch == copy_size) {
-            std::memcpy(host_ptr, staging_buffer.data(), guest_memory_size);
+            std::memcpy(guest_data, host_data, guest_memory_size);
         } else {
-            u8* start{host_ptr};
-            const u8* read_to{staging_buffer.data()};
+            u8* start{guest_data};
+            const u8* read_to{host_data};
             for (u32 h = params.height; h > 0; --h) {
                 std::memcpy(start, read_to, copy_size);
                 start += params.pitch;
@@ -288,7 +323,41 @@ void SurfaceBaseImpl::FlushBuffer(Tegra::MemoryManager& memory_manager,
             }
         }
     }
-    memory_manager.WriteBlockUnsafe(gpu_addr, host_ptr, guest_memory_size);
+}
+
+void SurfaceBaseImpl::LoadBuffer(Tegra::MemoryManager& memory_manager, StagingCache& staging_cache,
+                                 Common::ThreadWorker* workers) {
+    MICROPROFILE_SCOPE(GPU_Load_Texture);
+    auto& staging_buffer = staging_cache.GetBuffer(0);
+    if (u8* const guest_ptr = memory_manager.GetContiguousPointer(gpu_addr, guest_memory_size)) {
+        // Decode straight from guest memory when it is contiguous in the host
+        DecodeGuestData(guest_ptr, staging_buffer.data(), workers);
+        return;
+    }
+    // Use an extra temporal buffer
+    auto& tmp_buffer = staging_cache.GetBuffer(1);
+    tmp_buffer.resize(guest_memory_size);
+    memory_manager.ReadBlockUnsafe(gpu_addr, tmp_buffer.data(), guest_memory_size);
+
+    DecodeGuestData(tmp_buffer.data(), staging_buffer.data(), workers);
+}
+
+void SurfaceBaseImpl::FlushBuffer(Tegra::MemoryManager& memory_manager,
+                                  StagingCache& staging_cache, Common::ThreadWorker* workers) {
+    MICROPROFILE_SCOPE(GPU_Flush_Texture);
+    auto& staging_buffer = staging_cache.GetBuffer(0);
+
+    // Use an extra temporal buffer
+    auto& tmp_buffer = staging_cache.GetBuffer(1);
+    tmp_buffer.resize(guest_memory_size);
+
+    if (params.target == SurfaceTarget::Texture3D) {
+        // Special case for 3D texture segments
+        memory_manager.ReadBlockUnsafe(gpu_addr, tmp_buffer.data(), guest_memory_size);
+    }
+
+    EncodeGuestData(tmp_buffer.data(), staging_buffer.data(), workers);
+    memory_manager.WriteBlockUnsafe(gpu_addr, tmp_buffer.data(), guest_memory_size);
 }
 
 } // namespace VideoCommon
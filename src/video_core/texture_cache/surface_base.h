@@ -16,6 +16,10 @@
 #include "video_core/texture_cache/surface_params.h"
 #include "video_core/texture_cache/surface_view.h"
 
+namespace Common {
+class ThreadWorker;
+}
+
 namespace Tegra {
 class MemoryManager;
 }
@@ -60,9 +64,19 @@ private:
 
 class SurfaceBaseImpl {
 public:
-    void LoadBuffer(Tegra::MemoryManager& memory_manager, StagingCache& staging_cache);
+    void LoadBuffer(Tegra::MemoryManager& memory_manager, StagingCache& staging_cache,
+                    Common::ThreadWorker* workers = nullptr);
+
+    void FlushBuffer(Tegra::MemoryManager& memory_manager, StagingCache& staging_cache,
+                     Common::ThreadWorker* workers = nullptr);
+
+    /// Deswizzles and converts guest_data into the host layout in host_data. Each mipmap level
+    /// and layer is processed as an independent task on the given workers, if any.
+    void DecodeGuestData(u8* guest_data, u8* host_data, Common::ThreadWorker* workers) const;
 
-    void FlushBuffer(Tegra::MemoryManager& memory_manager, StagingCache& staging_cache);
+    /// Swizzles the host layout in host_data back into guest_data, the inverse of DecodeGuestData
+    /// without the format conversion.
+    void EncodeGuestData(u8* guest_data, u8* host_data, Common::ThreadWorker* workers) const;
 
     GPUVAddr GetGpuAddr() const {
         return gpu_addr;
@@ -119,6 +133,11 @@ public:
         return is_converted;
     }
 
+    /// Returns the format uploaded to the host, it differs from the guest format when converted.
+    VideoCore::Surface::PixelFormat GetHostFormat() const {
+        return host_format;
+    }
+
     bool MatchFormat(VideoCore::Surface::PixelFormat pixel_format) const {
         return params.pixel_format == pixel_format;
     }
@@ -149,7 +168,7 @@ public:
 
 protected:
     explicit SurfaceBaseImpl(GPUVAddr gpu_addr, const SurfaceParams& params,
-                             bool is_astc_supported);
+                             bool is_astc_supported, bool is_bcn_supported);
     ~SurfaceBaseImpl() = default;
 
     virtual void DecorateSurfaceName() = 0;
@@ -162,13 +181,27 @@ protected:
     VAddr cpu_addr{};
     VAddr cpu_addr_end{};
     bool is_converted{};
+    VideoCore::Surface::PixelFormat host_format{};
 
     std::vector<std::size_t> mipmap_sizes;
     std::vector<std::size_t> mipmap_offsets;
 
 private:
-    void SwizzleFunc(MortonSwizzleMode mode, u8* memory, const SurfaceParams& params, u8* buffer,
-                     u32 level);
+    /// Surfaces smaller than this in guest memory are swizzled on the calling thread
+    static constexpr std::size_t PARALLEL_SWIZZLE_THRESHOLD = 256 * 1024;
+
+    void SwizzleSlice(MortonSwizzleMode mode, u8* guest_data, u8* host_data, u32 level,
+                      u32 layer) const;
+
+    void DecodeSlice(u8* guest_data, u8* host_data, u32 level, u32 layer) const;
+
+    void EncodeSlice(u8* guest_data, u8* host_data, u32 level, u32 layer) const;
+
+    /// Returns the size in host memory of a single layer of a mipmap level.
+    std::size_t GetHostSliceSize(u32 level) const;
+
+    template <typename Func>
+    void ForEachSlice(Common::ThreadWorker* workers, Func&& func) const;
 
     std::vector<CopyParams> BreakDownLayered(const SurfaceParams& in_params) const;
 
@@ -245,6 +278,14 @@ public:
         return modification_tick;
     }
 
+    void MarkAsUsed(u64 frame) {
+        last_use_frame = frame;
+    }
+
+    u64 GetLastUseFrame() const {
+        return last_use_frame;
+    }
+
     TView EmplaceOverview(const SurfaceParams& overview_params) {
         const u32 num_layers{(params.is_layered && !overview_params.is_layered) ? 1 : params.depth};
         return GetView(ViewParams(overview_params.target, 0, num_layers, 0, params.num_levels));
@@ -298,8 +339,8 @@ public:
 
 protected:
     explicit SurfaceBase(const GPUVAddr gpu_addr, const SurfaceParams& params,
-                         bool is_astc_supported)
-        : SurfaceBaseImpl(gpu_addr, params, is_astc_supported) {}
+                         bool is_astc_supported, bool is_bcn_supported)
+        : SurfaceBaseImpl(gpu_addr, params, is_astc_supported, is_bcn_supported) {}
 
     ~SurfaceBase() = default;
 
@@ -328,6 +369,7 @@ private:
     bool is_sync_pending{};
     u32 index{NO_RT};
     u64 modification_tick{};
+    u64 last_use_frame{};
 };
 
 } // namespace VideoCommon
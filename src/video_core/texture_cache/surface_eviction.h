@@ -0,0 +1,57 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "common/common_types.h"
+
+namespace VideoCommon {
+
+/// Frames a surface has to stay unused before it can be evicted, so surfaces still in use by
+/// in-flight GPU work are never released.
+constexpr u64 MIN_EVICTION_AGE = 8;
+
+/// Returns true when a surface hasn't been used for long enough to be evicted.
+template <typename TSurface>
+bool IsEvictionAged(const TSurface& surface, u64 frame) {
+    return frame - surface->GetLastUseFrame() >= MIN_EVICTION_AGE;
+}
+
+/// Returns true when a registered surface can be dropped and later reloaded from guest memory.
+template <typename TSurface>
+bool IsEvictable(const TSurface& surface, u64 frame) {
+    return !surface->IsModified() && !surface->IsRenderTarget() && !surface->IsProtected() &&
+           !surface->IsSyncPending() && IsEvictionAged(surface, frame);
+}
+
+/**
+ * Releases surfaces from least to most recently used until the cache is within its budget.
+ *
+ * @param candidates  Surfaces that may be released, sorted by the call.
+ * @param over_budget Returns true while the cache uses more memory than its budget.
+ * @param release     Releases a surface, reducing the memory seen by over_budget.
+ * @returns The number of surfaces released.
+ */
+template <typename TSurface, typename OverBudget, typename Release>
+u64 EvictLeastRecentlyUsed(std::vector<TSurface>& candidates, OverBudget&& over_budget,
+                           Release&& release) {
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const TSurface& lhs, const TSurface& rhs) {
+                         return lhs->GetLastUseFrame() < rhs->GetLastUseFrame();
+                     });
+    u64 num_evicted = 0;
+    for (const TSurface& surface : candidates) {
+        if (!over_budget()) {
+            break;
+        }
+        release(surface);
+        ++num_evicted;
+    }
+    return num_evicted;
+}
+
+} // namespace VideoCommon
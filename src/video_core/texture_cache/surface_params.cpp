@@ -321,11 +321,11 @@ std::size_t SurfaceParams::GetGuestMipmapLevelOffset(u32 level) const {
     return offset;
 }
 
-std::size_t SurfaceParams::GetHostMipmapLevelOffset(u32 level, bool is_converted) const {
+std::size_t SurfaceParams::GetHostMipmapLevelOffset(u32 level, PixelFormat host_format) const {
     std::size_t offset = 0;
-    if (is_converted) {
+    if (host_format != pixel_format) {
         for (u32 i = 0; i < level; ++i) {
-            offset += GetConvertedMipmapSize(i) * GetNumLayers();
+            offset += GetConvertedMipmapSize(i, host_format) * GetNumLayers();
         }
     } else {
         for (u32 i = 0; i < level; ++i) {
@@ -335,12 +335,14 @@ std::size_t SurfaceParams::GetHostMipmapLevelOffset(u32 level, bool is_converted
     return offset;
 }
 
-std::size_t SurfaceParams::GetConvertedMipmapSize(u32 level) const {
-    constexpr std::size_t rgba8_bpp = 4ULL;
-    const std::size_t mip_width = GetMipWidth(level);
-    const std::size_t mip_height = GetMipHeight(level);
+std::size_t SurfaceParams::GetConvertedMipmapSize(u32 level, PixelFormat host_format) const {
+    const std::size_t block_width = VideoCore::Surface::GetDefaultBlockWidth(host_format);
+    const std::size_t block_height = VideoCore::Surface::GetDefaultBlockHeight(host_format);
+    const std::size_t mip_width = Common::AlignUp(GetMipWidth(level), block_width) / block_width;
+    const std::size_t mip_height =
+        Common::AlignUp(GetMipHeight(level), block_height) / block_height;
     const std::size_t mip_depth = is_layered ? 1 : GetMipDepth(level);
-    return mip_width * mip_height * mip_depth * rgba8_bpp;
+    return mip_width * mip_height * mip_depth * VideoCore::Surface::GetBytesPerPixel(host_format);
 }
 
 std::size_t SurfaceParams::GetLayerSize(bool as_host_size, bool uncompressed) const {
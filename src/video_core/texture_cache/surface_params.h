@@ -65,14 +65,15 @@ public:
         return GetInnerMemorySize(false, false, false);
     }
 
-    std::size_t GetHostSizeInBytes(bool is_converted) const {
-        if (!is_converted) {
+    /// Returns the size in bytes in host memory when the surface is uploaded as host_format,
+    /// which differs from pixel_format when compressed surfaces are converted in software.
+    std::size_t GetHostSizeInBytes(VideoCore::Surface::PixelFormat host_format) const {
+        if (host_format == pixel_format) {
             return GetInnerMemorySize(true, false, false);
         }
-        // ASTC is uncompressed in software, in emulated as RGBA8
         std::size_t host_size_in_bytes = 0;
         for (u32 level = 0; level < num_levels; ++level) {
-            host_size_in_bytes += GetConvertedMipmapSize(level) * GetNumLayers();
+            host_size_in_bytes += GetConvertedMipmapSize(level, host_format) * GetNumLayers();
         }
         return host_size_in_bytes;
     }
@@ -103,16 +104,22 @@ public:
     u32 GetMipBlockDepth(u32 level) const;
 
     /// Returns the best possible row/pitch alignment for the surface.
-    u32 GetRowAlignment(u32 level, bool is_converted) const {
-        const u32 bpp = is_converted ? 4 : GetBytesPerPixel();
-        return 1U << Common::CountTrailingZeroes32(GetMipWidth(level) * bpp);
+    u32 GetRowAlignment(u32 level, VideoCore::Surface::PixelFormat host_format) const {
+        if (host_format == pixel_format) {
+            return 1U << Common::CountTrailingZeroes32(GetMipWidth(level) * GetBytesPerPixel());
+        }
+        const u32 block_width = VideoCore::Surface::GetDefaultBlockWidth(host_format);
+        const u32 row_size = Common::AlignUp(GetMipWidth(level), block_width) / block_width *
+                             VideoCore::Surface::GetBytesPerPixel(host_format);
+        return 1U << Common::CountTrailingZeroes32(row_size);
     }
 
     /// Returns the offset in bytes in guest memory of a given mipmap level.
     std::size_t GetGuestMipmapLevelOffset(u32 level) const;
 
     /// Returns the offset in bytes in host memory (linear) of a given mipmap level.
-    std::size_t GetHostMipmapLevelOffset(u32 level, bool is_converted) const;
+    std::size_t GetHostMipmapLevelOffset(u32 level,
+                                         VideoCore::Surface::PixelFormat host_format) const;
 
     /// Returns the size in bytes in guest memory of a given mipmap level.
     std::size_t GetGuestMipmapSize(u32 level) const {
@@ -124,7 +131,9 @@ public:
         return GetInnerMipmapMemorySize(level, true, false) * GetNumLayers();
     }
 
-    std::size_t GetConvertedMipmapSize(u32 level) const;
+    /// Returns the size in bytes of a layer of a given mipmap level converted to host_format.
+    std::size_t GetConvertedMipmapSize(u32 level,
+                                       VideoCore::Surface::PixelFormat host_format) const;
 
     /// Get this texture Tegra Block size in guest memory layout
     u32 GetBlockSize() const;
@@ -0,0 +1,12 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/microprofile.h"
+
+namespace VideoCommon {
+
+// TextureCache is a header-only template, its profile tokens are defined here
+MICROPROFILE_DEFINE(GPU_Texture_Cache_Tick, "GPU", "Texture Cache Tick", MP_RGB(128, 192, 128));
+
+} // namespace VideoCommon
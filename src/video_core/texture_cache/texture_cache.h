@@ -6,10 +6,12 @@
 
 #include <algorithm>
 #include <array>
+#include <iterator>
 #include <list>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
 #include <vector>
@@ -21,6 +23,8 @@
 #include "common/assert.h"
 #include "common/common_types.h"
 #include "common/math_util.h"
+#include "common/microprofile.h"
+#include "common/thread_worker.h"
 #include "core/core.h"
 #include "core/memory.h"
 #include "core/settings.h"
@@ -35,8 +39,10 @@
 #include "video_core/texture_cache/copy_params.h"
 #include "video_core/texture_cache/format_lookup_table.h"
 #include "video_core/texture_cache/surface_base.h"
+#include "video_core/texture_cache/surface_eviction.h"
 #include "video_core/texture_cache/surface_params.h"
 #include "video_core/texture_cache/surface_view.h"
+#include "video_core/texture_cache/texture_cache_stats.h"
 
 namespace Tegra::Texture {
 struct FullTextureInfo;
@@ -48,6 +54,8 @@ class RasterizerInterface;
 
 namespace VideoCommon {
 
+MICROPROFILE_DECLARE(GPU_Texture_Cache_Tick);
+
 using VideoCore::Surface::FormatCompatibility;
 using VideoCore::Surface::PixelFormat;
 using VideoCore::Surface::SurfaceTarget;
@@ -127,6 +135,30 @@ public:
                            [](const TSurface& surface) { return surface->IsModified(); });
     }
 
+    /// Advances the frame counter used to order surfaces by last use, evicts the least recently
+    /// used surfaces when the cache is over its memory budget and publishes the cache stats.
+    void TickFrame() {
+        MICROPROFILE_SCOPE(GPU_Texture_Cache_Tick);
+        std::lock_guard lock{mutex};
+        ++frame_count;
+
+        const u64 budget = u64{Settings::values.texture_cache_budget_mb.GetValue()} << 20;
+        u64 num_evicted = 0;
+        if (budget != 0 && cache_size + reserve_size > budget) {
+            num_evicted = TrimCache(budget);
+        }
+
+        auto& stats = system.GPU().TextureCacheStats();
+        stats.SetSizes(cache_size, reserve_size, budget);
+        stats.AddLookups(num_hits, num_misses);
+        stats.AddEvictions(num_evicted);
+        MICROPROFILE_META_CPU("Texture Cache Hits", static_cast<int>(num_hits));
+        MICROPROFILE_META_CPU("Texture Cache Misses", static_cast<int>(num_misses));
+        MICROPROFILE_META_CPU("Texture Cache Evictions", static_cast<int>(num_evicted));
+        num_hits = 0;
+        num_misses = 0;
+    }
+
     TView GetTextureSurface(const Tegra::Texture::TICEntry& tic,
                             const VideoCommon::Shader::Sampler& entry) {
         std::lock_guard lock{mutex};
@@ -146,7 +178,7 @@ public:
         }
 
         const auto params{SurfaceParams::CreateForTexture(format_lookup_table, tic, entry)};
-        const auto [surface, view] = GetSurface(gpu_addr, *cpu_addr, params, true, false);
+        const auto [surface, view] = LookupSurface(gpu_addr, *cpu_addr, params, true, false);
         if (guard_samplers) {
             sampled_textures.push_back(surface);
         }
@@ -166,7 +198,7 @@ public:
             return GetNullSurface(SurfaceParams::ExpectedTarget(entry));
         }
         const auto params{SurfaceParams::CreateForImage(format_lookup_table, tic, entry)};
-        const auto [surface, view] = GetSurface(gpu_addr, *cpu_addr, params, true, false);
+        const auto [surface, view] = LookupSurface(gpu_addr, *cpu_addr, params, true, false);
         if (guard_samplers) {
             sampled_textures.push_back(surface);
         }
@@ -202,7 +234,8 @@ public:
             return {};
         }
         const auto depth_params{SurfaceParams::CreateForDepthBuffer(system)};
-        auto surface_view = GetSurface(gpu_addr, *cpu_addr, depth_params, preserve_contents, true);
+        auto surface_view =
+            LookupSurface(gpu_addr, *cpu_addr, depth_params, preserve_contents, true);
         if (depth_buffer.target)
             depth_buffer.target->MarkAsRenderTarget(false, NO_RT);
         depth_buffer.target = surface_view.first;
@@ -243,8 +276,8 @@ public:
         }
 
         auto surface_view =
-            GetSurface(gpu_addr, *cpu_addr, SurfaceParams::CreateForFramebuffer(system, index),
-                       preserve_contents, true);
+            LookupSurface(gpu_addr, *cpu_addr, SurfaceParams::CreateForFramebuffer(system, index),
+                          preserve_contents, true);
         if (render_targets[index].target) {
             auto& surface = render_targets[index].target;
             surface->MarkAsRenderTarget(false, NO_RT);
@@ -303,8 +336,9 @@ public:
         const auto& memory_manager = system.GPU().MemoryManager();
         const std::optional<VAddr> dst_cpu_addr = memory_manager.GpuToCpuAddress(dst_gpu_addr);
         const std::optional<VAddr> src_cpu_addr = memory_manager.GpuToCpuAddress(src_gpu_addr);
-        std::pair dst_surface = GetSurface(dst_gpu_addr, *dst_cpu_addr, dst_params, true, false);
-        TView src_surface = GetSurface(src_gpu_addr, *src_cpu_addr, src_params, true, false).second;
+        std::pair dst_surface = LookupSurface(dst_gpu_addr, *dst_cpu_addr, dst_params, true, false);
+        TView src_surface =
+            LookupSurface(src_gpu_addr, *src_cpu_addr, src_params, true, false).second;
         ImageBlit(src_surface, dst_surface.second, copy_config);
         dst_surface.first->MarkAsModified(true, Tick());
     }
@@ -418,7 +452,9 @@ protected:
         surface->SetCpuAddr(*cpu_addr);
         RegisterInnerCache(surface);
         surface->MarkAsRegistered(true);
+        surface->MarkAsUsed(frame_count);
         surface->SetMemoryMarked(true);
+        cache_size += surface->GetHostSizeInBytes();
         rasterizer.UpdatePagesCachedCount(*cpu_addr, size, 1);
     }
 
@@ -445,11 +481,15 @@ protected:
             surface->SetSyncPending(false);
         }
         UnregisterInnerCache(surface);
+        if (surface->IsRegistered()) {
+            cache_size -= surface->GetHostSizeInBytes();
+        }
         surface->MarkAsRegistered(false);
         ReserveSurface(surface->GetSurfaceParams(), surface);
     }
 
     TSurface GetUncachedSurface(const GPUVAddr gpu_addr, const SurfaceParams& params) {
+        ++num_created;
         if (const auto surface = TryGetReservedSurface(params); surface) {
             surface->SetGpuAddr(gpu_addr);
             return surface;
@@ -1112,7 +1152,7 @@ private:
 
     void LoadSurface(const TSurface& surface) {
         staging_cache.GetBuffer(0).resize(surface->GetHostSizeInBytes());
-        surface->LoadBuffer(system.GPU().MemoryManager(), staging_cache);
+        surface->LoadBuffer(system.GPU().MemoryManager(), staging_cache, &upload_workers);
         surface->UploadTexture(staging_cache.GetBuffer(0));
         surface->MarkAsModified(false, Tick());
     }
@@ -1123,7 +1163,7 @@ private:
         }
         staging_cache.GetBuffer(0).resize(surface->GetHostSizeInBytes());
         surface->DownloadTexture(staging_cache.GetBuffer(0));
-        surface->FlushBuffer(system.GPU().MemoryManager(), staging_cache);
+        surface->FlushBuffer(system.GPU().MemoryManager(), staging_cache, &upload_workers);
         surface->MarkAsModified(false, Tick());
     }
 
@@ -1177,6 +1217,7 @@ private:
     }
 
     void ReserveSurface(const SurfaceParams& params, TSurface surface) {
+        reserve_size += surface->GetHostSizeInBytes();
         surface_reserve[params].push_back(std::move(surface));
     }
 
@@ -1185,12 +1226,99 @@ private:
         if (search == surface_reserve.end()) {
             return {};
         }
-        for (auto& surface : search->second) {
-            if (!surface->IsRegistered()) {
-                return surface;
+        auto& surfaces = search->second;
+        const auto it =
+            std::find_if(surfaces.begin(), surfaces.end(),
+                         [](const TSurface& surface) { return !surface->IsRegistered(); });
+        if (it == surfaces.end()) {
+            return {};
+        }
+        // Take the surface out of the reserve, it is reserved again when it's unregistered
+        TSurface surface = std::move(*it);
+        surfaces.erase(it);
+        reserve_size -= surface->GetHostSizeInBytes();
+        return surface;
+    }
+
+    /// Drops a surface from the reserve, releasing its host memory once nothing else uses it.
+    void ReleaseReservedSurface(const TSurface& surface) {
+        const auto search{surface_reserve.find(surface->GetSurfaceParams())};
+        if (search == surface_reserve.end()) {
+            return;
+        }
+        auto& surfaces = search->second;
+        const auto it = std::find(surfaces.begin(), surfaces.end(), surface);
+        if (it == surfaces.end()) {
+            return;
+        }
+        reserve_size -= surface->GetHostSizeInBytes();
+        surfaces.erase(it);
+        if (surfaces.empty()) {
+            surface_reserve.erase(search);
+        }
+    }
+
+    /// Gets the surface of a guest lookup, counting a miss when a surface had to be created or
+    /// taken from the reserve to serve it, and marks it as used in this frame.
+    std::pair<TSurface, TView> LookupSurface(const GPUVAddr gpu_addr, const VAddr cpu_addr,
+                                             const SurfaceParams& params, bool preserve_contents,
+                                             bool is_render) {
+        const u64 num_created_before = num_created;
+        auto surface_view = GetSurface(gpu_addr, cpu_addr, params, preserve_contents, is_render);
+        if (num_created == num_created_before) {
+            ++num_hits;
+        } else {
+            ++num_misses;
+        }
+        if (surface_view.first) {
+            surface_view.first->MarkAsUsed(frame_count);
+        }
+        return surface_view;
+    }
+
+    /**
+     * Releases the least recently used surfaces until the cache fits in the budget. Reserved
+     * surfaces go first as the guest can't see them, then registered surfaces that can be
+     * reloaded from guest memory.
+     *
+     * @param budget Host memory the cache may use, in bytes.
+     * @returns The number of surfaces released.
+     */
+    u64 TrimCache(u64 budget) {
+        const auto over_budget = [this, budget] { return cache_size + reserve_size > budget; };
+
+        std::vector<TSurface> candidates;
+        for (const auto& [params, surfaces] : surface_reserve) {
+            std::copy_if(
+                surfaces.begin(), surfaces.end(), std::back_inserter(candidates),
+                [this](const TSurface& surface) { return IsEvictionAged(surface, frame_count); });
+        }
+        u64 num_evicted = EvictLeastRecentlyUsed(
+            candidates, over_budget,
+            [this](const TSurface& surface) { ReleaseReservedSurface(surface); });
+        if (!over_budget()) {
+            return num_evicted;
+        }
+
+        // Surfaces span several registry pages, mark them to collect each only once
+        candidates.clear();
+        for (const auto& [page, surfaces] : registry) {
+            for (const TSurface& surface : surfaces) {
+                if (!surface->IsPicked() && IsEvictable(surface, frame_count)) {
+                    surface->MarkAsPicked(true);
+                    candidates.push_back(surface);
+                }
             }
         }
-        return {};
+        for (const TSurface& surface : candidates) {
+            surface->MarkAsPicked(false);
+        }
+        num_evicted +=
+            EvictLeastRecentlyUsed(candidates, over_budget, [this](const TSurface& surface) {
+                Unregister(surface);
+                ReleaseReservedSurface(surface);
+            });
+        return num_evicted;
     }
 
     /// Try to do an image copy logging when formats are incompatible.
@@ -1304,6 +1432,20 @@ private:
 
     StagingCache staging_cache;
     std::recursive_mutex mutex;
+
+    /// Upper bound of threads used to swizzle the levels and layers of large surfaces.
+    static constexpr std::size_t MAX_UPLOAD_WORKERS = 4;
+
+    Common::ThreadWorker upload_workers{
+        std::clamp<std::size_t>(std::thread::hardware_concurrency() / 2, 1, MAX_UPLOAD_WORKERS),
+        "yuzu:TextureUpload"};
+
+    u64 frame_count{};
+    u64 cache_size{};   ///< Host memory used by registered surfaces, in bytes
+    u64 reserve_size{}; ///< Host memory used by reserved surfaces, in bytes
+    u64 num_created{};  ///< Surfaces created or taken from the reserve
+    u64 num_hits{};     ///< Lookups served by an existing surface since the last frame
+    u64 num_misses{};   ///< Lookups that needed a new surface since the last frame
 };
 
 } // namespace VideoCommon
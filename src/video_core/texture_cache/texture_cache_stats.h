@@ -0,0 +1,60 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+
+#include "common/common_types.h"
+
+namespace VideoCommon {
+
+/// Texture cache counters written by the GPU thread and read by the frontend.
+class TextureCacheStats {
+public:
+    struct Snapshot {
+        u64 cache_size;   ///< Host memory used by registered surfaces, in bytes
+        u64 reserve_size; ///< Host memory used by reserved surfaces, in bytes
+        u64 budget;       ///< Configured budget in bytes, zero when unlimited
+        u64 hits;         ///< Lookups resolved with an existing surface
+        u64 misses;       ///< Lookups that had to create or recycle a surface
+        u64 evictions;    ///< Surfaces released to stay within the budget
+    };
+
+    void SetSizes(u64 cache_size_, u64 reserve_size_, u64 budget_) {
+        cache_size.store(cache_size_, std::memory_order_relaxed);
+        reserve_size.store(reserve_size_, std::memory_order_relaxed);
+        budget.store(budget_, std::memory_order_relaxed);
+    }
+
+    void AddLookups(u64 num_hits, u64 num_misses) {
+        hits.fetch_add(num_hits, std::memory_order_relaxed);
+        misses.fetch_add(num_misses, std::memory_order_relaxed);
+    }
+
+    void AddEvictions(u64 num_evictions) {
+        evictions.fetch_add(num_evictions, std::memory_order_relaxed);
+    }
+
+    Snapshot GetSnapshot() const {
+        return {
+            .cache_size = cache_size.load(std::memory_order_relaxed),
+            .reserve_size = reserve_size.load(std::memory_order_relaxed),
+            .budget = budget.load(std::memory_order_relaxed),
+            .hits = hits.load(std::memory_order_relaxed),
+            .misses = misses.load(std::memory_order_relaxed),
+            .evictions = evictions.load(std::memory_order_relaxed),
+        };
+    }
+
+private:
+    std::atomic<u64> cache_size{};
+    std::atomic<u64> reserve_size{};
+    std::atomic<u64> budget{};
+    std::atomic<u64> hits{};
+    std::atomic<u64> misses{};
+    std::atomic<u64> evictions{};
+};
+
+} // namespace VideoCommon
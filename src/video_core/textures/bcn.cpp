@@ -0,0 +1,937 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef ARCHITECTURE_x86_64
+#include <emmintrin.h>
+#endif
+
+#include "common/assert.h"
+#include "common/common_types.h"
+#include "common/logging/log.h"
+#include "video_core/surface.h"
+#include "video_core/textures/astc.h"
+#include "video_core/textures/bcn.h"
+
+namespace Tegra::Texture::BCn {
+
+using VideoCore::Surface::PixelFormat;
+
+namespace {
+
+constexpr u32 BLOCK_SIZE = 4;
+constexpr u32 TEXELS_PER_BLOCK = BLOCK_SIZE * BLOCK_SIZE;
+
+/// Decoded texels of a block in row major order, four channels each.
+template <typename T>
+using BlockTexels = std::array<std::array<T, 4>, TEXELS_PER_BLOCK>;
+
+/// Reads little endian bit fields from a 128 bits block, lowest bits first.
+class BitReader {
+public:
+    explicit BitReader(const u8* block) {
+        std::memcpy(&low, block, sizeof(low));
+        std::memcpy(&high, block + sizeof(low), sizeof(high));
+    }
+
+    u32 Read(u32 count) {
+        if (count == 0) {
+            return 0;
+        }
+        const u32 value = static_cast<u32>(low & ((1ULL << count) - 1));
+        low = (low >> count) | (high << (64 - count));
+        high >>= count;
+        return value;
+    }
+
+private:
+    u64 low;
+    u64 high;
+};
+
+// BC7 and BC6H partition tables, shared by both formats. Two subset partitions store the subset
+// of each texel as a bit, three subset partitions as two bits.
+constexpr std::array<u16, 64> PARTITIONS_2{
+    0xcccc, 0x8888, 0xeeee, 0xecc8, 0xc880, 0xfeec, 0xfec8, 0xec80, 0xc800, 0xffec, 0xfe80,
+    0xe800, 0xffe8, 0xff00, 0xfff0, 0xf000, 0xf710, 0x008e, 0x7100, 0x08ce, 0x008c, 0x7310,
+    0x3100, 0x8cce, 0x088c, 0x3110, 0x6666, 0x366c, 0x17e8, 0x0ff0, 0x718e, 0x399c, 0xaaaa,
+    0xf0f0, 0x5a5a, 0x33cc, 0x3c3c, 0x55aa, 0x9696, 0xa55a, 0x73ce, 0x13c8, 0x324c, 0x3bdc,
+    0x6996, 0xc33c, 0x9966, 0x0660, 0x0272, 0x04e4, 0x4e40, 0x2720, 0xc936, 0x936c, 0x39c6,
+    0x639c, 0x9336, 0x9cc6, 0x817e, 0xe718, 0xccf0, 0x0fcc, 0x7744, 0xee22,
+};
+
+constexpr std::array<u32, 64> PARTITIONS_3{
+    0xaa685050, 0x6a5a5040, 0x5a5a4200, 0x5450a0a8, 0xa5a50000, 0xa0a05050, 0x5555a0a0,
+    0x5a5a5050, 0xaa550000, 0xaa555500, 0xaaaa5500, 0x90909090, 0x94949494, 0xa4a4a4a4,
+    0xa9a59450, 0x2a0a4250, 0xa5945040, 0x0a425054, 0xa5a5a500, 0x55a0a0a0, 0xa8a85454,
+    0x6a6a4040, 0xa4a45000, 0x1a1a0500, 0x0050a4a4, 0xaaa59090, 0x14696914, 0x69691400,
+    0xa08585a0, 0xaa821414, 0x50a4a450, 0x6a5a0200, 0xa9a58000, 0x5090a0a8, 0xa8a09050,
+    0x24242424, 0x00aa5500, 0x24924924, 0x24499224, 0x50a50a50, 0x500aa550, 0xaaaa4444,
+    0x66660000, 0xa5a0a5a0, 0x50a050a0, 0x69286928, 0x44aaaa44, 0x66666600, 0xaa444444,
+    0x54a854a8, 0x95809580, 0x96969600, 0xa85454a8, 0x80959580, 0xaa141414, 0x96960000,
+    0xaaaa1414, 0xa05050a0, 0xa0a5a5a0, 0x96000000, 0x40804080, 0xa9a8a9a8, 0xaaaaaa44,
+    0x2a4a5254,
+};
+
+/// Texel storing the index of the second subset with its most significant bit omitted.
+constexpr std::array<u8, 64> ANCHORS_2_OF_2{
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 2,  8,  2,  2,  8,
+    8,  15, 2,  8,  2,  2,  8,  8,  2,  2,  15, 15, 6,  8,  2,  8,  15, 15, 2,  8,  2,  2,
+    2,  15, 15, 6,  6,  2,  6,  8,  15, 15, 2,  2,  15, 15, 15, 15, 15, 2,  2,  15,
+};
+
+/// Texel storing the index of the second subset of a three subset partition.
+constexpr std::array<u8, 64> ANCHORS_2_OF_3{
+    3, 3,  15, 15, 8,  3,  15, 15, 8,  8,  6,  6,  6,  5, 3,  3,  3, 3,  8,  15, 3, 3,
+    6, 10, 5,  8,  8,  6,  8,  5,  15, 15, 8,  15, 3,  5, 6,  10, 8, 15, 15, 3,  15, 5,
+    15, 15, 15, 15, 3, 15, 5,  5,  5,  8,  5,  10, 5,  10, 8, 13, 15, 12, 3,  3,
+};
+
+/// Texel storing the index of the third subset of a three subset partition.
+constexpr std::array<u8, 64> ANCHORS_3_OF_3{
+    15, 8,  8,  3,  15, 15, 3,  8,  15, 15, 15, 15, 15, 15, 15, 8,  15, 8,  15, 3,  15, 8,
+    15, 8,  3,  15, 6,  10, 15, 15, 10, 8,  15, 3,  15, 10, 10, 8,  9,  10, 6,  15, 8,  15,
+    3,  6,  6,  8,  15, 3,  15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 3,  15, 15, 8,
+};
+
+constexpr std::array<u32, 4> WEIGHTS_2{0, 21, 43, 64};
+constexpr std::array<u32, 8> WEIGHTS_3{0, 9, 18, 27, 37, 46, 55, 64};
+constexpr std::array<u32, 16> WEIGHTS_4{0,  4,  9,  13, 17, 21, 26, 30,
+                                        34, 38, 43, 47, 51, 55, 60, 64};
+
+u32 Weight(u32 index_bits, u32 index) {
+    switch (index_bits) {
+    case 2:
+        return WEIGHTS_2[index];
+    case 3:
+        return WEIGHTS_3[index];
+    default:
+        return WEIGHTS_4[index];
+    }
+}
+
+/// Returns the subset of a texel for the given partition.
+u32 Subset(u32 num_subsets, u32 partition, u32 texel) {
+    switch (num_subsets) {
+    case 2:
+        return (PARTITIONS_2[partition] >> texel) & 1;
+    case 3:
+        return (PARTITIONS_3[partition] >> (texel * 2)) & 3;
+    default:
+        return 0;
+    }
+}
+
+/// Returns true when the texel stores its index with one bit less.
+bool IsAnchor(u32 num_subsets, u32 partition, u32 texel) {
+    if (texel == 0) {
+        return true;
+    }
+    switch (num_subsets) {
+    case 2:
+        return texel == ANCHORS_2_OF_2[partition];
+    case 3:
+        return texel == ANCHORS_2_OF_3[partition] || texel == ANCHORS_3_OF_3[partition];
+    default:
+        return false;
+    }
+}
+
+/// Expands a RGB565 color to RGBA8.
+std::array<u8, 4> Expand565(u16 color) {
+    const u32 r = (color >> 11) & 0x1f;
+    const u32 g = (color >> 5) & 0x3f;
+    const u32 b = color & 0x1f;
+    return {static_cast<u8>((r << 3) | (r >> 2)), static_cast<u8>((g << 2) | (g >> 4)),
+            static_cast<u8>((b << 3) | (b >> 2)), 255};
+}
+
+/// Builds the palette of a BC1 color block. BC2 and BC3 always use the four colors mode.
+std::array<std::array<u8, 4>, 4> ColorPalette(u16 color0, u16 color1, bool four_colors) {
+    const std::array<u8, 4> c0 = Expand565(color0);
+    const std::array<u8, 4> c1 = Expand565(color1);
+    std::array<std::array<u8, 4>, 4> palette{c0, c1};
+    for (u32 c = 0; c < 3; ++c) {
+        if (four_colors) {
+            palette[2][c] = static_cast<u8>((2 * c0[c] + c1[c] + 1) / 3);
+            palette[3][c] = static_cast<u8>((c0[c] + 2 * c1[c] + 1) / 3);
+        } else {
+            palette[2][c] = static_cast<u8>((c0[c] + c1[c] + 1) / 2);
+            palette[3][c] = 0;
+        }
+    }
+    palette[2][3] = 255;
+    palette[3][3] = four_colors ? 255 : 0;
+    return palette;
+}
+
+#ifdef ARCHITECTURE_x86_64
+// SSE2 is part of the x86-64 baseline, it doesn't need to be checked at runtime.
+
+/// Builds the palette of a BC1 color block in a vector, one entry per 32 bits lane.
+__m128i ColorPaletteSSE2(u16 color0, u16 color1, bool four_colors) {
+    const std::array<u8, 4> c0 = Expand565(color0);
+    const std::array<u8, 4> c1 = Expand565(color1);
+    const __m128i ends = _mm_setr_epi16(c0[0], c0[1], c0[2], c0[3], c1[0], c1[1], c1[2], c1[3]);
+    const __m128i swapped = _mm_shuffle_epi32(ends, _MM_SHUFFLE(1, 0, 3, 2));
+    const __m128i one = _mm_set1_epi16(1);
+    __m128i interpolated;
+    if (four_colors) {
+        // Sums are below 2^16, multiplying by 0xaaab and shifting by 17 divides them by three
+        const __m128i sum = _mm_add_epi16(_mm_add_epi16(_mm_add_epi16(ends, ends), swapped), one);
+        interpolated = _mm_srli_epi16(_mm_mulhi_epu16(sum, _mm_set1_epi16(-0x5555)), 1);
+    } else {
+        const __m128i sum = _mm_add_epi16(_mm_add_epi16(ends, swapped), one);
+        interpolated = _mm_and_si128(_mm_srli_epi16(sum, 1), _mm_setr_epi32(-1, -1, 0, 0));
+    }
+    return _mm_packus_epi16(ends, interpolated);
+}
+#endif
+
+void DecodeColorBlock(const u8* block, bool force_four_colors, BlockTexels<u8>& texels) {
+    u16 color0;
+    u16 color1;
+    u32 indices;
+    std::memcpy(&color0, block, sizeof(color0));
+    std::memcpy(&color1, block + 2, sizeof(color1));
+    std::memcpy(&indices, block + 4, sizeof(indices));
+    const bool four_colors = force_four_colors || color0 > color1;
+#ifdef ARCHITECTURE_x86_64
+    // Each row of four texels is selected from the palette with a compare per entry
+    const __m128i palette = ColorPaletteSSE2(color0, color1, four_colors);
+    const __m128i entry0 = _mm_shuffle_epi32(palette, _MM_SHUFFLE(0, 0, 0, 0));
+    const __m128i entry1 = _mm_shuffle_epi32(palette, _MM_SHUFFLE(1, 1, 1, 1));
+    const __m128i entry2 = _mm_shuffle_epi32(palette, _MM_SHUFFLE(2, 2, 2, 2));
+    const __m128i entry3 = _mm_shuffle_epi32(palette, _MM_SHUFFLE(3, 3, 3, 3));
+    const __m128i index_mask = _mm_setr_epi32(0x03, 0x0c, 0x30, 0xc0);
+    const __m128i index_step = _mm_setr_epi32(0x01, 0x04, 0x10, 0x40);
+    const __m128i index2 = _mm_add_epi32(index_step, index_step);
+    const __m128i index3 = _mm_add_epi32(index2, index_step);
+    const auto select = [](__m128i index, __m128i expected, __m128i entry) {
+        return _mm_and_si128(_mm_cmpeq_epi32(index, expected), entry);
+    };
+    for (u32 row = 0; row < BLOCK_SIZE; ++row) {
+        const __m128i bits = _mm_set1_epi32(static_cast<s32>(indices >> (row * 8)));
+        const __m128i index = _mm_and_si128(bits, index_mask);
+        const __m128i result = _mm_or_si128(
+            _mm_or_si128(select(index, _mm_setzero_si128(), entry0),
+                         select(index, index_step, entry1)),
+            _mm_or_si128(select(index, index2, entry2), select(index, index3, entry3)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(texels[row * BLOCK_SIZE].data()), result);
+    }
+#else
+    const auto palette = ColorPalette(color0, color1, four_colors);
+    for (u32 i = 0; i < TEXELS_PER_BLOCK; ++i) {
+        texels[i] = palette[(indices >> (i * 2)) & 3];
+    }
+#endif
+}
+
+/// Builds the eight entries palette of a BC4 channel, signed palettes are stored as two's
+/// complement bytes.
+template <bool is_signed>
+std::array<u8, 8> ChannelPalette(u8 raw0, u8 raw1) {
+    using Value = std::conditional_t<is_signed, s32, u32>;
+    const auto convert = [](u8 raw) -> Value {
+        if constexpr (is_signed) {
+            return std::max<s32>(static_cast<s8>(raw), -127);
+        } else {
+            return raw;
+        }
+    };
+    const Value v0 = convert(raw0);
+    const Value v1 = convert(raw1);
+    const auto divide = [](s32 value, s32 divisor) {
+        // Round to nearest for either sign
+        return value >= 0 ? (value + divisor / 2) / divisor : (value - divisor / 2) / divisor;
+    };
+    std::array<s32, 8> palette{static_cast<s32>(v0), static_cast<s32>(v1)};
+    if (v0 > v1) {
+        for (s32 i = 1; i < 7; ++i) {
+            palette[i + 1] = divide((7 - i) * static_cast<s32>(v0) + i * static_cast<s32>(v1), 7);
+        }
+    } else {
+        for (s32 i = 1; i < 5; ++i) {
+            palette[i + 1] = divide((5 - i) * static_cast<s32>(v0) + i * static_cast<s32>(v1), 5);
+        }
+        palette[6] = is_signed ? -127 : 0;
+        palette[7] = is_signed ? 127 : 255;
+    }
+    std::array<u8, 8> result;
+    for (std::size_t i = 0; i < palette.size(); ++i) {
+        result[i] = static_cast<u8>(palette[i]);
+    }
+    return result;
+}
+
+template <bool is_signed>
+void DecodeChannelBlock(const u8* block, u32 channel, BlockTexels<u8>& texels) {
+    const auto palette = ChannelPalette<is_signed>(block[0], block[1]);
+    u64 indices = 0;
+    std::memcpy(&indices, block + 2, 6);
+    for (u32 i = 0; i < TEXELS_PER_BLOCK; ++i) {
+        texels[i][channel] = palette[(indices >> (i * 3)) & 7];
+    }
+}
+
+void DecodeBC1(const u8* block, BlockTexels<u8>& texels) {
+    DecodeColorBlock(block, false, texels);
+}
+
+void DecodeBC2(const u8* block, BlockTexels<u8>& texels) {
+    DecodeColorBlock(block + 8, true, texels);
+    u64 alpha;
+    std::memcpy(&alpha, block, sizeof(alpha));
+    for (u32 i = 0; i < TEXELS_PER_BLOCK; ++i) {
+        texels[i][3] = static_cast<u8>(((alpha >> (i * 4)) & 0xf) * 17);
+    }
+}
+
+void DecodeBC3(const u8* block, BlockTexels<u8>& texels) {
+    DecodeColorBlock(block + 8, true, texels);
+    DecodeChannelBlock<false>(block, 3, texels);
+}
+
+template <bool is_signed>
+void DecodeBC4(const u8* block, BlockTexels<u8>& texels) {
+    DecodeChannelBlock<is_signed>(block, 0, texels);
+    for (auto& texel : texels) {
+        texel[1] = texel[2] = 0;
+        texel[3] = is_signed ? 127 : 255;
+    }
+}
+
+template <bool is_signed>
+void DecodeBC5(const u8* block, BlockTexels<u8>& texels) {
+    DecodeChannelBlock<is_signed>(block, 0, texels);
+    DecodeChannelBlock<is_signed>(block + 8, 1, texels);
+    for (auto& texel : texels) {
+        texel[2] = 0;
+        texel[3] = is_signed ? 127 : 255;
+    }
+}
+
+struct BC7Mode {
+    u32 num_subsets;
+    u32 partition_bits;
+    u32 rotation_bits;
+    u32 index_selection_bits;
+    u32 color_bits;
+    u32 alpha_bits;
+    u32 endpoint_pbits;
+    u32 shared_pbits;
+    u32 index_bits;
+    u32 secondary_index_bits;
+};
+
+constexpr std::array<BC7Mode, 8> BC7_MODES{{
+    {3, 4, 0, 0, 4, 0, 1, 0, 3, 0},
+    {2, 6, 0, 0, 6, 0, 0, 1, 3, 0},
+    {3, 6, 0, 0, 5, 0, 0, 0, 2, 0},
+    {2, 6, 0, 0, 7, 0, 1, 0, 2, 0},
+    {1, 0, 2, 1, 5, 6, 0, 0, 2, 3},
+    {1, 0, 2, 0, 7, 8, 0, 0, 2, 2},
+    {1, 0, 0, 0, 7, 7, 1, 0, 4, 0},
+    {2, 6, 0, 0, 5, 5, 1, 0, 2, 0},
+}};
+
+void DecodeBC7(const u8* block, BlockTexels<u8>& texels) {
+    BitReader reader(block);
+    u32 mode_index = 0;
+    while (mode_index < 8 && reader.Read(1) == 0) {
+        ++mode_index;
+    }
+    if (mode_index == 8) {
+        // Reserved mode, decodes to transparent black
+        texels = {};
+        return;
+    }
+    const BC7Mode& mode = BC7_MODES[mode_index];
+    const u32 partition = reader.Read(mode.partition_bits);
+    const u32 rotation = reader.Read(mode.rotation_bits);
+    const u32 index_selection = reader.Read(mode.index_selection_bits);
+
+    const u32 num_endpoints = mode.num_subsets * 2;
+    std::array<std::array<u32, 4>, 6> endpoints{};
+    for (u32 channel = 0; channel < 3; ++channel) {
+        for (u32 i = 0; i < num_endpoints; ++i) {
+            endpoints[i][channel] = reader.Read(mode.color_bits);
+        }
+    }
+    if (mode.alpha_bits > 0) {
+        for (u32 i = 0; i < num_endpoints; ++i) {
+            endpoints[i][3] = reader.Read(mode.alpha_bits);
+        }
+    }
+
+    u32 color_bits = mode.color_bits;
+    u32 alpha_bits = mode.alpha_bits;
+    if (mode.endpoint_pbits != 0 || mode.shared_pbits != 0) {
+        std::array<u32, 6> pbits{};
+        if (mode.endpoint_pbits != 0) {
+            for (u32 i = 0; i < num_endpoints; ++i) {
+                pbits[i] = reader.Read(1);
+            }
+        } else {
+            for (u32 subset = 0; subset < mode.num_subsets; ++subset) {
+                pbits[subset * 2] = pbits[subset * 2 + 1] = reader.Read(1);
+            }
+        }
+        for (u32 i = 0; i < num_endpoints; ++i) {
+            for (u32 channel = 0; channel < 4; ++channel) {
+                endpoints[i][channel] = (endpoints[i][channel] << 1) | pbits[i];
+            }
+        }
+        ++color_bits;
+        if (alpha_bits > 0) {
+            ++alpha_bits;
+        }
+    }
+    for (auto& endpoint : endpoints) {
+        for (u32 channel = 0; channel < 4; ++channel) {
+            const u32 bits = channel < 3 ? color_bits : alpha_bits;
+            if (bits == 0) {
+                endpoint[channel] = 255;
+            } else {
+                endpoint[channel] <<= 8 - bits;
+                endpoint[channel] |= endpoint[channel] >> bits;
+            }
+        }
+    }
+
+    std::array<u32, TEXELS_PER_BLOCK> indices;
+    for (u32 i = 0; i < TEXELS_PER_BLOCK; ++i) {
+        const bool anchor = IsAnchor(mode.num_subsets, partition, i);
+        indices[i] = reader.Read(mode.index_bits - (anchor ? 1 : 0));
+    }
+    std::array<u32, TEXELS_PER_BLOCK> secondary_indices{};
+    if (mode.secondary_index_bits > 0) {
+        for (u32 i = 0; i < TEXELS_PER_BLOCK; ++i) {
+            secondary_indices[i] = reader.Read(mode.secondary_index_bits - (i == 0 ? 1 : 0));
+        }
+    }
+
+    for (u32 i = 0; i < TEXELS_PER_BLOCK; ++i) {
+        const u32 subset = Subset(mode.num_subsets, partition, i);
+        const auto& e0 = endpoints[subset * 2];
+        const auto& e1 = endpoints[subset * 2 + 1];
+        u32 color_weight = Weight(mode.index_bits, indices[i]);
+        u32 alpha_weight = color_weight;
+        if (mode.secondary_index_bits > 0) {
+            alpha_weight = Weight(mode.secondary_index_bits, secondary_indices[i]);
+            if (index_selection != 0) {
+                std::swap(color_weight, alpha_weight);
+            }
+        }
+        for (u32 channel = 0; channel < 4; ++channel) {
+            const u32 weight = channel < 3 ? color_weight : alpha_weight;
+            texels[i][channel] =
+                static_cast<u8>(((64 - weight) * e0[channel] + weight * e1[channel] + 32) >> 6);
+        }
+        if (rotation != 0) {
+            std::swap(texels[i][rotation - 1], texels[i][3]);
+        }
+    }
+}
+
+// BC6H endpoint fields, the endpoint index times three plus the channel, and the partition.
+enum BC6HField : u8 { RW, GW, BW, RX, GX, BX, RY, GY, BY, RZ, GZ, BZ, D };
+
+struct BC6HSegment {
+    u8 field; ///< Field the bits belong to
+    u8 first; ///< Lowest bit of the field written by this segment
+    u8 count; ///< Number of bits, zero terminates the layout
+};
+
+struct BC6HMode {
+    bool transformed;
+    u32 num_subsets;
+    u32 endpoint_bits;
+    std::array<u32, 3> delta_bits;
+    std::array<BC6HSegment, 26> layout;
+};
+
+// Modes 13 and 14 store the most significant bits of the base endpoint in reverse order.
+constexpr std::array<BC6HMode, 14> BC6H_MODES{{
+    {true, 2, 10, {5, 5, 5}, {{{GY, 4, 1}, {BY, 4, 1}, {BZ, 4, 1}, {RW, 0, 10}, {GW, 0, 10},
+                              {BW, 0, 10}, {RX, 0, 5}, {GZ, 4, 1}, {GY, 0, 4}, {GX, 0, 5},
+                              {BZ, 0, 1}, {GZ, 0, 4}, {BX, 0, 5}, {BZ, 1, 1}, {BY, 0, 4},
+                              {RY, 0, 5}, {BZ, 2, 1}, {RZ, 0, 5}, {BZ, 3, 1}, {D, 0, 5}}}},
+    {true, 2, 7, {6, 6, 6}, {{{GY, 5, 1}, {GZ, 4, 1}, {GZ, 5, 1}, {RW, 0, 7}, {BZ, 0, 1},
+                             {BZ, 1, 1}, {BY, 4, 1}, {GW, 0, 7}, {BY, 5, 1}, {BZ, 2, 1},
+                             {GY, 4, 1}, {BW, 0, 7}, {BZ, 3, 1}, {BZ, 5, 1}, {BZ, 4, 1},
+                             {RX, 0, 6}, {GY, 0, 4}, {GX, 0, 6}, {GZ, 0, 4}, {BX, 0, 6},
+                             {BY, 0, 4}, {RY, 0, 6}, {RZ, 0, 6}, {D, 0, 5}}}},
+    {true, 2, 11, {5, 4, 4}, {{{RW, 0, 10}, {GW, 0, 10}, {BW, 0, 10}, {RX, 0, 5}, {RW, 10, 1},
+                              {GY, 0, 4}, {GX, 0, 4}, {GW, 10, 1}, {BZ, 0, 1}, {GZ, 0, 4},
+                              {BX, 0, 4}, {BW, 10, 1}, {BZ, 1, 1}, {BY, 0, 4}, {RY, 0, 5},
+                              {BZ, 2, 1}, {RZ, 0, 5}, {BZ, 3, 1}, {D, 0, 5}}}},
+    {true, 2, 11, {4, 5, 4}, {{{RW, 0, 10}, {GW, 0, 10}, {BW, 0, 10}, {RX, 0, 4}, {RW, 10, 1},
+                              {GZ, 4, 1}, {GY, 0, 4}, {GX, 0, 5}, {GW, 10, 1}, {GZ, 0, 4},
+                              {BX, 0, 4}, {BW, 10, 1}, {BZ, 1, 1}, {BY, 0, 4}, {RY, 0, 4},
+                              {BZ, 0, 1}, {BZ, 2, 1}, {RZ, 0, 4}, {GY, 4, 1}, {BZ, 3, 1},
+                              {D, 0, 5}}}},
+    {true, 2, 11, {4, 4, 5}, {{{RW, 0, 10}, {GW, 0, 10}, {BW, 0, 10}, {RX, 0, 4}, {RW, 10, 1},
+                              {BY, 4, 1}, {GY, 0, 4}, {GX, 0, 4}, {GW, 10, 1}, {BZ, 0, 1},
+                              {GZ, 0, 4}, {BX, 0, 5}, {BW, 10, 1}, {BY, 0, 4}, {RY, 0, 4},
+                              {BZ, 1, 1}, {BZ, 2, 1}, {RZ, 0, 4}, {BZ, 4, 1}, {BZ, 3, 1},
+                              {D, 0, 5}}}},
+    {true, 2, 9, {5, 5, 5}, {{{RW, 0, 9}, {BY, 4, 1}, {GW, 0, 9}, {GY, 4, 1}, {BW, 0, 9},
+                             {BZ, 4, 1}, {RX, 0, 5}, {GZ, 4, 1}, {GY, 0, 4}, {GX, 0, 5},
+                             {BZ, 0, 1}, {GZ, 0, 4}, {BX, 0, 5}, {BZ, 1, 1}, {BY, 0, 4},
+                             {RY, 0, 5}, {BZ, 2, 1}, {RZ, 0, 5}, {BZ, 3, 1}, {D, 0, 5}}}},
+    {true, 2, 8, {6, 5, 5}, {{{RW, 0, 8}, {GZ, 4, 1}, {BY, 4, 1}, {GW, 0, 8}, {BZ, 2, 1},
+                             {GY, 4, 1}, {BW, 0, 8}, {BZ, 3, 1}, {BZ, 4, 1}, {RX, 0, 6},
+                             {GY, 0, 4}, {GX, 0, 5}, {BZ, 0, 1}, {GZ, 0, 4}, {BX, 0, 5},
+                             {BZ, 1, 1}, {BY, 0, 4}, {RY, 0, 6}, {RZ, 0, 6}, {D, 0, 5}}}},
+    {true, 2, 8, {5, 6, 5}, {{{RW, 0, 8}, {BZ, 0, 1}, {BY, 4, 1}, {GW, 0, 8}, {GY, 5, 1},
+                             {GY, 4, 1}, {BW, 0, 8}, {GZ, 5, 1}, {BZ, 4, 1}, {RX, 0, 5},
+                             {GZ, 4, 1}, {GY, 0, 4}, {GX, 0, 6}, {GZ, 0, 4}, {BX, 0, 5},
+                             {BZ, 1, 1}, {BY, 0, 4}, {RY, 0, 5}, {BZ, 2, 1}, {RZ, 0, 5},
+                             {BZ, 3, 1}, {D, 0, 5}}}},
+    {true, 2, 8, {5, 5, 6}, {{{RW, 0, 8}, {BZ, 1, 1}, {BY, 4, 1}, {GW, 0, 8}, {BY, 5, 1},
+                             {GY, 4, 1}, {BW, 0, 8}, {BZ, 5, 1}, {BZ, 4, 1}, {RX, 0, 5},
+                             {GZ, 4, 1}, {GY, 0, 4}, {GX, 0, 5}, {BZ, 0, 1}, {GZ, 0, 4},
+                             {BX, 0, 6}, {BY, 0, 4}, {RY, 0, 5}, {BZ, 2, 1}, {RZ, 0, 5},
+                             {BZ, 3, 1}, {D, 0, 5}}}},
+    {false, 2, 6, {6, 6, 6}, {{{RW, 0, 6}, {GZ, 4, 1}, {BZ, 0, 1}, {BZ, 1, 1}, {BY, 4, 1},
+                              {GW, 0, 6}, {GY, 5, 1}, {BY, 5, 1}, {BZ, 2, 1}, {GY, 4, 1},
+                              {BW, 0, 6}, {GZ, 5, 1}, {BZ, 3, 1}, {BZ, 5, 1}, {BZ, 4, 1},
+                              {RX, 0, 6}, {GY, 0, 4}, {GX, 0, 6}, {GZ, 0, 4}, {BX, 0, 6},
+                              {BY, 0, 4}, {RY, 0, 6}, {RZ, 0, 6}, {D, 0, 5}}}},
+    {false, 1, 10, {10, 10, 10}, {{{RW, 0, 10}, {GW, 0, 10}, {BW, 0, 10}, {RX, 0, 10},
+                                   {GX, 0, 10}, {BX, 0, 10}}}},
+    {true, 1, 11, {9, 9, 9}, {{{RW, 0, 10}, {GW, 0, 10}, {BW, 0, 10}, {RX, 0, 9}, {RW, 10, 1},
+                              {GX, 0, 9}, {GW, 10, 1}, {BX, 0, 9}, {BW, 10, 1}}}},
+    {true, 1, 12, {8, 8, 8}, {{{RW, 0, 10}, {GW, 0, 10}, {BW, 0, 10}, {RX, 0, 8}, {RW, 11, 1},
+                              {RW, 10, 1}, {GX, 0, 8}, {GW, 11, 1}, {GW, 10, 1}, {BX, 0, 8},
+                              {BW, 11, 1}, {BW, 10, 1}}}},
+    {true, 1, 16, {4, 4, 4}, {{{RW, 0, 10}, {GW, 0, 10}, {BW, 0, 10}, {RX, 0, 4}, {RW, 15, 1},
+                              {RW, 14, 1}, {RW, 13, 1}, {RW, 12, 1}, {RW, 11, 1}, {RW, 10, 1},
+                              {GX, 0, 4}, {GW, 15, 1}, {GW, 14, 1}, {GW, 13, 1}, {GW, 12, 1},
+                              {GW, 11, 1}, {GW, 10, 1}, {BX, 0, 4}, {BW, 15, 1}, {BW, 14, 1},
+                              {BW, 13, 1}, {BW, 12, 1}, {BW, 11, 1}, {BW, 10, 1}}}},
+}};
+
+/// Returns the BC6H mode index of a five bits mode value, or -1 when it's reserved.
+s32 BC6HModeIndex(u32 value) {
+    switch (value) {
+    case 0x02:
+        return 2;
+    case 0x06:
+        return 3;
+    case 0x0a:
+        return 4;
+    case 0x0e:
+        return 5;
+    case 0x12:
+        return 6;
+    case 0x16:
+        return 7;
+    case 0x1a:
+        return 8;
+    case 0x1e:
+        return 9;
+    case 0x03:
+        return 10;
+    case 0x07:
+        return 11;
+    case 0x0b:
+        return 12;
+    case 0x0f:
+        return 13;
+    default:
+        return -1;
+    }
+}
+
+constexpr s32 SignExtend(s32 value, u32 bits) {
+    const s32 shift = 32 - static_cast<s32>(bits);
+    return static_cast<s32>(static_cast<u32>(value) << shift) >> shift;
+}
+
+s32 UnquantizeBC6H(s32 value, u32 bits, bool is_signed) {
+    if (!is_signed) {
+        if (bits >= 15) {
+            return value;
+        }
+        if (value == 0) {
+            return 0;
+        }
+        if (value == (1 << bits) - 1) {
+            return 0xffff;
+        }
+        return ((value << 16) + 0x8000) >> bits;
+    }
+    if (bits >= 16) {
+        return value;
+    }
+    const bool negative = value < 0;
+    const s32 magnitude = negative ? -value : value;
+    s32 result;
+    if (magnitude == 0) {
+        result = 0;
+    } else if (magnitude >= (1 << (bits - 1)) - 1) {
+        result = 0x7fff;
+    } else {
+        result = ((magnitude << 15) + 0x4000) >> (bits - 1);
+    }
+    return negative ? -result : result;
+}
+
+/// Scales an interpolated value to the half float range and returns its bit pattern.
+u16 FinishUnquantizeBC6H(s32 value, bool is_signed) {
+    if (!is_signed) {
+        return static_cast<u16>((value * 31) >> 6);
+    }
+    if (value < 0) {
+        return static_cast<u16>(0x8000 | (((-value) * 31) >> 5));
+    }
+    return static_cast<u16>((value * 31) >> 5);
+}
+
+template <bool is_signed>
+void DecodeBC6H(const u8* block, BlockTexels<u16>& texels) {
+    BitReader reader(block);
+    s32 mode_index = static_cast<s32>(reader.Read(2));
+    if (mode_index > 1) {
+        mode_index = BC6HModeIndex(mode_index | (reader.Read(3) << 2));
+    }
+    if (mode_index < 0) {
+        // Reserved mode, decodes to black
+        for (auto& texel : texels) {
+            texel = {0, 0, 0, 0x3c00};
+        }
+        return;
+    }
+    const BC6HMode& mode = BC6H_MODES[mode_index];
+    std::array<s32, 13> fields{};
+    for (const BC6HSegment& segment : mode.layout) {
+        if (segment.count == 0) {
+            break;
+        }
+        fields[segment.field] |= static_cast<s32>(reader.Read(segment.count) << segment.first);
+    }
+
+    const u32 num_endpoints = mode.num_subsets * 2;
+    const s32 mask = (1 << mode.endpoint_bits) - 1;
+    std::array<std::array<s32, 3>, 4> endpoints;
+    for (u32 channel = 0; channel < 3; ++channel) {
+        s32 base = fields[channel];
+        if (is_signed) {
+            base = SignExtend(base, mode.endpoint_bits);
+        }
+        endpoints[0][channel] = base;
+        for (u32 i = 1; i < num_endpoints; ++i) {
+            s32 value = fields[i * 3 + channel];
+            if (mode.transformed || is_signed) {
+                value = SignExtend(value, mode.delta_bits[channel]);
+            }
+            if (mode.transformed) {
+                value = (fields[channel] + value) & mask;
+                if (is_signed) {
+                    value = SignExtend(value, mode.endpoint_bits);
+                }
+            }
+            endpoints[i][channel] = value;
+        }
+    }
+    for (u32 i = 0; i < num_endpoints; ++i) {
+        for (u32 channel = 0; channel < 3; ++channel) {
+            endpoints[i][channel] =
+                UnquantizeBC6H(endpoints[i][channel], mode.endpoint_bits, is_signed);
+        }
+    }
+
+    const u32 partition = static_cast<u32>(fields[D]);
+    const u32 index_bits = mode.num_subsets == 2 ? 3 : 4;
+    for (u32 i = 0; i < TEXELS_PER_BLOCK; ++i) {
+        const bool anchor = IsAnchor(mode.num_subsets, partition, i);
+        const u32 weight = Weight(index_bits, reader.Read(index_bits - (anchor ? 1 : 0)));
+        const u32 subset = Subset(mode.num_subsets, partition, i);
+        const auto& e0 = endpoints[subset * 2];
+        const auto& e1 = endpoints[subset * 2 + 1];
+        for (u32 channel = 0; channel < 3; ++channel) {
+            const s32 value = (e0[channel] * static_cast<s32>(64 - weight) +
+                               e1[channel] * static_cast<s32>(weight) + 32) >>
+                              6;
+            texels[i][channel] = FinishUnquantizeBC6H(value, is_signed);
+        }
+        texels[i][3] = 0x3c00;
+    }
+}
+
+/// Decodes every block of a surface, writing the texels inside the surface bounds.
+template <typename T, typename Func>
+void DecodeBlocks(const u8* data, u32 width, u32 height, u32 depth, u32 block_size, u8* output,
+                  Func&& decode_block) {
+    const u32 blocks_x = (width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    const u32 blocks_y = (height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    constexpr std::size_t texel_size = sizeof(T) * 4;
+    BlockTexels<T> texels;
+    for (u32 z = 0; z < depth; ++z) {
+        u8* const slice = output + std::size_t{z} * width * height * texel_size;
+        for (u32 block_y = 0; block_y < blocks_y; ++block_y) {
+            for (u32 block_x = 0; block_x < blocks_x; ++block_x) {
+                decode_block(data, texels);
+                data += block_size;
+
+                const u32 x = block_x * BLOCK_SIZE;
+                const u32 y = block_y * BLOCK_SIZE;
+                const u32 copy_width = std::min(BLOCK_SIZE, width - x);
+                const u32 copy_height = std::min(BLOCK_SIZE, height - y);
+                for (u32 row = 0; row < copy_height; ++row) {
+                    u8* const dst = slice + (std::size_t{y + row} * width + x) * texel_size;
+                    std::memcpy(dst, &texels[row * BLOCK_SIZE], copy_width * texel_size);
+                }
+            }
+        }
+    }
+}
+
+/// Quantizes a RGB888 color to RGB565.
+u16 To565(s32 r, s32 g, s32 b) {
+    const auto quantize = [](s32 value, s32 max) {
+        return static_cast<u32>((std::clamp(value, 0, 255) * max + 127) / 255);
+    };
+    return static_cast<u16>((quantize(r, 31) << 11) | (quantize(g, 63) << 5) | quantize(b, 31));
+}
+
+/**
+ * Encodes the color part of a BC1 or BC3 block. BC3 blocks always use the four colors mode. BC1
+ * blocks with transparent texels use the three colors mode, where the fourth index is transparent.
+ */
+void EncodeColorBlock(const BlockTexels<u8>& texels, bool punch_through, u8* block) {
+    // Texels with an alpha below one half are transparent when punch through alpha is enabled
+    std::array<bool, TEXELS_PER_BLOCK> transparent{};
+    u32 num_opaque = 0;
+    for (u32 i = 0; i < TEXELS_PER_BLOCK; ++i) {
+        transparent[i] = punch_through && texels[i][3] < 128;
+        num_opaque += transparent[i] ? 0 : 1;
+    }
+    const bool three_colors = num_opaque != TEXELS_PER_BLOCK;
+
+    std::array<s32, 3> min{255, 255, 255};
+    std::array<s32, 3> max{0, 0, 0};
+    std::array<s32, 3> sum{};
+    for (u32 i = 0; i < TEXELS_PER_BLOCK; ++i) {
+        if (transparent[i]) {
+            continue;
+        }
+        for (u32 c = 0; c < 3; ++c) {
+            min[c] = std::min<s32>(min[c], texels[i][c]);
+            max[c] = std::max<s32>(max[c], texels[i][c]);
+            sum[c] += texels[i][c];
+        }
+    }
+    if (num_opaque == 0) {
+        min = max = {};
+    }
+    // Pick the diagonal of the bounding box that follows the correlation of green and blue with
+    // red, then inset it to reduce the error of the extremes.
+    const s32 count = static_cast<s32>(num_opaque);
+    s32 covariance_rg = 0;
+    s32 covariance_rb = 0;
+    for (u32 i = 0; i < TEXELS_PER_BLOCK; ++i) {
+        if (transparent[i]) {
+            continue;
+        }
+        const s32 r = texels[i][0] * count - sum[0];
+        covariance_rg += r * (texels[i][1] * count - sum[1]);
+        covariance_rb += r * (texels[i][2] * count - sum[2]);
+    }
+    if (covariance_rg < 0) {
+        std::swap(min[1], max[1]);
+    }
+    if (covariance_rb < 0) {
+        std::swap(min[2], max[2]);
+    }
+    for (u32 c = 0; c < 3; ++c) {
+        const s32 inset = (max[c] - min[c]) / 16;
+        max[c] -= inset;
+        min[c] += inset;
+    }
+    u16 color0 = To565(max[0], max[1], max[2]);
+    u16 color1 = To565(min[0], min[1], min[2]);
+    // The order of the endpoints selects the mode, three colors when color0 <= color1
+    if (three_colors ? color0 > color1 : color0 < color1) {
+        std::swap(color0, color1);
+    }
+
+    u32 indices = 0;
+    if (three_colors || color0 != color1) {
+        const auto palette = ColorPalette(color0, color1, !three_colors);
+        const u32 num_colors = three_colors ? 3 : 4;
+        for (u32 i = 0; i < TEXELS_PER_BLOCK; ++i) {
+            if (transparent[i]) {
+                indices |= 3U << (i * 2);
+                continue;
+            }
+            u32 best_index = 0;
+            s32 best_error = std::numeric_limits<s32>::max();
+            for (u32 p = 0; p < num_colors; ++p) {
+                s32 error = 0;
+                for (u32 c = 0; c < 3; ++c) {
+                    const s32 delta = static_cast<s32>(texels[i][c]) - palette[p][c];
+                    error += delta * delta;
+                }
+                if (error < best_error) {
+                    best_error = error;
+                    best_index = p;
+                }
+            }
+            indices |= best_index << (i * 2);
+        }
+    }
+    std::memcpy(block, &color0, sizeof(color0));
+    std::memcpy(block + 2, &color1, sizeof(color1));
+    std::memcpy(block + 4, &indices, sizeof(indices));
+}
+
+/// Encodes a BC4 block of the given channel using the eight values mode.
+void EncodeChannelBlock(const BlockTexels<u8>& texels, u32 channel, u8* block) {
+    u8 min = 255;
+    u8 max = 0;
+    for (const auto& texel : texels) {
+        min = std::min(min, texel[channel]);
+        max = std::max(max, texel[channel]);
+    }
+    u64 indices = 0;
+    if (min != max) {
+        const auto palette = ChannelPalette<false>(max, min);
+        for (u32 i = 0; i < TEXELS_PER_BLOCK; ++i) {
+            u32 best_index = 0;
+            s32 best_error = 256;
+            for (u32 p = 0; p < 8; ++p) {
+                const s32 error = std::abs(static_cast<s32>(texels[i][channel]) - palette[p]);
+                if (error < best_error) {
+                    best_error = error;
+                    best_index = p;
+                }
+            }
+            indices |= static_cast<u64>(best_index) << (i * 3);
+        }
+    }
+    block[0] = max;
+    block[1] = min;
+    std::memcpy(block + 2, &indices, 6);
+}
+
+} // Anonymous namespace
+
+bool IsBCnFormat(PixelFormat format) {
+    switch (format) {
+    case PixelFormat::BC1_RGBA_UNORM:
+    case PixelFormat::BC1_RGBA_SRGB:
+    case PixelFormat::BC2_UNORM:
+    case PixelFormat::BC2_SRGB:
+    case PixelFormat::BC3_UNORM:
+    case PixelFormat::BC3_SRGB:
+    case PixelFormat::BC4_UNORM:
+    case PixelFormat::BC4_SNORM:
+    case PixelFormat::BC5_UNORM:
+    case PixelFormat::BC5_SNORM:
+    case PixelFormat::BC6H_UFLOAT:
+    case PixelFormat::BC6H_SFLOAT:
+    case PixelFormat::BC7_UNORM:
+    case PixelFormat::BC7_SRGB:
+        return true;
+    default:
+        return false;
+    }
+}
+
+u32 DecompressedBytesPerPixel(PixelFormat format) {
+    return format == PixelFormat::BC6H_UFLOAT || format == PixelFormat::BC6H_SFLOAT ? 8 : 4;
+}
+
+void Decompress(PixelFormat format, const u8* data, u32 width, u32 height, u32 depth,
+                u8* output) {
+    switch (format) {
+    case PixelFormat::BC1_RGBA_UNORM:
+    case PixelFormat::BC1_RGBA_SRGB:
+        return DecodeBlocks<u8>(data, width, height, depth, 8, output, DecodeBC1);
+    case PixelFormat::BC2_UNORM:
+    case PixelFormat::BC2_SRGB:
+        return DecodeBlocks<u8>(data, width, height, depth, 16, output, DecodeBC2);
+    case PixelFormat::BC3_UNORM:
+    case PixelFormat::BC3_SRGB:
+        return DecodeBlocks<u8>(data, width, height, depth, 16, output, DecodeBC3);
+    case PixelFormat::BC4_UNORM:
+        return DecodeBlocks<u8>(data, width, height, depth, 8, output, DecodeBC4<false>);
+    case PixelFormat::BC4_SNORM:
+        return DecodeBlocks<u8>(data, width, height, depth, 8, output, DecodeBC4<true>);
+    case PixelFormat::BC5_UNORM:
+        return DecodeBlocks<u8>(data, width, height, depth, 16, output, DecodeBC5<false>);
+    case PixelFormat::BC5_SNORM:
+        return DecodeBlocks<u8>(data, width, height, depth, 16, output, DecodeBC5<true>);
+    case PixelFormat::BC6H_UFLOAT:
+        return DecodeBlocks<u16>(data, width, height, depth, 16, output, DecodeBC6H<false>);
+    case PixelFormat::BC6H_SFLOAT:
+        return DecodeBlocks<u16>(data, width, height, depth, 16, output, DecodeBC6H<true>);
+    case PixelFormat::BC7_UNORM:
+    case PixelFormat::BC7_SRGB:
+        return DecodeBlocks<u8>(data, width, height, depth, 16, output, DecodeBC7);
+    default:
+        UNREACHABLE_MSG("Format {} is not a BCn format", static_cast<u32>(format));
+    }
+}
+
+std::size_t CompressedSize(PixelFormat format, u32 width, u32 height, u32 depth) {
+    const std::size_t blocks_x = (width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    const std::size_t blocks_y = (height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    const bool is_bc1 =
+        format == PixelFormat::BC1_RGBA_UNORM || format == PixelFormat::BC1_RGBA_SRGB;
+    return blocks_x * blocks_y * depth * (is_bc1 ? 8 : 16);
+}
+
+void Compress(PixelFormat format, const u8* rgba8, u32 width, u32 height, u32 depth,
+              u8* output) {
+    const bool is_bc1 =
+        format == PixelFormat::BC1_RGBA_UNORM || format == PixelFormat::BC1_RGBA_SRGB;
+    ASSERT_MSG(is_bc1 || format == PixelFormat::BC3_UNORM || format == PixelFormat::BC3_SRGB,
+               "Compression to format {} is not implemented", static_cast<u32>(format));
+
+    const u32 blocks_x = (width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    const u32 blocks_y = (height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    BlockTexels<u8> texels;
+    for (u32 z = 0; z < depth; ++z) {
+        const u8* const slice = rgba8 + std::size_t{z} * width * height * 4;
+        for (u32 block_y = 0; block_y < blocks_y; ++block_y) {
+            for (u32 block_x = 0; block_x < blocks_x; ++block_x) {
+                // Texels outside of the surface replicate its edges
+                for (u32 i = 0; i < TEXELS_PER_BLOCK; ++i) {
+                    const u32 x = std::min(block_x * BLOCK_SIZE + i % BLOCK_SIZE, width - 1);
+                    const u32 y = std::min(block_y * BLOCK_SIZE + i / BLOCK_SIZE, height - 1);
+                    std::memcpy(&texels[i], slice + (std::size_t{y} * width + x) * 4, 4);
+                }
+                if (is_bc1) {
+                    EncodeColorBlock(texels, true, output);
+                    output += 8;
+                } else {
+                    EncodeChannelBlock(texels, 3, output);
+                    EncodeColorBlock(texels, false, output + 8);
+                    output += 16;
+                }
+            }
+        }
+    }
+}
+
+void TranscodeASTCToBC3(const u8* data, u32 width, u32 height, u32 depth, u32 block_width,
+                        u32 block_height, u8* output) {
+    const std::vector<u8> rgba8 =
+        ASTC::Decompress(data, width, height, depth, block_width, block_height);
+    Compress(PixelFormat::BC3_UNORM, rgba8.data(), width, height, depth, output);
+}
+
+} // namespace Tegra::Texture::BCn
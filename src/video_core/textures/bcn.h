@@ -0,0 +1,49 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+
+#include "common/common_types.h"
+
+namespace VideoCore::Surface {
+enum class PixelFormat;
+}
+
+namespace Tegra::Texture::BCn {
+
+/// Returns true when the pixel format is one of the BC1 to BC7 formats.
+bool IsBCnFormat(VideoCore::Surface::PixelFormat format);
+
+/// Returns the size in bytes of a decompressed pixel, 8 for BC6H and 4 for the other formats.
+u32 DecompressedBytesPerPixel(VideoCore::Surface::PixelFormat format);
+
+/**
+ * Decompresses a BCn surface. BC1 to BC5 and BC7 are decoded to RGBA8, with signed formats
+ * written as signed bytes. BC6H is decoded to RGBA16F with an alpha of one.
+ * @param format Compressed pixel format
+ * @param data   Compressed blocks, tightly packed
+ * @param output Decompressed pixels, tightly packed
+ */
+void Decompress(VideoCore::Surface::PixelFormat format, const u8* data, u32 width, u32 height,
+                u32 depth, u8* output);
+
+/// Returns the size in bytes of a BC1 or BC3 compressed surface of the given dimensions.
+std::size_t CompressedSize(VideoCore::Surface::PixelFormat format, u32 width, u32 height,
+                           u32 depth);
+
+/**
+ * Compresses tightly packed RGBA8 pixels to BC1 or BC3 in real time.
+ * The encoder fits endpoints to the bounding box of each block, favouring speed over quality.
+ * BC1 keeps punch through alpha, texels with an alpha below 128 are encoded as transparent.
+ */
+void Compress(VideoCore::Surface::PixelFormat format, const u8* rgba8, u32 width, u32 height,
+              u32 depth, u8* output);
+
+/// Transcodes an ASTC surface to BC3, the output must have CompressedSize bytes.
+void TranscodeASTCToBC3(const u8* data, u32 width, u32 height, u32 depth, u32 block_width,
+                        u32 block_height, u8* output);
+
+} // namespace Tegra::Texture::BCn
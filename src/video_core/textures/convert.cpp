@@ -3,90 +3,505 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
 #include <cstring>
 #include <tuple>
 #include <vector>
 
+#ifdef ARCHITECTURE_x86_64
+#include <immintrin.h>
+#endif
+
 #include "common/assert.h"
 #include "common/common_types.h"
 #include "common/logging/log.h"
+#ifdef ARCHITECTURE_x86_64
+#include "common/x64/cpu_detect.h"
+#endif
 #include "video_core/surface.h"
 #include "video_core/textures/astc.h"
+#include "video_core/textures/bcn.h"
 #include "video_core/textures/convert.h"
 
 namespace Tegra::Texture {
 
 using VideoCore::Surface::PixelFormat;
 
-template <bool reverse>
-void SwapS8Z24ToZ24S8(u8* data, u32 width, u32 height) {
-    union S8Z24 {
-        BitField<0, 24, u32> z24;
-        BitField<24, 8, u32> s8;
-    };
-    static_assert(sizeof(S8Z24) == 4, "S8Z24 is incorrect size");
-
-    union Z24S8 {
-        BitField<0, 8, u32> s8;
-        BitField<8, 24, u32> z24;
-    };
-    static_assert(sizeof(Z24S8) == 4, "Z24S8 is incorrect size");
-
-    S8Z24 s8z24_pixel{};
-    Z24S8 z24s8_pixel{};
-    constexpr auto bpp{
-        VideoCore::Surface::GetBytesPerPixel(VideoCore::Surface::PixelFormat::S8_UINT_D24_UNORM)};
-    for (std::size_t y = 0; y < height; ++y) {
-        for (std::size_t x = 0; x < width; ++x) {
-            const std::size_t offset{bpp * (y * width + x)};
-            if constexpr (reverse) {
-                std::memcpy(&z24s8_pixel, &data[offset], sizeof(Z24S8));
-                s8z24_pixel.s8.Assign(z24s8_pixel.s8);
-                s8z24_pixel.z24.Assign(z24s8_pixel.z24);
-                std::memcpy(&data[offset], &s8z24_pixel, sizeof(S8Z24));
-            } else {
-                std::memcpy(&s8z24_pixel, &data[offset], sizeof(S8Z24));
-                z24s8_pixel.s8.Assign(s8z24_pixel.s8);
-                z24s8_pixel.z24.Assign(s8z24_pixel.z24);
-                std::memcpy(&data[offset], &z24s8_pixel, sizeof(Z24S8));
-            }
+namespace {
+
+template <typename T>
+T Load(const u8* data, std::size_t index) {
+    T value;
+    std::memcpy(&value, data + index * sizeof(T), sizeof(T));
+    return value;
+}
+
+template <typename T>
+void Store(u8* data, std::size_t index, T value) {
+    std::memcpy(data + index * sizeof(T), &value, sizeof(T));
+}
+
+/// Expands an unsigned normalized value of the given bit width to 8 bits.
+template <u32 bits>
+constexpr u32 ExpandUnorm(u32 value) {
+    return (value << (8 - bits)) | (value >> (2 * bits - 8));
+}
+
+/// Quantizes an 8 bits unsigned normalized value to the given bit width, rounding to nearest.
+template <u32 bits>
+constexpr u32 QuantizeUnorm(u32 value) {
+    constexpr u32 max = (1U << bits) - 1;
+    return (value * max + 127) / 255;
+}
+
+/// Converts a half float to a single float. Signaling NaNs are quieted like F16C does.
+u32 HalfToFloat(u16 half) {
+    const u32 sign = static_cast<u32>(half & 0x8000) << 16;
+    const u32 exponent = (half >> 10) & 0x1f;
+    u32 mantissa = half & 0x3ff;
+    if (exponent == 0x1f) {
+        return sign | 0x7f800000 | (mantissa << 13) | (mantissa != 0 ? 0x400000 : 0);
+    }
+    if (exponent != 0) {
+        return sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+    if (mantissa == 0) {
+        return sign;
+    }
+    // Denormal, normalize it
+    u32 biased = 113;
+    while ((mantissa & 0x400) == 0) {
+        mantissa <<= 1;
+        --biased;
+    }
+    return sign | (biased << 23) | ((mantissa & 0x3ff) << 13);
+}
+
+/// Rounds an integer shifted right by shift to nearest, ties to even.
+constexpr u32 ShiftRoundEven(u32 value, u32 shift) {
+    const u32 result = value >> shift;
+    const u32 remainder = value & ((1U << shift) - 1);
+    const u32 halfway = 1U << (shift - 1);
+    return result + ((remainder > halfway || (remainder == halfway && (result & 1))) ? 1 : 0);
+}
+
+/// Converts a single float to a half float rounding to nearest even, matching F16C.
+u16 FloatToHalf(u32 value) {
+    const u32 sign = (value >> 16) & 0x8000;
+    const u32 abs = value & 0x7fffffff;
+    if (abs >= 0x7f800000) {
+        const u32 mantissa = abs > 0x7f800000 ? (0x200 | ((abs >> 13) & 0x3ff)) : 0;
+        return static_cast<u16>(sign | 0x7c00 | mantissa);
+    }
+    if (abs < 0x38800000) {
+        // Result is a half denormal or zero
+        const u32 exponent = abs >> 23;
+        if (exponent < 102) {
+            return static_cast<u16>(sign);
         }
+        const u32 mantissa = (abs & 0x7fffff) | 0x800000;
+        return static_cast<u16>(sign | ShiftRoundEven(mantissa, 126 - exponent));
+    }
+    // Rebias the exponent, a rounding carry propagates into it and saturates to infinity
+    const u32 half = std::min(ShiftRoundEven(abs - 0x38000000, 13), 0x7c00U);
+    return static_cast<u16>(sign | half);
+}
+
+/// Converts a half float to an unsigned small float with the given mantissa bits.
+template <u32 mantissa_bits>
+u32 HalfToUfloat(u16 half) {
+    constexpr u32 shift = 10 - mantissa_bits;
+    constexpr u32 infinity = 0x1fU << mantissa_bits;
+    const bool is_nan = (half & 0x7fff) > 0x7c00;
+    if (is_nan) {
+        return infinity | std::max((half & 0x3ffU) >> shift, 1U);
+    }
+    if ((half & 0x8000) != 0) {
+        // Negative values are clamped to zero
+        return 0;
     }
+    if (half == 0x7c00) {
+        return infinity;
+    }
+    return ShiftRoundEven(half, shift);
 }
 
-static void ConvertS8Z24ToZ24S8(u8* data, u32 width, u32 height) {
-    SwapS8Z24ToZ24S8<false>(data, width, height);
+void S8Z24ToZ24S8(const u8* in, u8* out, std::size_t num_pixels) {
+    for (std::size_t i = 0; i < num_pixels; ++i) {
+        const u32 pixel = Load<u32>(in, i);
+        Store<u32>(out, i, (pixel << 8) | (pixel >> 24));
+    }
+}
+
+void Z24S8ToS8Z24(const u8* in, u8* out, std::size_t num_pixels) {
+    for (std::size_t i = 0; i < num_pixels; ++i) {
+        const u32 pixel = Load<u32>(in, i);
+        Store<u32>(out, i, (pixel >> 8) | (pixel << 24));
+    }
 }
 
-static void ConvertZ24S8ToS8Z24(u8* data, u32 width, u32 height) {
-    SwapS8Z24ToZ24S8<true>(data, width, height);
+void SwapRedBlue(const u8* in, u8* out, std::size_t num_pixels) {
+    for (std::size_t i = 0; i < num_pixels; ++i) {
+        const u32 pixel = Load<u32>(in, i);
+        Store<u32>(out, i,
+                   (pixel & 0xff00ff00) | ((pixel >> 16) & 0xff) | ((pixel & 0xff) << 16));
+    }
+}
+
+void A1B5G5R5ToRGBA8(const u8* in, u8* out, std::size_t num_pixels) {
+    for (std::size_t i = 0; i < num_pixels; ++i) {
+        const u32 pixel = Load<u16>(in, i);
+        const u32 r = ExpandUnorm<5>(pixel & 0x1f);
+        const u32 g = ExpandUnorm<5>((pixel >> 5) & 0x1f);
+        const u32 b = ExpandUnorm<5>((pixel >> 10) & 0x1f);
+        const u32 a = (pixel >> 15) != 0 ? 0xff : 0;
+        Store<u32>(out, i, r | (g << 8) | (b << 16) | (a << 24));
+    }
+}
+
+void RGBA8ToA1B5G5R5(const u8* in, u8* out, std::size_t num_pixels) {
+    for (std::size_t i = 0; i < num_pixels; ++i) {
+        const u32 pixel = Load<u32>(in, i);
+        const u32 r = QuantizeUnorm<5>(pixel & 0xff);
+        const u32 g = QuantizeUnorm<5>((pixel >> 8) & 0xff);
+        const u32 b = QuantizeUnorm<5>((pixel >> 16) & 0xff);
+        const u32 a = (pixel >> 31);
+        Store<u16>(out, i, static_cast<u16>(r | (g << 5) | (b << 10) | (a << 15)));
+    }
+}
+
+void B5G6R5ToRGBA8(const u8* in, u8* out, std::size_t num_pixels) {
+    for (std::size_t i = 0; i < num_pixels; ++i) {
+        const u32 pixel = Load<u16>(in, i);
+        const u32 r = ExpandUnorm<5>(pixel & 0x1f);
+        const u32 g = ExpandUnorm<6>((pixel >> 5) & 0x3f);
+        const u32 b = ExpandUnorm<5>((pixel >> 11) & 0x1f);
+        Store<u32>(out, i, r | (g << 8) | (b << 16) | 0xff000000);
+    }
+}
+
+void RGBA8ToB5G6R5(const u8* in, u8* out, std::size_t num_pixels) {
+    for (std::size_t i = 0; i < num_pixels; ++i) {
+        const u32 pixel = Load<u32>(in, i);
+        const u32 r = QuantizeUnorm<5>(pixel & 0xff);
+        const u32 g = QuantizeUnorm<6>((pixel >> 8) & 0xff);
+        const u32 b = QuantizeUnorm<5>((pixel >> 16) & 0xff);
+        Store<u16>(out, i, static_cast<u16>(r | (g << 5) | (b << 11)));
+    }
+}
+
+/// Unsigned 11 and 10 bits floats share the half float exponent, so widening them is a shift.
+u64 ExpandB10G11R11(u32 pixel) {
+    const u64 r = static_cast<u64>(pixel & 0x7ff) << 4;
+    const u64 g = static_cast<u64>((pixel >> 11) & 0x7ff) << 4;
+    const u64 b = static_cast<u64>(pixel >> 22) << 5;
+    constexpr u64 a = 0x3c00; // 1.0
+    return r | (g << 16) | (b << 32) | (a << 48);
+}
+
+void B10G11R11ToRGBA16F(const u8* in, u8* out, std::size_t num_pixels) {
+    for (std::size_t i = 0; i < num_pixels; ++i) {
+        Store<u64>(out, i, ExpandB10G11R11(Load<u32>(in, i)));
+    }
+}
+
+void RGBA16FToB10G11R11(const u8* in, u8* out, std::size_t num_pixels) {
+    for (std::size_t i = 0; i < num_pixels; ++i) {
+        const u64 pixel = Load<u64>(in, i);
+        const u32 r = HalfToUfloat<6>(static_cast<u16>(pixel));
+        const u32 g = HalfToUfloat<6>(static_cast<u16>(pixel >> 16));
+        const u32 b = HalfToUfloat<5>(static_cast<u16>(pixel >> 32));
+        Store<u32>(out, i, r | (g << 11) | (b << 22));
+    }
+}
+
+void RGBA16FToRGBA32F(const u8* in, u8* out, std::size_t num_pixels) {
+    for (std::size_t i = 0; i < num_pixels * 4; ++i) {
+        Store<u32>(out, i, HalfToFloat(Load<u16>(in, i)));
+    }
+}
+
+void RGBA32FToRGBA16F(const u8* in, u8* out, std::size_t num_pixels) {
+    for (std::size_t i = 0; i < num_pixels * 4; ++i) {
+        Store<u16>(out, i, FloatToHalf(Load<u32>(in, i)));
+    }
 }
 
-void ConvertFromGuestToHost(u8* in_data, u8* out_data, PixelFormat pixel_format, u32 width,
-                            u32 height, u32 depth, bool convert_astc, bool convert_s8z24) {
-    if (convert_astc && IsPixelFormatASTC(pixel_format)) {
-        // Convert ASTC pixel formats to RGBA8, as most desktop GPUs do not support ASTC.
+#ifdef ARCHITECTURE_x86_64
+
+#ifdef _MSC_VER
+#define TARGET_SSSE3
+#define TARGET_AVX2
+#define TARGET_F16C
+#else
+#define TARGET_SSSE3 __attribute__((target("ssse3")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_F16C __attribute__((target("avx,f16c")))
+#endif
+
+// SSE2 is part of the x86-64 baseline, these don't need to be checked at runtime.
+
+void S8Z24ToZ24S8SSE2(const u8* in, u8* out, std::size_t num_pixels) {
+    std::size_t i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 4));
+        const __m128i result = _mm_or_si128(_mm_slli_epi32(pixels, 8), _mm_srli_epi32(pixels, 24));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 4), result);
+    }
+    S8Z24ToZ24S8(in + i * 4, out + i * 4, num_pixels - i);
+}
+
+void Z24S8ToS8Z24SSE2(const u8* in, u8* out, std::size_t num_pixels) {
+    std::size_t i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 4));
+        const __m128i result = _mm_or_si128(_mm_srli_epi32(pixels, 8), _mm_slli_epi32(pixels, 24));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 4), result);
+    }
+    Z24S8ToS8Z24(in + i * 4, out + i * 4, num_pixels - i);
+}
+
+void B10G11R11ToRGBA16FSSE2(const u8* in, u8* out, std::size_t num_pixels) {
+    const __m128i mask11 = _mm_set1_epi32(0x7ff);
+    const __m128i alpha = _mm_set1_epi32(0x3c00 << 16);
+    std::size_t i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 4));
+        const __m128i r = _mm_slli_epi32(_mm_and_si128(pixels, mask11), 4);
+        const __m128i g = _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(pixels, 11), mask11), 4 + 16);
+        const __m128i b = _mm_slli_epi32(_mm_srli_epi32(pixels, 22), 5);
+        const __m128i rg = _mm_or_si128(r, g);
+        const __m128i ba = _mm_or_si128(b, alpha);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 8), _mm_unpacklo_epi32(rg, ba));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 8 + 16), _mm_unpackhi_epi32(rg, ba));
+    }
+    B10G11R11ToRGBA16F(in + i * 4, out + i * 8, num_pixels - i);
+}
+
+TARGET_SSSE3 void SwapRedBlueSSSE3(const u8* in, u8* out, std::size_t num_pixels) {
+    const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    std::size_t i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 4),
+                         _mm_shuffle_epi8(pixels, shuffle));
+    }
+    SwapRedBlue(in + i * 4, out + i * 4, num_pixels - i);
+}
+
+TARGET_AVX2 void S8Z24ToZ24S8AVX2(const u8* in, u8* out, std::size_t num_pixels) {
+    std::size_t i = 0;
+    for (; i + 8 <= num_pixels; i += 8) {
+        const __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i * 4));
+        const __m256i result =
+            _mm256_or_si256(_mm256_slli_epi32(pixels, 8), _mm256_srli_epi32(pixels, 24));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * 4), result);
+    }
+    S8Z24ToZ24S8(in + i * 4, out + i * 4, num_pixels - i);
+}
+
+TARGET_AVX2 void Z24S8ToS8Z24AVX2(const u8* in, u8* out, std::size_t num_pixels) {
+    std::size_t i = 0;
+    for (; i + 8 <= num_pixels; i += 8) {
+        const __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i * 4));
+        const __m256i result =
+            _mm256_or_si256(_mm256_srli_epi32(pixels, 8), _mm256_slli_epi32(pixels, 24));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * 4), result);
+    }
+    Z24S8ToS8Z24(in + i * 4, out + i * 4, num_pixels - i);
+}
+
+TARGET_AVX2 void SwapRedBlueAVX2(const u8* in, u8* out, std::size_t num_pixels) {
+    const __m256i shuffle =
+        _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15, 2, 1, 0, 3, 6, 5, 4,
+                         7, 10, 9, 8, 11, 14, 13, 12, 15);
+    std::size_t i = 0;
+    for (; i + 8 <= num_pixels; i += 8) {
+        const __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i * 4));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * 4),
+                            _mm256_shuffle_epi8(pixels, shuffle));
+    }
+    SwapRedBlue(in + i * 4, out + i * 4, num_pixels - i);
+}
+
+TARGET_AVX2 void B10G11R11ToRGBA16FAVX2(const u8* in, u8* out, std::size_t num_pixels) {
+    const __m256i mask11 = _mm256_set1_epi32(0x7ff);
+    const __m256i alpha = _mm256_set1_epi32(0x3c00 << 16);
+    std::size_t i = 0;
+    for (; i + 8 <= num_pixels; i += 8) {
+        const __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i * 4));
+        const __m256i r = _mm256_slli_epi32(_mm256_and_si256(pixels, mask11), 4);
+        const __m256i g =
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(pixels, 11), mask11), 4 + 16);
+        const __m256i b = _mm256_slli_epi32(_mm256_srli_epi32(pixels, 22), 5);
+        const __m256i rg = _mm256_or_si256(r, g);
+        const __m256i ba = _mm256_or_si256(b, alpha);
+        // Unpacking works within 128 bits lanes, yielding pixels 0, 1, 4, 5 and 2, 3, 6, 7
+        const __m256i low = _mm256_unpacklo_epi32(rg, ba);
+        const __m256i high = _mm256_unpackhi_epi32(rg, ba);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * 8),
+                            _mm256_permute2x128_si256(low, high, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * 8 + 32),
+                            _mm256_permute2x128_si256(low, high, 0x31));
+    }
+    B10G11R11ToRGBA16FSSE2(in + i * 4, out + i * 8, num_pixels - i);
+}
+
+TARGET_F16C void RGBA16FToRGBA32FF16C(const u8* in, u8* out, std::size_t num_pixels) {
+    std::size_t i = 0;
+    for (; i + 2 <= num_pixels; i += 2) {
+        const __m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 8));
+        _mm256_storeu_ps(reinterpret_cast<float*>(out + i * 16), _mm256_cvtph_ps(halves));
+    }
+    RGBA16FToRGBA32F(in + i * 8, out + i * 16, num_pixels - i);
+}
+
+TARGET_F16C void RGBA32FToRGBA16FF16C(const u8* in, u8* out, std::size_t num_pixels) {
+    std::size_t i = 0;
+    for (; i + 2 <= num_pixels; i += 2) {
+        const __m256 floats = _mm256_loadu_ps(reinterpret_cast<const float*>(in + i * 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 8),
+                         _mm256_cvtps_ph(floats, _MM_FROUND_TO_NEAREST_INT));
+    }
+    RGBA32FToRGBA16F(in + i * 16, out + i * 8, num_pixels - i);
+}
+
+#endif
+
+constexpr std::size_t NUM_CONVERSIONS = 6;
+
+std::array<FormatConversion, NUM_CONVERSIONS> BuildConversions() {
+    std::array<FormatConversion, NUM_CONVERSIONS> conversions{{
+        {PixelFormat::S8_UINT_D24_UNORM, PixelFormat::D24_UNORM_S8_UINT, 4, 4, S8Z24ToZ24S8,
+         Z24S8ToS8Z24},
+        {PixelFormat::B8G8R8A8_UNORM, PixelFormat::A8B8G8R8_UNORM, 4, 4, SwapRedBlue,
+         SwapRedBlue},
+        {PixelFormat::A1B5G5R5_UNORM, PixelFormat::A8B8G8R8_UNORM, 2, 4, A1B5G5R5ToRGBA8,
+         RGBA8ToA1B5G5R5},
+        {PixelFormat::B5G6R5_UNORM, PixelFormat::A8B8G8R8_UNORM, 2, 4, B5G6R5ToRGBA8,
+         RGBA8ToB5G6R5},
+        {PixelFormat::B10G11R11_FLOAT, PixelFormat::R16G16B16A16_FLOAT, 4, 8, B10G11R11ToRGBA16F,
+         RGBA16FToB10G11R11},
+        {PixelFormat::R16G16B16A16_FLOAT, PixelFormat::R32G32B32A32_FLOAT, 8, 16,
+         RGBA16FToRGBA32F, RGBA32FToRGBA16F},
+    }};
+#ifdef ARCHITECTURE_x86_64
+    const auto& caps = Common::GetCPUCaps();
+    auto& s8z24 = conversions[0];
+    auto& swap_red_blue = conversions[1];
+    auto& b10g11r11 = conversions[4];
+    auto& rgba16f = conversions[5];
+    if (caps.avx2) {
+        s8z24.to_host = S8Z24ToZ24S8AVX2;
+        s8z24.to_guest = Z24S8ToS8Z24AVX2;
+        swap_red_blue.to_host = swap_red_blue.to_guest = SwapRedBlueAVX2;
+        b10g11r11.to_host = B10G11R11ToRGBA16FAVX2;
+    } else {
+        s8z24.to_host = S8Z24ToZ24S8SSE2;
+        s8z24.to_guest = Z24S8ToS8Z24SSE2;
+        if (caps.ssse3) {
+            swap_red_blue.to_host = swap_red_blue.to_guest = SwapRedBlueSSSE3;
+        }
+        b10g11r11.to_host = B10G11R11ToRGBA16FSSE2;
+    }
+    if (caps.f16c) {
+        rgba16f.to_host = RGBA16FToRGBA32FF16C;
+        rgba16f.to_guest = RGBA32FToRGBA16FF16C;
+    }
+#endif
+    return conversions;
+}
+
+} // Anonymous namespace
+
+const FormatConversion* GetFormatConversion(PixelFormat guest_format) {
+    static const std::array<FormatConversion, NUM_CONVERSIONS> conversions = BuildConversions();
+    const auto it = std::find_if(conversions.begin(), conversions.end(),
+                                 [guest_format](const FormatConversion& entry) {
+                                     return entry.guest_format == guest_format;
+                                 });
+    return it != conversions.end() ? &*it : nullptr;
+}
+
+void ConvertToHost(PixelFormat guest_format, const u8* in, u8* out, std::size_t num_pixels) {
+    const FormatConversion* const conversion = GetFormatConversion(guest_format);
+    ASSERT_MSG(conversion, "Format {} has no host conversion", static_cast<u32>(guest_format));
+    conversion->to_host(in, out, num_pixels);
+}
+
+void ConvertToGuest(PixelFormat guest_format, const u8* in, u8* out, std::size_t num_pixels) {
+    const FormatConversion* const conversion = GetFormatConversion(guest_format);
+    ASSERT_MSG(conversion, "Format {} has no host conversion", static_cast<u32>(guest_format));
+    conversion->to_guest(in, out, num_pixels);
+}
+
+PixelFormat GetConvertedFormat(PixelFormat pixel_format, bool is_bcn_supported) {
+    const bool is_srgb = VideoCore::Surface::IsPixelFormatSRGB(pixel_format);
+    if (IsPixelFormatASTC(pixel_format)) {
+        if (is_bcn_supported) {
+            return is_srgb ? PixelFormat::BC3_SRGB : PixelFormat::BC3_UNORM;
+        }
+        return is_srgb ? PixelFormat::A8B8G8R8_SRGB : PixelFormat::A8B8G8R8_UNORM;
+    }
+    switch (pixel_format) {
+    case PixelFormat::BC4_SNORM:
+    case PixelFormat::BC5_SNORM:
+        return PixelFormat::A8B8G8R8_SNORM;
+    case PixelFormat::BC6H_UFLOAT:
+    case PixelFormat::BC6H_SFLOAT:
+        return PixelFormat::R16G16B16A16_FLOAT;
+    default:
+        ASSERT_MSG(BCn::IsBCnFormat(pixel_format), "Format {} is not compressed",
+                   static_cast<u32>(pixel_format));
+        return is_srgb ? PixelFormat::A8B8G8R8_SRGB : PixelFormat::A8B8G8R8_UNORM;
+    }
+}
+
+void ConvertFromGuestToHost(u8* in_data, u8* out_data, PixelFormat pixel_format,
+                            PixelFormat host_format, u32 width, u32 height, u32 depth,
+                            bool convert_s8z24) {
+    const bool is_converted = host_format != pixel_format;
+    if (is_converted && IsPixelFormatASTC(pixel_format)) {
         u32 block_width{};
         u32 block_height{};
         std::tie(block_width, block_height) = GetASTCBlockSize(pixel_format);
-        const std::vector<u8> rgba8_data = Tegra::Texture::ASTC::Decompress(
-            in_data, width, height, depth, block_width, block_height);
-        std::copy(rgba8_data.begin(), rgba8_data.end(), out_data);
+        if (host_format == PixelFormat::BC3_UNORM || host_format == PixelFormat::BC3_SRGB) {
+            // Hosts with BCn but without ASTC, like most desktop GPUs, sample BC3 at a quarter of
+            // the memory RGBA8 takes. Input and output may alias, so transcode to a separate
+            // buffer first.
+            std::vector<u8> bc3_data(BCn::CompressedSize(host_format, width, height, depth));
+            BCn::TranscodeASTCToBC3(in_data, width, height, depth, block_width, block_height,
+                                    bc3_data.data());
+            std::copy(bc3_data.begin(), bc3_data.end(), out_data);
+        } else {
+            const std::vector<u8> rgba8_data = Tegra::Texture::ASTC::Decompress(
+                in_data, width, height, depth, block_width, block_height);
+            std::copy(rgba8_data.begin(), rgba8_data.end(), out_data);
+        }
+
+    } else if (is_converted && BCn::IsBCnFormat(pixel_format)) {
+        // Decompress BCn on hosts without BCn support, like some mobile GPUs. Input and output
+        // may alias, so decode to a separate buffer first.
+        std::vector<u8> decompressed(std::size_t{width} * height * depth *
+                                     BCn::DecompressedBytesPerPixel(pixel_format));
+        BCn::Decompress(pixel_format, in_data, width, height, depth, decompressed.data());
+        std::copy(decompressed.begin(), decompressed.end(), out_data);
 
     } else if (convert_s8z24 && pixel_format == PixelFormat::S8_UINT_D24_UNORM) {
-        Tegra::Texture::ConvertS8Z24ToZ24S8(in_data, width, height);
+        ConvertToHost(pixel_format, in_data, in_data, std::size_t{width} * height * depth);
     }
 }
 
 void ConvertFromHostToGuest(u8* data, PixelFormat pixel_format, u32 width, u32 height, u32 depth,
-                            bool convert_astc, bool convert_s8z24) {
-    if (convert_astc && IsPixelFormatASTC(pixel_format)) {
+                            bool convert_compressed, bool convert_s8z24) {
+    if (convert_compressed &&
+        (IsPixelFormatASTC(pixel_format) || BCn::IsBCnFormat(pixel_format))) {
         LOG_CRITICAL(HW_GPU, "Conversion of format {} after texture flushing is not implemented",
                      static_cast<u32>(pixel_format));
         UNREACHABLE();
 
     } else if (convert_s8z24 && pixel_format == PixelFormat::S8_UINT_D24_UNORM) {
-        Tegra::Texture::ConvertZ24S8ToS8Z24(data, width, height);
+        ConvertToGuest(pixel_format, data, data, std::size_t{width} * height * depth);
     }
 }
 
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 #include "common/common_types.h"
 
 namespace VideoCore::Surface {
@@ -12,11 +14,48 @@ enum class PixelFormat;
 
 namespace Tegra::Texture {
 
+/// Conversion between a guest pixel format and a layout every host API can upload natively.
+struct FormatConversion {
+    using Kernel = void (*)(const u8* in, u8* out, std::size_t num_pixels);
+
+    VideoCore::Surface::PixelFormat guest_format; ///< Format as stored in guest memory
+    VideoCore::Surface::PixelFormat host_format;  ///< Format of the converted pixels
+    u32 guest_bytes_per_pixel;                    ///< Size of a guest pixel in bytes
+    u32 host_bytes_per_pixel;                     ///< Size of a converted pixel in bytes
+    Kernel to_host;                               ///< Converts guest pixels to host pixels
+    Kernel to_guest;                              ///< Converts host pixels back to guest pixels
+};
+
+/**
+ * Returns the conversion of a guest pixel format, or nullptr when it doesn't have one.
+ * Kernels are picked for the host CPU on first use. They can run in place when the guest and host
+ * pixel sizes are equal.
+ */
+const FormatConversion* GetFormatConversion(VideoCore::Surface::PixelFormat guest_format);
+
+/// Converts num_pixels guest pixels of the given format to its host layout.
+void ConvertToHost(VideoCore::Surface::PixelFormat guest_format, const u8* in, u8* out,
+                   std::size_t num_pixels);
+
+/// Converts num_pixels host pixels back to the layout of the given guest format.
+void ConvertToGuest(VideoCore::Surface::PixelFormat guest_format, const u8* in, u8* out,
+                    std::size_t num_pixels);
+
+/**
+ * Returns the format a compressed surface is uploaded as when the host can't sample it.
+ * ASTC is transcoded to BC3 on hosts that support BCn and decompressed to RGBA8 otherwise.
+ * BCn is decompressed to RGBA8, or RGBA16F for BC6H.
+ */
+VideoCore::Surface::PixelFormat GetConvertedFormat(VideoCore::Surface::PixelFormat pixel_format,
+                                                   bool is_bcn_supported);
+
+/// Converts a guest surface to the layout uploaded to the host. Compressed surfaces are converted
+/// when host_format differs from pixel_format, host_format comes from GetConvertedFormat.
 void ConvertFromGuestToHost(u8* in_data, u8* out_data, VideoCore::Surface::PixelFormat pixel_format,
-                            u32 width, u32 height, u32 depth, bool convert_astc,
-                            bool convert_s8z24);
+                            VideoCore::Surface::PixelFormat host_format, u32 width, u32 height,
+                            u32 depth, bool convert_s8z24);
 
 void ConvertFromHostToGuest(u8* data, VideoCore::Surface::PixelFormat pixel_format, u32 width,
-                            u32 height, u32 depth, bool convert_astc, bool convert_s8z24);
+                            u32 height, u32 depth, bool convert_compressed, bool convert_s8z24);
 
 } // namespace Tegra::Texture
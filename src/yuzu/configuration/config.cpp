@@ -513,6 +513,8 @@ void Config::ReadDebuggingValues() {
     Settings::values.quest_flag = ReadSetting(QStringLiteral("quest_flag"), false).toBool();
     Settings::values.disable_macro_jit =
         ReadSetting(QStringLiteral("disable_macro_jit"), false).toBool();
+    Settings::values.handle_table_capacity =
+        ReadSetting(QStringLiteral("handle_table_capacity"), 1024).toUInt();
 
     qt_config->endGroup();
 }
@@ -656,6 +658,10 @@ void Config::ReadRendererValues() {
                       QStringLiteral("use_asynchronous_shaders"), false);
     ReadSettingGlobal(Settings::values.use_fast_gpu_time, QStringLiteral("use_fast_gpu_time"),
                       true);
+    ReadSettingGlobal(Settings::values.texture_cache_budget_mb,
+                      QStringLiteral("texture_cache_budget_mb"), 4096);
+    ReadSettingGlobal(Settings::values.use_precise_frame_pacing,
+                      QStringLiteral("use_precise_frame_pacing"), true);
     ReadSettingGlobal(Settings::values.bg_red, QStringLiteral("bg_red"), 0.0);
     ReadSettingGlobal(Settings::values.bg_green, QStringLiteral("bg_green"), 0.0);
     ReadSettingGlobal(Settings::values.bg_blue, QStringLiteral("bg_blue"), 0.0);
@@ -1042,6 +1048,8 @@ void Config::SaveDebuggingValues() {
     WriteSetting(QStringLiteral("dump_nso"), Settings::values.dump_nso, false);
     WriteSetting(QStringLiteral("quest_flag"), Settings::values.quest_flag, false);
     WriteSetting(QStringLiteral("disable_macro_jit"), Settings::values.disable_macro_jit, false);
+    WriteSetting(QStringLiteral("handle_table_capacity"), Settings::values.handle_table_capacity,
+                 1024);
 
     qt_config->endGroup();
 }
@@ -1160,6 +1168,10 @@ void Config::SaveRendererValues() {
                        Settings::values.use_asynchronous_shaders, false);
     WriteSettingGlobal(QStringLiteral("use_fast_gpu_time"), Settings::values.use_fast_gpu_time,
                        true);
+    WriteSettingGlobal(QStringLiteral("texture_cache_budget_mb"),
+                       Settings::values.texture_cache_budget_mb, 4096);
+    WriteSettingGlobal(QStringLiteral("use_precise_frame_pacing"),
+                       Settings::values.use_precise_frame_pacing, true);
     // Cast to double because Qt's written float values are not human-readable
     WriteSettingGlobal(QStringLiteral("bg_red"), Settings::values.bg_red, 0.0);
     WriteSettingGlobal(QStringLiteral("bg_green"), Settings::values.bg_green, 0.0);
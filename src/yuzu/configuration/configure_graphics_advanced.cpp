@@ -31,6 +31,10 @@ void ConfigureGraphicsAdvanced::SetConfiguration() {
     ui->use_assembly_shaders->setChecked(Settings::values.use_assembly_shaders.GetValue());
     ui->use_asynchronous_shaders->setChecked(Settings::values.use_asynchronous_shaders.GetValue());
     ui->use_fast_gpu_time->setChecked(Settings::values.use_fast_gpu_time.GetValue());
+    ui->use_precise_frame_pacing->setChecked(
+        Settings::values.use_precise_frame_pacing.GetValue());
+    ui->texture_cache_budget->setValue(
+        static_cast<int>(Settings::values.texture_cache_budget_mb.GetValue()));
 
     if (Settings::configuring_global) {
         ui->gpu_accuracy->setCurrentIndex(
@@ -76,10 +80,18 @@ void ConfigureGraphicsAdvanced::ApplyConfiguration() {
         if (Settings::values.use_fast_gpu_time.UsingGlobal()) {
             Settings::values.use_fast_gpu_time.SetValue(ui->use_fast_gpu_time->isChecked());
         }
+        if (Settings::values.use_precise_frame_pacing.UsingGlobal()) {
+            Settings::values.use_precise_frame_pacing.SetValue(
+                ui->use_precise_frame_pacing->isChecked());
+        }
         if (Settings::values.max_anisotropy.UsingGlobal()) {
             Settings::values.max_anisotropy.SetValue(
                 ui->anisotropic_filtering_combobox->currentIndex());
         }
+        if (Settings::values.texture_cache_budget_mb.UsingGlobal()) {
+            Settings::values.texture_cache_budget_mb.SetValue(
+                static_cast<u32>(ui->texture_cache_budget->value()));
+        }
     } else {
         ConfigurationShared::ApplyPerGameSetting(&Settings::values.max_anisotropy,
                                                  ui->anisotropic_filtering_combobox);
@@ -92,6 +104,9 @@ void ConfigureGraphicsAdvanced::ApplyConfiguration() {
                                                  use_asynchronous_shaders);
         ConfigurationShared::ApplyPerGameSetting(&Settings::values.use_fast_gpu_time,
                                                  ui->use_fast_gpu_time, use_fast_gpu_time);
+        ConfigurationShared::ApplyPerGameSetting(&Settings::values.use_precise_frame_pacing,
+                                                 ui->use_precise_frame_pacing,
+                                                 use_precise_frame_pacing);
         ConfigurationShared::ApplyPerGameSetting(&Settings::values.max_anisotropy,
                                                  ui->anisotropic_filtering_combobox);
 
@@ -125,12 +140,19 @@ void ConfigureGraphicsAdvanced::SetupPerGameUI() {
         ui->use_asynchronous_shaders->setEnabled(
             Settings::values.use_asynchronous_shaders.UsingGlobal());
         ui->use_fast_gpu_time->setEnabled(Settings::values.use_fast_gpu_time.UsingGlobal());
+        ui->use_precise_frame_pacing->setEnabled(
+            Settings::values.use_precise_frame_pacing.UsingGlobal());
         ui->anisotropic_filtering_combobox->setEnabled(
             Settings::values.max_anisotropy.UsingGlobal());
+        ui->texture_cache_budget->setEnabled(
+            Settings::values.texture_cache_budget_mb.UsingGlobal());
 
         return;
     }
 
+    // Spin boxes have no "use global" state, the budget can only be configured globally
+    ui->texture_cache_budget_layout->setVisible(false);
+
     ConfigurationShared::SetColoredTristate(ui->use_vsync, Settings::values.use_vsync, use_vsync);
     ConfigurationShared::SetColoredTristate(
         ui->use_assembly_shaders, Settings::values.use_assembly_shaders, use_assembly_shaders);
@@ -139,6 +161,9 @@ void ConfigureGraphicsAdvanced::SetupPerGameUI() {
                                             use_asynchronous_shaders);
     ConfigurationShared::SetColoredTristate(ui->use_fast_gpu_time,
                                             Settings::values.use_fast_gpu_time, use_fast_gpu_time);
+    ConfigurationShared::SetColoredTristate(ui->use_precise_frame_pacing,
+                                            Settings::values.use_precise_frame_pacing,
+                                            use_precise_frame_pacing);
     ConfigurationShared::SetColoredComboBox(
         ui->gpu_accuracy, ui->label_gpu_accuracy,
         static_cast<int>(Settings::values.gpu_accuracy.GetValue(true)));
@@ -96,7 +96,9 @@ static FileSys::VirtualFile VfsDirectoryCreateFileWrapper(const FileSys::Virtual
 #include "core/telemetry_session.h"
 #include "input_common/main.h"
 #include "video_core/gpu.h"
+#include "video_core/query_cache_stats.h"
 #include "video_core/shader_notify.h"
+#include "video_core/texture_cache/texture_cache_stats.h"
 #include "yuzu/about_dialog.h"
 #include "yuzu/bootmanager.h"
 #include "yuzu/compatdb.h"
@@ -516,9 +518,10 @@ void GMainWindow::InitializeWidgets() {
     emu_frametime_label->setToolTip(
         tr("Time taken to emulate a Switch frame, not counting framelimiting or v-sync. For "
            "full-speed emulation this should be at most 16.67 ms."));
+    texture_cache_label = new QLabel();
 
-    for (auto& label :
-         {shader_building_label, emu_speed_label, game_fps_label, emu_frametime_label}) {
+    for (auto& label : {shader_building_label, emu_speed_label, game_fps_label,
+                        emu_frametime_label, texture_cache_label}) {
         label->setVisible(false);
         label->setFrameStyle(QFrame::NoFrame);
         label->setContentsMargins(4, 0, 4, 0);
@@ -1194,6 +1197,7 @@ void GMainWindow::ShutdownGame() {
     emu_speed_label->setVisible(false);
     game_fps_label->setVisible(false);
     emu_frametime_label->setVisible(false);
+    texture_cache_label->setVisible(false);
     async_status_button->setEnabled(true);
     multicore_status_button->setEnabled(true);
 #ifdef HAS_VULKAN
@@ -2424,9 +2428,36 @@ void GMainWindow::UpdateStatusBar() {
     game_fps_label->setText(tr("Game: %1 FPS").arg(results.game_fps, 0, 'f', 0));
     emu_frametime_label->setText(tr("Frame: %1 ms").arg(results.frametime * 1000.0, 0, 'f', 2));
 
+    const auto query_stats = Core::System::GetInstance().GPU().QueryCacheStats().GetSnapshot();
+    emu_frametime_label->setToolTip(
+        tr("Time taken to emulate a Switch frame, not counting framelimiting or v-sync. For "
+           "full-speed emulation this should be at most 16.67 ms.\n"
+           "Frame pacing (p50 / p99 / p99.9): %1 / %2 / %3 ms.\n"
+           "Last frame waited %4 ms for %5 of %6 GPU queries.")
+            .arg(results.frame_length_p50 * 1000.0, 0, 'f', 2)
+            .arg(results.frame_length_p99 * 1000.0, 0, 'f', 2)
+            .arg(results.frame_length_p999 * 1000.0, 0, 'f', 2)
+            .arg(query_stats.last_frame.stall_ns / 1'000'000.0, 0, 'f', 2)
+            .arg(query_stats.last_frame.stalls)
+            .arg(query_stats.last_frame.queries));
+
+    const auto texture_stats =
+        Core::System::GetInstance().GPU().TextureCacheStats().GetSnapshot();
+    const u64 texture_lookups = texture_stats.hits + texture_stats.misses;
+    const double texture_hit_rate =
+        texture_lookups != 0 ? 100.0 * texture_stats.hits / texture_lookups : 100.0;
+    texture_cache_label->setText(
+        tr("Textures: %1 MiB").arg((texture_stats.cache_size + texture_stats.reserve_size) >> 20));
+    texture_cache_label->setToolTip(
+        tr("Host memory used by cached textures. Budget: %1 MiB, hit rate: %2%, evictions: %3")
+            .arg(texture_stats.budget >> 20)
+            .arg(texture_hit_rate, 0, 'f', 1)
+            .arg(texture_stats.evictions));
+
     emu_speed_label->setVisible(!Settings::values.use_multi_core.GetValue());
     game_fps_label->setVisible(true);
     emu_frametime_label->setVisible(true);
+    texture_cache_label->setVisible(true);
 }
 
 void GMainWindow::UpdateStatusButtons() {
@@ -388,6 +388,8 @@ void Config::ReadValues() {
         sdl2_config->GetBoolean("Renderer", "use_frame_limit", true));
     Settings::values.frame_limit.SetValue(
         static_cast<u16>(sdl2_config->GetInteger("Renderer", "frame_limit", 100)));
+    Settings::values.use_precise_frame_pacing.SetValue(
+        sdl2_config->GetBoolean("Renderer", "use_precise_frame_pacing", true));
     Settings::values.use_disk_shader_cache.SetValue(
         sdl2_config->GetBoolean("Renderer", "use_disk_shader_cache", false));
     const int gpu_accuracy_level = sdl2_config->GetInteger("Renderer", "gpu_accuracy", 0);
@@ -404,6 +406,8 @@ void Config::ReadValues() {
         sdl2_config->GetBoolean("Renderer", "use_asynchronous_shaders", false));
     Settings::values.use_fast_gpu_time.SetValue(
         sdl2_config->GetBoolean("Renderer", "use_fast_gpu_time", true));
+    Settings::values.texture_cache_budget_mb.SetValue(
+        static_cast<u32>(sdl2_config->GetInteger("Renderer", "texture_cache_budget_mb", 4096)));
 
     Settings::values.bg_red.SetValue(
         static_cast<float>(sdl2_config->GetReal("Renderer", "bg_red", 0.0)));
@@ -438,6 +442,8 @@ void Config::ReadValues() {
     Settings::values.quest_flag = sdl2_config->GetBoolean("Debugging", "quest_flag", false);
     Settings::values.disable_macro_jit =
         sdl2_config->GetBoolean("Debugging", "disable_macro_jit", false);
+    Settings::values.handle_table_capacity =
+        static_cast<u32>(sdl2_config->GetInteger("Debugging", "handle_table_capacity", 1024));
 
     const auto title_list = sdl2_config->Get("AddOns", "title_ids", "");
     std::stringstream ss(title_list);
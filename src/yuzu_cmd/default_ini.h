@@ -174,6 +174,11 @@ use_asynchronous_shaders =
 # 0: Off, 1: On (default)
 use_frame_limit =
 
+# Paces frames to precise deadlines by busy-waiting the last part of each frame limiter wait.
+# Lowers frame time jitter at the cost of some CPU time.
+# 0: Off, 1 (default): On
+use_precise_frame_pacing =
+
 # Limits the speed of the game to run no faster than this value as a percentage of target speed
 # 1 - 9999: Speed limit as a percentage of target game speed. 100 (default)
 frame_limit =
@@ -190,6 +195,10 @@ gpu_accuracy =
 # 0 : Off (slow), 1 (default): On (fast)
 use_asynchronous_gpu_emulation =
 
+# Host memory the texture cache may use before unused textures are evicted, in MiB
+# 0: Unlimited, 4096 (default)
+texture_cache_budget_mb =
+
 # Forces VSync on the display thread. Usually doesn't impact performance, but on some drivers it can
 # so only turn this off if you notice a speed difference.
 # 0: Off, 1 (default): On
@@ -322,6 +331,9 @@ dump_nso=false
 quest_flag =
 # Enables/Disables the macro JIT compiler
 disable_macro_jit=false
+# Number of handles the application may hold at once. Horizon allows 1024, homebrew stress tests
+# may need more. Values are clamped to [1024, 131072]
+handle_table_capacity=1024
 
 [WebService]
 # Whether or not to enable telemetry
@@ -91,6 +91,10 @@ bool EmuWindow_SDL2::IsOpen() const {
     return is_open;
 }
 
+void EmuWindow_SDL2::RequestClose() {
+    is_open = false;
+}
+
 bool EmuWindow_SDL2::IsShown() const {
     return is_shown;
 }
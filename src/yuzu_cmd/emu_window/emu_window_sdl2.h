@@ -30,6 +30,9 @@ public:
     /// Whether the window is still open, and a close request hasn't yet been sent
     bool IsOpen() const;
 
+    /// Requests the window to close, as if the user did
+    void RequestClose();
+
     /// Returns if window is shown (not minimized)
     bool IsShown() const override;
 
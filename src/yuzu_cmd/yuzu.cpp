@@ -4,6 +4,7 @@
 
 #include <chrono>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <string>
 #include <thread>
@@ -28,6 +29,7 @@
 #include "core/gdbstub/gdbstub.h"
 #include "core/hle/service/filesystem/filesystem.h"
 #include "core/loader/loader.h"
+#include "core/perf_stats.h"
 #include "core/settings.h"
 #include "core/telemetry_session.h"
 #include "input_common/main.h"
@@ -66,6 +68,9 @@ static void PrintHelp(const char* argv0) {
               << " [options] <filename>\n"
                  "-g, --gdbport=NUMBER  Enable gdb stub on port NUMBER\n"
                  "-f, --fullscreen      Start in fullscreen mode\n"
+                 "-b, --benchmark-startup=FRAMES\n"
+                 "                      Measure how long it takes to boot and present FRAMES\n"
+                 "                      game frames, then exit\n"
                  "-h, --help            Display this help and exit\n"
                  "-v, --version         Output version information and exit\n"
                  "-p, --program         Pass following string as arguments to executable\n";
@@ -75,6 +80,30 @@ static void PrintVersion() {
     std::cout << "yuzu " << Common::g_scm_branch << " " << Common::g_scm_desc << std::endl;
 }
 
+/// Timestamps of the boot phases measured by --benchmark-startup
+struct StartupTimes {
+    using Clock = std::chrono::steady_clock;
+
+    Clock::time_point start = Clock::now();
+    Clock::time_point loaded;
+    Clock::time_point disk_resources_loaded;
+    Clock::time_point first_frame;
+    Clock::time_point last_frame;
+};
+
+static void PrintStartupTimes(const StartupTimes& times, u32 num_frames) {
+    const auto ms = [&times](StartupTimes::Clock::time_point point) {
+        return std::chrono::duration<double, std::milli>(point - times.start).count();
+    };
+    fmt::print("Startup benchmark, in milliseconds since launch:\n"
+               "  Load              {:10.1f}\n"
+               "  Disk resources    {:10.1f}\n"
+               "  First frame       {:10.1f}\n"
+               "  {:<6} frames     {:10.1f}\n",
+               ms(times.loaded), ms(times.disk_resources_loaded), ms(times.first_frame),
+               num_frames, ms(times.last_frame));
+}
+
 static void InitializeLogging() {
     Log::Filter log_filter(Log::Level::Debug);
     log_filter.ParseFilterString(Settings::values.log_filter);
@@ -114,15 +143,18 @@ int main(int argc, char** argv) {
     std::string filepath;
 
     bool fullscreen = false;
+    u32 benchmark_frames = 0;
+    StartupTimes startup_times;
 
     static struct option long_options[] = {
         {"gdbport", required_argument, 0, 'g'}, {"fullscreen", no_argument, 0, 'f'},
         {"help", no_argument, 0, 'h'},          {"version", no_argument, 0, 'v'},
-        {"program", optional_argument, 0, 'p'}, {0, 0, 0, 0},
+        {"program", optional_argument, 0, 'p'}, {"benchmark-startup", required_argument, 0, 'b'},
+        {0, 0, 0, 0},
     };
 
     while (optind < argc) {
-        int arg = getopt_long(argc, argv, "g:fhvp::", long_options, &option_index);
+        int arg = getopt_long(argc, argv, "g:fhvp::b:", long_options, &option_index);
         if (arg != -1) {
             switch (static_cast<char>(arg)) {
             case 'g':
@@ -140,6 +172,20 @@ int main(int argc, char** argv) {
                 fullscreen = true;
                 LOG_INFO(Frontend, "Starting in fullscreen mode...");
                 break;
+            case 'b': {
+                errno = 0;
+                const unsigned long frames = strtoul(optarg, &endarg, 0);
+                if (endarg == optarg || frames == 0)
+                    errno = EINVAL;
+                if (frames > std::numeric_limits<u32>::max())
+                    errno = ERANGE;
+                if (errno != 0) {
+                    perror("--benchmark-startup");
+                    exit(1);
+                }
+                benchmark_frames = static_cast<u32>(frames);
+                break;
+            }
             case 'h':
                 PrintHelp(argv[0]);
                 return 0;
@@ -201,6 +247,7 @@ int main(int argc, char** argv) {
     system.GetFileSystemController().CreateFactories(*system.GetFilesystem());
 
     const Core::System::ResultStatus load_result{system.Load(*emu_window, filepath)};
+    startup_times.loaded = StartupTimes::Clock::now();
 
     switch (load_result) {
     case Core::System::ResultStatus::ErrorGetLoader:
@@ -236,11 +283,25 @@ int main(int argc, char** argv) {
     system.GPU().Start();
 
     system.Renderer().Rasterizer().LoadDiskResources();
+    startup_times.disk_resources_loaded = StartupTimes::Clock::now();
 
     std::thread render_thread([&emu_window] { emu_window->Present(); });
     system.Run();
     while (emu_window->IsOpen()) {
         std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        if (benchmark_frames == 0) {
+            continue;
+        }
+        const std::size_t num_frames = system.GetPerfStats().GetNumGameFrames();
+        if (num_frames != 0 && startup_times.first_frame == StartupTimes::Clock::time_point{}) {
+            startup_times.first_frame = StartupTimes::Clock::now();
+        }
+        if (num_frames >= benchmark_frames) {
+            startup_times.last_frame = StartupTimes::Clock::now();
+            PrintStartupTimes(startup_times, benchmark_frames);
+            benchmark_frames = 0;
+            emu_window->RequestClose();
+        }
     }
     system.Pause();
     render_thread.join();